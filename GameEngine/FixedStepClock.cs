@@ -0,0 +1,69 @@
+// Fixed-step clock - C# game engine
+// QuakeCloneWASM - Game Engine
+
+namespace GameEngine;
+
+/// <summary>
+/// Turns measured elapsed time into fixed simulation steps, like the C
+/// game's sim clock: elapsed time goes into an accumulator and every whole
+/// step it holds is run, so the simulation does not depend on how often or
+/// how regularly the caller wakes up. A call runs at most MaxStepsPerAdvance
+/// steps; time beyond that is dropped, so a stall slows the game down
+/// instead of making the next frames slower still.
+/// </summary>
+public sealed class FixedStepClock
+{
+    public const double DefaultRateHz = 60.0;
+    public const int DefaultMaxStepsPerAdvance = 6; // 0.1 s of game time
+
+    private double _accumulator;
+
+    public FixedStepClock(double rateHz = DefaultRateHz, int maxStepsPerAdvance = DefaultMaxStepsPerAdvance)
+    {
+        if (rateHz <= 0.0) throw new ArgumentOutOfRangeException(nameof(rateHz));
+        if (maxStepsPerAdvance <= 0) throw new ArgumentOutOfRangeException(nameof(maxStepsPerAdvance));
+        StepSeconds = 1.0 / rateHz;
+        MaxStepsPerAdvance = maxStepsPerAdvance;
+    }
+
+    public double StepSeconds { get; }
+    public int MaxStepsPerAdvance { get; }
+
+    public long Steps { get; private set; }         // Steps since the last Reset
+    public long DroppedSteps { get; private set; }  // Steps of time discarded by the guard
+
+    /// <summary>
+    /// Share of a step left in the accumulator (for interpolating displays)
+    /// </summary>
+    public double Alpha => _accumulator / StepSeconds;
+
+    /// <summary>
+    /// Add elapsed real time; returns how many steps of StepSeconds to run
+    /// </summary>
+    public int Advance(double elapsedSeconds)
+    {
+        if (elapsedSeconds > 0.0) _accumulator += elapsedSeconds;
+
+        int steps = 0;
+        while (_accumulator >= StepSeconds && steps < MaxStepsPerAdvance)
+        {
+            _accumulator -= StepSeconds;
+            steps++;
+        }
+        if (_accumulator >= StepSeconds)
+        {
+            long dropped = (long)(_accumulator / StepSeconds);
+            DroppedSteps += dropped;
+            _accumulator -= dropped * StepSeconds;
+        }
+        Steps += steps;
+        return steps;
+    }
+
+    public void Reset()
+    {
+        _accumulator = 0.0;
+        Steps = 0;
+        DroppedSteps = 0;
+    }
+}
@@ -11,6 +11,7 @@ public class PilotSeatController
     private SpaceShip _ship;
     private List<Planet> _planets;
     private bool _isActive = false;
+    private readonly FixedStepClock _clock = new();
     
     // Input state
     private float _thrusterPower = 0.0f;
@@ -42,6 +43,7 @@ public class PilotSeatController
         _pitchInput = 0.0f;
         _yawInput = 0.0f;
         _rollInput = 0.0f;
+        _clock.Reset();
     }
     
     /// <summary>
@@ -53,7 +55,25 @@ public class PilotSeatController
     }
     
     /// <summary>
-    /// Update pilot seat controller (called each frame)
+    /// Advance by measured elapsed real time in fixed steps of
+    /// Clock.StepSeconds. Returns the number of steps run.
+    /// </summary>
+    public int Advance(double elapsedSeconds)
+    {
+        if (!_isActive) return 0;
+        
+        int steps = _clock.Advance(elapsedSeconds);
+        for (int i = 0; i < steps; i++)
+        {
+            Update((float)_clock.StepSeconds);
+        }
+        return steps;
+    }
+    
+    public FixedStepClock Clock => _clock;
+    
+    /// <summary>
+    /// Update pilot seat controller by one step of deltaTime seconds
     /// </summary>
     public void Update(float deltaTime)
     {
@@ -88,8 +108,9 @@ public class PilotSeatController
     
     // Scanner methods
     public void ToggleScanner() => ScannerActive = !ScannerActive;
-    public List<Planet> GetNearbyPlanets() => _ship.NearbyPlanets;
-    public List<Planet> GetScannedPlanets() => _ship.ScannedPlanets;
+    public IReadOnlyList<Planet> GetNearbyPlanets() => _ship.NearbyPlanets;
+    public IReadOnlyList<Planet> GetScannedPlanets() => _ship.ScannedPlanets;
+    public int GetNearbyVersion() => _ship.Scanner?.Version ?? 0; // Changes when planets enter or leave range
     
     // Planet selection
     public void SelectPlanet(Planet planet) => SelectedPlanet = planet;
@@ -1,6 +1,8 @@
 // Planet data structure - C# game engine
 // QuakeCloneWASM - Game Engine
 
+using System.Numerics;
+
 namespace GameEngine;
 
 /// <summary>
@@ -18,6 +20,7 @@ public class Planet
     public bool HasLife { get; set; }
     public float RotationPeriodHours { get; set; }
     public int ResourceRichness { get; set; } // 0-100
+    public Vector3 Position { get; set; } // Position in space, same units as the ship's
     
     public float SurfaceTempCelsius => SurfaceTempK - 273.15f;
     
@@ -1,6 +1,8 @@
 // Planet database - C# game engine
 // QuakeCloneWASM - Game Engine
 
+using System.Numerics;
+
 namespace GameEngine;
 
 /// <summary>
@@ -8,6 +10,18 @@ namespace GameEngine;
 /// </summary>
 public static class PlanetDatabase
 {
+    // Million km per AU, the unit of ship positions and scanner range
+    private const float UnitsPerAu = 149.6f;
+
+    /// <summary>
+    /// Position of a planet on a circular orbit around the star at the origin
+    /// </summary>
+    public static Vector3 OrbitPosition(float distanceAu, float angleDegrees)
+    {
+        float angle = angleDegrees * MathF.PI / 180.0f;
+        return new Vector3(MathF.Cos(angle), 0.0f, MathF.Sin(angle)) * distanceAu * UnitsPerAu;
+    }
+
     /// <summary>
     /// Get all available planets with realistic astronomical data
     /// </summary>
@@ -27,7 +41,8 @@ public static class PlanetDatabase
                 HasWater = true,
                 HasLife = true,
                 RotationPeriodHours = 24.0f,
-                ResourceRichness = 85
+                ResourceRichness = 85,
+                Position = OrbitPosition(1.0f, 0.0f)
             },
             
             // Planet 1: Mars-like (Desert)
@@ -42,7 +57,8 @@ public static class PlanetDatabase
                 HasWater = false,
                 HasLife = false,
                 RotationPeriodHours = 24.6f,
-                ResourceRichness = 60
+                ResourceRichness = 60,
+                Position = OrbitPosition(1.5f, 70.0f)
             },
             
             // Planet 2: Venus-like (Toxic)
@@ -57,7 +73,8 @@ public static class PlanetDatabase
                 HasWater = false,
                 HasLife = false,
                 RotationPeriodHours = 5832.0f,
-                ResourceRichness = 40
+                ResourceRichness = 40,
+                Position = OrbitPosition(0.7f, 140.0f)
             },
             
             // Planet 3: Gas Giant Moon (Ice)
@@ -72,7 +89,8 @@ public static class PlanetDatabase
                 HasWater = true,
                 HasLife = false,
                 RotationPeriodHours = 84.0f,
-                ResourceRichness = 75
+                ResourceRichness = 75,
+                Position = OrbitPosition(5.2f, 210.0f)
             },
             
             // Planet 4: Ocean World
@@ -87,7 +105,8 @@ public static class PlanetDatabase
                 HasWater = true,
                 HasLife = true,
                 RotationPeriodHours = 18.0f,
-                ResourceRichness = 90
+                ResourceRichness = 90,
+                Position = OrbitPosition(1.2f, 280.0f)
             },
             
             // Planet 5: Rocky Desert
@@ -102,7 +121,8 @@ public static class PlanetDatabase
                 HasWater = false,
                 HasLife = false,
                 RotationPeriodHours = 36.0f,
-                ResourceRichness = 70
+                ResourceRichness = 70,
+                Position = OrbitPosition(2.8f, 35.0f)
             },
             
             // Planet 6: Lava World
@@ -117,7 +137,8 @@ public static class PlanetDatabase
                 HasWater = false,
                 HasLife = false,
                 RotationPeriodHours = 12.0f,
-                ResourceRichness = 95
+                ResourceRichness = 95,
+                Position = OrbitPosition(0.3f, 175.0f)
             },
             
             // Planet 7: Gas Giant with Space Station
@@ -132,7 +153,8 @@ public static class PlanetDatabase
                 HasWater = false,
                 HasLife = false,
                 RotationPeriodHours = 16.0f,
-                ResourceRichness = 50
+                ResourceRichness = 50,
+                Position = OrbitPosition(30.0f, 320.0f)
             }
         };
     }
@@ -0,0 +1,94 @@
+// Planet spatial index - C# game engine
+// QuakeCloneWASM - Game Engine
+
+using System.Numerics;
+
+namespace GameEngine;
+
+/// <summary>
+/// Uniform grid over planet positions. Planets are sorted by cell once, so
+/// a cell is a range of one array; radius queries visit only the cells the
+/// sphere overlaps and allocate nothing.
+/// </summary>
+public sealed class PlanetIndex
+{
+    // Cell coordinates are packed into a long, 21 bits each
+    private const int CellBits = 21;
+    private const int CellBias = 1 << (CellBits - 1);
+    private const long CellMask = (1L << CellBits) - 1;
+
+    private readonly IReadOnlyList<Planet> _planets;
+    private readonly Vector3[] _positions;
+    private readonly int[] _sorted; // Planet indices ordered by cell
+    private readonly Dictionary<long, (int Start, int Count)> _cells = new();
+    private readonly float _inverseCellSize;
+
+    public PlanetIndex(IReadOnlyList<Planet> planets, float cellSize)
+    {
+        if (cellSize <= 0.0f) throw new ArgumentOutOfRangeException(nameof(cellSize));
+
+        _planets = planets;
+        _inverseCellSize = 1.0f / cellSize;
+        CellSize = cellSize;
+        _positions = new Vector3[planets.Count];
+        _sorted = new int[planets.Count];
+
+        var keys = new long[planets.Count];
+        for (int i = 0; i < planets.Count; i++)
+        {
+            _positions[i] = planets[i].Position;
+            keys[i] = CellKey(CellOf(_positions[i].X), CellOf(_positions[i].Y), CellOf(_positions[i].Z));
+            _sorted[i] = i;
+        }
+        Array.Sort(keys, _sorted);
+
+        for (int start = 0; start < keys.Length;)
+        {
+            int end = start + 1;
+            while (end < keys.Length && keys[end] == keys[start]) end++;
+            _cells[keys[start]] = (start, end - start);
+            start = end;
+        }
+    }
+
+    public IReadOnlyList<Planet> Planets => _planets;
+    public int Count => _positions.Length;
+    public float CellSize { get; }
+    public int CellCount => _cells.Count;
+
+    /// <summary>
+    /// Position of planet index as of building the index
+    /// </summary>
+    public Vector3 GetPosition(int index) => _positions[index];
+
+    /// <summary>
+    /// Add the indices of the planets within radius of center to results
+    /// </summary>
+    public void QueryRadius(Vector3 center, float radius, List<int> results)
+    {
+        float radiusSquared = radius * radius;
+        int x0 = CellOf(center.X - radius), x1 = CellOf(center.X + radius);
+        int y0 = CellOf(center.Y - radius), y1 = CellOf(center.Y + radius);
+        int z0 = CellOf(center.Z - radius), z1 = CellOf(center.Z + radius);
+
+        for (int x = x0; x <= x1; x++)
+        for (int y = y0; y <= y1; y++)
+        for (int z = z0; z <= z1; z++)
+        {
+            if (!_cells.TryGetValue(CellKey(x, y, z), out var cell)) continue;
+            for (int i = cell.Start; i < cell.Start + cell.Count; i++)
+            {
+                int planet = _sorted[i];
+                if (Vector3.DistanceSquared(_positions[planet], center) <= radiusSquared)
+                {
+                    results.Add(planet);
+                }
+            }
+        }
+    }
+
+    private int CellOf(float coordinate) => (int)MathF.Floor(coordinate * _inverseCellSize);
+
+    private static long CellKey(int x, int y, int z) =>
+        ((x + CellBias) & CellMask) | (((y + CellBias) & CellMask) << CellBits) | (((z + CellBias) & CellMask) << (2 * CellBits));
+}
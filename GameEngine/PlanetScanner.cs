@@ -0,0 +1,154 @@
+// Planet scanner - C# game engine
+// QuakeCloneWASM - Game Engine
+
+using System.Numerics;
+
+namespace GameEngine;
+
+/// <summary>
+/// Tracks which planets are within scanner range of a moving ship. Each
+/// scan only processes range-boundary crossings: the index is queried for a
+/// shell of candidates (range plus a margin) around the ship, and until the
+/// ship has moved further than the margin no planet outside the shell can
+/// come into range, so scans test just the shell. After warm-up a scan
+/// allocates nothing.
+/// </summary>
+public sealed class PlanetScanner
+{
+    // Shell margin as a share of the range: wider shells are rebuilt less
+    // often but test more candidates per scan
+    private const float MarginFraction = 0.25f;
+
+    private readonly PlanetIndex _index;
+    private readonly Dictionary<Planet, int> _indexOf;
+    private readonly List<int> _shell = new();
+    private Vector3 _shellCenter;
+    private float _shellRange = -1.0f; // Range the shell was built for
+    private float _shellMargin;
+
+    private readonly bool[] _inRange;
+    private readonly bool[] _scanned;
+    private readonly int[] _nearbySlot;      // Slot in _nearby of planets in range
+    private readonly List<Planet> _nearby = new();
+    private readonly List<int> _nearbyIndices = new();
+    private readonly List<Planet> _scannedPlanets = new();
+
+    public PlanetScanner(IReadOnlyList<Planet> planets, float range)
+    {
+        // Cells about as large as the shell keep queries to a few cells
+        _index = new PlanetIndex(planets, MathF.Max(range * (1.0f + MarginFraction), 1.0f));
+        _indexOf = new Dictionary<Planet, int>(planets.Count, ReferenceEqualityComparer.Instance);
+        for (int i = 0; i < planets.Count; i++) _indexOf[planets[i]] = i;
+        _inRange = new bool[planets.Count];
+        _scanned = new bool[planets.Count];
+        _nearbySlot = new int[planets.Count];
+    }
+
+    /// <summary>
+    /// Planets within range as of the last scan (in the order they entered,
+    /// except that a planet leaving is replaced by the last one)
+    /// </summary>
+    public IReadOnlyList<Planet> Nearby => _nearby;
+
+    /// <summary>
+    /// Every planet that has been in range, in the order first seen
+    /// </summary>
+    public IReadOnlyList<Planet> Scanned => _scannedPlanets;
+
+    public IReadOnlyList<Planet> Planets => _index.Planets;
+
+    // Statistics of the last scan and totals
+    public int LastEntered { get; private set; }
+    public int LastLeft { get; private set; }
+    public int LastTested { get; private set; }
+    public int ShellRebuilds { get; private set; }
+
+    /// <summary>
+    /// Bumped whenever Nearby changes, so views can skip refreshing it
+    /// </summary>
+    public int Version { get; private set; }
+
+    public bool IsScanned(Planet planet) => _indexOf.TryGetValue(planet, out int i) && _scanned[i];
+
+    /// <summary>
+    /// Mark a planet as scanned without it having been in range
+    /// </summary>
+    public void MarkScanned(Planet planet)
+    {
+        if (_indexOf.TryGetValue(planet, out int i) && !_scanned[i])
+        {
+            _scanned[i] = true;
+            _scannedPlanets.Add(planet);
+        }
+    }
+
+    /// <summary>
+    /// Update the planets in range of position. Returns the number of
+    /// boundary crossings (planets entering or leaving range).
+    /// </summary>
+    public int Scan(Vector3 position, float range)
+    {
+        LastEntered = 0;
+        LastLeft = 0;
+        LastTested = 0;
+        float rangeSquared = range * range;
+
+        if (range != _shellRange || Vector3.DistanceSquared(position, _shellCenter) > _shellMargin * _shellMargin)
+        {
+            _shellMargin = range * MarginFraction;
+            _shellRange = range;
+            _shellCenter = position;
+            _shell.Clear();
+            _index.QueryRadius(position, range + _shellMargin, _shell);
+            ShellRebuilds++;
+
+            // Planets in range that the new shell misses are out of range now
+            for (int slot = _nearbyIndices.Count - 1; slot >= 0; slot--)
+            {
+                int i = _nearbyIndices[slot];
+                LastTested++;
+                if (Vector3.DistanceSquared(_index.GetPosition(i), position) > rangeSquared) Leave(i);
+            }
+        }
+
+        foreach (int i in _shell)
+        {
+            LastTested++;
+            bool inRange = Vector3.DistanceSquared(_index.GetPosition(i), position) <= rangeSquared;
+            if (inRange == _inRange[i]) continue;
+            if (inRange) Enter(i);
+            else Leave(i);
+        }
+        return LastEntered + LastLeft;
+    }
+
+    private void Enter(int i)
+    {
+        _inRange[i] = true;
+        _nearbySlot[i] = _nearby.Count;
+        _nearby.Add(_index.Planets[i]);
+        _nearbyIndices.Add(i);
+        if (!_scanned[i])
+        {
+            _scanned[i] = true;
+            _scannedPlanets.Add(_index.Planets[i]);
+        }
+        LastEntered++;
+        Version++;
+    }
+
+    private void Leave(int i)
+    {
+        int slot = _nearbySlot[i];
+        int last = _nearby.Count - 1;
+        int moved = _nearbyIndices[last];
+        _nearby[slot] = _nearby[last];
+        _nearbyIndices[slot] = moved;
+        _nearbySlot[moved] = slot;
+        _nearby.RemoveAt(last);
+        _nearbyIndices.RemoveAt(last);
+        _inRange[i] = false;
+        LastLeft++;
+        Version++;
+    }
+}
@@ -30,8 +30,12 @@ public class SpaceShip
     
     // Scanning system
     public float ScannerRange { get; set; } = 1000.0f; // Units
-    public List<Planet> ScannedPlanets { get; set; } = new();
-    public List<Planet> NearbyPlanets { get; set; } = new();
+    public IReadOnlyList<Planet> ScannedPlanets => _scanner?.Scanned ?? Array.Empty<Planet>();
+    public IReadOnlyList<Planet> NearbyPlanets => _scanner?.Nearby ?? Array.Empty<Planet>();
+    public PlanetScanner? Scanner => _scanner;
+    
+    private PlanetScanner? _scanner;
+    private int _scannerPlanetCount;
     
     /// <summary>
     /// Update ship physics and systems
@@ -103,28 +107,22 @@ public class SpaceShip
     }
     
     /// <summary>
-    /// Scan for nearby planets
+    /// Scan for planets within ScannerRange of the ship's position. The
+    /// planets' spatial index is built on the first scan and rebuilt only
+    /// when the planet list changes; scanned planets carry over.
     /// </summary>
-    public void ScanForPlanets(List<Planet> allPlanets)
+    public void ScanForPlanets(IReadOnlyList<Planet> allPlanets)
     {
-        NearbyPlanets.Clear();
-        
-        foreach (var planet in allPlanets)
+        if (_scanner == null || !ReferenceEquals(_scanner.Planets, allPlanets) || _scannerPlanetCount != allPlanets.Count)
         {
-            // Simple distance check (in real implementation, would use 3D distance)
-            float distance = planet.DistanceAu * 149.6f; // Convert AU to millions of km (simplified)
-            
-            if (distance <= ScannerRange)
+            var previous = _scanner;
+            _scanner = new PlanetScanner(allPlanets, ScannerRange);
+            _scannerPlanetCount = allPlanets.Count;
+            if (previous != null)
             {
-                NearbyPlanets.Add(planet);
-                
-                // Add to scanned planets if not already there
-                if (!ScannedPlanets.Contains(planet))
-                {
-                    ScannedPlanets.Add(planet);
-                }
+                foreach (var planet in previous.Scanned) _scanner.MarkScanned(planet);
             }
         }
+        _scanner.Scan(Position, ScannerRange);
     }
 }
-
@@ -0,0 +1,299 @@
+// Scanner benchmark - C# game engine
+// QuakeCloneWASM - Game Engine benchmarks
+//
+// Usage: dotnet run -c Release --project GameEngineBench -- [--planets N] [--ticks N] [--iterations N]
+//
+// A ship flies through a field of random planets, under its own physics
+// (full thrust, turning slowly) and then in a straight line at warp
+// speed, and scans every tick. Three scanners run each flight: the old
+// linear scan (List.Contains for scanned planets, nearby list rebuilt
+// every tick), a grid query every tick, and the incremental PlanetScanner. The table follows BenchmarkDotNet's layout:
+// time and allocation per scan over several measured iterations after
+// warm-up, with the old scan as the baseline. The incremental scanner is
+// checked against brute force on every tick first.
+//
+// Finally the pilot seat's update loop is replayed with jittery wake-ups:
+// the old loop (dt = 0.016 per wake-up) against FixedStepClock driven by
+// the measured time, for the same 10 s of real time.
+
+using System.Diagnostics;
+using System.Numerics;
+using GameEngine;
+
+var options = new BenchOptions();
+for (int i = 0; i + 1 < args.Length; i += 2)
+{
+    switch (args[i])
+    {
+        case "--planets": options.Planets = int.Parse(args[i + 1]); break;
+        case "--ticks": options.Ticks = int.Parse(args[i + 1]); break;
+        case "--iterations": options.Iterations = int.Parse(args[i + 1]); break;
+        case "--range": options.Range = float.Parse(args[i + 1]); break;
+        default:
+            Console.WriteLine($"Unknown option {args[i]}");
+            return 1;
+    }
+}
+
+var planets = ScannerBench.MakePlanets(options.Planets, options.Range);
+Console.WriteLine($"{planets.Count} planets, scanner range {options.Range}, {options.Ticks} ticks per iteration");
+
+var flights = new (string Name, Vector3[] Positions)[]
+{
+    ("cruise (ship physics)", ScannerBench.MakeFlight(options.Ticks)),
+    ("warp (straight, 10 units per tick)", ScannerBench.MakeWarpFlight(options.Ticks, 10.0f)),
+};
+foreach (var (name, flight) in flights)
+{
+    var check = new PlanetScanner(planets, options.Range);
+    int mismatches = ScannerBench.Validate(planets, flight, options.Range, check);
+    Console.WriteLine($"\nFlight: {name}, {Vector3.Distance(flight[0], flight[^1]):F0} units, " +
+                      $"{check.ShellRebuilds} shell rebuilds");
+    if (mismatches > 0)
+    {
+        Console.WriteLine($"Validation FAILED: {mismatches} ticks differ from brute force");
+        return 2;
+    }
+    Console.WriteLine("Validation: incremental scanner matches brute force on every tick\n");
+
+    var results = new List<BenchResult>
+    {
+        ScannerBench.Run("LinearScan", options, () => new LinearScanner(planets), flight),
+        ScannerBench.Run("GridQuery", options, () => new GridScanner(planets, options.Range), flight),
+        ScannerBench.Run("Incremental", options, () => new IncrementalScanner(planets, options.Range), flight),
+    };
+    ScannerBench.Print(results);
+}
+Console.WriteLine("\nTimes and allocations are per scan (one tick). Scanners are built before timing; lists growing\n" +
+                  "during the first scans of a flight count as allocations.");
+
+ClockBench.Run();
+return 0;
+
+class BenchOptions
+{
+    public int Planets { get; set; } = 100_000;
+    public int Ticks { get; set; } = 2_000;
+    public int Iterations { get; set; } = 15;
+    public int Warmup { get; set; } = 3;
+    public float Range { get; set; } = 1000.0f;
+}
+
+record BenchResult(string Method, double MeanNs, double ErrorNs, double StdDevNs, double AllocatedBytes);
+
+interface IScanner
+{
+    void Scan(Vector3 position, float range);
+}
+
+// The scan SpaceShip used to do, with true 3D distances
+sealed class LinearScanner : IScanner
+{
+    private readonly List<Planet> _planets;
+    private readonly List<Planet> _nearby = new();
+    private readonly List<Planet> _scanned = new();
+
+    public LinearScanner(List<Planet> planets) => _planets = planets;
+
+    public void Scan(Vector3 position, float range)
+    {
+        _nearby.Clear();
+        foreach (var planet in _planets)
+        {
+            if (Vector3.Distance(planet.Position, position) <= range)
+            {
+                _nearby.Add(planet);
+                if (!_scanned.Contains(planet)) _scanned.Add(planet);
+            }
+        }
+    }
+}
+
+// The grid index queried from scratch every tick, scanned planets in a set
+sealed class GridScanner : IScanner
+{
+    private readonly PlanetIndex _index;
+    private readonly List<int> _nearby = new();
+    private readonly HashSet<int> _scanned = new();
+
+    public GridScanner(List<Planet> planets, float range) => _index = new PlanetIndex(planets, range);
+
+    public void Scan(Vector3 position, float range)
+    {
+        _nearby.Clear();
+        _index.QueryRadius(position, range, _nearby);
+        foreach (int i in _nearby) _scanned.Add(i);
+    }
+}
+
+sealed class IncrementalScanner : IScanner
+{
+    private readonly PlanetScanner _scanner;
+
+    public IncrementalScanner(List<Planet> planets, float range) => _scanner = new PlanetScanner(planets, range);
+    public void Scan(Vector3 position, float range) => _scanner.Scan(position, range);
+}
+
+static class ScannerBench
+{
+    // Planets uniformly in a cube sized so about 50 are within range
+    public static List<Planet> MakePlanets(int count, float range)
+    {
+        var random = new Random(42);
+        float side = MathF.Cbrt(count / 50.0f * 4.0f / 3.0f * MathF.PI) * range;
+        var planets = new List<Planet>(count);
+        for (int i = 0; i < count; i++)
+        {
+            planets.Add(new Planet
+            {
+                Name = $"Planet {i}",
+                Position = new Vector3(random.NextSingle() - 0.5f, random.NextSingle() - 0.5f, random.NextSingle() - 0.5f) * side
+            });
+        }
+        return planets;
+    }
+
+    // Ship positions at 60 Hz: full thrust, yawing and pitching slowly
+    public static Vector3[] MakeFlight(int ticks)
+    {
+        const float dt = 1.0f / 60.0f;
+        var ship = new SpaceShip { EnergyRegenRate = 100.0f };
+        var positions = new Vector3[ticks];
+        for (int t = 0; t < ticks; t++)
+        {
+            ship.ApplyThruster(1.0f, dt);
+            ship.ApplyRotation(0.05f * MathF.Sin(t * 0.01f), 0.1f, 0.0f, dt);
+            ship.Update(dt);
+            positions[t] = ship.Position;
+        }
+        return positions;
+    }
+
+    // A straight line along a diagonal, far faster than the ship flies
+    public static Vector3[] MakeWarpFlight(int ticks, float unitsPerTick)
+    {
+        var direction = Vector3.Normalize(new Vector3(1.0f, 0.2f, 0.6f));
+        var positions = new Vector3[ticks];
+        for (int t = 0; t < ticks; t++)
+        {
+            positions[t] = direction * (unitsPerTick * (t - ticks / 2));
+        }
+        return positions;
+    }
+
+    // Ticks whose nearby set differs from testing every planet
+    public static int Validate(List<Planet> planets, Vector3[] flight, float range, PlanetScanner scanner)
+    {
+        var expected = new HashSet<Planet>(ReferenceEqualityComparer.Instance);
+        int mismatches = 0;
+        foreach (var position in flight)
+        {
+            scanner.Scan(position, range);
+            expected.Clear();
+            foreach (var planet in planets)
+            {
+                if (Vector3.DistanceSquared(planet.Position, position) <= range * range) expected.Add(planet);
+            }
+            if (!expected.SetEquals(scanner.Nearby) || scanner.Nearby.Count != expected.Count) mismatches++;
+        }
+        return mismatches;
+    }
+
+    public static BenchResult Run(string method, BenchOptions options, Func<IScanner> create, Vector3[] flight)
+    {
+        var samples = new List<double>();
+        double allocated = 0.0;
+        for (int iteration = 0; iteration < options.Warmup + options.Iterations; iteration++)
+        {
+            var scanner = create();
+            long bytes = GC.GetAllocatedBytesForCurrentThread();
+            long start = Stopwatch.GetTimestamp();
+            foreach (var position in flight)
+            {
+                scanner.Scan(position, options.Range);
+            }
+            double elapsed = Stopwatch.GetElapsedTime(start).TotalNanoseconds;
+            bytes = GC.GetAllocatedBytesForCurrentThread() - bytes;
+
+            if (iteration >= options.Warmup)
+            {
+                samples.Add(elapsed / flight.Length);
+                allocated += (double)bytes / flight.Length;
+            }
+        }
+
+        double mean = samples.Average();
+        double stdDev = Math.Sqrt(samples.Sum(s => (s - mean) * (s - mean)) / Math.Max(1, samples.Count - 1));
+        double error = 3.291 * stdDev / Math.Sqrt(samples.Count); // 99.9% confidence half-width
+        return new BenchResult(method, mean, error, stdDev, allocated / options.Iterations);
+    }
+
+    public static void Print(List<BenchResult> results)
+    {
+        double baseline = results[0].MeanNs;
+        Console.WriteLine($"| {"Method",-12} | {"Mean",12} | {"Error",11} | {"StdDev",11} | {"Ratio",7} | {"Allocated",10} |");
+        Console.WriteLine($"|{new string('-', 14)}|{new string('-', 13)}:|{new string('-', 12)}:|{new string('-', 12)}:|{new string('-', 8)}:|{new string('-', 11)}:|");
+        foreach (var r in results)
+        {
+            Console.WriteLine($"| {r.Method,-12} | {FormatTime(r.MeanNs),12} | {FormatTime(r.ErrorNs),11} | {FormatTime(r.StdDevNs),11} | " +
+                              $"{r.MeanNs / baseline,7:F3} | {FormatBytes(r.AllocatedBytes),10} |");
+        }
+    }
+
+    private static string FormatTime(double ns) =>
+        ns >= 1e6 ? $"{ns / 1e6:F3} ms" : ns >= 1e3 ? $"{ns / 1e3:F3} us" : $"{ns:F1} ns";
+
+    private static string FormatBytes(double bytes) =>
+        bytes >= 1024.0 ? $"{bytes / 1024.0:F1} KB" : $"{bytes:F0} B";
+}
+
+// Where the ship ends up after 10 s of thrust and turning, when wake-ups
+// come 16 ms apart plus up to a given lateness
+static class ClockBench
+{
+    private const double Seconds = 10.0;
+
+    public static void Run()
+    {
+        Console.WriteLine("\nPilot seat loop, 10 s of real time, wake-ups 16 ms + up to jitter apart:");
+        Console.WriteLine($"| {"Jitter",-8} | {"Old: game time",14} | {"Old: position",22} | {"Fixed: game time",16} | {"Fixed: position",22} |");
+        foreach (double jitter in new[] { 0.0, 0.004, 0.012 })
+        {
+            var (oldTime, oldPosition) = Fly(jitter, fixedStep: false);
+            var (newTime, newPosition) = Fly(jitter, fixedStep: true);
+            Console.WriteLine($"| {jitter * 1000.0,5:F0} ms | {oldTime,12:F3} s | {Format(oldPosition),22} | " +
+                              $"{newTime,14:F3} s | {Format(newPosition),22} |");
+        }
+    }
+
+    private static (double GameTime, Vector3 Position) Fly(double jitter, bool fixedStep)
+    {
+        var random = new Random(5);
+        var ship = new SpaceShip { EnergyRegenRate = 100.0f };
+        var controller = new PilotSeatController(ship, new List<Planet>());
+        controller.Activate();
+        controller.SetThrusterPower(1.0f);
+        controller.SetYawInput(0.2f);
+
+        double realTime = 0.0, gameTime = 0.0;
+        while (realTime < Seconds)
+        {
+            // Task.Delay(16) sleeps at least 16 ms and often longer
+            double wake = 0.016 + random.NextDouble() * jitter;
+            wake = Math.Min(wake, Seconds - realTime);
+            realTime += wake;
+            if (fixedStep)
+            {
+                gameTime += controller.Advance(wake) * controller.Clock.StepSeconds;
+            }
+            else
+            {
+                controller.Update(0.016f);
+                gameTime += 0.016;
+            }
+        }
+        return (gameTime, ship.Position);
+    }
+
+    private static string Format(Vector3 v) => $"({v.X:F1}, {v.Z:F1})";
+}
@@ -0,0 +1,193 @@
+// Benchmark driver - Native entry point and shared helpers
+// QuakeCloneWASM - Native benchmarks
+//
+// Usage: bench <command> [options]
+// Build with ./build_native.sh; see each command's --help for options.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+#include "input.h"
+#include "sim.h"
+
+typedef struct {
+    const char* name;
+    const char* description;
+    int (*run)(int argc, char** argv);
+} BenchCommand;
+
+static const BenchCommand g_commands[] = {
+    { "render", "Scripted camera flythroughs: ns/column, ns/pixel, p50/p99 frame time, bytes written", bench_render_main },
+    { "rays", "Scalar vs SIMD packet DDA throughput and bit-exactness", bench_rays_main },
+    { "maps", "Map memory and ray cost against map size, with and without empty-space skipping", bench_maps_main },
+    { "surface", "Endless surface streaming: chunk generation, world_update stalls, cache hits", bench_surface_main },
+    { "beam", "Beam transitions: in-frame swap cost and request-to-arrival latency, cold and prefetched", bench_beam_main },
+    { "collision", "Swept circle moves and broadphase neighbour queries per second, with tunnelling checks", bench_collision_main },
+    { "entities", "Entity tick time for 1k-50k wandering agents against a 2 ms budget", bench_entities_main },
+    { "sim", "Fixed-timestep simulation: same state at any frame rate, headless speed", bench_sim_main },
+    { "replay", "Input recordings: size, replay fidelity at any frame rate, replayed frame times", bench_replay_main },
+    { "galaxy", "Procedural galaxy: system count, cold and warm nearest-N and range queries, cache memory", bench_galaxy_main },
+};
+
+static const int g_command_count = sizeof(g_commands) / sizeof(g_commands[0]);
+
+static void print_usage(void) {
+    printf("Usage: bench <command> [options]\n\nCommands:\n");
+    for (int i = 0; i < g_command_count; ++i) {
+        printf("  %-10s %s\n", g_commands[i].name, g_commands[i].description);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        print_usage();
+        return 1;
+    }
+
+    for (int i = 0; i < g_command_count; ++i) {
+        if (strcmp(argv[1], g_commands[i].name) == 0) {
+            return g_commands[i].run(argc - 1, argv + 1);
+        }
+    }
+
+    printf("Unknown command: %s\n\n", argv[1]);
+    print_usage();
+    return 1;
+}
+
+// -------------------------------------------------------------------------
+// Shared helpers
+// -------------------------------------------------------------------------
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+uint64_t bench_percentile(uint64_t* samples, size_t count, double percentile) {
+    if (count == 0) {
+        return 0;
+    }
+    qsort(samples, count, sizeof(uint64_t), compare_u64);
+    size_t index = (size_t)(percentile / 100.0 * (double)(count - 1) + 0.5);
+    if (index >= count) index = count - 1;
+    return samples[index];
+}
+
+static uint32_t g_rng_state = 0x2545F491u;
+
+void bench_seed_random(uint32_t seed) {
+    g_rng_state = seed ? seed : 0x2545F491u;
+}
+
+float bench_random_unit(void) {
+    g_rng_state ^= g_rng_state << 13;
+    g_rng_state ^= g_rng_state >> 17;
+    g_rng_state ^= g_rng_state << 5;
+    return (float)(g_rng_state >> 8) / 16777216.0f;
+}
+
+static const int g_move_keys[] = { 'W', 'W', 'W', 'A', 'D', 'S', 0 };
+
+void bench_autopilot_reset(BenchAutopilot* pilot) {
+    pilot->random = 0x1234567u;
+    pilot->next_change = 0;
+    pilot->key = 0;
+    pilot->turn = 0.0f;
+}
+
+static uint32_t autopilot_random(BenchAutopilot* pilot) {
+    uint32_t x = pilot->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    pilot->random = x;
+    return x;
+}
+
+void bench_autopilot_input(uint64_t tick, void* user_data) {
+    BenchAutopilot* pilot = (BenchAutopilot*)user_data;
+    if (tick >= pilot->next_change) {
+        uint32_t r = autopilot_random(pilot);
+        int key = g_move_keys[r % 7];
+        if (key != pilot->key) {
+            if (pilot->key) set_key_state(pilot->key, 0);
+            if (key) set_key_state(key, 1);
+            pilot->key = key;
+        }
+        pilot->turn = ((int)((r >> 8) % 9) - 4) * 0.5f;
+        pilot->next_change = tick + SIM_TICK_HZ / 2 + (r >> 16) % (SIM_TICK_HZ * 5 / 2);
+    }
+    set_mouse_delta(pilot->turn, 0.0f);
+}
+
+int bench_parse_resolution(const char* text, int* width, int* height) {
+    int w = 0, h = 0;
+    if (sscanf(text, "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0) {
+        return 0;
+    }
+    *width = w;
+    *height = h;
+    return 1;
+}
+
+int bench_write_ppm(const char* path, const uint32_t* pixels, int width, int height) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        printf("ERROR: Cannot write %s\n", path);
+        return 0;
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    const uint8_t* bytes = (const uint8_t*)pixels;
+    size_t pixel_count = (size_t)width * (size_t)height;
+    for (size_t i = 0; i < pixel_count; ++i) {
+        fwrite(bytes + i * 4, 1, 3, file);
+    }
+
+    fclose(file);
+    return 1;
+}
+
+// Returns the number of mismatching pixels, or -1 if the golden image is unusable
+long bench_compare_ppm(const char* path, const uint32_t* pixels, int width, int height) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        printf("ERROR: Missing golden image %s\n", path);
+        return -1;
+    }
+
+    int w = 0, h = 0, max_value = 0;
+    if (fscanf(file, "P6 %d %d %d", &w, &h, &max_value) != 3 || fgetc(file) == EOF ||
+        w != width || h != height || max_value != 255) {
+        printf("ERROR: Golden image %s does not match %dx%d\n", path, width, height);
+        fclose(file);
+        return -1;
+    }
+
+    const uint8_t* bytes = (const uint8_t*)pixels;
+    size_t pixel_count = (size_t)width * (size_t)height;
+    long mismatches = 0;
+    for (size_t i = 0; i < pixel_count; ++i) {
+        uint8_t rgb[3];
+        if (fread(rgb, 1, 3, file) != 3) {
+            fclose(file);
+            return -1;
+        }
+        if (memcmp(rgb, bytes + i * 4, 3) != 0) {
+            mismatches++;
+        }
+    }
+
+    fclose(file);
+    return mismatches;
+}
@@ -0,0 +1,52 @@
+// Benchmark header - Shared helpers for the native benchmark driver
+// QuakeCloneWASM - Native benchmarks
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Monotonic time in nanoseconds
+uint64_t bench_now_ns(void);
+
+// Sort samples in place and return the requested percentile (0-100)
+uint64_t bench_percentile(uint64_t* samples, size_t count, double percentile);
+
+// Small deterministic xorshift generator, so runs are comparable across builds
+void bench_seed_random(uint32_t seed);
+float bench_random_unit(void); // [0, 1)
+
+// Parse "WIDTHxHEIGHT" (returns 1 on success)
+int bench_parse_resolution(const char* text, int* width, int* height);
+
+// Write / compare a framebuffer as a binary PPM (bytes in GL_RGBA upload order)
+int bench_write_ppm(const char* path, const uint32_t* pixels, int width, int height);
+long bench_compare_ppm(const char* path, const uint32_t* pixels, int width, int height);
+
+// Scripted player for simulation runs: every 0.5-3 s of game time it picks
+// a movement key to hold and a turn rate, fed as live input (set_key_state,
+// set_mouse_delta). bench_autopilot_input is a SimInputFunc.
+typedef struct {
+    uint32_t random;
+    uint64_t next_change;   // Tick of the next decision
+    int key;                // Held movement key (0: none)
+    float turn;             // Mouse x per tick
+} BenchAutopilot;
+
+void bench_autopilot_reset(BenchAutopilot* pilot);
+void bench_autopilot_input(uint64_t tick, void* user_data);
+
+// Subcommands
+int bench_render_main(int argc, char** argv);
+int bench_rays_main(int argc, char** argv);
+int bench_maps_main(int argc, char** argv);
+int bench_surface_main(int argc, char** argv);
+int bench_beam_main(int argc, char** argv);
+int bench_collision_main(int argc, char** argv);
+int bench_entities_main(int argc, char** argv);
+int bench_sim_main(int argc, char** argv);
+int bench_replay_main(int argc, char** argv);
+int bench_galaxy_main(int argc, char** argv);
+
+#endif // BENCH_H
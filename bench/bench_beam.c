@@ -0,0 +1,181 @@
+// Beam benchmark - Transition hitches and latency when beaming to planets
+// QuakeCloneWASM - Native benchmarks
+//
+// Beams from the spaceship to every planet three ways, each with a cold
+// surface cache: synchronously (space_beam_to_planet, the whole transition
+// inside one frame), asynchronously (space_request_beam, then frames run
+// until the destination is swapped in) and asynchronously after the planet
+// was prefetched for a while, as when it is selected in the planet menu.
+// Reports the frame time the swap took and the request-to-arrival latency.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "world.h"
+#include "space.h"
+#include "jobs.h"
+#include "surface.h"
+
+typedef struct {
+    double frame_ms;    // Time the rest of each frame takes
+    int prefetch_frames; // Frames the planet menu stays open before the beam
+    int planet;         // -1: all planets
+} BeamOptions;
+
+static void print_usage(void) {
+    printf("Usage: bench beam [options]\n"
+           "  --frame-ms F      Time spent rendering each frame (default 4)\n"
+           "  --prefetch N      Frames of prefetching before the beam (default 30)\n"
+           "  --planet I        Only planet I (default all)\n");
+}
+
+static int parse_options(int argc, char** argv, BeamOptions* options) {
+    options->frame_ms = 4.0;
+    options->prefetch_frames = 30;
+    options->planet = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage();
+            return 0;
+        }
+        if (!value) {
+            printf("ERROR: %s expects a value\n", arg);
+            return 0;
+        }
+
+        if (strcmp(arg, "--frame-ms") == 0) {
+            options->frame_ms = atof(value);
+        } else if (strcmp(arg, "--prefetch") == 0) {
+            options->prefetch_frames = atoi(value);
+        } else if (strcmp(arg, "--planet") == 0) {
+            options->planet = atoi(value);
+        } else {
+            printf("ERROR: Unknown option %s\n", arg);
+            print_usage();
+            return 0;
+        }
+        ++i;
+    }
+
+    if (options->frame_ms < 0.0 || options->prefetch_frames < 0) {
+        printf("ERROR: Frame time and prefetch frames must not be negative\n");
+        return 0;
+    }
+    return 1;
+}
+
+// One game frame: the update calls main.c makes, then the rest of the frame
+static void run_frame(double frame_ms) {
+    uint64_t start = bench_now_ns();
+    world_update(1.0 / 60.0);
+    space_update(1.0 / 60.0);
+    uint64_t frame_end = start + (uint64_t)(frame_ms * 1e6);
+    while (bench_now_ns() < frame_end) {
+    }
+}
+
+// Back on the spaceship with nothing generated or queued
+static void reset_to_spaceship(void) {
+    space_beam_to_spaceship();
+    space_prefetch_planet(-1);
+    jobs_wait_background();
+    surface_set_budget(SURFACE_DEFAULT_BUDGET);
+}
+
+// Request a beam and run frames until it arrives; returns the frame count
+static int run_async_beam(int planet, double frame_ms) {
+    space_request_beam(planet);
+    int frames = 0;
+    while (space_is_beam_pending()) {
+        run_frame(frame_ms);
+        frames++;
+    }
+    return frames;
+}
+
+int bench_beam_main(int argc, char** argv) {
+    BeamOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    if (!space_init() || !world_init() || !jobs_init(0)) {
+        printf("ERROR: Engine initialization failed\n");
+        return 1;
+    }
+    world_set_endless_surfaces(1);
+
+    typedef struct {
+        double sync_ms;
+        double async_commit_ms, async_latency_ms;
+        int async_frames, async_waited;
+        double prefetched_commit_ms, prefetched_latency_ms;
+        int prefetched_frames;
+    } BeamRow;
+
+    int planet_count = space_get_planet_count();
+    BeamRow* rows = (BeamRow*)calloc((size_t)planet_count, sizeof(BeamRow));
+    if (!rows) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+
+    for (int p = 0; p < planet_count; ++p) {
+        if (options.planet >= 0 && options.planet != p) {
+            continue;
+        }
+        BeamRow* row = &rows[p];
+        const SpaceBeamStats* stats = space_get_beam_stats();
+
+        // Everything inside one frame
+        reset_to_spaceship();
+        space_beam_to_planet(p);
+        row->sync_ms = stats->last_commit_ms;
+
+        // Prepared in the background, swapped in once ready
+        reset_to_spaceship();
+        int waited = stats->waited;
+        row->async_frames = run_async_beam(p, options.frame_ms);
+        row->async_commit_ms = stats->last_commit_ms;
+        row->async_latency_ms = stats->last_latency_ms;
+        row->async_waited = stats->waited - waited;
+
+        // Selected in the planet menu first
+        reset_to_spaceship();
+        space_prefetch_planet(p);
+        for (int f = 0; f < options.prefetch_frames; ++f) {
+            run_frame(options.frame_ms);
+        }
+        row->prefetched_frames = run_async_beam(p, options.frame_ms);
+        row->prefetched_commit_ms = stats->last_commit_ms;
+        row->prefetched_latency_ms = stats->last_latency_ms;
+    }
+
+    printf("\n%-17s %9s | %10s %11s %7s | %10s %11s %7s\n",
+           "planet", "sync(ms)", "commit(ms)", "latency(ms)", "frames", "commit(ms)", "latency(ms)", "frames");
+    printf("%-17s %9s | %-31s | %-31s\n", "", "", "async, cold", "async, prefetched");
+    int timed_out = 0;
+    for (int p = 0; p < planet_count; ++p) {
+        if (options.planet >= 0 && options.planet != p) {
+            continue;
+        }
+        const BeamRow* row = &rows[p];
+        timed_out |= row->async_waited;
+        printf("%-17s %9.3f | %10.3f %11.2f %6d%s | %10.3f %11.2f %7d\n",
+               space_get_planet(p)->name, row->sync_ms,
+               row->async_commit_ms, row->async_latency_ms, row->async_frames, row->async_waited ? "*" : " ",
+               row->prefetched_commit_ms, row->prefetched_latency_ms, row->prefetched_frames);
+    }
+    if (timed_out) {
+        printf("\n* destination was not fully generated when the beam timed out\n");
+    }
+
+    free(rows);
+    jobs_shutdown();
+    return 0;
+}
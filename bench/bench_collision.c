@@ -0,0 +1,310 @@
+// Collision benchmark - Swept movement and broadphase queries per second
+// QuakeCloneWASM - Native benchmarks
+//
+// Scatters movers over the open ground of Terra Nova's surface window and
+// runs ticks in which every mover sweeps its circle through the map
+// (collision_move), the broadphase is rebuilt, and every mover asks for the
+// movers it touches. Reports moves/s, neighbour queries/s and build time per
+// tick, with brute-force neighbour tests for comparison. It also checks that
+// large steps never end inside or pass through a wall, and that broadphase
+// results match the brute-force ones.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "world.h"
+#include "space.h"
+#include "jobs.h"
+#include "collision.h"
+
+#define MOVER_RADIUS 0.3f
+#define MOVER_SPEED 5.0f        // World units per second, as the player
+#define TICK_SECONDS (1.0f / 60.0f)
+#define MAX_NEIGHBOURS 64
+
+typedef struct {
+    int movers;         // 0: 1000, 4000 and 16000
+    int ticks;
+} CollisionOptions;
+
+static void print_usage(void) {
+    printf("Usage: bench collision [options]\n"
+           "  --movers N        Movers per run (default 1000, 4000 and 16000)\n"
+           "  --ticks N         Ticks per run (default 120)\n");
+}
+
+static int parse_options(int argc, char** argv, CollisionOptions* options) {
+    options->movers = 0;
+    options->ticks = 120;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage();
+            return 0;
+        }
+        if (!value) {
+            printf("ERROR: %s expects a value\n", arg);
+            return 0;
+        }
+
+        if (strcmp(arg, "--movers") == 0) {
+            options->movers = atoi(value);
+        } else if (strcmp(arg, "--ticks") == 0) {
+            options->ticks = atoi(value);
+        } else {
+            printf("ERROR: Unknown option %s\n", arg);
+            print_usage();
+            return 0;
+        }
+        ++i;
+    }
+
+    if (options->movers < 0 || options->ticks <= 0) {
+        printf("ERROR: Movers and ticks must be positive\n");
+        return 0;
+    }
+    return 1;
+}
+
+typedef struct {
+    int count;
+    float* x;
+    float* z;
+    float* radius;
+    float* heading;     // Radians; turned on every blocked move
+} Movers;
+
+static int movers_alloc(Movers* movers, int count) {
+    movers->count = count;
+    movers->x = (float*)malloc(sizeof(float) * (size_t)count);
+    movers->z = (float*)malloc(sizeof(float) * (size_t)count);
+    movers->radius = (float*)malloc(sizeof(float) * (size_t)count);
+    movers->heading = (float*)malloc(sizeof(float) * (size_t)count);
+    return movers->x && movers->z && movers->radius && movers->heading;
+}
+
+static void movers_free(Movers* movers) {
+    free(movers->x);
+    free(movers->z);
+    free(movers->radius);
+    free(movers->heading);
+}
+
+// Random open spots inside the area the grid covers
+static void scatter_movers(const CollisionGrid* grid, Movers* movers, float extent) {
+    for (int i = 0; i < movers->count; ++i) {
+        float x, z;
+        do {
+            x = grid->origin_x + bench_random_unit() * extent;
+            z = grid->origin_z + bench_random_unit() * extent;
+        } while (collision_overlaps(grid, x, z, MOVER_RADIUS));
+        movers->x[i] = x;
+        movers->z[i] = z;
+        movers->radius[i] = MOVER_RADIUS;
+        movers->heading[i] = bench_random_unit() * 6.2831853f;
+    }
+}
+
+// Any point of the x-then-z path (sampled finely) inside a wall
+static int path_enters_wall(const CollisionGrid* grid, float x0, float z0, float x1, float z1, float radius) {
+    const int samples = 64;
+    for (int s = 1; s <= samples; ++s) {
+        float t = (float)s / (float)samples;
+        if (collision_overlaps(grid, x0 + (x1 - x0) * t, z0, radius) ||
+            collision_overlaps(grid, x1, z0 + (z1 - z0) * t, radius)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Steps of up to 8 units (4 cells) from open spots: none may end inside a
+// wall or cross one on the way
+static int check_sweeps(const CollisionGrid* grid, const Movers* movers, int* blocked_moves) {
+    int failures = 0;
+    *blocked_moves = 0;
+    // Walls are compared with a radius a little under the mover's, since
+    // movers stop COLLISION_SKIN short of them
+    float test_radius = MOVER_RADIUS - 0.01f;
+    for (int i = 0; i < movers->count; ++i) {
+        float x = movers->x[i];
+        float z = movers->z[i];
+        float dx = (bench_random_unit() * 2.0f - 1.0f) * 8.0f;
+        float dz = (bench_random_unit() * 2.0f - 1.0f) * 8.0f;
+        int blocked = collision_move(grid, MOVER_RADIUS, &x, &z, dx, dz);
+        *blocked_moves += blocked != 0;
+        if (path_enters_wall(grid, movers->x[i], movers->z[i], x, z, test_radius)) {
+            failures++;
+        }
+    }
+    return failures;
+}
+
+// Broadphase against testing every pair, for a sample of movers
+static int check_broadphase(const CollisionBroadphase* broadphase, const Movers* movers) {
+    int mismatches = 0;
+    int results[MAX_NEIGHBOURS];
+    for (int i = 0; i < movers->count; i += 7) {
+        int found = collision_broadphase_query(broadphase, movers->x[i], movers->z[i], movers->radius[i], i,
+                                               results, MAX_NEIGHBOURS);
+        int expected = 0;
+        for (int j = 0; j < movers->count; ++j) {
+            float dx = movers->x[j] - movers->x[i];
+            float dz = movers->z[j] - movers->z[i];
+            float reach = movers->radius[j] + movers->radius[i];
+            expected += j != i && dx * dx + dz * dz < reach * reach;
+        }
+        mismatches += found != expected;
+    }
+    return mismatches;
+}
+
+typedef struct {
+    double move_ns;         // Per collision_move
+    double build_ms;        // Per broadphase build
+    double query_ns;        // Per broadphase query
+    double brute_ns;        // Per brute-force neighbour search (0: skipped)
+    double contacts;        // Touching neighbours per mover
+    double blocked_percent; // Moves cut short by a wall
+} CollisionResult;
+
+static CollisionResult run_ticks(const CollisionGrid* grid, Movers* movers, CollisionBroadphase* broadphase,
+                                 int ticks) {
+    CollisionResult result;
+    memset(&result, 0, sizeof(result));
+    uint64_t move_ns = 0, build_ns = 0, query_ns = 0;
+    long blocked = 0, contacts = 0;
+    int results[MAX_NEIGHBOURS];
+    float step = MOVER_SPEED * TICK_SECONDS;
+
+    for (int tick = 0; tick < ticks; ++tick) {
+        uint64_t start = bench_now_ns();
+        for (int i = 0; i < movers->count; ++i) {
+            float heading = movers->heading[i];
+            if (collision_move(grid, movers->radius[i], &movers->x[i], &movers->z[i],
+                               cosf(heading) * step, sinf(heading) * step)) {
+                movers->heading[i] = heading + 2.0f; // Bounce off somewhere else
+                blocked++;
+            }
+        }
+        uint64_t moved = bench_now_ns();
+        collision_broadphase_build(broadphase, movers->x, movers->z, movers->radius, movers->count);
+        uint64_t built = bench_now_ns();
+        for (int i = 0; i < movers->count; ++i) {
+            contacts += collision_broadphase_query(broadphase, movers->x[i], movers->z[i], movers->radius[i], i,
+                                                   results, MAX_NEIGHBOURS);
+        }
+        uint64_t queried = bench_now_ns();
+        move_ns += moved - start;
+        build_ns += built - moved;
+        query_ns += queried - built;
+    }
+
+    double samples = (double)ticks * (double)movers->count;
+    result.move_ns = (double)move_ns / samples;
+    result.build_ms = (double)build_ns / (double)ticks / 1e6;
+    result.query_ns = (double)query_ns / samples;
+    result.contacts = (double)contacts / samples;
+    result.blocked_percent = 100.0 * (double)blocked / samples;
+
+    // Brute force: every mover against every other, one tick (small runs)
+    if (movers->count <= 4000) {
+        uint64_t start = bench_now_ns();
+        volatile long sink = 0;
+        long found = 0;
+        for (int i = 0; i < movers->count; ++i) {
+            for (int j = 0; j < movers->count; ++j) {
+                float dx = movers->x[j] - movers->x[i];
+                float dz = movers->z[j] - movers->z[i];
+                float reach = movers->radius[j] + movers->radius[i];
+                found += j != i && dx * dx + dz * dz < reach * reach;
+            }
+        }
+        sink = found; // Keeps the loop from being optimized out
+        result.brute_ns = (double)(bench_now_ns() - start) / (double)movers->count;
+        (void)sink;
+    }
+    return result;
+}
+
+int bench_collision_main(int argc, char** argv) {
+    CollisionOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    if (!space_init() || !world_init() || !jobs_init(0)) {
+        printf("ERROR: Engine initialization failed\n");
+        return 1;
+    }
+    world_set_endless_surfaces(1);
+    space_beam_to_planet(0);
+    jobs_wait_background();
+    world_update(0.0);
+
+    // Movers stay inside the resident window: the chunks there are ready
+    CollisionGrid grid;
+    world_get_collision_grid(&grid);
+    float extent = (float)(SURFACE_WINDOW_CHUNKS * SURFACE_CHUNK_SIZE) * grid.cell_size;
+
+    int counts[3] = { 1000, 4000, 16000 };
+    int runs = 3;
+    if (options.movers > 0) {
+        counts[0] = options.movers;
+        runs = 1;
+    }
+
+    printf("\n%8s %9s %11s %10s %11s %12s %9s %8s %9s\n",
+           "movers", "move(ns)", "Mmoves/s", "build(ms)", "query(ns)", "Mqueries/s", "brute(ns)", "contacts",
+           "blocked");
+
+    int failures = 0;
+    for (int r = 0; r < runs; ++r) {
+        Movers movers;
+        CollisionBroadphase broadphase;
+        if (!movers_alloc(&movers, counts[r]) ||
+            !collision_broadphase_init(&broadphase, counts[r], 2.0f * MOVER_RADIUS)) {
+            printf("ERROR: Out of memory\n");
+            return 1;
+        }
+        bench_seed_random(1234u + (uint32_t)r);
+        scatter_movers(&grid, &movers, extent);
+
+        int blocked_moves;
+        int tunnels = check_sweeps(&grid, &movers, &blocked_moves);
+        collision_broadphase_build(&broadphase, movers.x, movers.z, movers.radius, movers.count);
+        int mismatches = check_broadphase(&broadphase, &movers);
+        if (tunnels || mismatches) {
+            printf("%8d  FAILED: %d of %d long moves entered a wall (%d blocked), %d broadphase mismatches\n",
+                   movers.count, tunnels, movers.count, blocked_moves, mismatches);
+            failures++;
+        }
+
+        CollisionResult result = run_ticks(&grid, &movers, &broadphase, options.ticks);
+        char brute[32];
+        if (result.brute_ns > 0.0) {
+            snprintf(brute, sizeof(brute), "%.0f", result.brute_ns);
+        } else {
+            snprintf(brute, sizeof(brute), "-");
+        }
+        printf("%8d %9.1f %11.2f %10.3f %11.1f %12.2f %9s %8.2f %8.1f%%\n",
+               movers.count, result.move_ns, 1e3 / result.move_ns, result.build_ms, result.query_ns,
+               1e3 / result.query_ns, brute, result.contacts, result.blocked_percent);
+
+        collision_broadphase_destroy(&broadphase);
+        movers_free(&movers);
+    }
+
+    jobs_shutdown();
+    if (failures) {
+        printf("\nCollision checks FAILED\n");
+        return 2;
+    }
+    printf("\nNo move entered or crossed a wall; broadphase matches brute force\n");
+    return 0;
+}
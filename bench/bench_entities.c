@@ -0,0 +1,227 @@
+// Entity benchmark - Tick cost of many wandering agents
+// QuakeCloneWASM - Native benchmarks
+//
+// Spawns N wandering agents on open cells of the built-in planet map (or of
+// Terra Nova's streamed surface with --surface) and runs world_update ticks,
+// as the game loop does. Reports the entity tick time (p50/p99/max, and its
+// move and spatial hash parts) against a 2 ms budget, and the cost of a
+// neighbour query. Checks that no agent ended inside a wall and that the
+// spatial hash answers the same as testing every pair.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "world.h"
+#include "space.h"
+#include "jobs.h"
+#include "entity.h"
+#include "collision.h"
+
+#define AGENT_RADIUS 0.25f
+#define NEIGHBOUR_RANGE 2.0f
+#define TICK_BUDGET_MS 2.0
+#define MAX_NEIGHBOURS 256
+
+typedef struct {
+    int entities;       // 0: 1000, 10000, 20000 and 50000
+    int ticks;
+    int surface;        // Spawn on the endless surface instead
+} EntityOptions;
+
+static void print_usage(void) {
+    printf("Usage: bench entities [options]\n"
+           "  --entities N      Agents per run (default 1000, 10000, 20000 and 50000)\n"
+           "  --ticks N         Ticks per run (default 300)\n"
+           "  --surface 1       Spawn on Terra Nova's streamed surface, not the planet map\n");
+}
+
+static int parse_options(int argc, char** argv, EntityOptions* options) {
+    options->entities = 0;
+    options->ticks = 300;
+    options->surface = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage();
+            return 0;
+        }
+        if (!value) {
+            printf("ERROR: %s expects a value\n", arg);
+            return 0;
+        }
+
+        if (strcmp(arg, "--entities") == 0) {
+            options->entities = atoi(value);
+        } else if (strcmp(arg, "--ticks") == 0) {
+            options->ticks = atoi(value);
+        } else if (strcmp(arg, "--surface") == 0) {
+            options->surface = atoi(value);
+        } else {
+            printf("ERROR: Unknown option %s\n", arg);
+            print_usage();
+            return 0;
+        }
+        ++i;
+    }
+
+    if (options->entities < 0 || options->ticks <= 0) {
+        printf("ERROR: Entities and ticks must be positive\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Agents at random open spots of the area [min, max)
+static int spawn_agents(int count, float min_x, float max_x, float min_z, float max_z) {
+    CollisionGrid grid;
+    world_get_collision_grid(&grid);
+    for (int i = 0; i < count; ++i) {
+        float x, z;
+        do {
+            x = min_x + bench_random_unit() * (max_x - min_x);
+            z = min_z + bench_random_unit() * (max_z - min_z);
+        } while (collision_overlaps(&grid, x, z, AGENT_RADIUS));
+        if (entity_spawn(x, z, AGENT_RADIUS, ENTITY_WANDER, 0x2545F491u * (uint32_t)(i + 1)) < 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Agents inside walls, and hash queries that disagree with brute force
+static void check_entities(int* in_walls, int* mismatches) {
+    const EntityData* data = entity_get_data();
+    CollisionGrid grid;
+    world_get_collision_grid(&grid);
+    int results[MAX_NEIGHBOURS];
+    *in_walls = 0;
+    *mismatches = 0;
+
+    for (int i = 0; i < data->count; ++i) {
+        *in_walls += collision_overlaps(&grid, data->x[i], data->z[i], data->radius[i] - 0.01f);
+    }
+    for (int i = 0; i < data->count; i += 97) {
+        int found = entity_query_neighbours(i, NEIGHBOUR_RANGE, results, MAX_NEIGHBOURS);
+        int expected = 0;
+        for (int j = 0; j < data->count; ++j) {
+            float dx = data->x[j] - data->x[i];
+            float dz = data->z[j] - data->z[i];
+            float reach = data->radius[j] + NEIGHBOUR_RANGE;
+            expected += j != i && dx * dx + dz * dz < reach * reach;
+        }
+        *mismatches += found != expected;
+    }
+}
+
+int bench_entities_main(int argc, char** argv) {
+    EntityOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    if (!space_init() || !world_init() || !jobs_init(0)) {
+        printf("ERROR: Engine initialization failed\n");
+        return 1;
+    }
+    world_set_endless_surfaces(options.surface);
+    space_beam_to_planet(0);
+    jobs_wait_background();
+    world_update(0.0);
+
+    // Spawn area: the whole bounded map, or the surface window
+    float min_x, max_x, min_z, max_z;
+    if (options.surface) {
+        CollisionGrid grid;
+        world_get_collision_grid(&grid);
+        float extent = (float)(SURFACE_WINDOW_CHUNKS * SURFACE_CHUNK_SIZE) * grid.cell_size;
+        min_x = grid.origin_x;
+        min_z = grid.origin_z;
+        max_x = min_x + extent;
+        max_z = min_z + extent;
+    } else {
+        world_get_bounds(&min_x, &max_x, &min_z, &max_z);
+    }
+
+    int counts[4] = { 1000, 10000, 20000, 50000 };
+    int runs = 4;
+    if (options.entities > 0) {
+        counts[0] = options.entities;
+        runs = 1;
+    }
+
+    uint64_t* samples = (uint64_t*)malloc(sizeof(uint64_t) * (size_t)options.ticks);
+    int* results = (int*)malloc(sizeof(int) * MAX_NEIGHBOURS);
+    if (!samples || !results) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+
+    printf("\n%s, %.0fx%.0f units, %d thread(s)\n", options.surface ? "Terra Nova surface window" : "Planet map",
+           max_x - min_x, max_z - min_z, jobs_get_thread_count());
+    printf("%9s %9s %9s %9s %10s %9s %9s %10s %10s %7s\n",
+           "entities", "p50(ms)", "p99(ms)", "max(ms)", "ns/entity", "move(ms)", "hash(ms)", "query(ns)",
+           "neighbours", "budget");
+
+    int failures = 0;
+    for (int r = 0; r < runs; ++r) {
+        if (!entity_init(counts[r])) {
+            return 1;
+        }
+        bench_seed_random(42u);
+        if (!spawn_agents(counts[r], min_x, max_x, min_z, max_z)) {
+            printf("ERROR: Failed to spawn %d entities\n", counts[r]);
+            return 1;
+        }
+
+        double move_ms = 0.0, hash_ms = 0.0;
+        for (int t = 0; t < options.ticks; ++t) {
+            world_update(1.0 / 60.0);
+            const EntityStats* stats = entity_get_stats();
+            samples[t] = (uint64_t)(stats->tick_ms * 1e6);
+            move_ms += stats->move_ms;
+            hash_ms += stats->hash_ms;
+        }
+
+        // Neighbour queries for every agent
+        const EntityData* data = entity_get_data();
+        long neighbours = 0;
+        uint64_t start = bench_now_ns();
+        for (int i = 0; i < data->count; ++i) {
+            neighbours += entity_query_neighbours(i, NEIGHBOUR_RANGE, results, MAX_NEIGHBOURS);
+        }
+        double query_ns = (double)(bench_now_ns() - start) / (double)data->count;
+
+        int in_walls, mismatches;
+        check_entities(&in_walls, &mismatches);
+        if (in_walls || mismatches) {
+            printf("%9d  FAILED: %d agents inside walls, %d hash mismatches\n", data->count, in_walls, mismatches);
+            failures++;
+        }
+
+        uint64_t max_ns = 0;
+        for (int t = 0; t < options.ticks; ++t) {
+            if (samples[t] > max_ns) max_ns = samples[t];
+        }
+        double p50 = bench_percentile(samples, (size_t)options.ticks, 50.0) / 1e6;
+        double p99 = bench_percentile(samples, (size_t)options.ticks, 99.0) / 1e6;
+        printf("%9d %9.3f %9.3f %9.3f %10.1f %9.3f %9.3f %10.1f %10.1f %7s\n",
+               data->count, p50, p99, (double)max_ns / 1e6, p50 * 1e6 / (double)data->count,
+               move_ms / options.ticks, hash_ms / options.ticks, query_ns,
+               (double)neighbours / (double)data->count, p99 <= TICK_BUDGET_MS ? "ok" : "over");
+    }
+
+    free(samples);
+    free(results);
+    jobs_shutdown();
+    if (failures) {
+        printf("\nEntity checks FAILED\n");
+        return 2;
+    }
+    printf("\nNo agent entered a wall; spatial hash matches brute force\n");
+    return 0;
+}
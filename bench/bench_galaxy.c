@@ -0,0 +1,303 @@
+// Galaxy benchmark - Catalogue size, lazy generation and spatial queries
+// QuakeCloneWASM - Native benchmarks
+//
+// Builds the procedural galaxy and reports its size, the init time and
+// the sector cache's memory. Times nearest-N and range queries cold
+// (cache flushed before every query, so each one generates its sectors)
+// and warm (a ship flying a straight line, as the game queries), with the
+// sectors generated per query. Checks the queries against a brute-force
+// scan of every system, and that flushed sectors regenerate identically.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "galaxy.h"
+#include "space.h"
+
+#define CHECK_POINTS 8
+#define MAX_NEAREST 256
+#define MAX_RANGE_HITS 65536
+#define FLIGHT_STEP 2.0f        // Light years between warm queries
+
+typedef struct {
+    int queries;
+    int nearest;
+    float radius;
+    int cache_sectors;
+} GalaxyOptions;
+
+typedef struct {
+    float x, y, z;
+} QueryPoint;
+
+static void print_usage(void) {
+    printf("Usage: bench galaxy [options]\n"
+           "  --queries N       Queries per run (default 2000)\n"
+           "  --nearest N       Systems per nearest query (default 16, max %d)\n"
+           "  --radius LY       Range query radius (default 100)\n"
+           "  --cache N         Sector cache size (default %d)\n", MAX_NEAREST, GALAXY_DEFAULT_CACHE_SECTORS);
+}
+
+static int parse_options(int argc, char** argv, GalaxyOptions* options) {
+    options->queries = 2000;
+    options->nearest = 16;
+    options->radius = 100.0f;
+    options->cache_sectors = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage();
+            return 0;
+        }
+        if (!value) {
+            printf("ERROR: %s expects a value\n", arg);
+            return 0;
+        }
+
+        if (strcmp(arg, "--queries") == 0) {
+            options->queries = atoi(value);
+        } else if (strcmp(arg, "--nearest") == 0) {
+            options->nearest = atoi(value);
+        } else if (strcmp(arg, "--radius") == 0) {
+            options->radius = (float)atof(value);
+        } else if (strcmp(arg, "--cache") == 0) {
+            options->cache_sectors = atoi(value);
+        } else {
+            printf("ERROR: Unknown option %s\n", arg);
+            print_usage();
+            return 0;
+        }
+        ++i;
+    }
+
+    if (options->queries <= 0 || options->nearest <= 0 || options->nearest > MAX_NEAREST ||
+        options->radius <= 0.0f || options->cache_sectors < 0) {
+        printf("ERROR: Queries, nearest (up to %d) and radius must be positive\n", MAX_NEAREST);
+        return 0;
+    }
+    return 1;
+}
+
+// Query points where the systems are: next to random systems (cold), or
+// along a straight flight out of the home system (warm)
+static void make_points(QueryPoint* points, int count, int flight) {
+    float x, y, z;
+    space_get_galaxy_position(&x, &y, &z);
+    for (int i = 0; i < count; ++i) {
+        if (flight) {
+            points[i].x = x + FLIGHT_STEP * 0.8f * (float)i;
+            points[i].y = y;
+            points[i].z = z + FLIGHT_STEP * 0.6f * (float)i;
+            continue;
+        }
+        GalaxySystem system;
+        galaxy_get_system((uint32_t)(bench_random_unit() * (float)galaxy_get_system_count()), &system);
+        points[i].x = system.x + (bench_random_unit() - 0.5f) * 20.0f;
+        points[i].y = system.y;
+        points[i].z = system.z + (bench_random_unit() - 0.5f) * 20.0f;
+    }
+}
+
+typedef struct {
+    double p50_us;
+    double p99_us;
+    double sectors;         // Generated per query
+    double results;         // Per query
+} QueryRun;
+
+static void run_queries(const QueryPoint* points, int count, int cold, int nearest, float radius,
+                        GalaxyHit* hits, uint64_t* samples, QueryRun* run) {
+    uint64_t sectors = galaxy_get_stats()->sectors_generated;
+    long results = 0;
+    galaxy_flush_cache();
+    for (int i = 0; i < count; ++i) {
+        if (cold) {
+            galaxy_flush_cache();
+        }
+        uint64_t start = bench_now_ns();
+        if (nearest) {
+            results += galaxy_query_nearest(points[i].x, points[i].y, points[i].z, nearest, hits);
+        } else {
+            results += galaxy_query_range(points[i].x, points[i].y, points[i].z, radius, hits, MAX_RANGE_HITS);
+        }
+        samples[i] = bench_now_ns() - start;
+    }
+    run->sectors = (double)(galaxy_get_stats()->sectors_generated - sectors) / count;
+    run->results = (double)results / count;
+    run->p50_us = bench_percentile(samples, (size_t)count, 50.0) / 1e3;
+    run->p99_us = bench_percentile(samples, (size_t)count, 99.0) / 1e3;
+}
+
+static void print_run(const char* name, const QueryRun* run) {
+    printf("%-22s %10.2f %10.2f %10.1f %10.1f\n", name, run->p50_us, run->p99_us, run->sectors, run->results);
+}
+
+// Every system against the check points: the nearest ones by distance and
+// how many lie in the radius
+typedef struct {
+    QueryPoint point;
+    float nearest[MAX_NEAREST];     // Distances, ascending
+    int found;
+    int in_range;
+} BruteForce;
+
+static void brute_force(BruteForce* checks, int count, int nearest, float radius) {
+    uint32_t systems = galaxy_get_system_count();
+    for (uint32_t id = 0; id < systems; ++id) {
+        GalaxySystem system;
+        galaxy_get_system(id, &system);
+        for (int c = 0; c < count; ++c) {
+            BruteForce* check = &checks[c];
+            float dx = system.x - check->point.x;
+            float dy = system.y - check->point.y;
+            float dz = system.z - check->point.z;
+            float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+            check->in_range += distance <= radius;
+            if (check->found == nearest && distance >= check->nearest[nearest - 1]) {
+                continue;
+            }
+            int i = check->found < nearest ? check->found++ : nearest - 1;
+            while (i > 0 && check->nearest[i - 1] > distance) {
+                check->nearest[i] = check->nearest[i - 1];
+                --i;
+            }
+            check->nearest[i] = distance;
+        }
+    }
+}
+
+// Queries that disagree with brute force (distances within a rounding)
+static int check_queries(int nearest, float radius, GalaxyHit* hits) {
+    BruteForce checks[CHECK_POINTS];
+    QueryPoint points[CHECK_POINTS];
+    memset(checks, 0, sizeof(checks));
+    make_points(points, CHECK_POINTS, 0);
+    space_get_galaxy_position(&points[0].x, &points[0].y, &points[0].z);
+    for (int c = 0; c < CHECK_POINTS; ++c) {
+        checks[c].point = points[c];
+    }
+    brute_force(checks, CHECK_POINTS, nearest, radius);
+
+    int mismatches = 0;
+    for (int c = 0; c < CHECK_POINTS; ++c) {
+        const QueryPoint* p = &points[c];
+        int found = galaxy_query_nearest(p->x, p->y, p->z, nearest, hits);
+        mismatches += found != checks[c].found;
+        for (int i = 0; i < found && i < checks[c].found; ++i) {
+            mismatches += fabsf(hits[i].distance - checks[c].nearest[i]) > 0.01f;
+        }
+        int in_range = galaxy_query_range(p->x, p->y, p->z, radius, hits, MAX_RANGE_HITS);
+        mismatches += abs(in_range - checks[c].in_range) > 1;
+    }
+    return mismatches;
+}
+
+// Ids of the same queries before and after flushing the cache
+static int check_regeneration(int nearest, GalaxyHit* hits, GalaxyHit* again) {
+    QueryPoint points[CHECK_POINTS];
+    make_points(points, CHECK_POINTS, 0);
+    int mismatches = 0;
+    for (int c = 0; c < CHECK_POINTS; ++c) {
+        int found = galaxy_query_nearest(points[c].x, points[c].y, points[c].z, nearest, hits);
+        galaxy_flush_cache();
+        int found_again = galaxy_query_nearest(points[c].x, points[c].y, points[c].z, nearest, again);
+        mismatches += found != found_again || memcmp(hits, again, sizeof(GalaxyHit) * (size_t)found) != 0;
+    }
+    return mismatches;
+}
+
+static void print_neighbourhood(GalaxyHit* hits) {
+    float x, y, z;
+    space_get_galaxy_position(&x, &y, &z);
+    int found = galaxy_query_nearest(x, y, z, 5, hits);
+    printf("\nNearest systems to the home system (%.0f, %.0f, %.0f):\n", x, y, z);
+    for (int i = 0; i < found; ++i) {
+        GalaxySystem system;
+        char name[GALAXY_NAME_MAX];
+        galaxy_get_system(hits[i].id, &system);
+        galaxy_get_system_name(hits[i].id, name, sizeof(name));
+        printf("  %-20s %7.1f ly  %c class  %d planet(s)", name, hits[i].distance,
+               "OBAFGKM"[system.star_class], system.planet_count);
+        PlanetData planet;
+        char planet_name[GALAXY_NAME_MAX + 4];
+        if (galaxy_get_planet(hits[i].id, 0, &planet)) {
+            galaxy_get_planet_name(hits[i].id, 0, planet_name, sizeof(planet_name));
+            printf("  %s: %.2f AU, %.0fK, %.2fg", planet_name, planet.distance_au, planet.surface_temp_k,
+                   planet.gravity_g);
+        }
+        printf("\n");
+    }
+}
+
+int bench_galaxy_main(int argc, char** argv) {
+    GalaxyOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    uint64_t start = bench_now_ns();
+    if (!galaxy_init(GALAXY_DEFAULT_SEED, options.cache_sectors)) {
+        return 1;
+    }
+    double init_ms = (double)(bench_now_ns() - start) / 1e6;
+    const GalaxyStats* stats = galaxy_get_stats();
+    printf("\n%u systems, init %.2f ms; sector cache %d sectors, %.2f MB (%.1f bytes per cached system)\n",
+           stats->system_count, init_ms, stats->cache_sectors, (double)stats->cache_bytes / (1024.0 * 1024.0),
+           (double)stats->cache_bytes / ((double)stats->cache_sectors * GALAXY_MAX_SECTOR_SYSTEMS));
+
+    QueryPoint* random_points = (QueryPoint*)malloc(sizeof(QueryPoint) * (size_t)options.queries);
+    QueryPoint* flight_points = (QueryPoint*)malloc(sizeof(QueryPoint) * (size_t)options.queries);
+    uint64_t* samples = (uint64_t*)malloc(sizeof(uint64_t) * (size_t)options.queries);
+    GalaxyHit* hits = (GalaxyHit*)malloc(sizeof(GalaxyHit) * MAX_RANGE_HITS);
+    GalaxyHit* again = (GalaxyHit*)malloc(sizeof(GalaxyHit) * MAX_NEAREST);
+    if (!random_points || !flight_points || !samples || !hits || !again) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+    bench_seed_random(7u);
+    make_points(random_points, options.queries, 0);
+    make_points(flight_points, options.queries, 1);
+
+    char nearest_name[32], range_name[32];
+    snprintf(nearest_name, sizeof(nearest_name), "nearest %d", options.nearest);
+    snprintf(range_name, sizeof(range_name), "range %.0f ly", options.radius);
+    printf("\n%-22s %10s %10s %10s %10s\n", "query", "p50(us)", "p99(us)", "sectors", "results");
+    QueryRun run;
+    char label[64];
+    for (int kind = 0; kind < 2; ++kind) {
+        const char* name = kind == 0 ? nearest_name : range_name;
+        int nearest = kind == 0 ? options.nearest : 0;
+        run_queries(random_points, options.queries, 1, nearest, options.radius, hits, samples, &run);
+        snprintf(label, sizeof(label), "%s cold", name);
+        print_run(label, &run);
+        run_queries(flight_points, options.queries, 0, nearest, options.radius, hits, samples, &run);
+        snprintf(label, sizeof(label), "%s warm", name);
+        print_run(label, &run);
+    }
+
+    print_neighbourhood(hits);
+
+    bench_seed_random(11u);
+    int query_mismatches = check_queries(options.nearest, options.radius, hits);
+    int regeneration_mismatches = check_regeneration(options.nearest, hits, again);
+
+    free(random_points);
+    free(flight_points);
+    free(samples);
+    free(hits);
+    free(again);
+    galaxy_shutdown();
+
+    if (query_mismatches || regeneration_mismatches) {
+        printf("\nGalaxy checks FAILED: %d query mismatches, %d regenerated differently\n",
+               query_mismatches, regeneration_mismatches);
+        return 2;
+    }
+    printf("\nQueries match brute force over every system; flushed sectors regenerate identically\n");
+    return 0;
+}
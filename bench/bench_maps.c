@@ -0,0 +1,282 @@
+// Map benchmark - Memory and ray cost against map size
+// QuakeCloneWASM - Native benchmarks
+//
+// Generates outdoor-style maps (a border wall and scattered rock clusters)
+// of increasing size, loads them with world_load_map and reports their
+// memory next to the old int-per-cell layout. The same packets of rays are
+// then traced cell by cell and with empty-space skipping, as packets and
+// one ray at a time; all results must match bit for bit.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "world.h"
+#include "space.h"
+
+#define MAX_MAP_SIZES 16
+#define MAP_SCALE 2.0f
+
+static const int g_default_sizes[] = { 16, 64, 256, 1024, 4096 };
+
+typedef struct {
+    int sizes[MAX_MAP_SIZES];
+    int size_count;
+    int packets;
+    float max_dist; // 0: the map diagonal
+} MapOptions;
+
+// Border of 1s, clusters of 2s covering under 1% of the interior
+static uint8_t* generate_map(int size) {
+    uint8_t* cells = (uint8_t*)calloc((size_t)size * (size_t)size, 1);
+    if (!cells) {
+        return NULL;
+    }
+
+    for (int i = 0; i < size; ++i) {
+        cells[i] = 1;
+        cells[(size_t)(size - 1) * (size_t)size + (size_t)i] = 1;
+        cells[(size_t)i * (size_t)size] = 1;
+        cells[(size_t)i * (size_t)size + (size_t)(size - 1)] = 1;
+    }
+
+    int clusters = size * size / 1024 + 1;
+    for (int c = 0; c < clusters; ++c) {
+        int w = 1 + (int)(bench_random_unit() * 4.0f);
+        int h = 1 + (int)(bench_random_unit() * 4.0f);
+        int x0 = 1 + (int)(bench_random_unit() * (float)(size - 2));
+        int z0 = 1 + (int)(bench_random_unit() * (float)(size - 2));
+        for (int z = z0; z < z0 + h && z < size - 1; ++z) {
+            for (int x = x0; x < x0 + w && x < size - 1; ++x) {
+                cells[(size_t)z * (size_t)size + (size_t)x] = 2;
+            }
+        }
+    }
+    return cells;
+}
+
+// Origin on a free cell of the active map
+static void random_origin(float* x, float* z) {
+    float min_x, max_x, min_z, max_z;
+    world_get_bounds(&min_x, &max_x, &min_z, &max_z);
+    for (;;) {
+        *x = min_x + 2.0f + bench_random_unit() * (max_x - min_x - 4.0f);
+        *z = min_z + 2.0f + bench_random_unit() * (max_z - min_z - 4.0f);
+        if (!world_check_collision(*x, 0.0f, *z, 0.1f)) {
+            return;
+        }
+    }
+}
+
+typedef struct {
+    float* dist;
+    int* side;
+    float* u;
+    int* cell;
+} RayResults;
+
+static int alloc_results(RayResults* results, size_t count) {
+    results->dist = (float*)malloc(count * sizeof(float));
+    results->side = (int*)malloc(count * sizeof(int));
+    results->u = (float*)malloc(count * sizeof(float));
+    results->cell = (int*)malloc(count * sizeof(int));
+    return results->dist && results->side && results->u && results->cell;
+}
+
+static void free_results(RayResults* results) {
+    free(results->dist);
+    free(results->side);
+    free(results->u);
+    free(results->cell);
+}
+
+// Trace every packet; returns elapsed nanoseconds
+static uint64_t trace_packets(const float* origins, const float* dir_x, const float* dir_z,
+                              int packets, int width, float max_dist, RayResults* out) {
+    uint64_t start = bench_now_ns();
+    for (int p = 0; p < packets; ++p) {
+        size_t i = (size_t)p * (size_t)width;
+        world_cast_ray_packet(origins[p * 2], origins[p * 2 + 1], dir_x + i, dir_z + i, max_dist,
+                              out->dist + i, out->side + i, out->u + i, out->cell + i);
+    }
+    return bench_now_ns() - start;
+}
+
+// Same rays through the scalar tracer
+static uint64_t trace_scalar(const float* origins, const float* dir_x, const float* dir_z,
+                             int packets, int width, float max_dist, RayResults* out) {
+    uint64_t start = bench_now_ns();
+    for (int p = 0; p < packets; ++p) {
+        for (int lane = 0; lane < width; ++lane) {
+            size_t i = (size_t)p * (size_t)width + (size_t)lane;
+            world_cast_ray(origins[p * 2], origins[p * 2 + 1], dir_x[i], dir_z[i], max_dist,
+                           &out->dist[i], &out->side[i], &out->u[i], &out->cell[i]);
+        }
+    }
+    return bench_now_ns() - start;
+}
+
+static long count_mismatches(const RayResults* a, const RayResults* b, size_t count) {
+    long mismatches = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (memcmp(&a->dist[i], &b->dist[i], sizeof(float)) != 0 || a->side[i] != b->side[i] ||
+            memcmp(&a->u[i], &b->u[i], sizeof(float)) != 0 || a->cell[i] != b->cell[i]) {
+            if (mismatches < 10) {
+                printf("  MISMATCH ray %zu: %.9g/%d/%d vs %.9g/%d/%d\n",
+                       i, a->dist[i], a->side[i], a->cell[i], b->dist[i], b->side[i], b->cell[i]);
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static void print_usage(void) {
+    printf("Usage: bench maps [options]\n"
+           "  --size N          Square map size in cells; repeatable\n"
+           "                    (default 16, 64, 256, 1024, 4096)\n"
+           "  --packets N       Ray packets per map (default 20000)\n"
+           "  --max-dist D      Ray length in world units (default: map diagonal)\n");
+}
+
+static int parse_options(int argc, char** argv, MapOptions* options) {
+    memset(options, 0, sizeof(*options));
+    options->packets = 20000;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage();
+            return 0;
+        }
+        if (!value) {
+            printf("ERROR: %s expects a value\n", arg);
+            return 0;
+        }
+
+        if (strcmp(arg, "--size") == 0) {
+            if (options->size_count >= MAX_MAP_SIZES) {
+                printf("ERROR: Too many map sizes\n");
+                return 0;
+            }
+            int size = atoi(value);
+            if (size < 8) {
+                printf("ERROR: Map size must be at least 8\n");
+                return 0;
+            }
+            options->sizes[options->size_count++] = size;
+        } else if (strcmp(arg, "--packets") == 0) {
+            options->packets = atoi(value);
+        } else if (strcmp(arg, "--max-dist") == 0) {
+            options->max_dist = (float)atof(value);
+        } else {
+            printf("ERROR: Unknown option %s\n", arg);
+            print_usage();
+            return 0;
+        }
+        ++i;
+    }
+
+    if (options->packets <= 0 || options->max_dist < 0.0f) {
+        printf("ERROR: Packets and distance must be positive\n");
+        return 0;
+    }
+
+    if (options->size_count == 0) {
+        int count = (int)(sizeof(g_default_sizes) / sizeof(g_default_sizes[0]));
+        for (int i = 0; i < count; ++i) {
+            options->sizes[i] = g_default_sizes[i];
+        }
+        options->size_count = count;
+    }
+    return 1;
+}
+
+int bench_maps_main(int argc, char** argv) {
+    MapOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    if (!space_init() || !world_init()) {
+        printf("ERROR: Engine initialization failed\n");
+        return 1;
+    }
+
+    const int width = world_ray_packet_width();
+    const size_t ray_count = (size_t)options.packets * (size_t)width;
+    float* dir_x = (float*)malloc(ray_count * sizeof(float));
+    float* dir_z = (float*)malloc(ray_count * sizeof(float));
+    float* origins = (float*)malloc((size_t)options.packets * 2 * sizeof(float));
+    RayResults dda, skip, scalar;
+    if (!dir_x || !dir_z || !origins || !alloc_results(&dda, ray_count) || !alloc_results(&skip, ray_count) ||
+        !alloc_results(&scalar, ray_count)) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+
+    printf("\n%-11s %10s %11s %10s %6s %10s %9s %9s %8s %11s\n",
+           "map", "cells KB", "pyramid KB", "int KB", "levels", "rays", "dda Mr/s", "skip Mr/s", "speedup", "scalar Mr/s");
+
+    long mismatches = 0;
+    for (int m = 0; m < options.size_count; ++m) {
+        int size = options.sizes[m];
+        uint8_t* cells = generate_map(size);
+        if (!cells || !world_load_map(cells, size, size)) {
+            printf("ERROR: Cannot build a %dx%d map\n", size, size);
+            free(cells);
+            return 1;
+        }
+        free(cells);
+
+        WorldMapInfo info;
+        world_get_map_info(&info);
+
+        float max_dist = options.max_dist > 0.0f ? options.max_dist : (float)size * MAP_SCALE * 1.415f;
+
+        // One packet of adjacent screen-like columns per origin
+        for (int p = 0; p < options.packets; ++p) {
+            random_origin(&origins[p * 2], &origins[p * 2 + 1]);
+            float angle = bench_random_unit() * 6.28318531f;
+            for (int lane = 0; lane < width; ++lane) {
+                float a = angle + (float)lane * (1.15f / 640.0f);
+                dir_x[(size_t)p * width + lane] = sinf(a);
+                dir_z[(size_t)p * width + lane] = -cosf(a);
+            }
+        }
+
+        world_set_empty_space_skipping(0);
+        uint64_t dda_ns = trace_packets(origins, dir_x, dir_z, options.packets, width, max_dist, &dda);
+        world_set_empty_space_skipping(1);
+        uint64_t skip_ns = trace_packets(origins, dir_x, dir_z, options.packets, width, max_dist, &skip);
+        uint64_t scalar_ns = trace_scalar(origins, dir_x, dir_z, options.packets, width, max_dist, &scalar);
+
+        mismatches += count_mismatches(&dda, &skip, ray_count);
+        mismatches += count_mismatches(&scalar, &skip, ray_count);
+
+        char name[32];
+        snprintf(name, sizeof(name), "%dx%d", size, size);
+        printf("%-11s %10.1f %11.1f %10.1f %6d %10zu %9.2f %9.2f %7.2fx %11.2f\n",
+               name, (double)info.cell_bytes / 1024.0, (double)info.pyramid_bytes / 1024.0,
+               (double)size * (double)size * sizeof(int) / 1024.0, info.levels, ray_count,
+               (double)ray_count * 1e3 / (double)dda_ns, (double)ray_count * 1e3 / (double)skip_ns,
+               (double)dda_ns / (double)skip_ns, (double)ray_count * 1e3 / (double)scalar_ns);
+    }
+
+    free(dir_x);
+    free(dir_z);
+    free(origins);
+    free_results(&dda);
+    free_results(&skip);
+    free_results(&scalar);
+
+    if (mismatches) {
+        printf("\nEmpty-space skipping FAILED: %ld rays differ between tracers\n", mismatches);
+        return 2;
+    }
+    printf("\nEmpty-space skipping matches the cell-by-cell DDA and the scalar tracer bit for bit\n");
+    return 0;
+}
@@ -0,0 +1,160 @@
+// Ray benchmark - Scalar vs packet DDA throughput and equivalence
+// QuakeCloneWASM - Native benchmarks
+//
+// Casts the same random rays through world_cast_ray and
+// world_cast_ray_packet, reports rays per second for both and fails if any
+// hit distance, side, texture coordinate or cell differs in a single bit.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "world.h"
+#include "space.h"
+
+#define RAY_MAX_DIST 50.0f
+
+typedef struct {
+    float origin_x, origin_z;
+    float* dir_x;
+    float* dir_z;
+} RayBatch;
+
+// Origins on free cells of both maps (cells are 2 units wide)
+static void random_origin(float* x, float* z) {
+    float min_x, max_x, min_z, max_z;
+    world_get_bounds(&min_x, &max_x, &min_z, &max_z);
+    for (;;) {
+        *x = min_x + 2.0f + bench_random_unit() * (max_x - min_x - 4.0f);
+        *z = min_z + 2.0f + bench_random_unit() * (max_z - min_z - 4.0f);
+        if (!world_check_collision(*x, 0.0f, *z, 0.1f)) {
+            return;
+        }
+    }
+}
+
+static void fill_batch(RayBatch* batch, int count) {
+    random_origin(&batch->origin_x, &batch->origin_z);
+    float angle = bench_random_unit() * 6.28318531f;
+    float spread = 1.15f / (float)count;
+    for (int i = 0; i < count; ++i) {
+        // Adjacent columns, like world_render; every 16th batch is axis-aligned
+        float a = angle + (float)i * spread;
+        batch->dir_x[i] = sinf(a);
+        batch->dir_z[i] = -cosf(a);
+    }
+    if (bench_random_unit() < 0.0625f) {
+        batch->dir_x[0] = 0.0f;
+        batch->dir_z[0] = -1.0f;
+    }
+}
+
+int bench_rays_main(int argc, char** argv) {
+    int batches = 200000;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--batches") == 0 && i + 1 < argc) {
+            batches = atoi(argv[++i]);
+        } else {
+            printf("Usage: bench rays [--batches N]\n");
+            return 1;
+        }
+    }
+
+    if (!space_init() || !world_init()) {
+        printf("ERROR: Engine initialization failed\n");
+        return 1;
+    }
+
+    const int width = world_ray_packet_width();
+    const size_t ray_count = (size_t)batches * (size_t)width;
+    float* dir_x = (float*)malloc(ray_count * sizeof(float));
+    float* dir_z = (float*)malloc(ray_count * sizeof(float));
+    float* origins = (float*)malloc((size_t)batches * 2 * sizeof(float));
+    float* scalar_dist = (float*)malloc(ray_count * sizeof(float));
+    float* packet_dist = (float*)malloc(ray_count * sizeof(float));
+    int* scalar_side = (int*)malloc(ray_count * sizeof(int));
+    int* packet_side = (int*)malloc(ray_count * sizeof(int));
+    float* scalar_u = (float*)malloc(ray_count * sizeof(float));
+    float* packet_u = (float*)malloc(ray_count * sizeof(float));
+    int* scalar_cell = (int*)malloc(ray_count * sizeof(int));
+    int* packet_cell = (int*)malloc(ray_count * sizeof(int));
+    if (!dir_x || !dir_z || !origins || !scalar_dist || !packet_dist || !scalar_side || !packet_side ||
+        !scalar_u || !packet_u || !scalar_cell || !packet_cell) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+
+    printf("\n%-10s %6s %10s %12s %12s %8s\n", "map", "lanes", "rays", "scalar Mr/s", "packet Mr/s", "speedup");
+
+    long mismatches = 0;
+    for (int map = 0; map < 2; ++map) {
+        if (map == 0) {
+            world_set_planet_map(0);
+        } else {
+            world_set_spaceship_map();
+        }
+
+        for (int b = 0; b < batches; ++b) {
+            RayBatch batch = { 0.0f, 0.0f, dir_x + (size_t)b * width, dir_z + (size_t)b * width };
+            fill_batch(&batch, width);
+            origins[b * 2] = batch.origin_x;
+            origins[b * 2 + 1] = batch.origin_z;
+        }
+
+        uint64_t start = bench_now_ns();
+        for (int b = 0; b < batches; ++b) {
+            for (int lane = 0; lane < width; ++lane) {
+                size_t i = (size_t)b * width + lane;
+                world_cast_ray(origins[b * 2], origins[b * 2 + 1], dir_x[i], dir_z[i],
+                               RAY_MAX_DIST, &scalar_dist[i], &scalar_side[i], &scalar_u[i], &scalar_cell[i]);
+            }
+        }
+        uint64_t scalar_ns = bench_now_ns() - start;
+
+        start = bench_now_ns();
+        for (int b = 0; b < batches; ++b) {
+            size_t i = (size_t)b * width;
+            world_cast_ray_packet(origins[b * 2], origins[b * 2 + 1], dir_x + i, dir_z + i,
+                                  RAY_MAX_DIST, packet_dist + i, packet_side + i, packet_u + i, packet_cell + i);
+        }
+        uint64_t packet_ns = bench_now_ns() - start;
+
+        for (size_t i = 0; i < ray_count; ++i) {
+            if (memcmp(&scalar_dist[i], &packet_dist[i], sizeof(float)) != 0 || scalar_side[i] != packet_side[i] ||
+                memcmp(&scalar_u[i], &packet_u[i], sizeof(float)) != 0 || scalar_cell[i] != packet_cell[i]) {
+                if (mismatches < 10) {
+                    printf("  MISMATCH ray %zu: scalar %.9g/%d/%.9g/%d packet %.9g/%d/%.9g/%d\n",
+                           i, scalar_dist[i], scalar_side[i], scalar_u[i], scalar_cell[i],
+                           packet_dist[i], packet_side[i], packet_u[i], packet_cell[i]);
+                }
+                mismatches++;
+            }
+        }
+
+        printf("%-10s %6d %10zu %12.1f %12.1f %7.2fx\n",
+               map == 0 ? "planet" : "spaceship", width, ray_count,
+               (double)ray_count * 1e3 / (double)scalar_ns,
+               (double)ray_count * 1e3 / (double)packet_ns,
+               (double)scalar_ns / (double)packet_ns);
+    }
+
+    free(dir_x);
+    free(dir_z);
+    free(origins);
+    free(scalar_dist);
+    free(packet_dist);
+    free(scalar_side);
+    free(packet_side);
+    free(scalar_u);
+    free(packet_u);
+    free(scalar_cell);
+    free(packet_cell);
+
+    if (mismatches) {
+        printf("\nPacket tracer FAILED: %ld rays differ from the scalar path\n", mismatches);
+        return 2;
+    }
+    printf("\nPacket tracer matches the scalar path bit for bit\n");
+    return 0;
+}
@@ -0,0 +1,592 @@
+// Render benchmark - Scripted camera flythroughs of the raycaster
+// QuakeCloneWASM - Native benchmarks
+//
+// Flies a fixed camera path through the planet and spaceship maps at several
+// resolutions and reports per-frame cost. Frames can be dumped as PPM files
+// and later compared against those dumps (--golden) to check that an
+// optimization did not change the image. --threads runs the same path with
+// different worker pool sizes and reports how busy each thread was. --hold
+// keeps every camera pose for several frames, like a player standing still,
+// to exercise damage tracking (skipped frames, uploaded bytes). --walls
+// compares flat-shaded walls against the texture atlas path. --maps flies
+// the planet scene through Terra Nova's .qmap map instead of the built-in one.
+// --floors compares the ceiling/floor gradient against textured floor
+// casting and reports the cost of each cast row.
+// The surface scene flies the planet path with the endless surface streamed
+// around the landing site. --sprites scatters standing entities over the
+// path's area and reports how many of them the sprite pass culls. --trace
+// breaks every run down by frame phase and writes the spans of all of them
+// (main thread phases and worker job ranges) as a Chrome trace.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "bench.h"
+#include "renderer.h"
+#include "player.h"
+#include "world.h"
+#include "space.h"
+#include "jobs.h"
+#include "entity.h"
+#include "sprite.h"
+#include "collision.h"
+#include "profile.h"
+
+#define MAX_RESOLUTIONS 16
+#define MAX_THREAD_COUNTS 8
+
+// Entities scattered by --sprites, over the camera path's area
+#define SPRITE_RADIUS 0.25f
+#define SPRITE_AREA 32.0f
+
+typedef struct {
+    const char* name;
+    int is_spaceship;
+    int endless_surface;    // Planet map opened onto its generated surface
+} RenderScene;
+
+static const RenderScene g_scenes[] = {
+    { "planet", 0, 0 },
+    { "spaceship", 1, 0 },
+    { "surface", 0, 1 },
+};
+
+static const int g_scene_count = sizeof(g_scenes) / sizeof(g_scenes[0]);
+
+// Wall shading modes (world_set_textured_walls)
+static const char* g_wall_modes[] = { "flat", "textured" };
+
+// Floor/ceiling modes (world_set_textured_floors)
+static const char* g_floor_modes[] = { "flat", "textured" };
+
+// Default resolutions: from low-end fallback up to 1080p
+static const int g_default_resolutions[][2] = {
+    { 320, 240 },
+    { 800, 600 },
+    { 1280, 720 },
+    { 1920, 1080 },
+};
+
+// Camera path: a loop around the free perimeter corridor (map cells are
+// 2 units wide, so 3.0 is the centre of the first free cell on both maps)
+typedef struct {
+    float x, z;
+    float heading; // Yaw in degrees while travelling this segment
+} PathPoint;
+
+static const PathPoint g_path[] = {
+    { 3.0f, 3.0f, 90.0f },
+    { 29.0f, 3.0f, 180.0f },
+    { 29.0f, 29.0f, 270.0f },
+    { 3.0f, 29.0f, 0.0f },
+};
+
+static const int g_path_count = sizeof(g_path) / sizeof(g_path[0]);
+
+typedef struct {
+    int frames;
+    int warmup;
+    int dump_every;
+    int hold;
+    int sprites;
+    float scale;
+    double budget_ms;
+    const char* scene;
+    const char* walls;
+    const char* floors;
+    const char* dump_dir;
+    const char* golden_dir;
+    const char* maps_dir;
+    const char* trace_path;
+    int resolutions[MAX_RESOLUTIONS][2];
+    int resolution_count;
+    int thread_counts[MAX_THREAD_COUNTS];
+    int thread_count_count;
+} RenderOptions;
+
+// Place the camera at parameter t in [0, 1) along the path
+static void set_camera(float t) {
+    float segment_pos = t * (float)g_path_count;
+    int segment = (int)segment_pos;
+    if (segment >= g_path_count) segment = g_path_count - 1;
+    float s = segment_pos - (float)segment;
+
+    const PathPoint* a = &g_path[segment];
+    const PathPoint* b = &g_path[(segment + 1) % g_path_count];
+
+    float x = a->x + (b->x - a->x) * s;
+    float z = a->z + (b->z - a->z) * s;
+
+    // Sweep the view around the travel direction and nod up and down
+    const float two_pi = 6.28318531f;
+    float yaw = a->heading + 35.0f * sinf(two_pi * 3.0f * t);
+    float pitch = 20.0f * sinf(two_pi * 2.0f * t);
+    if (yaw < 0.0f) yaw += 360.0f;
+    if (yaw >= 360.0f) yaw -= 360.0f;
+
+    player_set_position(x, 0.0f, z);
+    player_set_rotation(yaw, pitch);
+}
+
+// The phases of the game loop's frame, timed as it times them
+static void render_frame(void) {
+    PROFILE_FRAME_BEGIN();
+    PROFILE_BEGIN(PROFILE_UPDATE);
+    world_update(0.0);
+    PROFILE_END(PROFILE_UPDATE);
+    renderer_clear();
+    PROFILE_BEGIN(PROFILE_WORLD_RENDER);
+    world_render();
+    PROFILE_END(PROFILE_WORLD_RENDER);
+    player_render();
+    PROFILE_BEGIN(PROFILE_PRESENT);
+    renderer_present();
+    PROFILE_END(PROFILE_PRESENT);
+    PROFILE_FRAME_END();
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Cost of floor casting per cast row: every pose is drawn with the
+// gradient and with cast floors back to back, in alternating order
+// (switching redraws the whole frame both times), so drift and background
+// load cancel out; the median of the per-pose differences is spread over
+// the rows cast
+static int report_cast_cost(int frames) {
+    double* added_ns = (double*)malloc(sizeof(double) * (size_t)frames);
+    if (!added_ns) {
+        printf("ERROR: Out of memory\n");
+        return 0;
+    }
+
+    double rows = 0.0;
+    for (int frame = 0; frame < frames; ++frame) {
+        set_camera((float)frame / (float)frames);
+        uint64_t frame_ns[2];
+        for (int i = 0; i < 2; ++i) {
+            int textured = (frame + i) & 1;
+            world_set_textured_floors(textured);
+            uint64_t start = bench_now_ns();
+            render_frame();
+            frame_ns[textured] = bench_now_ns() - start;
+            if (textured) {
+                rows += world_get_cast_rows();
+            }
+        }
+        added_ns[frame] = (double)frame_ns[1] - (double)frame_ns[0];
+    }
+    qsort(added_ns, (size_t)frames, sizeof(double), compare_doubles);
+
+    double median_ns = added_ns[frames / 2];
+    double rows_per_frame = rows / (double)frames;
+    if (rows_per_frame > 0.0) {
+        printf("%-19s floor casting: %.0f rows per frame, %+.3f ms per frame, %.1f ns per row (median of %d pairs)\n", "",
+               rows_per_frame, median_ns / 1e6, median_ns / rows_per_frame, frames);
+    }
+    free(added_ns);
+    return 1;
+}
+
+static void print_usage(void) {
+    printf("Usage: bench render [options]\n"
+           "  --frames N        Measured frames per run (default 240)\n"
+           "  --warmup N        Unmeasured frames before each run (default 16)\n"
+           "  --res WxH         Resolution to run; repeatable (default 320x240,\n"
+           "                    800x600, 1280x720, 1920x1080)\n"
+           "  --scene NAME      planet, spaceship, surface or all (default all)\n"
+           "  --walls MODE      flat, textured or both (default textured)\n"
+           "  --floors MODE     flat, textured or both (default textured); both also\n"
+           "                    reports the cost per cast row\n"
+           "  --dump DIR        Write every Kth frame as DIR/<scene>_<walls>_<floors>_<WxH>_<frame>.ppm\n"
+           "  --golden DIR      Compare the same frames against a previous --dump\n"
+           "  --dump-every K    Frame interval for --dump/--golden (default 60)\n"
+           "  --threads N       Render threads; repeatable (default one per core)\n"
+           "  --hold K          Keep each camera pose for K frames (default 1)\n"
+           "  --scale S         Fixed render scale in [0.4, 1] (default 1)\n"
+           "  --budget MS       Dynamic resolution against a frame budget instead\n"
+           "  --maps DIR        Load the planets' .qmap maps from DIR (e.g. site/maps)\n"
+           "  --sprites N       Scatter N standing entities over the path (default 0);\n"
+           "                    compare goldens only against dumps with the same N\n"
+           "  --trace FILE      Time each frame phase and write a Chrome trace to FILE\n");
+}
+
+static int parse_options(int argc, char** argv, RenderOptions* options) {
+    memset(options, 0, sizeof(*options));
+    options->frames = 240;
+    options->warmup = 16;
+    options->dump_every = 60;
+    options->hold = 1;
+    options->scale = 1.0f;
+    options->scene = "all";
+    options->walls = "textured";
+    options->floors = "textured";
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage();
+            return 0;
+        }
+        if (!value) {
+            printf("ERROR: %s expects a value\n", arg);
+            return 0;
+        }
+
+        if (strcmp(arg, "--frames") == 0) {
+            options->frames = atoi(value);
+        } else if (strcmp(arg, "--warmup") == 0) {
+            options->warmup = atoi(value);
+        } else if (strcmp(arg, "--dump-every") == 0) {
+            options->dump_every = atoi(value);
+        } else if (strcmp(arg, "--hold") == 0) {
+            options->hold = atoi(value);
+        } else if (strcmp(arg, "--sprites") == 0) {
+            options->sprites = atoi(value);
+        } else if (strcmp(arg, "--scale") == 0) {
+            options->scale = (float)atof(value);
+        } else if (strcmp(arg, "--budget") == 0) {
+            options->budget_ms = atof(value);
+        } else if (strcmp(arg, "--scene") == 0) {
+            options->scene = value;
+        } else if (strcmp(arg, "--walls") == 0) {
+            options->walls = value;
+        } else if (strcmp(arg, "--floors") == 0) {
+            options->floors = value;
+        } else if (strcmp(arg, "--dump") == 0) {
+            options->dump_dir = value;
+        } else if (strcmp(arg, "--golden") == 0) {
+            options->golden_dir = value;
+        } else if (strcmp(arg, "--maps") == 0) {
+            options->maps_dir = value;
+        } else if (strcmp(arg, "--trace") == 0) {
+            options->trace_path = value;
+        } else if (strcmp(arg, "--res") == 0) {
+            if (options->resolution_count >= MAX_RESOLUTIONS) {
+                printf("ERROR: Too many resolutions\n");
+                return 0;
+            }
+            int* res = options->resolutions[options->resolution_count];
+            if (!bench_parse_resolution(value, &res[0], &res[1])) {
+                printf("ERROR: Invalid resolution '%s'\n", value);
+                return 0;
+            }
+            options->resolution_count++;
+        } else if (strcmp(arg, "--threads") == 0) {
+            if (options->thread_count_count >= MAX_THREAD_COUNTS) {
+                printf("ERROR: Too many thread counts\n");
+                return 0;
+            }
+            int threads = atoi(value);
+            if (threads < 1 || threads > JOBS_MAX_THREADS) {
+                printf("ERROR: Thread count must be 1-%d\n", JOBS_MAX_THREADS);
+                return 0;
+            }
+            options->thread_counts[options->thread_count_count++] = threads;
+        } else {
+            printf("ERROR: Unknown option %s\n", arg);
+            print_usage();
+            return 0;
+        }
+        ++i;
+    }
+
+    if (options->frames <= 0 || options->warmup < 0 || options->dump_every <= 0 || options->hold <= 0 ||
+        options->sprites < 0) {
+        printf("ERROR: Frame counts must be positive\n");
+        return 0;
+    }
+    if (strcmp(options->walls, "flat") != 0 && strcmp(options->walls, "textured") != 0 &&
+        strcmp(options->walls, "both") != 0) {
+        printf("ERROR: Unknown wall mode '%s'\n", options->walls);
+        return 0;
+    }
+    if (strcmp(options->floors, "flat") != 0 && strcmp(options->floors, "textured") != 0 &&
+        strcmp(options->floors, "both") != 0) {
+        printf("ERROR: Unknown floor mode '%s'\n", options->floors);
+        return 0;
+    }
+    if (options->scale <= 0.0f || options->budget_ms < 0.0) {
+        printf("ERROR: Scale and budget must be positive\n");
+        return 0;
+    }
+
+    if (options->resolution_count == 0) {
+        int count = (int)(sizeof(g_default_resolutions) / sizeof(g_default_resolutions[0]));
+        for (int i = 0; i < count; ++i) {
+            options->resolutions[i][0] = g_default_resolutions[i][0];
+            options->resolutions[i][1] = g_default_resolutions[i][1];
+        }
+        options->resolution_count = count;
+    }
+
+    return 1;
+}
+
+static int enter_scene(const RenderScene* scene, int sprites) {
+    world_set_endless_surfaces(scene->endless_surface);
+    if (scene->is_spaceship) {
+        space_beam_to_spaceship();
+    } else {
+        space_beam_to_planet(0);
+    }
+    if (sprites == 0) {
+        return 1;
+    }
+
+    // Same spots for every run of a scene; world_update(0.0) keeps them still
+    if (sprites > entity_get_data()->capacity && !entity_init(sprites)) {
+        return 0;
+    }
+    CollisionGrid grid;
+    world_get_collision_grid(&grid);
+    bench_seed_random(7u);
+    for (int i = 0; i < sprites; ++i) {
+        float x, z;
+        do {
+            x = bench_random_unit() * SPRITE_AREA;
+            z = bench_random_unit() * SPRITE_AREA;
+        } while (collision_overlaps(&grid, x, z, SPRITE_RADIUS));
+        entity_spawn(x, z, SPRITE_RADIUS, ENTITY_IDLE, (uint32_t)i + 1u);
+    }
+    return 1;
+}
+
+// Run one scene at one resolution; returns the number of golden mismatches
+static long run_scene(const RenderScene* scene, const char* walls, const char* floors, int width, int height,
+                      const RenderOptions* options) {
+    renderer_resize(width, height);
+
+    for (int i = 0; i < options->warmup; ++i) {
+        set_camera((float)i / (float)options->frames);
+        render_frame();
+    }
+
+    uint64_t* samples = (uint64_t*)malloc(sizeof(uint64_t) * (size_t)options->frames);
+    if (!samples) {
+        printf("ERROR: Out of memory\n");
+        return -1;
+    }
+
+    long mismatches = 0;
+    uint64_t total_ns = 0;
+    int threads = jobs_get_thread_count();
+    double busy_ms[JOBS_MAX_THREADS] = { 0.0 };
+    double column_wall_ms = 0.0;
+    double bytes_written = 0.0;
+    const RendererStats* stats = renderer_get_stats();
+    uint32_t skipped_before = stats->frames_skipped;
+    uint64_t uploaded_before = stats->total_upload_bytes;
+    double scale_sum = 0.0;
+    double visible_sprites = 0.0;
+    double sprite_ms = 0.0;
+    profile_reset();
+    for (int frame = 0; frame < options->frames; ++frame) {
+        int pose = frame - frame % options->hold;
+        set_camera((float)pose / (float)options->frames);
+
+        uint64_t start = bench_now_ns();
+        render_frame();
+        uint64_t elapsed = bench_now_ns() - start;
+
+        samples[frame] = elapsed;
+        total_ns += elapsed;
+
+        bytes_written += (double)renderer_get_bytes_written();
+        scale_sum += renderer_get_scale();
+        visible_sprites += sprite_get_stats()->visible;
+        sprite_ms += sprite_get_stats()->prepare_ms;
+        column_wall_ms += jobs_get_last_wall_ms();
+        for (int t = 0; t < threads; ++t) {
+            busy_ms[t] += jobs_get_thread_stats(t)->busy_ms;
+        }
+
+        if ((options->dump_dir || options->golden_dir) && frame % options->dump_every == 0) {
+            char path[512];
+            uint32_t* pixels = renderer_get_framebuffer();
+            int render_width, render_height;
+            renderer_get_viewport(&render_width, &render_height);
+            if (render_width != width || render_height != height) {
+                printf("ERROR: Frames can only be dumped or compared at scale 1\n");
+                free(samples);
+                return -1;
+            }
+            if (options->dump_dir) {
+                snprintf(path, sizeof(path), "%s/%s_%s_%s_%dx%d_%04d.ppm", options->dump_dir, scene->name, walls, floors,
+                         width, height, frame);
+                bench_write_ppm(path, pixels, width, height);
+            }
+            if (options->golden_dir) {
+                snprintf(path, sizeof(path), "%s/%s_%s_%s_%dx%d_%04d.ppm", options->golden_dir, scene->name, walls, floors,
+                         width, height, frame);
+                long diff = bench_compare_ppm(path, pixels, width, height);
+                if (diff != 0) {
+                    printf("  MISMATCH %s: %ld pixels differ\n", path, diff);
+                    mismatches += (diff > 0) ? diff : 1;
+                }
+            }
+        }
+    }
+
+    double mean_ns = (double)total_ns / (double)options->frames;
+    double ns_per_column = mean_ns / (double)width;
+    double ns_per_pixel = mean_ns / ((double)width * (double)height);
+    double p50_ms = (double)bench_percentile(samples, (size_t)options->frames, 50.0) / 1e6;
+    double p99_ms = (double)bench_percentile(samples, (size_t)options->frames, 99.0) / 1e6;
+    double skipped_pct = (double)(stats->frames_skipped - skipped_before) * 100.0 / (double)options->frames;
+    double upload_mb = (double)(stats->total_upload_bytes - uploaded_before) / (double)options->frames / 1e6;
+
+    printf("%-10s %-8s %-8s %5dx%-5d %7d %7d %10.1f %9.3f %9.3f %9.3f %9.3f %9.2f %8.1f%% %9.2f %6.2f\n",
+           scene->name, walls, floors, width, height, threads, options->frames,
+           ns_per_column, ns_per_pixel, mean_ns / 1e6, p50_ms, p99_ms,
+           bytes_written / (double)options->frames / 1e6, skipped_pct, upload_mb,
+           scale_sum / (double)options->frames);
+
+    if (options->sprites) {
+        printf("%-19s sprites: %d, %.1f visible per frame, %.3f ms culling and sorting\n", "",
+               options->sprites, visible_sprites / (double)options->frames, sprite_ms / (double)options->frames);
+    }
+
+    // Phase breakdown of the measured frames (at most the last PROFILE_HISTORY)
+    if (options->trace_path) {
+        printf("%-19s", "");
+        for (int p = PROFILE_UPDATE; p < PROFILE_PHASE_COUNT; ++p) {
+            ProfileStats phase;
+            profile_get_stats((ProfilePhase)p, &phase);
+            printf(" %s %.3f/%.3fms", profile_get_phase_name((ProfilePhase)p), phase.avg_ms, phase.p99_ms);
+        }
+        printf(" (avg/p99)\n");
+    }
+
+    // Per-thread busy time per frame and its share of the column pass
+    if (threads > 1) {
+        printf("%-19s", "");
+        for (int t = 0; t < threads; ++t) {
+            double share = column_wall_ms > 0.0 ? busy_ms[t] / column_wall_ms * 100.0 : 0.0;
+            printf(" t%d %.3fms (%.0f%%)", t, busy_ms[t] / (double)options->frames, share);
+        }
+        printf("\n");
+    }
+
+    free(samples);
+    return mismatches;
+}
+
+int bench_render_main(int argc, char** argv) {
+    RenderOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    if (options.dump_dir) {
+        mkdir(options.dump_dir, 0755);
+    }
+
+    if (!renderer_init(options.resolutions[0][0], options.resolutions[0][1]) ||
+        !space_init() || !world_init() || !jobs_init(0)) {
+        printf("ERROR: Engine initialization failed\n");
+        return 1;
+    }
+    player_init(g_path[0].x, g_path[0].z);
+
+    if (options.maps_dir && space_load_planet_maps(options.maps_dir) == 0) {
+        printf("ERROR: No planet maps found in %s\n", options.maps_dir);
+        return 1;
+    }
+
+    if (options.thread_count_count == 0) {
+        options.thread_counts[0] = jobs_get_thread_count();
+        options.thread_count_count = 1;
+    }
+
+    if (options.budget_ms > 0.0) {
+        renderer_set_frame_budget_ms(options.budget_ms);
+        renderer_set_fixed_scale(0.0f);
+    } else {
+        renderer_set_fixed_scale(options.scale);
+    }
+
+    // Room for every span of every run: a handful per frame and thread
+    if (options.trace_path) {
+        int runs = g_scene_count * 4 * options.resolution_count * options.thread_count_count;
+        if (!profile_trace_begin(runs * (options.frames + options.warmup) * 8)) {
+            return 1;
+        }
+    }
+
+    printf("\n%-10s %-8s %-8s %11s %7s %7s %10s %9s %9s %9s %9s %9s %9s %9s %6s\n",
+           "scene", "walls", "floors", "resolution", "threads", "frames", "ns/column", "ns/pixel", "mean(ms)", "p50(ms)", "p99(ms)",
+           "MB/frame", "skipped", "upload MB", "scale");
+
+    long mismatches = 0;
+    int ran = 0;
+    for (int s = 0; s < g_scene_count; ++s) {
+        if (strcmp(options.scene, "all") != 0 && strcmp(options.scene, g_scenes[s].name) != 0) {
+            continue;
+        }
+        if (!enter_scene(&g_scenes[s], options.sprites)) {
+            return 1;
+        }
+        for (int w = 0; w < 2; ++w) {
+            const char* walls = g_wall_modes[w];
+            if (strcmp(options.walls, "both") != 0 && strcmp(options.walls, walls) != 0) {
+                continue;
+            }
+            world_set_textured_walls(w == 1);
+            for (int r = 0; r < options.resolution_count; ++r) {
+                for (int t = 0; t < options.thread_count_count; ++t) {
+                    jobs_set_thread_count(options.thread_counts[t]);
+                    for (int f = 0; f < 2; ++f) {
+                        const char* floors = g_floor_modes[f];
+                        if (strcmp(options.floors, "both") != 0 && strcmp(options.floors, floors) != 0) {
+                            continue;
+                        }
+                        world_set_textured_floors(f == 1);
+                        long result = run_scene(&g_scenes[s], walls, floors, options.resolutions[r][0], options.resolutions[r][1],
+                                                &options);
+                        if (result < 0) {
+                            return 1;
+                        }
+                        mismatches += result;
+                        ran++;
+                    }
+                    if (strcmp(options.floors, "both") == 0 && !report_cast_cost(options.frames)) {
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    if (!ran) {
+        printf("ERROR: Unknown scene '%s'\n", options.scene);
+        return 1;
+    }
+
+    if (options.trace_path) {
+        profile_trace_end();
+        if (profile_write_trace(options.trace_path)) {
+            printf("\nTrace written to %s (open in chrome://tracing or ui.perfetto.dev)\n", options.trace_path);
+        }
+        profile_shutdown();
+    }
+
+    if (options.golden_dir) {
+        if (mismatches) {
+            printf("\nGolden comparison FAILED (%ld pixels differ)\n", mismatches);
+            return 2;
+        }
+        printf("\nGolden comparison passed\n");
+    }
+
+    jobs_shutdown();
+    renderer_shutdown();
+    return 0;
+}
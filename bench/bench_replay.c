@@ -0,0 +1,367 @@
+// Replay benchmark - Input recordings as a reproducible workload
+// QuakeCloneWASM - Native benchmarks
+//
+// Records an autopilot session on Terra Nova's surface through the live
+// input path (keys, mouse, a B-key beam up and a menu beam down), with
+// jittery frame times like a browser's, or loads a recording made in the
+// browser. The recording is then played back at its own frame pacing, at
+// steady 30 and 144 Hz and headless; every playback must retrace the
+// player's trajectory exactly, tick for tick. With --render the recorded
+// pacing is replayed with rendering, for frame times of a real session.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "replay.h"
+#include "sim.h"
+#include "input.h"
+#include "player.h"
+#include "world.h"
+#include "space.h"
+#include "jobs.h"
+#include "renderer.h"
+
+typedef struct {
+    int seconds;                // Game time to record
+    const char* record_path;    // Save the recording here
+    const char* play_path;      // Play this recording instead of recording one
+    int width;                  // Rendered replay (0: none)
+    int height;
+} ReplayOptions;
+
+static void print_usage(void) {
+    printf("Usage: bench replay [options]\n"
+           "  --seconds N       Game time to record (default 60)\n"
+           "  --record FILE     Save the recording (.qrep)\n"
+           "  --play FILE       Replay FILE instead of recording\n"
+           "  --render WxH      Also replay the recorded pacing with rendering\n");
+}
+
+static int parse_options(int argc, char** argv, ReplayOptions* options) {
+    memset(options, 0, sizeof(*options));
+    options->seconds = 60;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage();
+            return 0;
+        }
+        if (!value) {
+            printf("ERROR: %s expects a value\n", arg);
+            return 0;
+        }
+
+        if (strcmp(arg, "--seconds") == 0) {
+            options->seconds = atoi(value);
+        } else if (strcmp(arg, "--record") == 0) {
+            options->record_path = value;
+        } else if (strcmp(arg, "--play") == 0) {
+            options->play_path = value;
+        } else if (strcmp(arg, "--render") == 0) {
+            if (!bench_parse_resolution(value, &options->width, &options->height)) {
+                printf("ERROR: Invalid resolution %s\n", value);
+                return 0;
+            }
+        } else {
+            printf("ERROR: Unknown option %s\n", arg);
+            print_usage();
+            return 0;
+        }
+        ++i;
+    }
+
+    if (options->seconds <= 0) {
+        printf("ERROR: Seconds must be positive\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Player pose before every tick, hashed (FNV-1a)
+typedef struct {
+    uint32_t* poses;
+    uint64_t capacity;          // Ticks traced
+    uint64_t length;            // Ticks to record
+    BenchAutopilot* pilot;      // Drives the recording run (NULL: replay)
+} Trajectory;
+
+static uint32_t hash_pose(void) {
+    float pose[5];
+    player_get_position(&pose[0], &pose[1], &pose[2]);
+    pose[3] = player_get_yaw();
+    pose[4] = player_get_pitch();
+    const uint8_t* bytes = (const uint8_t*)pose;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(pose); ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void trace_input(uint64_t tick, void* user_data) {
+    Trajectory* trajectory = (Trajectory*)user_data;
+    if (tick < trajectory->capacity) {
+        trajectory->poses[tick] = hash_pose();
+    }
+
+    BenchAutopilot* pilot = trajectory->pilot;
+    if (!pilot) {
+        return;
+    }
+    bench_autopilot_input(tick, pilot);
+
+    // A third in, beam up with the B key; two thirds in, pick Aridus
+    // Prime from the planet menu
+    uint64_t beam_up = trajectory->length / 3;
+    if (tick == beam_up) set_key_state('B', 1);
+    if (tick == beam_up + 1) set_key_state('B', 0);
+    if (tick == trajectory->length * 2 / 3 && replay_record_beam(1)) {
+        space_request_beam(1);
+    }
+}
+
+// Browser-like frames: mostly 16.7 ms, some fast, some hitches
+static double next_frame_seconds(void) {
+    float r = bench_random_unit();
+    if (r < 0.05f) return 0.030 + bench_random_unit() * 0.040;
+    if (r < 0.20f) return 0.006 + bench_random_unit() * 0.004;
+    return 1.0 / 60.0 + (bench_random_unit() - 0.5f) * 0.002;
+}
+
+// Returns a copy of the recording; the last frame may run a few ticks past
+// the length
+static uint8_t* record_session(Trajectory* trajectory, size_t* size) {
+    world_set_endless_surfaces(1);
+    space_beam_to_planet(0);
+    jobs_wait_background();
+    world_update(0.0);
+    input_clear();
+    sim_init();
+
+    BenchAutopilot pilot;
+    bench_autopilot_reset(&pilot);
+    trajectory->pilot = &pilot;
+    sim_set_input(trace_input, trajectory);
+
+    if (!replay_start_recording()) {
+        return NULL;
+    }
+    bench_seed_random(17u);
+    while (sim_get_stats()->ticks < trajectory->length) {
+        double frame_seconds = next_frame_seconds();
+        replay_record_frame(frame_seconds);
+        sim_advance(frame_seconds);
+    }
+    trajectory->pilot = NULL;
+    sim_set_input(NULL, NULL);
+    input_clear();
+
+    const uint8_t* data;
+    *size = replay_stop_recording(&data);
+    uint8_t* copy = (uint8_t*)malloc(*size);
+    if (copy) {
+        memcpy(copy, data, *size);
+    }
+    return copy;
+}
+
+static uint8_t* load_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        printf("ERROR: Cannot read %s\n", path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = length > 0 ? (uint8_t*)malloc((size_t)length) : NULL;
+    if (!data || fread(data, 1, (size_t)length, file) != (size_t)length) {
+        printf("ERROR: Cannot read %s\n", path);
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    *size = (size_t)length;
+    return data;
+}
+
+static int save_file(const char* path, const uint8_t* data, size_t size) {
+    FILE* file = fopen(path, "wb");
+    if (!file || fwrite(data, 1, size, file) != size) {
+        printf("ERROR: Cannot write %s\n", path);
+        if (file) fclose(file);
+        return 0;
+    }
+    fclose(file);
+    return 1;
+}
+
+typedef enum {
+    PACE_RECORDED = 0,
+    PACE_30HZ,
+    PACE_144HZ,
+    PACE_HEADLESS,
+    PACE_COUNT
+} Pace;
+
+static const char* g_pace_names[PACE_COUNT] = { "recorded", "30 Hz", "144 Hz", "headless" };
+
+static void render_frame(void) {
+    renderer_clear();
+    world_render();
+    player_render();
+    renderer_present();
+}
+
+// Play the recording once; returns the ticks whose pose differed from
+// reference (NULL: fill it instead), or -1 if playback failed
+static long play(const uint8_t* data, size_t size, Pace pace, Trajectory* trajectory,
+                 const uint32_t* reference, int render, uint64_t* frame_ns, int* frames, double* seconds) {
+    if (!replay_start_playback(data, size)) {
+        return -1;
+    }
+    uint64_t ticks = replay_get_tick_count();
+    sim_set_input(trace_input, trajectory);
+
+    *frames = 0;
+    uint64_t start = bench_now_ns();
+    if (pace == PACE_HEADLESS) {
+        sim_run_ticks(ticks);
+        replay_stop_playback();
+    } else {
+        double frame_seconds = pace == PACE_30HZ ? 1.0 / 30.0 : 1.0 / 144.0;
+        while (replay_is_playing()) {
+            if (pace == PACE_RECORDED && !replay_next_frame(&frame_seconds)) {
+                // Frames used up: finish the last ticks
+                sim_run_ticks(ticks - replay_get_stats()->tick);
+                replay_stop_playback();
+                break;
+            }
+            uint64_t frame_start = bench_now_ns();
+            sim_advance(frame_seconds);
+            if (render) {
+                render_frame();
+            }
+            if (frame_ns) {
+                frame_ns[*frames] = bench_now_ns() - frame_start;
+            }
+            (*frames)++;
+        }
+    }
+    *seconds = (double)(bench_now_ns() - start) / 1e9;
+    sim_set_input(NULL, NULL);
+
+    if (!reference) {
+        return 0;
+    }
+    long differing = 0;
+    for (uint64_t i = 0; i < ticks; ++i) {
+        differing += trajectory->poses[i] != reference[i];
+    }
+    return differing;
+}
+
+int bench_replay_main(int argc, char** argv) {
+    ReplayOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    int width = options.width ? options.width : 320;
+    int height = options.height ? options.height : 240;
+    if (!renderer_init(width, height) || !space_init() || !world_init() || !input_init() || !jobs_init(0)) {
+        printf("ERROR: Engine initialization failed\n");
+        return 1;
+    }
+    renderer_set_fixed_scale(1.0f);
+
+    // The recording, and the trajectory it was recorded with (if made here)
+    uint64_t length = (uint64_t)options.seconds * SIM_TICK_HZ;
+    Trajectory trajectory = { NULL, length + SIM_MAX_TICKS_PER_FRAME, length, NULL };
+    uint32_t* reference = NULL;
+    uint8_t* data = NULL;
+    size_t size = 0;
+    if (options.play_path) {
+        data = load_file(options.play_path, &size);
+    } else {
+        trajectory.poses = (uint32_t*)malloc(trajectory.capacity * sizeof(uint32_t));
+        data = trajectory.poses ? record_session(&trajectory, &size) : NULL;
+        reference = trajectory.poses;
+        trajectory.poses = NULL;
+    }
+    if (!data || size < sizeof(ReplayHeader)) {
+        printf("ERROR: No usable recording\n");
+        return 1;
+    }
+
+    ReplayHeader header;
+    memcpy(&header, data, sizeof(header));
+    printf("\nRecording: %u ticks (%.1f s), %u frames, %u events, %zu bytes (%.0f bytes/s)\n",
+           header.ticks, header.ticks * SIM_TICK_SECONDS, header.frames, header.events, size,
+           (double)size / (header.ticks * SIM_TICK_SECONDS));
+    if (options.record_path && save_file(options.record_path, data, size)) {
+        printf("Saved %s\n", options.record_path);
+    }
+    trajectory.capacity = header.ticks;
+    trajectory.poses = (uint32_t*)malloc(((size_t)header.ticks + 1) * sizeof(uint32_t));
+    if (!trajectory.poses) {
+        return 1;
+    }
+
+    printf("\n%-10s %8s %10s %12s %14s %10s\n", "pacing", "frames", "checksums", "mismatches", "ticks differ", "time(s)");
+    int failures = 0;
+    for (int p = 0; p < PACE_COUNT; ++p) {
+        int frames;
+        double seconds;
+        long differing = play(data, size, (Pace)p, &trajectory, reference, 0, NULL, &frames, &seconds);
+        if (differing < 0) {
+            failures++;
+            break;
+        }
+        // A loaded recording is checked against its first playback
+        if (!reference) {
+            reference = trajectory.poses;
+            trajectory.poses = (uint32_t*)malloc(((size_t)header.ticks + 1) * sizeof(uint32_t));
+            if (!trajectory.poses) {
+                return 1;
+            }
+        }
+        const ReplayStats* stats = replay_get_stats();
+        printf("%-10s %8d %10u %12u %14ld %10.2f\n", g_pace_names[p], frames, stats->checks,
+               stats->mismatches, differing, seconds);
+        failures += stats->mismatches != 0 || differing != 0;
+    }
+
+    // The recorded session again, rendered frame by frame
+    if (options.width && !failures) {
+        uint64_t* frame_ns = (uint64_t*)malloc(((size_t)header.frames + 1) * sizeof(uint64_t));
+        int frames;
+        double seconds;
+        long differing = play(data, size, PACE_RECORDED, &trajectory, reference, 1, frame_ns, &frames, &seconds);
+        failures += differing != 0 || replay_get_stats()->mismatches != 0;
+        printf("\nRendered replay at %dx%d: %d frames in %.2f s, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+               width, height, frames, seconds,
+               bench_percentile(frame_ns, (size_t)frames, 50.0) / 1e6,
+               bench_percentile(frame_ns, (size_t)frames, 99.0) / 1e6,
+               bench_percentile(frame_ns, (size_t)frames, 100.0) / 1e6);
+        free(frame_ns);
+    }
+
+    free(trajectory.poses);
+    free(reference);
+    free(data);
+    replay_shutdown();
+    jobs_shutdown();
+    renderer_shutdown();
+    if (failures) {
+        printf("\nReplay did not reproduce the recording\n");
+        return 2;
+    }
+    printf("\nEvery replay retraced the recorded trajectory\n");
+    return 0;
+}
@@ -0,0 +1,274 @@
+// Simulation benchmark - Frame-rate independence and headless speed
+// QuakeCloneWASM - Native benchmarks
+//
+// An autopilot drives the player through the fixed-timestep simulation
+// (walking, strafing, turning) with wandering entities around it. The
+// same run is paced by different frame rates, steady and jittery; with
+// fixed ticks every pacing must end in the same state, which is checked
+// with a hash of the player and entities. For contrast the run is repeated
+// with the old variable-timestep update at two frame rates. Finally the
+// simulation runs headless in lockstep on Terra Nova's streamed surface,
+// as fast as it can, and reports how much faster than real time it went.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "sim.h"
+#include "input.h"
+#include "player.h"
+#include "world.h"
+#include "space.h"
+#include "jobs.h"
+#include "entity.h"
+#include "collision.h"
+
+#define ENTITY_RADIUS 0.25f
+#define SPAWN_AREA 32.0f        // Entities start on the 32x32 units around the origin
+
+typedef struct {
+    double hours;           // Headless run length in game time
+    int seconds;            // Game time of each pacing run
+    int entities;
+} SimOptions;
+
+static void print_usage(void) {
+    printf("Usage: bench sim [options]\n"
+           "  --hours H         Game time of the headless run (default 1)\n"
+           "  --seconds N       Game time of each frame pacing run (default 60)\n"
+           "  --entities N      Wandering entities (default 200)\n");
+}
+
+static int parse_options(int argc, char** argv, SimOptions* options) {
+    options->hours = 1.0;
+    options->seconds = 60;
+    options->entities = 200;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage();
+            return 0;
+        }
+        if (!value) {
+            printf("ERROR: %s expects a value\n", arg);
+            return 0;
+        }
+
+        if (strcmp(arg, "--hours") == 0) {
+            options->hours = atof(value);
+        } else if (strcmp(arg, "--seconds") == 0) {
+            options->seconds = atoi(value);
+        } else if (strcmp(arg, "--entities") == 0) {
+            options->entities = atoi(value);
+        } else {
+            printf("ERROR: Unknown option %s\n", arg);
+            print_usage();
+            return 0;
+        }
+        ++i;
+    }
+
+    if (options->hours < 0.0 || options->seconds <= 0 || options->entities < 0) {
+        printf("ERROR: Hours, seconds and entities must be positive\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Fresh world for a run: the same map, player pose, entities and input
+static void reset_run(BenchAutopilot* pilot, int endless, int entities) {
+    world_set_endless_surfaces(endless);
+    space_beam_to_planet(0);
+    jobs_wait_background();
+    world_update(0.0);
+
+    entity_clear();
+    CollisionGrid grid;
+    world_get_collision_grid(&grid);
+    bench_seed_random(99u);
+    for (int i = 0; i < entities; ++i) {
+        float x, z;
+        do {
+            x = bench_random_unit() * SPAWN_AREA;
+            z = bench_random_unit() * SPAWN_AREA;
+        } while (collision_overlaps(&grid, x, z, ENTITY_RADIUS));
+        entity_spawn(x, z, ENTITY_RADIUS, ENTITY_WANDER, (uint32_t)i * 2654435761u + 1u);
+    }
+
+    // No keys held, no mouse movement or presses left over
+    input_clear();
+    bench_autopilot_reset(pilot);
+    sim_init();
+    sim_set_input(bench_autopilot_input, pilot);
+}
+
+// FNV-1a over the player's pose and every entity position
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t hash_state(void) {
+    float x, y, z;
+    player_get_position(&x, &y, &z);
+    float pose[4] = { x, z, player_get_yaw(), player_get_pitch() };
+    uint64_t hash = hash_bytes(14695981039346656037ull, pose, sizeof(pose));
+    const EntityData* data = entity_get_data();
+    hash = hash_bytes(hash, data->x, sizeof(float) * (size_t)data->count);
+    return hash_bytes(hash, data->z, sizeof(float) * (size_t)data->count);
+}
+
+// Frame pacings: steady rates, and jittery frames between 5 and 50 ms
+typedef struct {
+    const char* name;
+    double frame_seconds;   // 0: jittery
+} Pacing;
+
+static const Pacing g_pacings[] = {
+    { "30 Hz", 1.0 / 30.0 },
+    { "60 Hz", 1.0 / 60.0 },
+    { "144 Hz", 1.0 / 144.0 },
+    { "240 Hz", 1.0 / 240.0 },
+    { "jitter", 0.0 },
+};
+
+static const int g_pacing_count = sizeof(g_pacings) / sizeof(g_pacings[0]);
+
+static double next_frame_seconds(const Pacing* pacing) {
+    if (pacing->frame_seconds > 0.0) {
+        return pacing->frame_seconds;
+    }
+    return 0.005 + bench_random_unit() * 0.045;
+}
+
+// Paced run; hashes the state once target ticks have run
+typedef struct {
+    uint64_t target;
+    uint64_t hash;
+    int hashed;
+    BenchAutopilot* pilot;
+} PacedRun;
+
+static void paced_input(uint64_t tick, void* user_data) {
+    PacedRun* run = (PacedRun*)user_data;
+    if (tick == run->target && !run->hashed) {
+        run->hash = hash_state();
+        run->hashed = 1;
+    }
+    bench_autopilot_input(tick, run->pilot);
+}
+
+static uint64_t run_paced(const Pacing* pacing, int seconds, int entities, int* frames) {
+    BenchAutopilot pilot;
+    reset_run(&pilot, 0, entities);
+    PacedRun run = { (uint64_t)seconds * SIM_TICK_HZ, 0, 0, &pilot };
+    sim_set_input(paced_input, &run);
+    sim_set_lockstep(1);
+
+    bench_seed_random(5u);
+    *frames = 0;
+    while (!run.hashed) {
+        sim_advance(next_frame_seconds(pacing));
+        (*frames)++;
+    }
+    return run.hash;
+}
+
+// The previous game loop: every frame's time passed straight to the update
+static void run_variable(double frame_seconds, int seconds, int entities, float* x, float* z) {
+    BenchAutopilot pilot;
+    reset_run(&pilot, 0, entities);
+    sim_set_input(NULL, NULL);
+    double time = 0.0;
+    while (time < (double)seconds) {
+        bench_autopilot_input((uint64_t)(time * SIM_TICK_HZ), &pilot);
+        player_update(frame_seconds);
+        world_update(frame_seconds);
+        space_update(frame_seconds);
+        input_update();
+        time += frame_seconds;
+    }
+    float y;
+    player_get_position(x, &y, z);
+}
+
+int bench_sim_main(int argc, char** argv) {
+    SimOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    if (!space_init() || !world_init() || !input_init() || !jobs_init(0)) {
+        printf("ERROR: Engine initialization failed\n");
+        return 1;
+    }
+    if (options.entities > ENTITY_DEFAULT_CAPACITY && !entity_init(options.entities)) {
+        return 1;
+    }
+
+    printf("\nFixed %d Hz ticks, %d s of game time per pacing, %d entities\n",
+           SIM_TICK_HZ, options.seconds, options.entities);
+    printf("%-8s %8s %18s\n", "pacing", "frames", "state hash");
+
+    int failures = 0;
+    uint64_t reference = 0;
+    for (int p = 0; p < g_pacing_count; ++p) {
+        int frames;
+        uint64_t hash = run_paced(&g_pacings[p], options.seconds, options.entities, &frames);
+        if (p == 0) {
+            reference = hash;
+        }
+        printf("%-8s %8d   %016llx %s\n", g_pacings[p].name, frames, (unsigned long long)hash,
+               hash == reference ? "" : "MISMATCH");
+        failures += hash != reference;
+    }
+
+    // The variable timestep drifts with the frame rate
+    float x30, z30, x144, z144;
+    run_variable(1.0 / 30.0, options.seconds, options.entities, &x30, &z30);
+    run_variable(1.0 / 144.0, options.seconds, options.entities, &x144, &z144);
+    printf("Variable timestep: player ends %.2f units apart at 30 and 144 Hz\n",
+           sqrtf((x30 - x144) * (x30 - x144) + (z30 - z144) * (z30 - z144)));
+
+    // Headless: back-to-back ticks on the streamed surface
+    if (options.hours > 0.0) {
+        BenchAutopilot pilot;
+        reset_run(&pilot, 1, options.entities);
+        sim_set_lockstep(1);
+        uint64_t ticks = (uint64_t)(options.hours * 3600.0 * SIM_TICK_HZ);
+        float start_x, start_z, y;
+        player_get_position(&start_x, &y, &start_z);
+
+        uint64_t start = bench_now_ns();
+        sim_run_ticks(ticks);
+        double seconds = (double)(bench_now_ns() - start) / 1e9;
+
+        float end_x, end_z;
+        player_get_position(&end_x, &y, &end_z);
+        SurfaceStats surface;
+        surface_get_stats(&surface);
+        double game_seconds = sim_get_time();
+        printf("\nHeadless: %.2f h of game time (%llu ticks) in %.2f s, %.0fx real time, %.2f us/tick\n",
+               game_seconds / 3600.0, (unsigned long long)ticks, seconds, game_seconds / seconds,
+               seconds * 1e6 / (double)ticks);
+        printf("          player ended %.0f units from the landing site; %lu surface chunks generated\n",
+               sqrtf((end_x - start_x) * (end_x - start_x) + (end_z - start_z) * (end_z - start_z)),
+               surface.generated);
+    }
+
+    sim_set_input(NULL, NULL);
+    jobs_shutdown();
+    if (failures) {
+        printf("\nFrame pacing changed the simulation (%d mismatches)\n", failures);
+        return 2;
+    }
+    printf("\nEvery frame pacing produced the same simulation\n");
+    return 0;
+}
@@ -0,0 +1,254 @@
+// Surface benchmark - Chunk streaming on endless planet surfaces
+// QuakeCloneWASM - Native benchmarks
+//
+// Flies the player around a large square on each planet's surface at a
+// fixed speed and calls world_update every frame, as the game loop does,
+// spending a fixed frame time in between as rendering would.
+// Reports chunk generation cost, the time world_update takes on the main
+// thread, frames where a chunk next to the player was still missing, and
+// cache behaviour under the memory budget. Finally every generated chunk in
+// the window is regenerated from scratch and compared byte for byte.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "player.h"
+#include "world.h"
+#include "space.h"
+#include "jobs.h"
+#include "surface.h"
+
+#define MAP_SCALE 2.0f
+
+typedef struct {
+    int frames;
+    float speed;        // World units per frame
+    double frame_ms;    // Time the rest of each frame takes
+    size_t budget;      // Cache budget in bytes
+    int planet;         // -1: all planets
+} SurfaceOptions;
+
+static void print_usage(void) {
+    printf("Usage: bench surface [options]\n"
+           "  --frames N        Frames per planet (default 1000)\n"
+           "  --speed U         World units travelled per frame (default 4)\n"
+           "  --frame-ms F      Time spent rendering each frame (default 4)\n"
+           "  --budget KB       Chunk cache budget (default %d)\n"
+           "  --planet I        Only planet I (default all)\n",
+           SURFACE_DEFAULT_BUDGET / 1024);
+}
+
+static int parse_options(int argc, char** argv, SurfaceOptions* options) {
+    options->frames = 1000;
+    options->speed = 4.0f;
+    options->frame_ms = 4.0;
+    options->budget = SURFACE_DEFAULT_BUDGET;
+    options->planet = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage();
+            return 0;
+        }
+        if (!value) {
+            printf("ERROR: %s expects a value\n", arg);
+            return 0;
+        }
+
+        if (strcmp(arg, "--frames") == 0) {
+            options->frames = atoi(value);
+        } else if (strcmp(arg, "--speed") == 0) {
+            options->speed = (float)atof(value);
+        } else if (strcmp(arg, "--frame-ms") == 0) {
+            options->frame_ms = atof(value);
+        } else if (strcmp(arg, "--budget") == 0) {
+            options->budget = (size_t)atol(value) * 1024;
+        } else if (strcmp(arg, "--planet") == 0) {
+            options->planet = atoi(value);
+        } else {
+            printf("ERROR: Unknown option %s\n", arg);
+            print_usage();
+            return 0;
+        }
+        ++i;
+    }
+
+    if (options->frames <= 0 || options->speed <= 0.0f || options->frame_ms < 0.0) {
+        printf("ERROR: Frames and speed must be positive\n");
+        return 0;
+    }
+    return 1;
+}
+
+// Position after travelling distance d around a square of the given side,
+// starting and ending at (x0, z0)
+static void square_path(float x0, float z0, float side, float d, float* x, float* z) {
+    float lap = fmodf(d, side * 4.0f);
+    int edge = (int)(lap / side);
+    float s = lap - (float)edge * side;
+    switch (edge) {
+    case 0: *x = x0 + s; *z = z0; break;
+    case 1: *x = x0 + side; *z = z0 + s; break;
+    case 2: *x = x0 + side - s; *z = z0 + side; break;
+    default: *x = x0; *z = z0 + side - s; break;
+    }
+}
+
+// A chunk next to the player (the ones rays reach) is still missing
+static int near_chunk_missing(float x, float z) {
+    int origin_x, origin_z;
+    surface_get_window(&origin_x, &origin_z);
+    int cell_x = (int)floorf(x / MAP_SCALE) - origin_x;
+    int cell_z = (int)floorf(z / MAP_SCALE) - origin_z;
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            if (!surface_window_ready(cell_x + dx * SURFACE_CHUNK_SIZE, cell_z + dz * SURFACE_CHUNK_SIZE)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Compare every ready window chunk away from the landing site with a fresh
+// generation; returns mismatching chunks. Also reports the rock coverage.
+static int verify_window(const SurfaceDesc* desc, double* rock_share) {
+    int origin_x, origin_z;
+    const WorldMap* window = surface_get_window(&origin_x, &origin_z);
+    uint8_t cells[SURFACE_CHUNK_CELLS];
+    WorldMap chunk_layout;
+    memset(&chunk_layout, 0, sizeof(chunk_layout));
+    chunk_layout.width = SURFACE_CHUNK_SIZE;
+    chunk_layout.height = SURFACE_CHUNK_SIZE;
+    chunk_layout.tiles_x = SURFACE_CHUNK_SIZE / WORLDMAP_TILE_SIZE;
+    chunk_layout.tiles_y = SURFACE_CHUNK_SIZE / WORLDMAP_TILE_SIZE;
+    long rock = 0, total = 0;
+    int mismatches = 0;
+
+    for (int slot_z = 0; slot_z < SURFACE_WINDOW_CHUNKS; ++slot_z) {
+        for (int slot_x = 0; slot_x < SURFACE_WINDOW_CHUNKS; ++slot_x) {
+            int base_x = slot_x * SURFACE_CHUNK_SIZE;
+            int base_z = slot_z * SURFACE_CHUNK_SIZE;
+            int chunk_x = (origin_x + base_x) / SURFACE_CHUNK_SIZE;
+            int chunk_z = (origin_z + base_z) / SURFACE_CHUNK_SIZE;
+            // The landing site is stamped over the chunks around the origin
+            if (!surface_window_ready(base_x, base_z) || (abs(chunk_x) <= 2 && abs(chunk_z) <= 2)) {
+                continue;
+            }
+            surface_generate_chunk(desc, chunk_x, chunk_z, cells);
+
+            int differs = 0;
+            for (int z = 0; z < SURFACE_CHUNK_SIZE; ++z) {
+                for (int x = 0; x < SURFACE_CHUNK_SIZE; ++x) {
+                    uint8_t expected = cells[worldmap_cell_index(&chunk_layout, x, z)];
+                    uint8_t actual = window->cells[worldmap_cell_index(window, base_x + x, base_z + z)];
+                    differs |= expected != actual;
+                    rock += actual != 0;
+                    total++;
+                }
+            }
+            mismatches += differs;
+        }
+    }
+    *rock_share = total ? (double)rock / (double)total : 0.0;
+    return mismatches;
+}
+
+int bench_surface_main(int argc, char** argv) {
+    SurfaceOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    if (!space_init() || !world_init() || !jobs_init(0) || !surface_set_budget(options.budget)) {
+        printf("ERROR: Engine initialization failed\n");
+        return 1;
+    }
+    world_set_endless_surfaces(1);
+
+    uint64_t* samples = (uint64_t*)malloc(sizeof(uint64_t) * (size_t)options.frames);
+    if (!samples) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+
+    printf("\n%-17s %7s %7s %9s %8s %8s %8s %7s %7s %9s %9s %6s\n",
+           "planet", "frames", "chunks", "gen(us)", "p50(ms)", "p99(ms)", "max(ms)", "missed", "hit %",
+           "evicted", "cache KB", "rock %");
+
+    int mismatches = 0;
+    int planet_count = space_get_planet_count();
+    for (int p = 0; p < planet_count; ++p) {
+        if (options.planet >= 0 && options.planet != p) {
+            continue;
+        }
+
+        // A fresh cache per planet, so every row starts cold
+        surface_set_budget(options.budget);
+        space_beam_to_spaceship();
+        space_beam_to_planet(p);
+
+        float x0, y0, z0;
+        player_get_position(&x0, &y0, &z0);
+        // A lap and a quarter, so the run ends away from the landing site
+        float side = (float)options.frames * options.speed / 5.0f;
+        int missed = 0;
+
+        for (int frame = 0; frame < options.frames; ++frame) {
+            float x, z;
+            square_path(x0, z0, side, (float)frame * options.speed, &x, &z);
+            player_set_position(x, 0.0f, z);
+
+            uint64_t start = bench_now_ns();
+            world_update(1.0 / 60.0);
+            samples[frame] = bench_now_ns() - start;
+            missed += near_chunk_missing(x, z);
+
+            // Stand-in for rendering: the background thread keeps working
+            uint64_t frame_end = start + (uint64_t)(options.frame_ms * 1e6);
+            while (bench_now_ns() < frame_end) {
+            }
+        }
+
+        // Let in-flight chunks land before verifying
+        jobs_wait_background();
+        world_update(0.0);
+
+        SurfaceStats stats;
+        surface_get_stats(&stats);
+        double rock_share;
+        SurfaceDesc desc;
+        space_get_surface_desc(p, &desc);
+        mismatches += verify_window(&desc, &rock_share);
+
+        uint64_t max_ns = 0;
+        for (int i = 0; i < options.frames; ++i) {
+            if (samples[i] > max_ns) max_ns = samples[i];
+        }
+        double p50 = bench_percentile(samples, (size_t)options.frames, 50.0) / 1e6;
+        double p99 = bench_percentile(samples, (size_t)options.frames, 99.0) / 1e6;
+        unsigned long lookups = stats.hits + stats.misses;
+
+        printf("%-17s %7d %7lu %9.1f %8.3f %8.3f %8.3f %7d %7.1f %9lu %9.0f %6.1f\n",
+               space_get_planet(p)->name, options.frames, stats.generated,
+               stats.generated ? stats.generate_ms * 1000.0 / (double)stats.generated : 0.0,
+               p50, p99, (double)max_ns / 1e6, missed,
+               lookups ? 100.0 * (double)stats.hits / (double)lookups : 0.0,
+               stats.evictions, (double)stats.resident_bytes / 1024.0, rock_share * 100.0);
+    }
+
+    free(samples);
+    jobs_shutdown();
+
+    if (mismatches) {
+        printf("\nSurface streaming FAILED: %d window chunks differ from a fresh generation\n", mismatches);
+        return 2;
+    }
+    printf("\nStreamed chunks match a fresh generation byte for byte\n");
+    return 0;
+}
@@ -28,6 +28,24 @@ if %errorlevel% neq 0 (
     call "%EMSDK_PATH%\emsdk_env.bat"
 )
 
+REM Multithreaded column rendering is opt-in: set THREADS=1 before building
+REM Needs SharedArrayBuffer, so the page must be served with
+REM Cross-Origin-Opener-Policy: same-origin and
+REM Cross-Origin-Embedder-Policy: require-corp
+set THREAD_FLAGS=
+if "%THREADS%"=="1" (
+    set THREAD_FLAGS=-pthread -s PTHREAD_POOL_SIZE=8
+    echo Building with render worker threads
+)
+
+REM Phase timers (profile.h) are compiled out of release builds; set
+REM PROFILE=1 to keep them for get_profile_ms
+set PROFILE_FLAGS=
+if "%PROFILE%"=="1" (
+    set PROFILE_FLAGS=-DPROFILER
+    echo Building with the profiler
+)
+
 REM Create output directory if it doesn't exist
 if not exist "site\wasm" mkdir "site\wasm"
 
@@ -42,16 +60,34 @@ emcc ^
     src/world.c ^
     src/input.c ^
     src/space.c ^
+    src/jobs.c ^
+    src/camera.c ^
+    src/texture.c ^
+    src/colormap.c ^
+    src/worldmap.c ^
+    src/qmap.c ^
+    src/surface.c ^
+    src/collision.c ^
+    src/entity.c ^
+    src/sprite.c ^
+    src/sim.c ^
+    src/replay.c ^
+    src/profile.c ^
+    src/hud.c ^
+    src/galaxy.c ^
     -o site/wasm/game.js ^
     -O3 ^
+    -msimd128 ^
+    %THREAD_FLAGS% ^
+    %PROFILE_FLAGS% ^
     -s WASM=1 ^
     -s USE_WEBGL2=1 ^
     -s USE_GLFW=0 ^
     -s MIN_WEBGL_VERSION=2 ^
     -s MAX_WEBGL_VERSION=2 ^
     -s ALLOW_MEMORY_GROWTH=1 ^
-    -s EXPORTED_RUNTIME_METHODS=["ccall","cwrap"] ^
-    -s EXPORTED_FUNCTIONS=["_main","_get_fps","_resize_window","_set_key_state","_set_mouse_delta","_beam_up","_beam_to_pilot_seat","_get_current_location_name","_get_planet_count","_get_planet_name","_get_planet_info","_beam_to_planet","_is_on_spaceship"] ^
+    -s EXPORTED_RUNTIME_METHODS=["ccall","cwrap","UTF8ToString","HEAPU8","HEAP32","HEAPU32","HEAPF32"] ^
+    -s EXPORTED_FUNCTIONS=["_main","_get_fps","_resize_window","_set_key_state","_set_mouse_delta","_get_input_queue","_get_hud_status","_get_profile_ms","_get_profile_phase_count","_get_profile_phase_name","_beam_up","_beam_to_pilot_seat","_get_current_location_name","_get_planet_count","_get_planet_name","_get_planet_info","_get_galaxy_system_count","_find_nearby_systems","_get_nearby_system_name","_get_nearby_system_info","_beam_to_planet","_prefetch_planet","_is_beam_pending","_get_beam_latency_ms","_get_beam_commit_ms","_is_on_spaceship","_set_render_threads","_get_render_threads","_get_render_thread_busy_ms","_get_frames_skipped","_get_upload_bytes","_set_render_scale","_get_render_scale","_set_frame_budget_ms","_set_textured_walls","_set_textured_floors","_get_planet_map_file","_attach_planet_map","_start_input_recording","_stop_input_recording","_get_input_recording_data","_start_input_replay","_stop_input_replay","_get_input_replay_state","_get_input_replay_mismatches","_malloc","_free"] ^
     -s ASSERTIONS=0 ^
     -s SINGLE_FILE=0 ^
     -s MODULARIZE=1 ^
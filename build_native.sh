@@ -0,0 +1,122 @@
+#!/bin/bash
+# Build script for native (headless) builds
+# QuakeCloneWASM - Compile the engine and benchmark driver for the host
+#
+# The renderer uses its headless backend outside Emscripten, so this needs
+# nothing beyond a C compiler, libm and pthreads. Override the compiler with CC=...
+
+CC=${CC:-cc}
+
+# Instruction set for the SIMD packet tracer: the host's best by default
+# (AVX2 where available). ARCH_FLAGS="" builds the SSE2 baseline;
+# SIMD=0 forces the scalar fallback.
+ARCH_FLAGS=${ARCH_FLAGS--march=native}
+SIMD=${SIMD:-1}
+SIMD_FLAGS=""
+if [ "$SIMD" = "0" ]; then
+    SIMD_FLAGS="-DNO_SIMD"
+fi
+
+# Phase timers (profile.h) for bench render --trace; PROFILE=0 compiles
+# them out like the release web build
+PROFILE=${PROFILE:-1}
+PROFILE_FLAGS=""
+if [ "$PROFILE" = "1" ]; then
+    PROFILE_FLAGS="-DPROFILER"
+fi
+
+echo "============================================"
+echo "Building QuakeCloneWASM (native, headless)"
+echo "============================================"
+echo ""
+
+if ! command -v "$CC" &> /dev/null; then
+    echo "ERROR: C compiler '$CC' not found"
+    exit 1
+fi
+
+mkdir -p build/native
+
+echo "Compiling benchmark driver..."
+echo ""
+
+# -ffp-contract=off keeps float results identical to the WASM build
+# (no fused multiply-add), so golden images transfer between targets
+$CC \
+    src/renderer.c \
+    src/player.c \
+    src/world.c \
+    src/input.c \
+    src/space.c \
+    src/jobs.c \
+    src/camera.c \
+    src/texture.c \
+    src/colormap.c \
+    src/worldmap.c \
+    src/qmap.c \
+    src/surface.c \
+    src/collision.c \
+    src/entity.c \
+    src/sprite.c \
+    src/sim.c \
+    src/replay.c \
+    src/profile.c \
+    src/hud.c \
+    src/galaxy.c \
+    bench/bench.c \
+    bench/bench_render.c \
+    bench/bench_rays.c \
+    bench/bench_maps.c \
+    bench/bench_surface.c \
+    bench/bench_beam.c \
+    bench/bench_collision.c \
+    bench/bench_entities.c \
+    bench/bench_sim.c \
+    bench/bench_replay.c \
+    bench/bench_galaxy.c \
+    -o build/native/bench \
+    -O3 \
+    -std=gnu99 \
+    -ffp-contract=off \
+    $ARCH_FLAGS \
+    $SIMD_FLAGS \
+    $PROFILE_FLAGS \
+    -pthread \
+    -I src \
+    -lm
+
+if [ $? -ne 0 ]; then
+    echo ""
+    echo "ERROR: Compilation failed!"
+    exit 1
+fi
+
+echo "Compiling map converter..."
+echo ""
+
+$CC \
+    tools/qmapconv.c \
+    src/worldmap.c \
+    src/qmap.c \
+    -o build/native/qmapconv \
+    -O2 \
+    -std=gnu99 \
+    -I src
+
+if [ $? -ne 0 ]; then
+    echo ""
+    echo "ERROR: Compilation failed!"
+    exit 1
+fi
+
+echo ""
+echo "============================================"
+echo "Build completed successfully!"
+echo "============================================"
+echo "Output files:"
+echo "  - build/native/bench"
+echo "  - build/native/qmapconv"
+echo ""
+echo "To benchmark the renderer, run: ./build/native/bench render"
+echo "To rebuild the planet maps, run: ./tools/convert_maps.sh"
+echo ""
@@ -9,9 +9,6 @@ let ctx = null;
 
 // FPS counter
 let fpsDisplay = null;
-let lastFpsUpdate = 0;
-let fpsFrameCount = 0;
-let fpsLastTime = performance.now();
 
 // Input state
 const keys = {};
@@ -20,6 +17,35 @@ let mouseDeltaY = 0;
 let lastMouseX = 0;
 let lastMouseY = 0;
 
+// Input event queue in module memory (InputQueue in input.h): events are
+// written straight into its slots and drained by the engine once per
+// frame, instead of a ccall per event
+const INPUT_EVENT_KEY_UP = 0;
+const INPUT_EVENT_KEY_DOWN = 1;
+const INPUT_EVENT_MOUSE = 2;
+let inputQueue = null;
+
+// Events that did not fit while the queue was full, oldest first. They are
+// pushed before any newer event so the engine (and the replay recorder)
+// sees input in order; mouse deltas arriving meanwhile are summed
+let inputOverflow = [];
+
+// HUD status block in module memory (HudStatus in hud.h), read as 32-bit
+// words every frame without calls; keep these offsets in sync with it
+const HUD_GENERATION = 0;
+const HUD_FPS = 2;
+const HUD_LOCATION = 3;
+const HUD_LOCATION_NAME_ID = 4;
+const HUD_STRING_COUNT = 8;
+const HUD_STRINGS = 9;
+const HUD_PLANET_COUNT = 10;
+const HUD_PLANETS = 11;        // { name_id, info_id } per planet
+const HUD_LOCATION_SPACESHIP = 0;
+let hudBase = 0;               // Word offset of the block
+let hudGeneration = -1;        // Last generation shown
+let hudErrorReported = false;  // A failed HUD read was logged
+const hudStrings = [];         // Decoded string table, by id
+
 // Initialize the game
 async function initGame() {
     const loadingText = document.getElementById('loading-text');
@@ -87,6 +113,12 @@ async function initGame() {
             printErr: console.error
         });
         
+        loadingBar.style.width = '80%';
+        loadingText.textContent = 'Loading planet maps...';
+        
+        // Fetch each planet's .qmap image straight into the WASM heap
+        await loadPlanetMaps();
+        
         loadingBar.style.width = '90%';
         loadingText.textContent = 'Setting up input...';
         
@@ -123,18 +155,149 @@ async function initGame() {
     }
 }
 
+// Load every planet's map image. Each file is fetched once and copied into
+// a heap buffer the engine uses in place; planets whose map is missing keep
+// the built-in map.
+async function loadPlanetMaps() {
+    const planetCount = gameModule.ccall('get_planet_count', 'number');
+    const loads = [];
+    
+    for (let i = 0; i < planetCount; i++) {
+        const file = gameModule.ccall('get_planet_map_file', 'string', ['number'], [i]);
+        if (!file) continue;
+        
+        loads.push(fetch('./maps/' + file)
+            .then(response => {
+                if (!response.ok) throw new Error('HTTP ' + response.status);
+                return response.arrayBuffer();
+            })
+            .then(buffer => {
+                const bytes = new Uint8Array(buffer);
+                const ptr = gameModule._malloc(bytes.length);
+                gameModule.HEAPU8.set(bytes, ptr);
+                if (!gameModule.ccall('attach_planet_map', 'number', ['number', 'number', 'number'], [i, ptr, bytes.length])) {
+                    gameModule._free(ptr);
+                    throw new Error('rejected by the engine');
+                }
+            })
+            .catch(error => {
+                console.warn('Using built-in map for planet ' + i + ' (' + file + '): ' + error.message);
+            }));
+    }
+    
+    await Promise.all(loads);
+}
+
+// Locate the engine's input queue (word offsets into the heap views)
+function setupInputQueue() {
+    const ptr = gameModule.ccall('get_input_queue', 'number');
+    const base = ptr >> 2;
+    inputQueue = {
+        head: base,
+        tail: base + 1,
+        capacity: gameModule.HEAPU32[base + 2],
+        events: base + 4,
+        shared: typeof SharedArrayBuffer !== 'undefined' && gameModule.HEAPU32.buffer instanceof SharedArrayBuffer
+    };
+}
+
+// Append one event; returns false if the queue is full (the engine has
+// not drained it for a long while)
+function pushInputEvent(type, keyCode, dx, dy) {
+    // Heap views are replaced when memory grows, so look them up each time
+    const u32 = gameModule.HEAPU32;
+    const q = inputQueue;
+    const head = u32[q.head];
+    const tail = q.shared ? Atomics.load(u32, q.tail) : u32[q.tail];
+    if (((head - tail) >>> 0) >= q.capacity) {
+        return false;
+    }
+    
+    const slot = q.events + (head & (q.capacity - 1)) * 4;
+    u32[slot] = type;
+    gameModule.HEAP32[slot + 1] = keyCode;
+    gameModule.HEAPF32[slot + 2] = dx;
+    gameModule.HEAPF32[slot + 3] = dy;
+    
+    // Publish after the slot is written
+    if (q.shared) {
+        Atomics.store(u32, q.head, (head + 1) >>> 0);
+    } else {
+        u32[q.head] = (head + 1) >>> 0;
+    }
+    return true;
+}
+
+// Push held-back events in order; returns false while the queue is still full
+function flushInputOverflow() {
+    while (inputOverflow.length > 0) {
+        const e = inputOverflow[0];
+        if (!pushInputEvent(e.type, e.keyCode, e.dx, e.dy)) {
+            return false;
+        }
+        inputOverflow.shift();
+    }
+    return true;
+}
+
+function sendKey(keyCode, isDown) {
+    const type = isDown ? INPUT_EVENT_KEY_DOWN : INPUT_EVENT_KEY_UP;
+    if (!flushInputOverflow() || !pushInputEvent(type, keyCode, 0, 0)) {
+        inputOverflow.push({ type, keyCode, dx: 0, dy: 0 });
+    }
+}
+
+function sendMouseDelta(dx, dy) {
+    if (flushInputOverflow() && pushInputEvent(INPUT_EVENT_MOUSE, 0, dx, dy)) {
+        return;
+    }
+    const last = inputOverflow[inputOverflow.length - 1];
+    if (last && last.type === INPUT_EVENT_MOUSE) {
+        last.dx += dx;
+        last.dy += dy;
+    } else {
+        inputOverflow.push({ type: INPUT_EVENT_MOUSE, keyCode: 0, dx, dy });
+    }
+}
+
+// HUD word at offset (heap views change when memory grows: look up each time)
+function hudWord(offset) {
+    return gameModule.HEAP32[hudBase + offset];
+}
+
+// Text of an interned string; each id is decoded once
+function hudString(id) {
+    const count = hudWord(HUD_STRING_COUNT);
+    const table = gameModule.HEAPU32[hudBase + HUD_STRINGS] >> 2;
+    while (hudStrings.length < count) {
+        hudStrings.push(gameModule.UTF8ToString(gameModule.HEAPU32[table + hudStrings.length]));
+    }
+    return id >= 0 && id < hudStrings.length ? hudStrings[id] : '';
+}
+
+function isOnSpaceship() {
+    return hudWord(HUD_LOCATION) === HUD_LOCATION_SPACESHIP;
+}
+
 // Setup input handlers
 function setupInputHandlers() {
     canvas = document.getElementById('canvas');
+    setupInputQueue();
     
     // Keyboard input
     document.addEventListener('keydown', (e) => {
         const keyCode = e.keyCode || e.which;
         keys[keyCode] = true;
         
-        // Update C key state
+        // Queue the key for the engine
         if (gameModule) {
-            gameModule.ccall('set_key_state', null, ['number', 'number'], [keyCode, 1]);
+            sendKey(keyCode, true);
+        }
+        
+        // F8 starts and stops an input recording
+        if (keyCode === 119) {
+            e.preventDefault();
+            toggleInputRecording();
         }
         
         // ESC to unlock pointer
@@ -149,9 +312,9 @@ function setupInputHandlers() {
         const keyCode = e.keyCode || e.which;
         keys[keyCode] = false;
         
-        // Update C key state
+        // Queue the key for the engine
         if (gameModule) {
-            gameModule.ccall('set_key_state', null, ['number', 'number'], [keyCode, 0]);
+            sendKey(keyCode, false);
         }
     });
     
@@ -195,10 +358,9 @@ function setupInputHandlers() {
             mouseDeltaX = movementX;
             mouseDeltaY = movementY;
             
-            // Update C mouse delta
+            // Queue the movement for the engine
             if (gameModule) {
-                gameModule.ccall('set_mouse_delta', null, ['number', 'number'], 
-                               [mouseDeltaX, mouseDeltaY]);
+                sendMouseDelta(mouseDeltaX, mouseDeltaY);
             }
         }
     });
@@ -207,6 +369,72 @@ function setupInputHandlers() {
     canvas.addEventListener('contextmenu', (e) => {
         e.preventDefault();
     });
+    
+    // Drop a .qrep recording on the canvas to replay it
+    canvas.addEventListener('dragover', (e) => {
+        e.preventDefault();
+    });
+    canvas.addEventListener('drop', (e) => {
+        e.preventDefault();
+        if (e.dataTransfer.files.length > 0) {
+            replayInputRecording(e.dataTransfer.files[0]);
+        }
+    });
+}
+
+// Input recording: every key, mouse and beam event with its tick, for
+// replaying movement bugs and performance spikes (see replay.h). Stopping
+// downloads the recording.
+function toggleInputRecording() {
+    if (!gameModule) return;
+    
+    const state = gameModule.ccall('get_input_replay_state', 'number');
+    if (state === 2) {
+        console.warn('Cannot record while a replay is playing');
+        return;
+    }
+    if (state === 0) {
+        if (gameModule.ccall('start_input_recording', 'number')) {
+            console.log('Recording input (F8 to stop)');
+        }
+        return;
+    }
+    
+    const size = gameModule.ccall('stop_input_recording', 'number');
+    const ptr = gameModule.ccall('get_input_recording_data', 'number');
+    if (size <= 0 || !ptr) return;
+    
+    const bytes = gameModule.HEAPU8.slice(ptr, ptr + size);
+    const link = document.createElement('a');
+    link.href = URL.createObjectURL(new Blob([bytes], { type: 'application/octet-stream' }));
+    link.download = 'input-' + new Date().toISOString().replace(/[:.]/g, '-') + '.qrep';
+    link.click();
+    URL.revokeObjectURL(link.href);
+}
+
+// Replay a recording file; live input is ignored until it ends
+async function replayInputRecording(file) {
+    if (!gameModule) return;
+    
+    const bytes = new Uint8Array(await file.arrayBuffer());
+    const ptr = gameModule._malloc(bytes.length);
+    gameModule.HEAPU8.set(bytes, ptr);
+    const started = gameModule.ccall('start_input_replay', 'number', ['number', 'number'], [ptr, bytes.length]);
+    gameModule._free(ptr);
+    if (!started) {
+        console.warn('Not a valid input recording: ' + file.name);
+        return;
+    }
+    
+    console.log('Replaying ' + file.name);
+    const poll = setInterval(() => {
+        if (gameModule.ccall('get_input_replay_state', 'number') !== 2) {
+            clearInterval(poll);
+            const mismatches = gameModule.ccall('get_input_replay_mismatches', 'number');
+            console.log(mismatches === 0 ? 'Replay matched the recording'
+                                         : 'Replay diverged (' + mismatches + ' checksums differ)');
+        }
+    }, 250);
 }
 
 // Handle pointer lock changes
@@ -266,53 +494,48 @@ function resizeCanvas() {
 
 // Game loop (FPS display and location updates)
 function startGameLoop() {
+    hudBase = gameModule.ccall('get_hud_status', 'number') >> 2;
+    const locationSpan = document.getElementById('location');
+    const beamUpBtn = document.getElementById('beam-up-btn');
+    const pilotSeatBtn = document.getElementById('pilot-seat-btn');
+    
     function update() {
         if (!gameInitialized || !gameModule) return;
         
-        // Update FPS counter
-        const now = performance.now();
-        fpsFrameCount++;
-        
-        if (now - fpsLastTime >= 1000) {
-            const fps = gameModule.ccall('get_fps', 'number');
-            if (fpsDisplay) {
-                fpsDisplay.textContent = fps;
-            }
-            fpsLastTime = now;
-            fpsFrameCount = 0;
+        // Retry input held back while the engine was stalled
+        if (inputOverflow.length > 0) {
+            flushInputOverflow();
         }
         
-        // Update location display
         try {
-            const locationName = gameModule.ccall('get_current_location_name', 'string');
-            const locationSpan = document.getElementById('location');
-            if (locationSpan) {
-                locationSpan.textContent = locationName;
-            }
-            
-            // Show/hide beam up button based on location
-            const beamUpBtn = document.getElementById('beam-up-btn');
-            const pilotSeatBtn = document.getElementById('pilot-seat-btn');
-            const isOnSpaceship = gameModule.ccall('is_on_spaceship', 'number');
-            
-            if (beamUpBtn) {
-                if (isOnSpaceship) {
-                    beamUpBtn.style.display = 'none';
-                } else {
-                    beamUpBtn.style.display = 'block';
+            // The engine bumps the generation whenever the status changes
+            const generation = hudWord(HUD_GENERATION);
+            if (generation !== hudGeneration) {
+                hudGeneration = generation;
+                
+                if (fpsDisplay) {
+                    fpsDisplay.textContent = hudWord(HUD_FPS);
                 }
-            }
-            
-            // Show pilot seat button when on spaceship
-            if (pilotSeatBtn) {
-                if (isOnSpaceship) {
-                    pilotSeatBtn.style.display = 'block';
-                } else {
-                    pilotSeatBtn.style.display = 'none';
+                if (locationSpan) {
+                    locationSpan.textContent = hudString(hudWord(HUD_LOCATION_NAME_ID));
+                }
+                
+                // Beam up on planets, pilot seat aboard the spaceship
+                const onSpaceship = isOnSpaceship();
+                if (beamUpBtn) {
+                    beamUpBtn.style.display = onSpaceship ? 'none' : 'block';
+                }
+                if (pilotSeatBtn) {
+                    pilotSeatBtn.style.display = onSpaceship ? 'block' : 'none';
                 }
             }
         } catch (e) {
-            // Ignore errors if functions not ready yet
+            // Keep the loop alive (e.g. a module built without a runtime
+            // method the HUD needs); report the first failure only
+            if (!hudErrorReported) {
+                hudErrorReported = true;
+                console.error('HUD update failed:', e);
+            }
         }
         
         requestAnimationFrame(update);
@@ -365,8 +588,7 @@ function setupBeamUpButton() {
             }
             if (gameModule) {
                 try {
-                    const isOnSpaceship = gameModule.ccall('is_on_spaceship', 'number');
-                    if (!isOnSpaceship) {
+                    if (!isOnSpaceship()) {
                         gameModule.ccall('beam_up', null);
                         console.log('Beaming up to spaceship...');
                     }
@@ -398,18 +620,28 @@ function setupPlanetSelector() {
         if (!gameModule) return;
         
         try {
-            const planetCount = gameModule.ccall('get_planet_count', 'number');
+            const planetCount = hudWord(HUD_PLANET_COUNT);
             planetList.innerHTML = '';
             
             for (let i = 0; i < planetCount; i++) {
                 const planetBtn = document.createElement('button');
                 planetBtn.style.cssText = 'display: block; width: 100%; margin: 10px 0; padding: 15px; background: rgba(0, 255, 0, 0.1); border: 1px solid #0f0; color: #0f0; cursor: pointer; text-align: left; font-family: "Courier New", monospace;';
                 
-                const planetName = gameModule.ccall('get_planet_name', 'string', ['number'], [i]);
-                const planetInfo = gameModule.ccall('get_planet_info', 'string', ['number'], [i]);
+                const planetName = hudString(hudWord(HUD_PLANETS + i * 2));
+                const planetInfo = hudString(hudWord(HUD_PLANETS + i * 2 + 1));
                 
                 planetBtn.innerHTML = `<strong>${planetName}</strong><br><small style="font-size: 10px;">${planetInfo.replace(/\n/g, '<br>')}</small>`;
-                
+
+                // Selecting a planet starts generating its surface, so the
+                // beam itself only has to swap it in
+                const prefetch = () => {
+                    if (gameModule) {
+                        gameModule.ccall('prefetch_planet', null, ['number'], [i]);
+                    }
+                };
+                planetBtn.addEventListener('mouseenter', prefetch);
+                planetBtn.addEventListener('focus', prefetch);
+
                 planetBtn.addEventListener('click', () => {
                     if (gameModule) {
                         try {
@@ -434,8 +666,7 @@ function setupPlanetSelector() {
         if (e.key === 'P' || e.key === 'p') {
             if (gameModule) {
                 try {
-                    const isOnSpaceship = gameModule.ccall('is_on_spaceship', 'number');
-                    if (isOnSpaceship) {
+                    if (isOnSpaceship()) {
                         updatePlanetList();
                         planetSelector.classList.remove('hidden');
                     }
@@ -0,0 +1,83 @@
+// Camera implementation - Per-viewport ray and projection tables
+// QuakeCloneWASM - Rendering system
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "camera.h"
+#include "simd.h"
+
+static CameraTables g_tables = { 0, 0, 0, NULL, NULL, NULL };
+static int g_tables_valid = 0;
+
+// Rebuild column tables for a new viewport size
+int camera_tables_build(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return 0;
+    }
+
+    g_tables.height = height;
+    if (g_tables_valid && width == g_tables.width) {
+        return 1; // Column tables only depend on the width
+    }
+
+    int padded_width = (width + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+    if (padded_width > g_tables.padded_width) {
+        float* ray_sin = (float*)realloc(g_tables.ray_sin, (size_t)padded_width * sizeof(float));
+        if (!ray_sin) {
+            printf("ERROR: Failed to allocate camera tables (%d columns)\n", width);
+            return 0;
+        }
+        g_tables.ray_sin = ray_sin;
+
+        float* ray_cos = (float*)realloc(g_tables.ray_cos, (size_t)padded_width * sizeof(float));
+        if (!ray_cos) {
+            printf("ERROR: Failed to allocate camera tables (%d columns)\n", width);
+            return 0;
+        }
+        g_tables.ray_cos = ray_cos;
+
+        float* ray_slope = (float*)realloc(g_tables.ray_slope, (size_t)padded_width * sizeof(float));
+        if (!ray_slope) {
+            printf("ERROR: Failed to allocate camera tables (%d columns)\n", width);
+            return 0;
+        }
+        g_tables.ray_slope = ray_slope;
+    }
+
+    // Column x looks at -fov/2 + x * step from the view direction
+    const float fov_radians = CAMERA_FOV_DEGREES * (M_PI / 180.0f);
+    const float start_angle = -(fov_radians * 0.5f);
+    const float angle_step = fov_radians / (float)width;
+
+    for (int x = 0; x < padded_width; ++x) {
+        int column = x < width ? x : width - 1;
+        float angle = start_angle + column * angle_step;
+        g_tables.ray_sin[x] = sinf(angle);
+        g_tables.ray_cos[x] = cosf(angle);
+        g_tables.ray_slope[x] = tanf(angle);
+    }
+
+    g_tables.width = width;
+    g_tables.padded_width = padded_width;
+    g_tables_valid = 1;
+    return 1;
+}
+
+const CameraTables* camera_get_tables(void) {
+    return g_tables_valid ? &g_tables : NULL;
+}
+
+// Release the tables
+void camera_tables_free(void) {
+    free(g_tables.ray_sin);
+    free(g_tables.ray_cos);
+    free(g_tables.ray_slope);
+    g_tables.ray_sin = NULL;
+    g_tables.ray_cos = NULL;
+    g_tables.ray_slope = NULL;
+    g_tables.width = 0;
+    g_tables.height = 0;
+    g_tables.padded_width = 0;
+    g_tables_valid = 0;
+}
@@ -0,0 +1,31 @@
+// Camera header - Per-viewport ray and projection tables
+// QuakeCloneWASM - Rendering system
+
+#ifndef CAMERA_H
+#define CAMERA_H
+
+// Horizontal field of view of the raycaster
+#define CAMERA_FOV_DEGREES 66.0f
+
+// Column tables in camera space (relative to the view direction). They depend
+// only on viewport width and FOV, so they are rebuilt on resize; a yaw change
+// rotates them instead of calling sinf/cosf per column.
+typedef struct {
+    int width;          // Viewport columns
+    int height;         // Viewport rows
+    int padded_width;   // width rounded up to SIMD_WIDTH; spare entries repeat the last column
+    float* ray_sin;     // sin of the column angle relative to the view direction
+    float* ray_cos;     // cos of the same angle (also the fisheye correction factor)
+    float* ray_slope;   // tan of the angle: lateral offset per unit of depth (floor casting)
+} CameraTables;
+
+// Rebuild the tables for a viewport (called by renderer_init/renderer_resize)
+int camera_tables_build(int width, int height);
+
+// Current tables (NULL until the first build)
+const CameraTables* camera_get_tables(void);
+
+// Release the tables
+void camera_tables_free(void);
+
+#endif // CAMERA_H
@@ -0,0 +1,274 @@
+// Collision implementation - Swept circle against grid, hashed broadphase
+// QuakeCloneWASM - Physics system
+//
+// A sweep along one axis visits the cell columns the circle's leading edge
+// crosses, nearest first, and in each the rows the circle covers across the
+// motion. A circle meets a cell either on the face (the cell's row range
+// contains the centre) or on a corner, where the contact is pulled back by
+// sqrt(r^2 - gap^2). Contacts in a nearer column always come first, so the
+// sweep ends at the first column with a hit.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "collision.h"
+
+// Largest query (in broadphase cells) answered by scanning buckets; bigger
+// ones test every mover
+#define MAX_QUERY_CELLS 64
+
+static int cell_solid(const CollisionGrid* grid, int axis, int a, int b) {
+    return axis == 0 ? grid->solid(a, b) : grid->solid(b, a);
+}
+
+// Distance a circle at (a, b) can travel by d along one axis (x when axis
+// is 0, z otherwise; b is the other coordinate), minus COLLISION_SKIN.
+// Sets *blocked when a cell cuts the move short.
+static float sweep_axis(const CollisionGrid* grid, int axis, float a, float b, float radius, float d, int* blocked) {
+    float cell = grid->cell_size;
+    float local_a = a - (axis == 0 ? grid->origin_x : grid->origin_z);
+    float local_b = b - (axis == 0 ? grid->origin_z : grid->origin_x);
+    float distance = fabsf(d);
+    int step = d > 0.0f ? 1 : -1;
+
+    // Rows the circle overlaps (a circle just touching a row does not)
+    int row_first = (int)floorf((local_b - radius) / cell);
+    int row_last = (int)ceilf((local_b + radius) / cell) - 1;
+
+    // Columns from the one under the leading edge to the one it reaches
+    float lead = local_a + (float)step * radius;
+    int column = (int)floorf(lead / cell);
+    int column_last = (int)floorf((lead + d) / cell);
+    int centre_a = (int)floorf(local_a / cell);
+    int centre_b = (int)floorf(local_b / cell);
+
+    for (;;) {
+        float travel = distance;
+        for (int row = row_first; row <= row_last; ++row) {
+            // A mover stuck inside a solid cell may walk out of it
+            if ((column == centre_a && row == centre_b) || !cell_solid(grid, axis, column, row)) {
+                continue;
+            }
+            float row_min = (float)row * cell;
+            float row_max = row_min + cell;
+            float gap = local_b < row_min ? row_min - local_b : (local_b > row_max ? local_b - row_max : 0.0f);
+            if (gap >= radius) {
+                continue;
+            }
+            float reach = gap > 0.0f ? sqrtf(radius * radius - gap * gap) : radius;
+            float contact = step > 0 ? (float)column * cell - reach - local_a
+                                     : local_a - ((float)(column + 1) * cell + reach);
+            contact -= COLLISION_SKIN;
+            if (contact < 0.0f) {
+                contact = 0.0f; // Already touching or overlapping: no deeper
+            }
+            if (contact < travel) {
+                travel = contact;
+            }
+        }
+        if (travel < distance) {
+            *blocked = 1;
+            return travel;
+        }
+        if (column == column_last) {
+            return distance;
+        }
+        column += step;
+    }
+}
+
+// Move a circle along x, then along z
+int collision_move(const CollisionGrid* grid, float radius, float* x, float* z, float dx, float dz) {
+    int result = 0;
+    if (dx != 0.0f) {
+        int blocked = 0;
+        float travel = sweep_axis(grid, 0, *x, *z, radius, dx, &blocked);
+        *x += dx > 0.0f ? travel : -travel;
+        result |= blocked ? COLLISION_BLOCKED_X : 0;
+    }
+    if (dz != 0.0f) {
+        int blocked = 0;
+        float travel = sweep_axis(grid, 1, *z, *x, radius, dz, &blocked);
+        *z += dz > 0.0f ? travel : -travel;
+        result |= blocked ? COLLISION_BLOCKED_Z : 0;
+    }
+    return result;
+}
+
+// Circle against the solid cells it may touch
+int collision_overlaps(const CollisionGrid* grid, float x, float z, float radius) {
+    float cell = grid->cell_size;
+    float local_x = x - grid->origin_x;
+    float local_z = z - grid->origin_z;
+    int x0 = (int)floorf((local_x - radius) / cell);
+    int x1 = (int)floorf((local_x + radius) / cell);
+    int z0 = (int)floorf((local_z - radius) / cell);
+    int z1 = (int)floorf((local_z + radius) / cell);
+    for (int cz = z0; cz <= z1; ++cz) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            if (!grid->solid(cx, cz)) {
+                continue;
+            }
+            float min_x = (float)cx * cell;
+            float min_z = (float)cz * cell;
+            float near_x = local_x < min_x ? min_x : (local_x > min_x + cell ? min_x + cell : local_x);
+            float near_z = local_z < min_z ? min_z : (local_z > min_z + cell ? min_z + cell : local_z);
+            float gap_x = local_x - near_x;
+            float gap_z = local_z - near_z;
+            if (gap_x * gap_x + gap_z * gap_z < radius * radius) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Broadphase cell to bucket (spatial hash; cells are unbounded)
+static uint32_t bucket_of(const CollisionBroadphase* broadphase, int cell_x, int cell_z) {
+    return (((uint32_t)cell_x * 73856093u) ^ ((uint32_t)cell_z * 19349663u)) & broadphase->bucket_mask;
+}
+
+static int cell_of(const CollisionBroadphase* broadphase, float c) {
+    return (int)floorf(c / broadphase->cell_size);
+}
+
+int collision_broadphase_init(CollisionBroadphase* broadphase, int capacity, float cell_size) {
+    uint32_t buckets = 1;
+    while (buckets < (uint32_t)capacity * 2) {
+        buckets <<= 1;
+    }
+    broadphase->cell_size = cell_size;
+    broadphase->capacity = capacity;
+    broadphase->count = 0;
+    broadphase->max_radius = 0.0f;
+    broadphase->bucket_mask = buckets - 1;
+    broadphase->bucket_limit = buckets - 1;
+    broadphase->bucket_start = (int*)malloc((buckets + 1) * sizeof(int));
+    broadphase->entries = (int*)malloc((size_t)capacity * sizeof(int));
+    broadphase->mover_bucket = (int*)malloc((size_t)capacity * sizeof(int));
+    broadphase->x = NULL;
+    broadphase->z = NULL;
+    broadphase->radius = NULL;
+    if (!broadphase->bucket_start || !broadphase->entries || !broadphase->mover_bucket) {
+        printf("ERROR: Failed to allocate broadphase for %d movers\n", capacity);
+        collision_broadphase_destroy(broadphase);
+        return 0;
+    }
+    return 1;
+}
+
+// Counting sort of the movers by bucket. The bucket table follows the
+// mover count, so a few movers in a large broadphase clear a small table.
+void collision_broadphase_build(CollisionBroadphase* broadphase, const float* x, const float* z,
+                                const float* radius, int count) {
+    int* start = broadphase->bucket_start;
+    if (count > broadphase->capacity) {
+        count = broadphase->capacity;
+    }
+    uint32_t buckets = 1;
+    while (buckets < (uint32_t)count * 2 && buckets <= broadphase->bucket_limit) {
+        buckets <<= 1;
+    }
+    broadphase->bucket_mask = buckets - 1;
+    broadphase->count = count;
+    broadphase->x = x;
+    broadphase->z = z;
+    broadphase->radius = radius;
+
+    for (uint32_t b = 0; b <= buckets; ++b) {
+        start[b] = 0;
+    }
+    float max_radius = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        int b = (int)bucket_of(broadphase, cell_of(broadphase, x[i]), cell_of(broadphase, z[i]));
+        broadphase->mover_bucket[i] = b;
+        start[b + 1]++;
+        if (radius[i] > max_radius) {
+            max_radius = radius[i];
+        }
+    }
+    broadphase->max_radius = max_radius;
+    for (uint32_t b = 0; b < buckets; ++b) {
+        start[b + 1] += start[b];
+    }
+    // Scatter with each bucket's start as its cursor (leaving it at the
+    // next bucket's start), then shift the starts back into place
+    for (int i = 0; i < count; ++i) {
+        int b = broadphase->mover_bucket[i];
+        broadphase->entries[start[b]++] = i;
+    }
+    for (uint32_t b = buckets; b > 0; --b) {
+        start[b] = start[b - 1];
+    }
+    start[0] = 0;
+}
+
+// Test one mover against the query circle
+static int overlaps_mover(const CollisionBroadphase* broadphase, int i, float x, float z, float radius) {
+    float dx = broadphase->x[i] - x;
+    float dz = broadphase->z[i] - z;
+    float reach = broadphase->radius[i] + radius;
+    return dx * dx + dz * dz < reach * reach;
+}
+
+int collision_broadphase_query(const CollisionBroadphase* broadphase, float x, float z, float radius,
+                               int exclude, int* results, int max_results) {
+    int found = 0;
+    float reach = radius + broadphase->max_radius;
+    int x0 = cell_of(broadphase, x - reach);
+    int x1 = cell_of(broadphase, x + reach);
+    int z0 = cell_of(broadphase, z - reach);
+    int z1 = cell_of(broadphase, z + reach);
+
+    long cells = (long)(x1 - x0 + 1) * (long)(z1 - z0 + 1);
+    if (cells > MAX_QUERY_CELLS || cells > (long)broadphase->bucket_mask + 1) {
+        for (int i = 0; i < broadphase->count; ++i) {
+            if (i != exclude && overlaps_mover(broadphase, i, x, z, radius)) {
+                if (found < max_results) {
+                    results[found] = i;
+                }
+                found++;
+            }
+        }
+        return found;
+    }
+
+    // Different cells can share a bucket; scan each bucket once
+    uint32_t visited[MAX_QUERY_CELLS];
+    int visited_count = 0;
+    for (int cz = z0; cz <= z1; ++cz) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            uint32_t b = bucket_of(broadphase, cx, cz);
+            int seen = 0;
+            for (int v = 0; v < visited_count; ++v) {
+                seen |= visited[v] == b;
+            }
+            if (seen) {
+                continue;
+            }
+            visited[visited_count++] = b;
+
+            for (int e = broadphase->bucket_start[b]; e < broadphase->bucket_start[b + 1]; ++e) {
+                int i = broadphase->entries[e];
+                if (i != exclude && overlaps_mover(broadphase, i, x, z, radius)) {
+                    if (found < max_results) {
+                        results[found] = i;
+                    }
+                    found++;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+void collision_broadphase_destroy(CollisionBroadphase* broadphase) {
+    free(broadphase->bucket_start);
+    free(broadphase->entries);
+    free(broadphase->mover_bucket);
+    broadphase->bucket_start = NULL;
+    broadphase->entries = NULL;
+    broadphase->mover_bucket = NULL;
+    broadphase->capacity = 0;
+    broadphase->count = 0;
+}
@@ -0,0 +1,77 @@
+// Collision header - Swept circles against the map grid, and a broadphase
+// QuakeCloneWASM - Physics system
+//
+// Movers are circles on the ground plane. collision_move sweeps one along
+// each axis in turn against the solid cells of a grid, stopping at the
+// first contact and keeping the other axis's motion, so movers slide along
+// walls and cannot pass through them however far they move in one step.
+// The broadphase buckets many movers into a hashed uniform grid once per
+// tick, so finding the movers near a point costs a few bucket scans.
+
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <stdint.h>
+
+// Non-zero when grid cell (x, z) is solid (cells outside a map should be)
+typedef int (*CollisionCellFunc)(int x, int z);
+
+// Grid of square cells; cell (0, 0) spans [origin, origin + cell_size) on
+// both axes, in world units
+typedef struct {
+    CollisionCellFunc solid;
+    float origin_x, origin_z;
+    float cell_size;
+} CollisionGrid;
+
+// Gap left between a mover and the wall it stops against, in world units
+#define COLLISION_SKIN 0.001f
+
+// collision_move result flags
+#define COLLISION_BLOCKED_X 1
+#define COLLISION_BLOCKED_Z 2
+
+// Move a circle of the given radius at (*x, *z) by (dx, dz): along x first,
+// then along z from where the x sweep ended. Each axis stops at its first
+// contact; a mover already overlapping a wall may move away from it but not
+// deeper. Returns COLLISION_BLOCKED_* flags for the axes that were cut short.
+int collision_move(const CollisionGrid* grid, float radius, float* x, float* z, float dx, float dz);
+
+// 1 if a circle at (x, z) overlaps a solid cell
+int collision_overlaps(const CollisionGrid* grid, float x, float z, float radius);
+
+// Movers bucketed by the grid cell holding their centre. Positions are
+// read from the caller's arrays, which must stay unchanged until the next
+// build.
+typedef struct {
+    float cell_size;        // Bucket cell size (world units)
+    int capacity;           // Movers the buffers hold
+    int count;              // Movers in the last build
+    float max_radius;       // Largest radius in the last build
+    uint32_t bucket_mask;   // Buckets in use - 1 (a power of two, about 2 per mover of the last build)
+    uint32_t bucket_limit;  // Buckets allocated - 1
+    int* bucket_start;      // Per bucket: first entry (bucket_limit + 2 values)
+    int* entries;           // Mover indices grouped by bucket
+    int* mover_bucket;      // Bucket of each mover
+    const float* x;
+    const float* z;
+    const float* radius;
+} CollisionBroadphase;
+
+// Allocate for up to capacity movers; cell_size should be about the
+// diameter of a typical mover. Returns 0 on failure.
+int collision_broadphase_init(CollisionBroadphase* broadphase, int capacity, float cell_size);
+
+// Bucket count movers (count <= capacity); linear time
+void collision_broadphase_build(CollisionBroadphase* broadphase, const float* x, const float* z,
+                                const float* radius, int count);
+
+// Movers whose circles overlap a circle at (x, z), except mover exclude
+// (-1 for none). Up to max_results indices are written; returns how many
+// overlap in total.
+int collision_broadphase_query(const CollisionBroadphase* broadphase, float x, float z, float radius,
+                               int exclude, int* results, int max_results);
+
+void collision_broadphase_destroy(CollisionBroadphase* broadphase);
+
+#endif // COLLISION_H
@@ -0,0 +1,107 @@
+// Colormap implementation - Light and fog tables per atmosphere
+// QuakeCloneWASM - Rendering system
+//
+// Every level darkens a channel by the light falloff the walls have always
+// used, then mixes it with the fog colour by exponential-squared fog. The
+// tables are rebuilt only when the world switches planets.
+
+#include <math.h>
+#include "colormap.h"
+
+static float clamp01(float value) {
+    if (value < 0.0f) return 0.0f;
+    if (value > 1.0f) return 1.0f;
+    return value;
+}
+
+// Brightness at a share t of the visible distance: a linear falloff to
+// 35%, plus a further fade over the last 30%
+static float light_at(float t) {
+    float light = 1.0f - t * 0.65f;
+    if (light < 0.25f) light = 0.25f;
+    if (t > 0.7f) {
+        light *= 1.0f - (t - 0.7f) / 0.3f * 0.3f;
+    }
+    return light;
+}
+
+// Colour and density of a planet's air: a base per atmosphere type,
+// tinted and thickened towards the hot (glowing haze) and cold (ice
+// crystal) extremes of surface temperature
+static float planet_fog(const PlanetData* planet, float rgb[3]) {
+    static const float base[4][3] = {
+        { 0.0f, 0.0f, 0.0f },           // None
+        { 170.0f, 140.0f, 110.0f },     // Thin: dust
+        { 165.0f, 185.0f, 205.0f },     // Breathable: blue haze
+        { 185.0f, 165.0f, 80.0f },      // Toxic: sulphur
+    };
+    static const float base_density[4] = { 0.0f, 0.6f, 1.0f, 1.8f };
+    static const float hot[3] = { 215.0f, 105.0f, 45.0f };
+    static const float cold[3] = { 150.0f, 185.0f, 225.0f };
+
+    int type = planet ? planet->atmosphere_type : 0;
+    if (type < 0 || type > 3) {
+        type = 0;
+    }
+    if (type == 0) {
+        rgb[0] = rgb[1] = rgb[2] = 0.0f;
+        return 0.0f;
+    }
+
+    float heat = clamp01((planet->surface_temp_k - 320.0f) / 900.0f);
+    float chill = clamp01((230.0f - planet->surface_temp_k) / 180.0f);
+    for (int c = 0; c < 3; ++c) {
+        rgb[c] = base[type][c] + (hot[c] - base[type][c]) * heat + (cold[c] - base[type][c]) * chill;
+    }
+    return base_density[type] * (1.0f + 0.3f * (heat > chill ? heat : chill));
+}
+
+void colormap_build(Colormap* map, const PlanetData* planet, float max_distance) {
+    float fog[3];
+    float density = planet_fog(planet, fog);
+
+    map->fog_density = density;
+    map->fog_color = 0xFF000000u | ((uint32_t)fog[0] << 16) | ((uint32_t)fog[1] << 8) | (uint32_t)fog[2];
+    map->levels_per_unit = (float)COLORMAP_LEVELS / max_distance;
+
+    for (int level = 0; level < COLORMAP_LEVELS; ++level) {
+        float t = ((float)level + 0.5f) / (float)COLORMAP_LEVELS;
+        float fog_share = 1.0f - expf(-(density * t) * (density * t));
+        ColormapLevel* entry = &map->levels[level];
+        entry->scale = (uint32_t)(light_at(t) * (1.0f - fog_share) * 256.0f + 0.5f);
+        for (int c = 0; c < 3; ++c) {
+            // Never past 255 for a full channel, despite the rounding
+            uint32_t offset = (uint32_t)(fog[c] * fog_share * 256.0f) + 128;
+            uint32_t limit = 255 * 256 + 255 - 255 * entry->scale;
+            entry->offset[c] = offset < limit ? offset : limit;
+        }
+        map->fog_weight[level] = (uint8_t)(fog_share * 255.0f + 0.5f);
+    }
+}
+
+// Plain loop over independent texels: compilers vectorize it (SSE/AVX,
+// wasm SIMD), which three table loads per texel would prevent
+void colormap_shade_strip(const ColormapLevel* level, uint32_t* dest, const uint32_t* source, int count) {
+    uint32_t scale = level->scale;
+    uint32_t red = level->offset[0];
+    uint32_t green = level->offset[1];
+    uint32_t blue = level->offset[2];
+    for (int i = 0; i < count; ++i) {
+        uint32_t texel = source[i];
+        uint32_t r = (((texel >> 16) & 0xFF) * scale + red) >> 8;
+        uint32_t g = (((texel >> 8) & 0xFF) * scale + green) >> 8;
+        uint32_t b = ((texel & 0xFF) * scale + blue) >> 8;
+        dest[i] = 0xFF000000u | (r << 16) | (g << 8) | b;
+    }
+}
+
+uint32_t colormap_fog(const Colormap* map, int level, uint32_t color) {
+    int weight = map->fog_weight[level];
+    uint32_t result = 0xFF000000u;
+    for (int shift = 0; shift <= 16; shift += 8) {
+        int value = (int)((color >> shift) & 0xFF);
+        int fog = (int)((map->fog_color >> shift) & 0xFF);
+        result |= (uint32_t)(value + ((fog - value) * weight + 127) / 255) << shift;
+    }
+    return result;
+}
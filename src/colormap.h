@@ -0,0 +1,69 @@
+// Colormap header - Precomputed distance shading and atmospheric fog
+// QuakeCloneWASM - Rendering system
+//
+// Doom-style colormaps for a true-colour framebuffer: the light falloff
+// and fog of every light level are precomputed, so shading a texel is a
+// table entry applied to it instead of float shade and fade arithmetic.
+// Light plus fog is affine in each channel, so a level's whole colormap
+// reduces to one integer scale and a fog offset per channel (the 256-entry
+// ramps of a palette colormap would cost three dependent loads a texel and
+// keep the strips from vectorizing). Light levels step with distance; the
+// darker faces of a wall add a fixed offset (the "fake contrast" between
+// north/south and east/west). A planet with an atmosphere gets its own
+// table, fogging distant walls, sprites and floor rows towards the colour
+// of its air.
+
+#ifndef COLORMAP_H
+#define COLORMAP_H
+
+#include <stdint.h>
+#include "space.h"
+
+// Light levels from nearest (0) to the farthest visible distance
+#define COLORMAP_LEVELS 64
+
+// Levels added for the darker wall faces
+#define COLORMAP_SIDE_LEVELS 6
+
+// What a light level does to a channel value c: (c * scale + offset) >> 8
+typedef struct {
+    uint32_t scale;         // Light times the unfogged share, in 1/256
+    uint32_t offset[3];     // Red, green and blue fog added, in 1/256 (with rounding)
+} ColormapLevel;
+
+typedef struct {
+    ColormapLevel levels[COLORMAP_LEVELS];
+    uint8_t fog_weight[COLORMAP_LEVELS];   // Fog share of every level in 1/255
+    uint32_t fog_color;
+    float fog_density;                     // 0: no atmosphere
+    float levels_per_unit;
+} Colormap;
+
+// Build the table for a planet's atmosphere (NULL: no fog, as inside
+// the spaceship), reaching the last level at max_distance
+void colormap_build(Colormap* map, const PlanetData* planet, float max_distance);
+
+// Light level of a surface at a distance
+static inline int colormap_level(const Colormap* map, float distance) {
+    int level = (int)(distance * map->levels_per_unit);
+    if (level < 0) level = 0;
+    if (level > COLORMAP_LEVELS - 1) level = COLORMAP_LEVELS - 1;
+    return level;
+}
+
+// One colour through one level
+static inline uint32_t colormap_shade(const ColormapLevel* level, uint32_t color) {
+    uint32_t r = (((color >> 16) & 0xFF) * level->scale + level->offset[0]) >> 8;
+    uint32_t g = (((color >> 8) & 0xFF) * level->scale + level->offset[1]) >> 8;
+    uint32_t b = ((color & 0xFF) * level->scale + level->offset[2]) >> 8;
+    return 0xFF000000u | (r << 16) | (g << 8) | b;
+}
+
+// Shade count texels from source into dest at one level
+void colormap_shade_strip(const ColormapLevel* level, uint32_t* dest, const uint32_t* source, int count);
+
+// Blend a colour towards the fog by a level's fog share only (for colours
+// that already carry their own lighting, like the sky and floor gradient)
+uint32_t colormap_fog(const Colormap* map, int level, uint32_t color);
+
+#endif // COLORMAP_H
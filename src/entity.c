@@ -0,0 +1,242 @@
+// Entity implementation - SoA storage, wandering behaviour, spatial hash
+// QuakeCloneWASM - Entity system
+//
+// The tick runs in two passes: entities decide and move in parallel ranges
+// (each touches only its own fields and reads the map), then the spatial
+// hash is rebuilt with one counting sort (collision.c's broadphase with
+// map-cell buckets). Both passes are linear in the entity count.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "jobs.h"
+#include "world.h"
+#include "entity.h"
+
+// Walking speed of wandering entities, in world units per second
+#define WANDER_SPEED 2.5f
+
+// Entities moved per job range
+#define TICK_GRAIN 1024
+
+static EntityData g_entities;
+static EntityStats g_stats;
+static CollisionBroadphase g_hash;
+static int g_hash_dirty = 1;    // Entities spawned or removed since the last build
+
+typedef struct {
+    CollisionGrid grid;
+    float dt;
+} TickContext;
+
+static uint32_t next_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void free_arrays(void) {
+    free(g_entities.x);
+    free(g_entities.z);
+    free(g_entities.vel_x);
+    free(g_entities.vel_z);
+    free(g_entities.radius);
+    free(g_entities.timer);
+    free(g_entities.state);
+    free(g_entities.cell_x);
+    free(g_entities.cell_z);
+    free(g_entities.random);
+    memset(&g_entities, 0, sizeof(g_entities));
+}
+
+// Allocate the arrays and the hash
+int entity_init(int capacity) {
+    entity_shutdown();
+    size_t n = (size_t)capacity;
+    g_entities.x = (float*)malloc(n * sizeof(float));
+    g_entities.z = (float*)malloc(n * sizeof(float));
+    g_entities.vel_x = (float*)malloc(n * sizeof(float));
+    g_entities.vel_z = (float*)malloc(n * sizeof(float));
+    g_entities.radius = (float*)malloc(n * sizeof(float));
+    g_entities.timer = (float*)malloc(n * sizeof(float));
+    g_entities.state = (uint8_t*)malloc(n);
+    g_entities.cell_x = (int32_t*)malloc(n * sizeof(int32_t));
+    g_entities.cell_z = (int32_t*)malloc(n * sizeof(int32_t));
+    g_entities.random = (uint32_t*)malloc(n * sizeof(uint32_t));
+    if (!g_entities.x || !g_entities.z || !g_entities.vel_x || !g_entities.vel_z || !g_entities.radius ||
+        !g_entities.timer || !g_entities.state || !g_entities.cell_x || !g_entities.cell_z || !g_entities.random) {
+        printf("ERROR: Failed to allocate %d entities\n", capacity);
+        free_arrays();
+        return 0;
+    }
+
+    // Buckets are map cells
+    CollisionGrid grid;
+    world_get_collision_grid(&grid);
+    if (!collision_broadphase_init(&g_hash, capacity, grid.cell_size)) {
+        free_arrays();
+        return 0;
+    }
+    g_entities.capacity = capacity;
+    g_hash_dirty = 1;
+    return 1;
+}
+
+// Start walking in one of 65536 directions
+static void set_heading(int i, uint32_t direction) {
+    float heading = (float)(direction & 0xFFFF) * (6.2831853f / 65536.0f);
+    g_entities.state[i] = ENTITY_WANDER;
+    g_entities.vel_x[i] = cosf(heading) * WANDER_SPEED;
+    g_entities.vel_z[i] = sinf(heading) * WANDER_SPEED;
+}
+
+// Pick a new state, heading and duration
+static void decide(int i) {
+    uint32_t r = next_random(&g_entities.random[i]);
+    g_entities.timer[i] = 1.0f + (float)(r & 0xFF) * (4.0f / 256.0f);
+    if (((r >> 8) & 3) == 0) {
+        g_entities.state[i] = ENTITY_IDLE;
+        g_entities.vel_x[i] = 0.0f;
+        g_entities.vel_z[i] = 0.0f;
+        return;
+    }
+    set_heading(i, r >> 16);
+}
+
+static void update_cell(int i, float cell_size) {
+    g_entities.cell_x[i] = (int32_t)floorf(g_entities.x[i] / cell_size);
+    g_entities.cell_z[i] = (int32_t)floorf(g_entities.z[i] / cell_size);
+}
+
+// Add an entity
+int entity_spawn(float x, float z, float radius, EntityState state, uint32_t seed) {
+    if (g_entities.count >= g_entities.capacity) {
+        return -1;
+    }
+    int i = g_entities.count++;
+    g_entities.x[i] = x;
+    g_entities.z[i] = z;
+    g_entities.radius[i] = radius;
+    g_entities.random[i] = seed ? seed : 0x9E3779B9u;
+    decide(i);
+    if (state == ENTITY_IDLE) {
+        g_entities.state[i] = ENTITY_IDLE;
+        g_entities.vel_x[i] = 0.0f;
+        g_entities.vel_z[i] = 0.0f;
+    } else if (g_entities.state[i] != ENTITY_WANDER) {
+        set_heading(i, next_random(&g_entities.random[i]));
+    }
+    update_cell(i, g_hash.cell_size);
+    g_hash_dirty = 1;
+    return i;
+}
+
+// Remove an entity by moving the last one into its place
+void entity_despawn(int index) {
+    if (index < 0 || index >= g_entities.count) {
+        return;
+    }
+    int last = --g_entities.count;
+    g_entities.x[index] = g_entities.x[last];
+    g_entities.z[index] = g_entities.z[last];
+    g_entities.vel_x[index] = g_entities.vel_x[last];
+    g_entities.vel_z[index] = g_entities.vel_z[last];
+    g_entities.radius[index] = g_entities.radius[last];
+    g_entities.timer[index] = g_entities.timer[last];
+    g_entities.state[index] = g_entities.state[last];
+    g_entities.cell_x[index] = g_entities.cell_x[last];
+    g_entities.cell_z[index] = g_entities.cell_z[last];
+    g_entities.random[index] = g_entities.random[last];
+    g_hash_dirty = 1;
+}
+
+void entity_clear(void) {
+    g_entities.count = 0;
+    g_hash_dirty = 1;
+}
+
+// Job range: decide, move and re-cell entities [begin, end)
+static void tick_range(void* user_data, int begin, int end, int thread_index) {
+    (void)thread_index;
+    const TickContext* ctx = (const TickContext*)user_data;
+    float dt = ctx->dt;
+    for (int i = begin; i < end; ++i) {
+        g_entities.timer[i] -= dt;
+        if (g_entities.timer[i] <= 0.0f) {
+            decide(i);
+        }
+        if (g_entities.state[i] != ENTITY_WANDER) {
+            continue;
+        }
+        int blocked = collision_move(&ctx->grid, g_entities.radius[i], &g_entities.x[i], &g_entities.z[i],
+                                     g_entities.vel_x[i] * dt, g_entities.vel_z[i] * dt);
+        // Bounce off walls
+        if (blocked & COLLISION_BLOCKED_X) {
+            g_entities.vel_x[i] = -g_entities.vel_x[i];
+        }
+        if (blocked & COLLISION_BLOCKED_Z) {
+            g_entities.vel_z[i] = -g_entities.vel_z[i];
+        }
+        update_cell(i, ctx->grid.cell_size);
+    }
+}
+
+static void rebuild_hash(void) {
+    collision_broadphase_build(&g_hash, g_entities.x, g_entities.z, g_entities.radius, g_entities.count);
+    g_hash_dirty = 0;
+}
+
+// Advance every entity and rebuild the hash
+void entity_tick(float dt) {
+    if (g_entities.count == 0) {
+        return;
+    }
+    double start = platform_now_ms();
+    TickContext ctx;
+    world_get_collision_grid(&ctx.grid);
+    ctx.dt = dt;
+    jobs_parallel_for(g_entities.count, TICK_GRAIN, tick_range, &ctx);
+    double moved = platform_now_ms();
+    rebuild_hash();
+    double end = platform_now_ms();
+
+    g_stats.move_ms = moved - start;
+    g_stats.hash_ms = end - moved;
+    g_stats.tick_ms = end - start;
+}
+
+// Radius query through the hash (as of the last tick, or rebuilt after
+// spawns and removals)
+int entity_query_radius(float x, float z, float radius, int exclude, int* results, int max_results) {
+    if (g_hash_dirty) {
+        rebuild_hash();
+    }
+    return collision_broadphase_query(&g_hash, x, z, radius, exclude, results, max_results);
+}
+
+int entity_query_neighbours(int index, float range, int* results, int max_results) {
+    if (index < 0 || index >= g_entities.count) {
+        return 0;
+    }
+    return entity_query_radius(g_entities.x[index], g_entities.z[index], range, index, results, max_results);
+}
+
+const EntityData* entity_get_data(void) {
+    return &g_entities;
+}
+
+const EntityStats* entity_get_stats(void) {
+    return &g_stats;
+}
+
+void entity_shutdown(void) {
+    free_arrays();
+    collision_broadphase_destroy(&g_hash);
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_hash_dirty = 1;
+}
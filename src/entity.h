@@ -0,0 +1,77 @@
+// Entity header - Moving agents stored as structure of arrays
+// QuakeCloneWASM - Entity system
+//
+// Every field lives in its own array indexed by entity, so the tick streams
+// through the few fields it needs. Entities are circles on the ground; each
+// tick they move through the active map with collision_move and are
+// bucketed by map cell into a spatial hash for neighbour and radius queries.
+// Positions are in world units; cells are map cells in world coordinates
+// (world position / cell size, so the same on bounded maps and surfaces).
+
+#ifndef ENTITY_H
+#define ENTITY_H
+
+#include <stdint.h>
+
+// Entities the world allocates room for
+#define ENTITY_DEFAULT_CAPACITY 16384
+
+// Behaviour states
+typedef enum {
+    ENTITY_IDLE = 0,        // Stands still until its timer runs out
+    ENTITY_WANDER = 1       // Walks in a straight line, turning at walls
+} EntityState;
+
+// Entity fields; valid up to count, read-only outside entity.c
+typedef struct {
+    int count;
+    int capacity;
+    float* x;
+    float* z;
+    float* vel_x;           // World units per second
+    float* vel_z;
+    float* radius;
+    float* timer;           // Seconds until the next decision
+    uint8_t* state;         // EntityState
+    int32_t* cell_x;        // Map cell holding the entity (updated by the tick)
+    int32_t* cell_z;
+    uint32_t* random;       // Per-entity generator, so ticks are deterministic
+} EntityData;
+
+// Tick timings
+typedef struct {
+    double tick_ms;         // Last entity_tick
+    double move_ms;         // Decisions and collision
+    double hash_ms;         // Spatial hash rebuild
+} EntityStats;
+
+// Allocate room for capacity entities. Returns 0 on failure.
+int entity_init(int capacity);
+
+// Add an entity at (x, z); returns its index, or -1 when full
+int entity_spawn(float x, float z, float radius, EntityState state, uint32_t seed);
+
+// Remove an entity; the last entity takes over its index
+void entity_despawn(int index);
+
+// Remove every entity (the active map changed)
+void entity_clear(void);
+
+// Advance every entity by dt seconds and rebuild the spatial hash. Cost is
+// linear in the entity count; the moves run on the job pool.
+void entity_tick(float dt);
+
+// Entities whose circles overlap a circle at (x, z), except exclude (-1 for
+// none). Writes up to max_results indices; returns how many overlap.
+int entity_query_radius(float x, float z, float radius, int exclude, int* results, int max_results);
+
+// Entities whose circles come within range of entity index's centre (not
+// counting itself). Queries see positions as of the last tick.
+int entity_query_neighbours(int index, float range, int* results, int max_results);
+
+const EntityData* entity_get_data(void);
+const EntityStats* entity_get_stats(void);
+
+void entity_shutdown(void);
+
+#endif // ENTITY_H
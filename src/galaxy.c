@@ -0,0 +1,478 @@
+// Galaxy implementation - Sector counts, system generation, sector cache
+// QuakeCloneWASM - Space exploration
+//
+// Everything about a system is a function of (seed, sector, index in the
+// sector); the cache only keeps the positions the queries scan, packed to
+// six bytes per system.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "galaxy.h"
+
+#define HALF_SECTORS (GALAXY_SECTORS / 2)
+#define LOCAL_SCALE (GALAXY_SECTOR_SIZE / 65536.0f)   // Light years per offset unit
+#define HEIGHT_SCALE (1.0f / 16.0f)                    // Light years per height unit
+
+// Disc profile in half-sector units (squared radius from the centre)
+#define DISC_RADIUS2 16384          // 64 sectors
+#define DISC_CORE2 2048             // Density halves about 23 sectors out
+#define DISC_PEAK 896               // Systems in a core sector
+
+#define SALT_SYSTEM 0x5EC70A11u
+#define SALT_HEIGHT 0x4E16B7C3u
+#define SALT_PLANET 0x9E3779B9u
+
+static uint32_t g_seed = 0;
+static uint32_t g_first[GALAXY_SECTOR_COUNT + 1]; // First id of every sector
+static int g_initialized = 0;
+
+// Sector cache: slot s holds its sector's systems from s * MAX_SECTOR_SYSTEMS
+static int16_t g_sector_slot[GALAXY_SECTOR_COUNT];
+static int32_t* g_slot_sector = NULL;
+static uint64_t* g_slot_used = NULL;
+static uint16_t* g_local_x = NULL;
+static uint16_t* g_local_z = NULL;
+static int16_t* g_height = NULL;
+static uint64_t g_clock = 0;
+
+static GalaxyStats g_stats;
+
+static uint32_t mix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+static uint32_t lattice_hash(uint32_t seed, uint32_t x, uint32_t z) {
+    return mix32(seed ^ mix32(x ^ mix32(z + 0x9E3779B9u)));
+}
+
+// Squared distance of a sector's centre from the galactic centre, in
+// half sectors (integers, so counts and ids match on every platform)
+static int sector_radius2(int sx, int sz) {
+    int dx = 2 * sx - (GALAXY_SECTORS - 1);
+    int dz = 2 * sz - (GALAXY_SECTORS - 1);
+    return dx * dx + dz * dz;
+}
+
+static int sector_system_count(int sx, int sz) {
+    uint32_t h = lattice_hash(g_seed, (uint32_t)sx, (uint32_t)sz);
+    int r2 = sector_radius2(sx, sz);
+    if (r2 > DISC_RADIUS2) {
+        return (int)(h & 3); // Sparse halo
+    }
+    int base = DISC_PEAK * DISC_CORE2 / (DISC_CORE2 + r2);
+    return base * (896 + (int)((h >> 8) & 255)) / 1024;
+}
+
+static float sector_left(int sx) {
+    return (float)(sx - HALF_SECTORS) * GALAXY_SECTOR_SIZE;
+}
+
+// Systems of one sector: offsets in the sector and height above the disc.
+// The disc thins from about 2000 ly at the core to 450 ly at the rim.
+static void make_position(int sector, int index, uint16_t* local_x, uint16_t* local_z, int16_t* height) {
+    uint32_t h = lattice_hash(g_seed ^ SALT_SYSTEM, (uint32_t)sector, (uint32_t)index);
+    uint32_t v = mix32(h ^ SALT_HEIGHT);
+    int r2 = sector_radius2(sector % GALAXY_SECTORS, sector / GALAXY_SECTORS);
+    int thickness = 128 + 896 * DISC_CORE2 / (DISC_CORE2 + r2);
+    int y = ((int)(int16_t)(v & 0xFFFF) + (int)(int16_t)(v >> 16)) / 2;
+    *local_x = (uint16_t)(h & 0xFFFF);
+    *local_z = (uint16_t)(h >> 16);
+    *height = (int16_t)((y * thickness) >> 10);
+}
+
+static uint32_t system_seed(int sector, int index) {
+    return mix32(lattice_hash(g_seed ^ SALT_SYSTEM, (uint32_t)sector, (uint32_t)index) + SALT_PLANET);
+}
+
+// Sector holding id (binary search over the first ids)
+static int find_sector(uint32_t id) {
+    int low = 0, high = GALAXY_SECTOR_COUNT;
+    while (high - low > 1) {
+        int mid = (low + high) / 2;
+        if (g_first[mid] <= id) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+int galaxy_init(uint32_t seed, int cache_sectors) {
+    if (g_initialized) {
+        galaxy_shutdown();
+    }
+    if (cache_sectors <= 0) {
+        cache_sectors = GALAXY_DEFAULT_CACHE_SECTORS;
+    }
+    if (cache_sectors > INT16_MAX) {
+        cache_sectors = INT16_MAX;
+    }
+
+    size_t systems = (size_t)cache_sectors * GALAXY_MAX_SECTOR_SYSTEMS;
+    g_slot_sector = (int32_t*)malloc((size_t)cache_sectors * sizeof(int32_t));
+    g_slot_used = (uint64_t*)calloc((size_t)cache_sectors, sizeof(uint64_t));
+    g_local_x = (uint16_t*)malloc(systems * sizeof(uint16_t));
+    g_local_z = (uint16_t*)malloc(systems * sizeof(uint16_t));
+    g_height = (int16_t*)malloc(systems * sizeof(int16_t));
+    if (!g_slot_sector || !g_slot_used || !g_local_x || !g_local_z || !g_height) {
+        printf("ERROR: Failed to allocate the galaxy sector cache\n");
+        galaxy_shutdown();
+        return 0;
+    }
+
+    g_seed = seed;
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_stats.cache_sectors = cache_sectors;
+    g_stats.cache_bytes = (size_t)cache_sectors * (sizeof(int32_t) + sizeof(uint64_t))
+                        + systems * (2 * sizeof(uint16_t) + sizeof(int16_t));
+
+    uint32_t total = 0;
+    for (int sector = 0; sector < GALAXY_SECTOR_COUNT; ++sector) {
+        g_first[sector] = total;
+        total += (uint32_t)sector_system_count(sector % GALAXY_SECTORS, sector / GALAXY_SECTORS);
+    }
+    g_first[GALAXY_SECTOR_COUNT] = total;
+    g_stats.system_count = total;
+
+    g_initialized = 1;
+    galaxy_flush_cache();
+    printf("Galaxy initialized with %u star systems in %d sectors\n", total, GALAXY_SECTOR_COUNT);
+    return 1;
+}
+
+void galaxy_flush_cache(void) {
+    for (int i = 0; i < GALAXY_SECTOR_COUNT; ++i) {
+        g_sector_slot[i] = -1;
+    }
+    for (int s = 0; s < g_stats.cache_sectors; ++s) {
+        g_slot_sector[s] = -1;
+        g_slot_used[s] = 0;
+    }
+    g_stats.cached_sectors = 0;
+}
+
+// Slot holding a sector's systems, generating them into the least
+// recently used slot on a miss
+static int load_sector(int sector) {
+    g_stats.sector_lookups++;
+    int slot = g_sector_slot[sector];
+    if (slot < 0) {
+        slot = 0;
+        for (int s = 1; s < g_stats.cache_sectors && g_slot_used[slot] != 0; ++s) {
+            if (g_slot_used[s] < g_slot_used[slot]) {
+                slot = s;
+            }
+        }
+        if (g_slot_sector[slot] >= 0) {
+            g_sector_slot[g_slot_sector[slot]] = -1;
+        } else {
+            g_stats.cached_sectors++;
+        }
+        g_slot_sector[slot] = sector;
+        g_sector_slot[sector] = (int16_t)slot;
+
+        int count = (int)(g_first[sector + 1] - g_first[sector]);
+        size_t base = (size_t)slot * GALAXY_MAX_SECTOR_SYSTEMS;
+        for (int i = 0; i < count; ++i) {
+            make_position(sector, i, &g_local_x[base + i], &g_local_z[base + i], &g_height[base + i]);
+        }
+        g_stats.sectors_generated++;
+        g_stats.systems_generated += (uint64_t)count;
+    }
+    g_slot_used[slot] = ++g_clock;
+    return slot;
+}
+
+uint32_t galaxy_get_system_count(void) {
+    return g_initialized ? g_first[GALAXY_SECTOR_COUNT] : 0;
+}
+
+int galaxy_get_system(uint32_t id, GalaxySystem* system) {
+    if (!g_initialized || id >= g_first[GALAXY_SECTOR_COUNT]) {
+        return 0;
+    }
+    int sector = find_sector(id);
+    int index = (int)(id - g_first[sector]);
+    uint16_t local_x, local_z;
+    int16_t height;
+    make_position(sector, index, &local_x, &local_z, &height);
+
+    uint32_t seed = system_seed(sector, index);
+    // Main-sequence mix: mostly red dwarfs, one in 20000 a blue giant
+    static const uint16_t class_limits[GALAXY_STAR_CLASS_COUNT - 1] = { 2, 87, 480, 2446, 7426, 15356 };
+    int star_class = GALAXY_STAR_M;
+    for (int c = 0; c < GALAXY_STAR_CLASS_COUNT - 1; ++c) {
+        if ((seed & 0xFFFF) < class_limits[c]) {
+            star_class = c;
+            break;
+        }
+    }
+
+    system->id = id;
+    system->seed = seed;
+    system->x = sector_left(sector % GALAXY_SECTORS) + (float)local_x * LOCAL_SCALE;
+    system->y = (float)height * HEIGHT_SCALE;
+    system->z = sector_left(sector / GALAXY_SECTORS) + (float)local_z * LOCAL_SCALE;
+    system->star_class = star_class;
+    system->planet_count = (int)((seed >> 16) % (GALAXY_MAX_PLANETS + 1));
+    return 1;
+}
+
+int galaxy_get_system_name(uint32_t id, char* buffer, size_t size) {
+    static const char* syllables[32] = {
+        "al", "be", "cor", "da", "el", "fa", "gor", "hy", "is", "ju", "ka", "lo", "mi", "nor", "os", "pra",
+        "qua", "ri", "sa", "tau", "ul", "ve", "wy", "xa", "yo", "ze", "an", "ther", "cyg", "dra", "leo", "vin"
+    };
+    GalaxySystem system;
+    if (size == 0) {
+        return 0;
+    }
+    if (!galaxy_get_system(id, &system)) {
+        buffer[0] = '\0';
+        return 0;
+    }
+
+    uint32_t s = mix32(system.seed ^ 0xA511E9B3u);
+    char name[GALAXY_NAME_MAX];
+    int length = 0;
+    int parts = 2 + (int)(s & 1);
+    for (int i = 0; i < parts; ++i) {
+        const char* syllable = syllables[(s >> (1 + 5 * i)) & 31];
+        length += snprintf(name + length, sizeof(name) - (size_t)length, "%s", syllable);
+    }
+    name[0] = (char)(name[0] - 'a' + 'A');
+    // A quarter of the systems carry a catalogue number
+    if (((s >> 16) & 3) == 0) {
+        snprintf(name + length, sizeof(name) - (size_t)length, "-%u", 1 + (s >> 18) % 999);
+    }
+    return snprintf(buffer, size, "%s", name);
+}
+
+int galaxy_get_planet_name(uint32_t id, int index, char* buffer, size_t size) {
+    GalaxySystem system;
+    if (size == 0) {
+        return 0;
+    }
+    if (!galaxy_get_system(id, &system) || index < 0 || index >= system.planet_count) {
+        buffer[0] = '\0';
+        return 0;
+    }
+    char star[GALAXY_NAME_MAX];
+    galaxy_get_system_name(id, star, sizeof(star));
+    return snprintf(buffer, size, "%s %c", star, 'b' + index);
+}
+
+static float unit_from_bits(uint32_t bits, int shift) {
+    return (float)((bits >> shift) & 0xFF) / 255.0f;
+}
+
+int galaxy_get_planet(uint32_t id, int index, PlanetData* planet) {
+    static const float luminosity[GALAXY_STAR_CLASS_COUNT] = { 30000.0f, 800.0f, 20.0f, 3.0f, 1.0f, 0.3f, 0.03f };
+    GalaxySystem system;
+    if (!galaxy_get_system(id, &system) || index < 0 || index >= system.planet_count) {
+        return 0;
+    }
+    uint32_t p = mix32(system.seed + (uint32_t)(index + 1) * SALT_PLANET);
+    uint32_t q = mix32(p);
+    float light = luminosity[system.star_class];
+
+    memset(planet, 0, sizeof(*planet));
+    // Orbits widen geometrically from a star-dependent inner edge
+    planet->distance_au = 0.3f * sqrtf(light) * powf(1.8f, (float)index) * (0.8f + 0.4f * unit_from_bits(p, 0));
+    planet->radius_km = 2000.0f + 22000.0f * unit_from_bits(p, 8) * unit_from_bits(p, 8);
+    planet->atmosphere_type = planet->radius_km < 3000.0f ? 0 : (int)((p >> 16) & 3);
+    float temp = 278.0f * powf(light, 0.25f) / sqrtf(planet->distance_au);
+    if (planet->atmosphere_type == 2 && temp > 600.0f) {
+        planet->atmosphere_type = 3;
+    }
+    temp *= planet->atmosphere_type == 3 ? 1.6f : planet->atmosphere_type == 2 ? 1.1f : 1.0f;
+    planet->surface_temp_k = temp;
+    planet->gravity_g = planet->radius_km / 6371.0f * (0.6f + 0.6f * unit_from_bits(p, 24));
+    planet->has_water = planet->atmosphere_type >= 1 && temp > 180.0f && temp < 400.0f && ((q & 1) || (temp > 250.0f && temp < 350.0f));
+    planet->has_life = planet->has_water && planet->atmosphere_type == 2 && temp > 250.0f && temp < 330.0f && ((q >> 1) & 3) == 0;
+    planet->rotation_period_h = 6.0f + 200.0f * unit_from_bits(q, 8);
+    planet->resource_richness = (int)((q >> 16) % 101);
+    planet->map_offset_x = 16.0f;
+    planet->map_offset_z = 16.0f;
+    return 1;
+}
+
+// Squared distance from (x, z) to a sector's square (0 inside)
+static float sector_distance2(int sx, int sz, float x, float z) {
+    float left = sector_left(sx), top = sector_left(sz);
+    float dx = x < left ? left - x : (x > left + GALAXY_SECTOR_SIZE ? x - left - GALAXY_SECTOR_SIZE : 0.0f);
+    float dz = z < top ? top - z : (z > top + GALAXY_SECTOR_SIZE ? z - top - GALAXY_SECTOR_SIZE : 0.0f);
+    return dx * dx + dz * dz;
+}
+
+// Hits ordered by (squared distance, id); the nearest query keeps a
+// max-heap of the best so far in its hits array
+static int hit_after(const GalaxyHit* a, const GalaxyHit* b) {
+    return a->distance > b->distance || (a->distance == b->distance && a->id > b->id);
+}
+
+static void heap_sift_down(GalaxyHit* heap, int count, int i) {
+    for (;;) {
+        int largest = i;
+        int left = 2 * i + 1, right = left + 1;
+        if (left < count && hit_after(&heap[left], &heap[largest])) largest = left;
+        if (right < count && hit_after(&heap[right], &heap[largest])) largest = right;
+        if (largest == i) {
+            return;
+        }
+        GalaxyHit t = heap[i]; heap[i] = heap[largest]; heap[largest] = t;
+        i = largest;
+    }
+}
+
+static void heap_push(GalaxyHit* heap, int* count, int capacity, GalaxyHit hit) {
+    if (*count < capacity) {
+        int i = (*count)++;
+        heap[i] = hit;
+        while (i > 0 && hit_after(&heap[i], &heap[(i - 1) / 2])) {
+            GalaxyHit t = heap[i]; heap[i] = heap[(i - 1) / 2]; heap[(i - 1) / 2] = t;
+            i = (i - 1) / 2;
+        }
+    } else if (hit_after(&heap[0], &hit)) {
+        heap[0] = hit;
+        heap_sift_down(heap, *count, 0);
+    }
+}
+
+static void scan_sector_nearest(int sx, int sz, float x, float y, float z, GalaxyHit* heap, int* found, int count) {
+    if (*found == count && sector_distance2(sx, sz, x, z) > heap[0].distance) {
+        return; // Nothing in it can be closer
+    }
+    int sector = sz * GALAXY_SECTORS + sx;
+    int systems = (int)(g_first[sector + 1] - g_first[sector]);
+    if (systems == 0) {
+        return;
+    }
+    size_t base = (size_t)load_sector(sector) * GALAXY_MAX_SECTOR_SYSTEMS;
+    float left = sector_left(sx), top = sector_left(sz);
+    for (int i = 0; i < systems; ++i) {
+        float dx = left + (float)g_local_x[base + i] * LOCAL_SCALE - x;
+        float dy = (float)g_height[base + i] * HEIGHT_SCALE - y;
+        float dz = top + (float)g_local_z[base + i] * LOCAL_SCALE - z;
+        GalaxyHit hit = { g_first[sector] + (uint32_t)i, dx * dx + dy * dy + dz * dz };
+        heap_push(heap, found, count, hit);
+    }
+}
+
+static int clamp_sector(float coordinate) {
+    int s = (int)floorf(coordinate / GALAXY_SECTOR_SIZE) + HALF_SECTORS;
+    return s < 0 ? 0 : (s >= GALAXY_SECTORS ? GALAXY_SECTORS - 1 : s);
+}
+
+int galaxy_query_nearest(float x, float y, float z, int count, GalaxyHit* hits) {
+    if (!g_initialized || count <= 0) {
+        return 0;
+    }
+    int cx = clamp_sector(x), cz = clamp_sector(z);
+    int found = 0;
+
+    for (int r = 0; ; ++r) {
+        // The ring of sectors r away from the centre sector
+        for (int sz = cz - r; sz <= cz + r; ++sz) {
+            if (sz < 0 || sz >= GALAXY_SECTORS) {
+                continue;
+            }
+            int step = (sz == cz - r || sz == cz + r) ? 1 : 2 * r; // Edges only in between
+            for (int sx = cx - r; sx <= cx + r; sx += step) {
+                if (sx >= 0 && sx < GALAXY_SECTORS) {
+                    scan_sector_nearest(sx, sz, x, y, z, hits, &found, count);
+                }
+            }
+        }
+
+        // Unvisited sectors lie beyond the square's sides that still have
+        // sectors outside them
+        const float none = 1e30f;
+        float bound = none;
+        if (cx - r > 0) bound = fminf(bound, x - sector_left(cx - r));
+        if (cx + r < GALAXY_SECTORS - 1) bound = fminf(bound, sector_left(cx + r + 1) - x);
+        if (cz - r > 0) bound = fminf(bound, z - sector_left(cz - r));
+        if (cz + r < GALAXY_SECTORS - 1) bound = fminf(bound, sector_left(cz + r + 1) - z);
+        if (bound == none) {
+            break; // Every sector visited
+        }
+        bound = fmaxf(bound, 0.0f);
+        if (found == count && hits[0].distance <= bound * bound) {
+            break;
+        }
+    }
+
+    // Heap order to closest first
+    for (int n = found - 1; n > 0; --n) {
+        GalaxyHit t = hits[0]; hits[0] = hits[n]; hits[n] = t;
+        heap_sift_down(hits, n, 0);
+    }
+    for (int i = 0; i < found; ++i) {
+        hits[i].distance = sqrtf(hits[i].distance);
+    }
+    return found;
+}
+
+int galaxy_query_range(float x, float y, float z, float radius, GalaxyHit* hits, int max_hits) {
+    if (!g_initialized || radius < 0.0f) {
+        return 0;
+    }
+    int sx0 = clamp_sector(x - radius), sx1 = clamp_sector(x + radius);
+    int sz0 = clamp_sector(z - radius), sz1 = clamp_sector(z + radius);
+    float radius2 = radius * radius;
+    int found = 0;
+
+    for (int sz = sz0; sz <= sz1; ++sz) {
+        for (int sx = sx0; sx <= sx1; ++sx) {
+            int sector = sz * GALAXY_SECTORS + sx;
+            int systems = (int)(g_first[sector + 1] - g_first[sector]);
+            if (systems == 0 || sector_distance2(sx, sz, x, z) > radius2) {
+                continue;
+            }
+            size_t base = (size_t)load_sector(sector) * GALAXY_MAX_SECTOR_SYSTEMS;
+            float left = sector_left(sx), top = sector_left(sz);
+            for (int i = 0; i < systems; ++i) {
+                float dx = left + (float)g_local_x[base + i] * LOCAL_SCALE - x;
+                float dy = (float)g_height[base + i] * HEIGHT_SCALE - y;
+                float dz = top + (float)g_local_z[base + i] * LOCAL_SCALE - z;
+                float d2 = dx * dx + dy * dy + dz * dz;
+                if (d2 <= radius2) {
+                    if (found < max_hits) {
+                        hits[found].id = g_first[sector] + (uint32_t)i;
+                        hits[found].distance = sqrtf(d2);
+                    }
+                    found++;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+const GalaxyStats* galaxy_get_stats(void) {
+    return &g_stats;
+}
+
+void galaxy_shutdown(void) {
+    free(g_slot_sector);
+    free(g_slot_used);
+    free(g_local_x);
+    free(g_local_z);
+    free(g_height);
+    g_slot_sector = NULL;
+    g_slot_used = NULL;
+    g_local_x = NULL;
+    g_local_z = NULL;
+    g_height = NULL;
+    g_stats.cache_sectors = 0;
+    g_stats.cached_sectors = 0;
+    g_initialized = 0;
+}
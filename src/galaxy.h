@@ -0,0 +1,108 @@
+// Galaxy header - Procedural star systems generated lazily by sector
+// QuakeCloneWASM - Space exploration
+//
+// The galaxy is a disc of a few million star systems on a square grid of
+// sectors. How many systems a sector holds is an integer function of the
+// seed and its coordinates, so the total and every system's id are known
+// at init without generating anything: ids are dense, numbered sector by
+// sector. A sector's systems are generated from the seed only when a query
+// or lookup first touches it, into an LRU cache of sectors stored as
+// structure of arrays (16-bit offsets within the sector, no strings).
+// Names and planets are derived from a system's seed on demand.
+//
+// The sector grid doubles as the spatial index: nearest-N queries search
+// rings of sectors outward until no unvisited sector can hold a closer
+// system, range queries scan the sectors overlapping the sphere.
+// Coordinates are light years, the galactic centre at the origin and the
+// disc in the x/z plane.
+
+#ifndef GALAXY_H
+#define GALAXY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "space.h"
+
+#define GALAXY_DEFAULT_SEED 0x51A7D15Cu
+
+// 128x128 sectors of 100 ly
+#define GALAXY_SECTORS 128
+#define GALAXY_SECTOR_COUNT (GALAXY_SECTORS * GALAXY_SECTORS)
+#define GALAXY_SECTOR_SIZE 100.0f
+#define GALAXY_MAX_SECTOR_SYSTEMS 1024
+
+// Default sector cache (about 1.5 MB: 6 bytes per cached system)
+#define GALAXY_DEFAULT_CACHE_SECTORS 256
+
+#define GALAXY_MAX_PLANETS 8
+#define GALAXY_NAME_MAX 32
+
+typedef enum {
+    GALAXY_STAR_O = 0,
+    GALAXY_STAR_B,
+    GALAXY_STAR_A,
+    GALAXY_STAR_F,
+    GALAXY_STAR_G,
+    GALAXY_STAR_K,
+    GALAXY_STAR_M,
+    GALAXY_STAR_CLASS_COUNT
+} GalaxyStarClass;
+
+// One system, unpacked from the cache
+typedef struct {
+    uint32_t id;
+    uint32_t seed;          // Names and planets derive from it
+    float x, y, z;
+    int star_class;         // GalaxyStarClass
+    int planet_count;       // 0 to GALAXY_MAX_PLANETS
+} GalaxySystem;
+
+// A query result
+typedef struct {
+    uint32_t id;
+    float distance;
+} GalaxyHit;
+
+typedef struct {
+    uint32_t system_count;
+    int cache_sectors;          // Cache capacity
+    int cached_sectors;         // Sectors in the cache now
+    size_t cache_bytes;
+    uint64_t sector_lookups;
+    uint64_t sectors_generated; // Cache misses
+    uint64_t systems_generated;
+} GalaxyStats;
+
+// Count every sector's systems and allocate the sector cache (0 for the
+// default size). Returns 0 on failure.
+int galaxy_init(uint32_t seed, int cache_sectors);
+
+uint32_t galaxy_get_system_count(void);
+
+// Unpack system id. Returns 0 for an invalid id.
+int galaxy_get_system(uint32_t id, GalaxySystem* system);
+
+// Write a system's name ("" for an invalid id); returns its length
+int galaxy_get_system_name(uint32_t id, char* buffer, size_t size);
+
+// Planet index of system id (planets are named after their star, "b" and
+// on). The data's name and map_file are NULL. Returns 0 if there is none.
+int galaxy_get_planet(uint32_t id, int index, PlanetData* planet);
+int galaxy_get_planet_name(uint32_t id, int index, char* buffer, size_t size);
+
+// The count systems nearest to (x, y, z), closest first (ties by id).
+// Returns how many were written (fewer only if the galaxy is smaller).
+int galaxy_query_nearest(float x, float y, float z, int count, GalaxyHit* hits);
+
+// Systems within radius of (x, y, z), in no particular order. Writes up to
+// max_hits; returns how many are in range.
+int galaxy_query_range(float x, float y, float z, float radius, GalaxyHit* hits, int max_hits);
+
+// Forget the cached sectors (they are regenerated identically)
+void galaxy_flush_cache(void);
+
+const GalaxyStats* galaxy_get_stats(void);
+
+void galaxy_shutdown(void);
+
+#endif // GALAXY_H
@@ -0,0 +1,99 @@
+// HUD implementation - Status block and interned strings
+// QuakeCloneWASM - HUD system
+
+#include <stdio.h>
+#include <string.h>
+#include "hud.h"
+#include "space.h"
+#include "replay.h"
+
+static HudStatus g_status;
+static const char* g_strings[HUD_MAX_STRINGS];
+static char g_string_pool[HUD_STRING_POOL_SIZE];
+static size_t g_pool_used = 0;
+
+int hud_intern(const char* text) {
+    for (int i = 0; i < g_status.string_count; ++i) {
+        if (strcmp(g_strings[i], text) == 0) {
+            return i;
+        }
+    }
+    size_t length = strlen(text) + 1;
+    if (g_status.string_count >= HUD_MAX_STRINGS || g_pool_used + length > HUD_STRING_POOL_SIZE) {
+        printf("ERROR: HUD string table full\n");
+        return -1;
+    }
+    char* copy = g_string_pool + g_pool_used;
+    memcpy(copy, text, length);
+    g_pool_used += length;
+    g_strings[g_status.string_count] = copy;
+    return g_status.string_count++;
+}
+
+const char* hud_get_string(int id) {
+    return id >= 0 && id < g_status.string_count ? g_strings[id] : "";
+}
+
+// The planet menu's description, formatted once
+static int intern_planet_info(const PlanetData* planet) {
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer),
+        "%s\nDistance: %.2f AU\nTemp: %.1fK (%.1fC)\nGravity: %.2fg\nAtmosphere: %s\nResources: %d%%",
+        planet->name,
+        planet->distance_au,
+        planet->surface_temp_k,
+        planet->surface_temp_k - 273.15f,
+        planet->gravity_g,
+        planet->atmosphere_type == 0 ? "None" :
+        planet->atmosphere_type == 1 ? "Thin" :
+        planet->atmosphere_type == 2 ? "Breathable" : "Toxic",
+        planet->resource_richness);
+    return hud_intern(buffer);
+}
+
+int hud_init(void) {
+    memset(&g_status, 0, sizeof(g_status));
+    g_pool_used = 0;
+    g_status.size = sizeof(HudStatus);
+    g_status.strings = (uint32_t)(uintptr_t)g_strings;
+    g_status.planet_index = -1;
+
+    int spaceship = hud_intern("Spaceship");
+    int count = space_get_planet_count();
+    if (spaceship < 0 || count > HUD_MAX_PLANETS) {
+        printf("ERROR: HUD cannot list %d planets\n", count);
+        return 0;
+    }
+    for (int i = 0; i < count; ++i) {
+        const PlanetData* planet = space_get_planet(i);
+        g_status.planets[i].name_id = hud_intern(planet->name);
+        g_status.planets[i].info_id = intern_planet_info(planet);
+        if (g_status.planets[i].name_id < 0 || g_status.planets[i].info_id < 0) {
+            return 0;
+        }
+    }
+    g_status.planet_count = count;
+    hud_update(0);
+    return 1;
+}
+
+void hud_update(int fps) {
+    HudStatus next = g_status;
+    next.fps = fps;
+    next.location = space_get_location_type();
+    next.planet_index = next.location == LOCATION_PLANET ? space_get_current_planet() : -1;
+    next.location_name_id = next.planet_index >= 0 && next.planet_index < g_status.planet_count
+                          ? g_status.planets[next.planet_index].name_id : 0;
+    next.beam_pending = space_is_beam_pending();
+    next.replay_state = (int32_t)replay_get_stats()->state;
+
+    // next starts as a copy, so only the fields set above can differ
+    if (memcmp(&next, &g_status, sizeof(HudStatus)) != 0) {
+        next.generation = g_status.generation + 1;
+        g_status = next;
+    }
+}
+
+const HudStatus* hud_get_status(void) {
+    return &g_status;
+}
@@ -0,0 +1,61 @@
+// HUD header - Status block shared with the page
+// QuakeCloneWASM - HUD system
+//
+// Everything the page shows about the game lives in one HudStatus in
+// module memory. hud_update refreshes it in place once per frame and bumps
+// generation whenever a field changed, so the page reads it through a
+// typed-array view without any call and skips its DOM updates while the
+// generation stays the same. Text (location and planet names, planet
+// descriptions) is interned once into a string table and referenced by id;
+// the page decodes each id once.
+//
+// Every field is 32 bits wide so the page indexes them as words; keep the
+// offsets in site/main.js (HUD_*) in sync with this layout.
+
+#ifndef HUD_H
+#define HUD_H
+
+#include <stdint.h>
+
+#define HUD_MAX_PLANETS 16
+#define HUD_MAX_STRINGS 64
+#define HUD_STRING_POOL_SIZE 4096   // Bytes for copied (formatted) strings
+
+// A planet in the planet menu
+typedef struct {
+    int32_t name_id;
+    int32_t info_id;            // Multi-line description
+} HudPlanet;
+
+typedef struct {
+    uint32_t generation;        // Bumped after every change
+    uint32_t size;              // sizeof(HudStatus)
+    int32_t fps;                // Frames in the last whole second
+    int32_t location;           // LocationType
+    int32_t location_name_id;   // "Spaceship" or the planet's name
+    int32_t planet_index;       // -1 aboard the spaceship
+    int32_t beam_pending;
+    int32_t replay_state;       // ReplayState
+    int32_t string_count;       // Ids [0, string_count) are valid
+    uint32_t strings;           // Address of const char*[HUD_MAX_STRINGS] (WASM)
+    int32_t planet_count;
+    HudPlanet planets[HUD_MAX_PLANETS];
+} HudStatus;
+
+// Intern the planets' names and descriptions and fill the status.
+// Returns 0 on failure.
+int hud_init(void);
+
+// Refresh the status (end of every frame); fps is the last whole second's
+void hud_update(int fps);
+
+// The status block the page reads
+const HudStatus* hud_get_status(void);
+
+// Id of text in the string table, adding a copy if it is new (-1 if full)
+int hud_intern(const char* text);
+
+// Text of a string id ("" for an unknown id)
+const char* hud_get_string(int id);
+
+#endif // HUD_H
@@ -1,10 +1,11 @@
 // Input implementation - Keyboard and mouse handling via JavaScript
 // QuakeCloneWASM - Input system
 
-#include <emscripten.h>
 #include <string.h>
 #include <stdio.h>
+#include "platform.h"
 #include "input.h"
+#include "replay.h"
 
 // Input state
 #define MAX_KEYS 256
@@ -13,22 +14,50 @@ static int g_keys_pressed[MAX_KEYS];
 static float g_mouse_dx = 0.0f;
 static float g_mouse_dy = 0.0f;
 static int g_input_initialized = 0;
+static InputQueue g_queue = { .capacity = INPUT_QUEUE_CAPACITY };
 
-// External JavaScript functions (to be called from JS)
+// External JavaScript functions (to be called from JS); while a replay
+// plays, its recorded events stand in for them
 EMSCRIPTEN_KEEPALIVE
 void set_key_state(int key_code, int is_down) {
+    if (replay_record_key(key_code, is_down)) {
+        input_apply_key(key_code, is_down);
+    }
+}
+
+// External function to add mouse movement
+EMSCRIPTEN_KEEPALIVE
+void set_mouse_delta(float dx, float dy) {
+    if (replay_record_mouse(dx, dy)) {
+        input_apply_mouse(dx, dy);
+    }
+}
+
+void input_apply_key(int key_code, int is_down) {
     if (key_code >= 0 && key_code < MAX_KEYS) {
         int was_down = g_keys[key_code];
         g_keys[key_code] = is_down;
-        g_keys_pressed[key_code] = (is_down && !was_down) ? 1 : 0;
+        // A press stays latched until a tick consumes it, even if the key
+        // is released first
+        if (is_down && !was_down) {
+            g_keys_pressed[key_code] = 1;
+        }
     }
 }
 
-// External function to set mouse delta
-EMSCRIPTEN_KEEPALIVE
-void set_mouse_delta(float dx, float dy) {
-    g_mouse_dx = dx;
-    g_mouse_dy = dy;
+// Mouse movement accumulates until the next tick reads it, so events
+// between ticks are not lost
+void input_apply_mouse(float dx, float dy) {
+    g_mouse_dx += dx;
+    g_mouse_dy += dy;
+}
+
+// Release every key and drop pending presses and mouse movement
+void input_clear(void) {
+    memset(g_keys, 0, sizeof(g_keys));
+    memset(g_keys_pressed, 0, sizeof(g_keys_pressed));
+    g_mouse_dx = 0.0f;
+    g_mouse_dy = 0.0f;
 }
 
 // Initialize input system
@@ -48,7 +77,28 @@ int input_init(void) {
     return 1;
 }
 
-// Update input state (call each frame)
+InputQueue* input_get_queue(void) {
+    return &g_queue;
+}
+
+int input_drain_events(void) {
+    unsigned int tail = atomic_load_explicit(&g_queue.tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&g_queue.head, memory_order_acquire);
+    int count = (int)(head - tail);
+    for (; tail != head; ++tail) {
+        const InputEvent* event = &g_queue.events[tail & (INPUT_QUEUE_CAPACITY - 1)];
+        if (event->type == INPUT_EVENT_MOUSE) {
+            set_mouse_delta(event->dx, event->dy);
+        } else {
+            set_key_state(event->key_code, event->type == INPUT_EVENT_KEY_DOWN);
+        }
+    }
+    // The slots are free for the producer again
+    atomic_store_explicit(&g_queue.tail, tail, memory_order_release);
+    return count;
+}
+
+// Update input state (call after each simulation tick)
 void input_update(void) {
     // Reset pressed keys
     memset(g_keys_pressed, 0, sizeof(g_keys_pressed));
@@ -65,7 +115,7 @@ int input_is_key_down(int key_code) {
     return 0;
 }
 
-// Check if key was just pressed this frame
+// Check if key was pressed since the last tick
 int input_is_key_pressed(int key_code) {
     if (key_code >= 0 && key_code < MAX_KEYS) {
         return g_keys_pressed[key_code];
@@ -73,7 +123,7 @@ int input_is_key_pressed(int key_code) {
     return 0;
 }
 
-// Get mouse delta (movement since last frame)
+// Get mouse delta (movement since the last read)
 void input_get_mouse_delta(float* dx, float* dy) {
     if (dx) *dx = g_mouse_dx;
     if (dy) *dy = g_mouse_dy;
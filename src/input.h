@@ -4,19 +4,69 @@
 #ifndef INPUT_H
 #define INPUT_H
 
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Event queue JavaScript writes straight into module memory, one slot per
+// key or mouse event, instead of a ccall per event. Single producer (the
+// page) and single consumer (input_drain_events): the producer fills the
+// slot at head and then advances head; the consumer reads up to head and
+// advances tail. Both count up freely; slots wrap at the capacity.
+#define INPUT_QUEUE_CAPACITY 512    // Power of two
+
+typedef enum {
+    INPUT_EVENT_KEY_UP = 0,
+    INPUT_EVENT_KEY_DOWN,
+    INPUT_EVENT_MOUSE
+} InputEventType;
+
+typedef struct {
+    uint32_t type;              // InputEventType
+    int32_t key_code;
+    float dx;                   // Mouse movement
+    float dy;
+} InputEvent;
+
+typedef struct {
+    atomic_uint head;           // Events published (producer)
+    atomic_uint tail;           // Events consumed (consumer)
+    uint32_t capacity;          // INPUT_QUEUE_CAPACITY
+    uint32_t reserved;
+    InputEvent events[INPUT_QUEUE_CAPACITY];
+} InputQueue;
+
 // Initialize input system
 int input_init(void);
 
-// Update input state (call each frame)
+// Update input state (call after each simulation tick)
 void input_update(void);
 
+// Live key and mouse events (called from JavaScript; scripted input too).
+// Recorded while a replay records, ignored while one plays.
+void set_key_state(int key_code, int is_down);
+void set_mouse_delta(float dx, float dy);
+
+// Apply an event directly, bypassing recording (replay playback)
+void input_apply_key(int key_code, int is_down);
+void input_apply_mouse(float dx, float dy);
+
+// Release every key and drop pending presses and mouse movement
+void input_clear(void);
+
+// The queue JavaScript writes to
+InputQueue* input_get_queue(void);
+
+// Apply every queued event in order, as set_key_state and set_mouse_delta
+// would have (once per frame, before its ticks). Returns the events read.
+int input_drain_events(void);
+
 // Check if key is currently down
 int input_is_key_down(int key_code);
 
-// Check if key was just pressed this frame
+// Check if key was pressed since the last tick
 int input_is_key_pressed(int key_code);
 
-// Get mouse delta (movement since last frame)
+// Get mouse delta (movement since the last read)
 void input_get_mouse_delta(float* dx, float* dy);
 
 // Set mouse position (for centering)
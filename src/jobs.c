@@ -0,0 +1,404 @@
+// Job system implementation - Persistent worker pool
+// QuakeCloneWASM - Job system
+//
+// Workers are created once and sleep on a condition variable between jobs.
+// A job is a range [0, count) cut into grain-sized pieces; participants
+// claim pieces through an atomic counter, so uneven pieces balance out.
+// A separate background thread runs queued tasks (such as terrain
+// generation) that may take longer than a frame.
+// Native builds always have threads. Emscripten builds get them only with
+// -pthread (SharedArrayBuffer); otherwise everything runs on the main thread.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "platform.h"
+#include "jobs.h"
+#include "profile.h"
+
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define JOBS_THREADED 1
+#include <pthread.h>
+#include <stdatomic.h>
+#ifdef __EMSCRIPTEN__
+#include <emscripten/threading.h>
+#else
+#include <unistd.h>
+#endif
+#endif
+
+// Thread count picked by jobs_init(0)
+#define JOBS_DEFAULT_MAX_THREADS 8
+
+// Background tasks waiting to run
+#define JOBS_BACKGROUND_QUEUE_SIZE 64
+
+typedef struct {
+    JobTaskFunc func;
+    void* user_data;
+} BackgroundTask;
+
+static BackgroundTask g_background_queue[JOBS_BACKGROUND_QUEUE_SIZE];
+static int g_background_head = 0;  // Oldest queued task
+static int g_background_count = 0;
+
+static JobThreadStats g_thread_stats[JOBS_MAX_THREADS];
+static double g_last_wall_ms = 0.0;
+static int g_thread_count = 1;
+static int g_jobs_initialized = 0;
+
+// Run pieces of the current job until none are left
+static void run_pieces(JobRangeFunc func, void* user_data, int count, int grain,
+                       int thread_index, int (*claim)(void)) {
+    JobThreadStats* stats = &g_thread_stats[thread_index];
+    double start = platform_now_ms();
+    int ranges = 0;
+    PROFILE_JOB_BEGIN(thread_index);
+
+    for (;;) {
+        int piece = claim();
+        int begin = piece * grain;
+        if (begin >= count) {
+            break;
+        }
+        int end = begin + grain < count ? begin + grain : count;
+        func(user_data, begin, end, thread_index);
+        ranges++;
+    }
+
+    PROFILE_JOB_END(thread_index);
+    stats->busy_ms = platform_now_ms() - start;
+    stats->ranges = ranges;
+}
+
+#ifdef JOBS_THREADED
+
+static pthread_t g_workers[JOBS_MAX_THREADS];
+static int g_worker_count = 0; // Threads created (excluding main)
+
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_done = PTHREAD_COND_INITIALIZER;
+
+// Current job (written by the main thread under g_mutex before waking workers)
+static JobRangeFunc g_job_func = NULL;
+static void* g_job_data = NULL;
+static int g_job_count = 0;
+static int g_job_grain = 1;
+static int g_job_participants = 0;
+static unsigned g_job_generation = 0;
+static int g_workers_busy = 0;
+static int g_quit = 0;
+static atomic_int g_next_piece;
+
+static int claim_piece(void) {
+    return atomic_fetch_add_explicit(&g_next_piece, 1, memory_order_relaxed);
+}
+
+static void* worker_main(void* arg) {
+    int thread_index = (int)(intptr_t)arg;
+    unsigned seen_generation = 0;
+
+    pthread_mutex_lock(&g_mutex);
+    for (;;) {
+        while (!g_quit && g_job_generation == seen_generation) {
+            pthread_cond_wait(&g_wake, &g_mutex);
+        }
+        if (g_quit) {
+            break;
+        }
+        seen_generation = g_job_generation;
+        if (thread_index >= g_job_participants) {
+            continue; // Not needed at the current thread count
+        }
+
+        JobRangeFunc func = g_job_func;
+        void* user_data = g_job_data;
+        int count = g_job_count;
+        int grain = g_job_grain;
+        pthread_mutex_unlock(&g_mutex);
+
+        run_pieces(func, user_data, count, grain, thread_index, claim_piece);
+
+        pthread_mutex_lock(&g_mutex);
+        if (--g_workers_busy == 0) {
+            pthread_cond_signal(&g_done);
+        }
+    }
+    pthread_mutex_unlock(&g_mutex);
+    return NULL;
+}
+
+// Make sure threads 1..thread_count-1 exist
+static void spawn_workers(int thread_count) {
+    while (g_worker_count + 1 < thread_count) {
+        int thread_index = g_worker_count + 1;
+        if (pthread_create(&g_workers[g_worker_count], NULL, worker_main, (void*)(intptr_t)thread_index) != 0) {
+            printf("WARNING: Failed to start render worker %d\n", thread_index);
+            break;
+        }
+        g_worker_count++;
+    }
+}
+
+// Background thread: one long-lived worker that drains the background
+// queue, so slow tasks never hold up a jobs_parallel_for
+static pthread_t g_background_thread;
+static int g_background_started = 0;
+static int g_background_busy = 0;  // A task is running
+static int g_background_quit = 0;
+static pthread_mutex_t g_background_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_background_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_background_idle = PTHREAD_COND_INITIALIZER;
+
+static void* background_main(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&g_background_mutex);
+    for (;;) {
+        while (!g_background_quit && g_background_count == 0) {
+            pthread_cond_wait(&g_background_wake, &g_background_mutex);
+        }
+        if (g_background_quit) {
+            break;
+        }
+        BackgroundTask task = g_background_queue[g_background_head];
+        g_background_head = (g_background_head + 1) % JOBS_BACKGROUND_QUEUE_SIZE;
+        g_background_count--;
+        g_background_busy = 1;
+        pthread_mutex_unlock(&g_background_mutex);
+
+        task.func(task.user_data);
+
+        pthread_mutex_lock(&g_background_mutex);
+        g_background_busy = 0;
+        if (g_background_count == 0) {
+            pthread_cond_broadcast(&g_background_idle);
+        }
+    }
+    pthread_mutex_unlock(&g_background_mutex);
+    return NULL;
+}
+
+#endif // JOBS_THREADED
+
+// Number of hardware threads, capped for the default pool size
+static int default_thread_count(void) {
+    int cores = 1;
+#if defined(__EMSCRIPTEN_PTHREADS__)
+    cores = emscripten_num_logical_cores();
+#elif defined(JOBS_THREADED)
+    cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (cores < 1) cores = 1;
+    if (cores > JOBS_DEFAULT_MAX_THREADS) cores = JOBS_DEFAULT_MAX_THREADS;
+    return cores;
+}
+
+// Initialize the pool (thread_count 0 = one per core, up to 8)
+int jobs_init(int thread_count) {
+    if (g_jobs_initialized) {
+        return 1;
+    }
+
+    if (thread_count <= 0) {
+        thread_count = default_thread_count();
+    }
+
+    memset(g_thread_stats, 0, sizeof(g_thread_stats));
+    g_jobs_initialized = 1;
+    jobs_set_thread_count(thread_count);
+
+    printf("Job system initialized: %d thread(s)\n", g_thread_count);
+    return 1;
+}
+
+// Change the number of participating threads
+void jobs_set_thread_count(int thread_count) {
+#ifdef JOBS_THREADED
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > JOBS_MAX_THREADS) thread_count = JOBS_MAX_THREADS;
+
+    pthread_mutex_lock(&g_mutex);
+    spawn_workers(thread_count);
+    g_thread_count = g_worker_count + 1 < thread_count ? g_worker_count + 1 : thread_count;
+    pthread_mutex_unlock(&g_mutex);
+#else
+    (void)thread_count;
+    g_thread_count = 1;
+#endif
+}
+
+int jobs_get_thread_count(void) {
+    return g_thread_count;
+}
+
+#ifndef JOBS_THREADED
+static int g_serial_piece = 0;
+
+static int claim_piece_serial(void) {
+    return g_serial_piece++;
+}
+#endif
+
+// Run a job across the pool and wait for it
+void jobs_parallel_for(int count, int grain, JobRangeFunc func, void* user_data) {
+    if (count <= 0) {
+        return;
+    }
+    if (grain < 1) {
+        grain = 1;
+    }
+
+    double start = platform_now_ms();
+    memset(g_thread_stats, 0, sizeof(g_thread_stats));
+
+#ifdef JOBS_THREADED
+    int pieces = (count + grain - 1) / grain;
+    int participants = g_thread_count < pieces ? g_thread_count : pieces;
+
+    atomic_store_explicit(&g_next_piece, 0, memory_order_relaxed);
+
+    if (participants > 1) {
+        pthread_mutex_lock(&g_mutex);
+        g_job_func = func;
+        g_job_data = user_data;
+        g_job_count = count;
+        g_job_grain = grain;
+        g_job_participants = participants;
+        g_workers_busy = participants - 1;
+        g_job_generation++;
+        pthread_cond_broadcast(&g_wake);
+        pthread_mutex_unlock(&g_mutex);
+    }
+
+    run_pieces(func, user_data, count, grain, 0, claim_piece);
+
+    if (participants > 1) {
+        pthread_mutex_lock(&g_mutex);
+        while (g_workers_busy > 0) {
+            pthread_cond_wait(&g_done, &g_mutex);
+        }
+        pthread_mutex_unlock(&g_mutex);
+    }
+#else
+    g_serial_piece = 0;
+    run_pieces(func, user_data, count, grain, 0, claim_piece_serial);
+#endif
+
+    g_last_wall_ms = platform_now_ms() - start;
+}
+
+const JobThreadStats* jobs_get_thread_stats(int thread_index) {
+    if (thread_index < 0 || thread_index >= JOBS_MAX_THREADS) {
+        return NULL;
+    }
+    return &g_thread_stats[thread_index];
+}
+
+double jobs_get_last_wall_ms(void) {
+    return g_last_wall_ms;
+}
+
+// Queue a task for the background thread
+int jobs_submit_background(JobTaskFunc func, void* user_data) {
+#ifdef JOBS_THREADED
+    pthread_mutex_lock(&g_background_mutex);
+    if (!g_background_started) {
+        if (pthread_create(&g_background_thread, NULL, background_main, NULL) != 0) {
+            pthread_mutex_unlock(&g_background_mutex);
+            printf("WARNING: Failed to start background worker; running task inline\n");
+            func(user_data);
+            return 1;
+        }
+        g_background_started = 1;
+    }
+#endif
+    if (g_background_count == JOBS_BACKGROUND_QUEUE_SIZE) {
+#ifdef JOBS_THREADED
+        pthread_mutex_unlock(&g_background_mutex);
+#endif
+        return 0;
+    }
+    int slot = (g_background_head + g_background_count) % JOBS_BACKGROUND_QUEUE_SIZE;
+    g_background_queue[slot].func = func;
+    g_background_queue[slot].user_data = user_data;
+    g_background_count++;
+#ifdef JOBS_THREADED
+    pthread_cond_signal(&g_background_wake);
+    pthread_mutex_unlock(&g_background_mutex);
+#endif
+    return 1;
+}
+
+// Run queued background tasks on the calling thread (builds without threads)
+int jobs_run_background(double budget_ms) {
+#ifdef JOBS_THREADED
+    (void)budget_ms;
+    return 0;
+#else
+    double start = platform_now_ms();
+    int ran = 0;
+    while (g_background_count > 0 && (ran == 0 || platform_now_ms() - start < budget_ms)) {
+        BackgroundTask task = g_background_queue[g_background_head];
+        g_background_head = (g_background_head + 1) % JOBS_BACKGROUND_QUEUE_SIZE;
+        g_background_count--;
+        task.func(task.user_data);
+        ran++;
+    }
+    return ran;
+#endif
+}
+
+// Wait until the background queue is empty and no task is running
+void jobs_wait_background(void) {
+#ifdef JOBS_THREADED
+    pthread_mutex_lock(&g_background_mutex);
+    while (g_background_started && (g_background_count > 0 || g_background_busy)) {
+        pthread_cond_wait(&g_background_idle, &g_background_mutex);
+    }
+    pthread_mutex_unlock(&g_background_mutex);
+#else
+    while (g_background_count > 0) {
+        jobs_run_background(1e9);
+    }
+#endif
+}
+
+// Stop all workers
+void jobs_shutdown(void) {
+#ifdef JOBS_THREADED
+    pthread_mutex_lock(&g_background_mutex);
+    if (g_background_started) {
+        g_background_quit = 1;
+        pthread_cond_broadcast(&g_background_wake);
+        pthread_mutex_unlock(&g_background_mutex);
+        pthread_join(g_background_thread, NULL);
+        pthread_mutex_lock(&g_background_mutex);
+        g_background_started = 0;
+        g_background_quit = 0;
+    }
+    g_background_head = 0;
+    g_background_count = 0;
+    pthread_mutex_unlock(&g_background_mutex);
+#endif
+
+    if (!g_jobs_initialized) {
+        return;
+    }
+
+#ifdef JOBS_THREADED
+    pthread_mutex_lock(&g_mutex);
+    g_quit = 1;
+    pthread_cond_broadcast(&g_wake);
+    pthread_mutex_unlock(&g_mutex);
+
+    for (int i = 0; i < g_worker_count; ++i) {
+        pthread_join(g_workers[i], NULL);
+    }
+    g_worker_count = 0;
+    g_quit = 0;
+#endif
+
+    g_thread_count = 1;
+    g_jobs_initialized = 0;
+}
@@ -0,0 +1,58 @@
+// Jobs header - Persistent worker pool for parallel frame work
+// QuakeCloneWASM - Job system
+
+#ifndef JOBS_H
+#define JOBS_H
+
+// Upper bound for jobs_set_thread_count (main thread included)
+#define JOBS_MAX_THREADS 16
+
+// Process items [begin, end) on behalf of worker thread_index (0 = main thread)
+typedef void (*JobRangeFunc)(void* user_data, int begin, int end, int thread_index);
+
+// Per-thread timing for the most recent jobs_parallel_for
+typedef struct {
+    double busy_ms;   // Time spent inside JobRangeFunc
+    int ranges;       // Number of ranges processed
+} JobThreadStats;
+
+// Start the pool with thread_count threads (main thread included);
+// 0 picks one thread per core, up to 8
+int jobs_init(int thread_count);
+
+// Change the number of threads used by jobs_parallel_for at runtime.
+// Clamped to [1, JOBS_MAX_THREADS]; always 1 in builds without threads.
+void jobs_set_thread_count(int thread_count);
+int jobs_get_thread_count(void);
+
+// Split [0, count) into ranges of grain items, run them on the pool and
+// return once every range has completed. The calling thread participates.
+void jobs_parallel_for(int count, int grain, JobRangeFunc func, void* user_data);
+
+// Timing of the last jobs_parallel_for (NULL for an out-of-range thread)
+const JobThreadStats* jobs_get_thread_stats(int thread_index);
+
+// Wall time of the last jobs_parallel_for in milliseconds
+double jobs_get_last_wall_ms(void);
+
+// Task for the background queue
+typedef void (*JobTaskFunc)(void* user_data);
+
+// Queue func(user_data) for the background thread, which runs tasks one at
+// a time in submission order, independently of jobs_parallel_for. Returns 0
+// if the queue is full. Builds without threads keep the task until
+// jobs_run_background or jobs_wait_background runs it on the caller.
+int jobs_submit_background(JobTaskFunc func, void* user_data);
+
+// Builds without threads: run queued tasks for up to budget_ms (at least
+// one). Returns the number run; always 0 when a background thread exists.
+int jobs_run_background(double budget_ms);
+
+// Return once every queued background task has finished
+void jobs_wait_background(void);
+
+// Stop and join all worker threads (background tasks not yet started are
+// dropped)
+void jobs_shutdown(void);
+
+#endif // JOBS_H
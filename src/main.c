@@ -1,23 +1,21 @@
 // Main game loop and initialization
 // QuakeCloneWASM - Main entry point
 
-#include <emscripten.h>
-#include <emscripten/html5.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include "platform.h"
 #include "renderer.h"
 #include "player.h"
 #include "world.h"
 #include "input.h"
+#include "replay.h"
 #include "space.h"
-
-// Include GL headers for GL enum types and functions
-#ifdef __EMSCRIPTEN__
-#include <GL/gl.h>
-#else
-#include <GLES3/gl3.h>
-#endif
+#include "galaxy.h"
+#include "jobs.h"
+#include "sim.h"
+#include "profile.h"
+#include "hud.h"
 
 // External reference to GL state ready flag
 extern int g_gl_state_ready;
@@ -47,19 +45,16 @@ void update_fps_counter(double delta_time);
 
 // Main game loop callback for Emscripten
 void game_loop(void* user_data) {
+    PROFILE_FRAME_BEGIN();
+
     // Calculate delta time
-    double current_time = emscripten_get_now() / 1000.0;
+    double current_time = platform_now_ms() / 1000.0;
     if (g_last_time == 0.0) {
         g_last_time = current_time;
     }
     g_delta_time = current_time - g_last_time;
     g_last_time = current_time;
     
-    // Cap delta time to prevent large jumps
-    if (g_delta_time > 0.1) {
-        g_delta_time = 0.1;
-    }
-    
     // Update FPS counter
     update_fps_counter(g_delta_time);
     
@@ -68,32 +63,27 @@ void game_loop(void* user_data) {
     
     // Render frame
     render_game();
-    
-    // Update input state
-    input_update();
+
+    // Publish the frame's status to the page
+    hud_update(g_fps);
+
+    PROFILE_FRAME_END();
 }
 
-// Update game logic
+// Update game logic: fixed ticks for the elapsed time (sim.c caps how many
+// a frame may run and consumes input per tick)
 void update_game(double delta_time) {
     if (!g_game_state.running) {
         return;
     }
-    
-    // Check for beam up key (B key)
-    if (input_is_key_pressed('B') || input_is_key_pressed('b')) {
-        if (space_get_location_type() == LOCATION_PLANET) {
-            space_beam_to_spaceship();
-        }
-    }
-    
-    // Update player movement and rotation
-    player_update(delta_time);
-    
-    // Update world interactions
-    world_update(delta_time);
-    
-    // Update space system
-    space_update(delta_time);
+    PROFILE_BEGIN(PROFILE_INPUT);
+    input_drain_events();
+    PROFILE_END(PROFILE_INPUT);
+
+    PROFILE_BEGIN(PROFILE_UPDATE);
+    replay_record_frame(delta_time);
+    sim_advance(delta_time);
+    PROFILE_END(PROFILE_UPDATE);
 }
 
 // Render the game frame
@@ -103,9 +93,13 @@ void render_game(void) {
     }
 
     renderer_clear();
+    PROFILE_BEGIN(PROFILE_WORLD_RENDER);
     world_render();
+    PROFILE_END(PROFILE_WORLD_RENDER);
     player_render();
+    PROFILE_BEGIN(PROFILE_PRESENT);
     renderer_present();
+    PROFILE_END(PROFILE_PRESENT);
 }
 
 // Update FPS counter
@@ -137,8 +131,8 @@ void resize_window(int width, int height) {
 // Beam up to spaceship (called from JavaScript)
 EMSCRIPTEN_KEEPALIVE
 void beam_up(void) {
-    if (space_get_location_type() == LOCATION_PLANET) {
-        space_beam_to_spaceship();
+    if (space_get_location_type() == LOCATION_PLANET && replay_record_beam(-1)) {
+        space_request_beam(-1);
     }
 }
 
@@ -182,36 +176,124 @@ const char* get_planet_name(int index) {
     return "Unknown";
 }
 
-// Get planet info as formatted string (for JavaScript)
-// Uses static buffer to avoid malloc/free issues
+// Get planet info as formatted string (for JavaScript); the page reads
+// the same interned text through the HUD status block
 EMSCRIPTEN_KEEPALIVE
 const char* get_planet_info(int index) {
-    static char buffer[512];
-    PlanetData* planet = space_get_planet(index);
-    if (!planet) {
-        buffer[0] = '\0';
-        return buffer;
+    const HudStatus* status = hud_get_status();
+    if (index < 0 || index >= status->planet_count) {
+        return "";
     }
-    
-    snprintf(buffer, sizeof(buffer),
-        "%s\nDistance: %.2f AU\nTemp: %.1fK (%.1fC)\nGravity: %.2fg\nAtmosphere: %s\nResources: %d%%",
-        planet->name,
-        planet->distance_au,
-        planet->surface_temp_k,
-        planet->surface_temp_k - 273.15f,
-        planet->gravity_g,
-        planet->atmosphere_type == 0 ? "None" :
-        planet->atmosphere_type == 1 ? "Thin" :
-        planet->atmosphere_type == 2 ? "Breathable" : "Toxic",
-        planet->resource_richness);
-    
-    return buffer;
+    return hud_get_string(status->planets[index].info_id);
+}
+
+// Star systems around the home system, a page at a time:
+// find_nearby_systems(first, count) looks up the systems first to
+// first + count - 1 by distance and returns how many it found; the
+// get_nearby_system_* calls read entries of that page
+#define NEARBY_MAX 256
+static GalaxyHit g_nearby[NEARBY_MAX];
+static int g_nearby_first = 0;
+static int g_nearby_count = 0;
+
+EMSCRIPTEN_KEEPALIVE
+int get_galaxy_system_count(void) {
+    return (int)galaxy_get_system_count();
+}
+
+EMSCRIPTEN_KEEPALIVE
+int find_nearby_systems(int first, int count) {
+    if (first < 0 || count <= 0 || first + count > NEARBY_MAX) {
+        printf("ERROR: Nearby systems %d-%d out of range (max %d)\n", first, first + count - 1, NEARBY_MAX);
+        g_nearby_count = 0;
+        return 0;
+    }
+    float x, y, z;
+    space_get_galaxy_position(&x, &y, &z);
+    int found = galaxy_query_nearest(x, y, z, first + count, g_nearby);
+    g_nearby_first = first;
+    g_nearby_count = found > first ? found - first : 0;
+    return g_nearby_count;
+}
+
+EMSCRIPTEN_KEEPALIVE
+const char* get_nearby_system_name(int index) {
+    static char name[GALAXY_NAME_MAX];
+    if (index < 0 || index >= g_nearby_count) {
+        return "";
+    }
+    galaxy_get_system_name(g_nearby[g_nearby_first + index].id, name, sizeof(name));
+    return name;
+}
+
+EMSCRIPTEN_KEEPALIVE
+const char* get_nearby_system_info(int index) {
+    static char info[256];
+    GalaxySystem system;
+    if (index < 0 || index >= g_nearby_count || !galaxy_get_system(g_nearby[g_nearby_first + index].id, &system)) {
+        return "";
+    }
+    char name[GALAXY_NAME_MAX];
+    galaxy_get_system_name(system.id, name, sizeof(name));
+    snprintf(info, sizeof(info), "%s\nDistance: %.1f ly\nStar: %c class\nPlanets: %d",
+             name, g_nearby[g_nearby_first + index].distance, "OBAFGKM"[system.star_class], system.planet_count);
+    return info;
 }
 
-// Beam to planet (called from JavaScript)
+// Beam to planet (called from JavaScript); arrives over the next frames
 EMSCRIPTEN_KEEPALIVE
 void beam_to_planet(int planet_index) {
-    space_beam_to_planet(planet_index);
+    if (replay_record_beam(planet_index)) {
+        space_request_beam(planet_index);
+    }
+}
+
+// Start preparing the planet selected in the planet menu (-1: none)
+EMSCRIPTEN_KEEPALIVE
+void prefetch_planet(int planet_index) {
+    space_prefetch_planet(planet_index);
+}
+
+// A beam has been requested and not arrived yet
+EMSCRIPTEN_KEEPALIVE
+int is_beam_pending(void) {
+    return space_is_beam_pending();
+}
+
+// Time from the last beam request to arrival, in ms
+EMSCRIPTEN_KEEPALIVE
+double get_beam_latency_ms(void) {
+    return space_get_beam_stats()->last_latency_ms;
+}
+
+// Frame time the last beam's world swap took, in ms
+EMSCRIPTEN_KEEPALIVE
+double get_beam_commit_ms(void) {
+    return space_get_beam_stats()->last_commit_ms;
+}
+
+// Get the .qmap file name for a planet's map, or "" if it has none
+EMSCRIPTEN_KEEPALIVE
+const char* get_planet_map_file(int index) {
+    PlanetData* planet = space_get_planet(index);
+    if (planet && planet->map_file) {
+        return planet->map_file;
+    }
+    return "";
+}
+
+// Attach a .qmap image that JavaScript fetched into the heap (not copied;
+// the buffer must stay allocated). Returns 0 if the image is rejected.
+EMSCRIPTEN_KEEPALIVE
+int attach_planet_map(int planet_index, const void* data, int size) {
+    if (size <= 0 || !world_attach_planet_map(planet_index, data, (size_t)size)) {
+        return 0;
+    }
+    // Already standing on that planet: move to the new map's spawn point
+    if (space_get_current_planet() == planet_index) {
+        space_beam_to_planet(planet_index);
+    }
+    return 1;
 }
 
 // Check if on spaceship (for JavaScript)
@@ -220,6 +302,146 @@ int is_on_spaceship(void) {
     return space_get_location_type() == LOCATION_SPACESHIP;
 }
 
+// Set the number of render threads (called from JavaScript)
+// Has no effect unless the module was built with THREADS=1
+EMSCRIPTEN_KEEPALIVE
+void set_render_threads(int thread_count) {
+    jobs_set_thread_count(thread_count);
+}
+
+// Get the number of render threads in use
+EMSCRIPTEN_KEEPALIVE
+int get_render_threads(void) {
+    return jobs_get_thread_count();
+}
+
+// Get how long a render thread worked on the last frame's columns, in ms
+EMSCRIPTEN_KEEPALIVE
+double get_render_thread_busy_ms(int thread_index) {
+    const JobThreadStats* stats = jobs_get_thread_stats(thread_index);
+    return stats ? stats->busy_ms : 0.0;
+}
+
+// Frames whose render and upload were skipped because nothing changed
+EMSCRIPTEN_KEEPALIVE
+int get_frames_skipped(void) {
+    return (int)renderer_get_stats()->frames_skipped;
+}
+
+// Texture bytes uploaded by the last presented frame
+EMSCRIPTEN_KEEPALIVE
+double get_upload_bytes(void) {
+    return (double)renderer_get_stats()->last_upload_bytes;
+}
+
+// Pin the internal render scale (0 = dynamic, driven by the frame budget)
+EMSCRIPTEN_KEEPALIVE
+void set_render_scale(float scale) {
+    renderer_set_fixed_scale(scale);
+}
+
+// Current render size / canvas size
+EMSCRIPTEN_KEEPALIVE
+float get_render_scale(void) {
+    return renderer_get_scale();
+}
+
+// Software frame budget for dynamic resolution, in ms
+EMSCRIPTEN_KEEPALIVE
+void set_frame_budget_ms(double budget_ms) {
+    renderer_set_frame_budget_ms(budget_ms);
+}
+
+// Textured walls (1, default) or flat-shaded walls (0)
+EMSCRIPTEN_KEEPALIVE
+void set_textured_walls(int enabled) {
+    world_set_textured_walls(enabled);
+}
+
+// Textured floors and spaceship ceilings (1, default) or gradients (0)
+EMSCRIPTEN_KEEPALIVE
+void set_textured_floors(int enabled) {
+    world_set_textured_floors(enabled);
+}
+
+// Phase timings over the last PROFILE_HISTORY frames (profile.h): statistic
+// 0 = min, 1 = avg, 2 = p99, 3 = max, in ms. Zeros unless built with PROFILE=1.
+EMSCRIPTEN_KEEPALIVE
+double get_profile_ms(int phase, int statistic) {
+    ProfileStats stats;
+    if (!profile_get_stats((ProfilePhase)phase, &stats)) {
+        return 0.0;
+    }
+    switch (statistic) {
+        case 0: return stats.min_ms;
+        case 1: return stats.avg_ms;
+        case 2: return stats.p99_ms;
+        default: return stats.max_ms;
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+int get_profile_phase_count(void) {
+    return PROFILE_PHASE_COUNT;
+}
+
+EMSCRIPTEN_KEEPALIVE
+const char* get_profile_phase_name(int phase) {
+    return profile_get_phase_name((ProfilePhase)phase);
+}
+
+// Status block the page reads every frame without calls (see hud.h)
+EMSCRIPTEN_KEEPALIVE
+const HudStatus* get_hud_status(void) {
+    return hud_get_status();
+}
+
+// Input event queue JavaScript writes to (see input.h)
+EMSCRIPTEN_KEEPALIVE
+InputQueue* get_input_queue(void) {
+    return input_get_queue();
+}
+
+// Start recording input from the current state (see replay.h)
+EMSCRIPTEN_KEEPALIVE
+int start_input_recording(void) {
+    return replay_start_recording();
+}
+
+// Finish the recording; returns its size, get_input_recording_data its bytes
+EMSCRIPTEN_KEEPALIVE
+int stop_input_recording(void) {
+    return (int)replay_stop_recording(NULL);
+}
+
+EMSCRIPTEN_KEEPALIVE
+const uint8_t* get_input_recording_data(void) {
+    return replay_get_recording(NULL);
+}
+
+// Replay a recording copied into module memory (the copy can be freed)
+EMSCRIPTEN_KEEPALIVE
+int start_input_replay(const uint8_t* data, int size) {
+    return size > 0 && replay_start_playback(data, (size_t)size);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void stop_input_replay(void) {
+    replay_stop_playback();
+}
+
+// 0: idle, 1: recording, 2: replaying
+EMSCRIPTEN_KEEPALIVE
+int get_input_replay_state(void) {
+    return (int)replay_get_stats()->state;
+}
+
+// Checksums of the current or last replay that did not match
+EMSCRIPTEN_KEEPALIVE
+int get_input_replay_mismatches(void) {
+    return (int)replay_get_stats()->mismatches;
+}
+
 // Initialize the game
 int main(void) {
     printf("Initializing QuakeCloneWASM...\n");
@@ -230,6 +452,12 @@ int main(void) {
         return 1;
     }
     
+    // Start render worker threads (one per core in threaded builds)
+    if (!jobs_init(0)) {
+        printf("ERROR: Failed to initialize job system\n");
+        return 1;
+    }
+    
     // Initialize input system
     if (!input_init()) {
         printf("ERROR: Failed to initialize input system\n");
@@ -241,6 +469,18 @@ int main(void) {
         printf("ERROR: Failed to initialize space system\n");
         return 1;
     }
+
+    // The galaxy around the home system (sectors are generated when queried)
+    if (!galaxy_init(GALAXY_DEFAULT_SEED, 0)) {
+        printf("ERROR: Failed to initialize galaxy\n");
+        return 1;
+    }
+
+    // Status block for the page (planet names and descriptions interned)
+    if (!hud_init()) {
+        printf("ERROR: Failed to initialize HUD status\n");
+        return 1;
+    }
     
     // Initialize world
     if (!world_init()) {
@@ -248,12 +488,12 @@ int main(void) {
         return 1;
     }
     
-    // Initialize player on first planet
+    // Initialize player on first planet (its map, spawn point and surface)
     int current_planet = space_get_current_planet();
     if (current_planet >= 0) {
         PlanetData* planet = space_get_planet(current_planet);
         if (planet) {
-            player_init(planet->map_offset_x, planet->map_offset_z);
+            space_beam_to_planet(current_planet);
             printf("Starting on planet: %s\n", planet->name);
         } else {
             // Fallback position
@@ -264,9 +504,19 @@ int main(void) {
         player_init(4.0f, 4.0f);
     }
     
+    // Fixed-timestep clock starts at tick 0
+    sim_init();
+    
     printf("Game initialized successfully!\n");
     printf("Starting main loop...\n");
+#ifdef __EMSCRIPTEN__
     emscripten_set_main_loop_arg(game_loop, NULL, 0, 1);
+#else
+    // Headless native build: no browser to drive requestAnimationFrame
+    while (g_game_state.running) {
+        game_loop(NULL);
+    }
+#endif
     
     return 0;
 }
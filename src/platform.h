@@ -0,0 +1,27 @@
+// Platform header - Emscripten / native portability shims
+// QuakeCloneWASM - Platform layer
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#else
+#include <time.h>
+
+// Native builds have no JavaScript to export to
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+
+// Monotonic time in milliseconds
+static inline double platform_now_ms(void) {
+#ifdef __EMSCRIPTEN__
+    return emscripten_get_now();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+#endif
+}
+
+#endif // PLATFORM_H
@@ -6,6 +6,7 @@
 #include "player.h"
 #include "input.h"
 #include "world.h"
+#include "collision.h"
 
 // Player state
 typedef struct {
@@ -13,6 +14,9 @@ typedef struct {
     float yaw, pitch;           // Rotation (degrees)
     float speed;                // Movement speed
     float mouse_sensitivity;    // Mouse look sensitivity
+    float prev_x, prev_z;       // Pose at the start of the last tick
+    float prev_yaw, prev_pitch;
+    float alpha;                // Render interpolation between prev and current
 } Player;
 
 static Player g_player = {
@@ -22,9 +26,18 @@ static Player g_player = {
     .yaw = 0.0f,
     .pitch = 0.0f,
     .speed = 5.0f,
-    .mouse_sensitivity = 0.5f
+    .mouse_sensitivity = 0.5f,
+    .alpha = 1.0f
 };
 
+// Render from the current pose (after a teleport)
+static void snap_view(void) {
+    g_player.prev_x = g_player.pos_x;
+    g_player.prev_z = g_player.pos_z;
+    g_player.prev_yaw = g_player.yaw;
+    g_player.prev_pitch = g_player.pitch;
+}
+
 // Initialize player at starting position
 void player_init(float start_x, float start_y) {
     g_player.pos_x = start_x;
@@ -32,12 +45,15 @@ void player_init(float start_x, float start_y) {
     g_player.pos_z = start_y;
     g_player.yaw = 0.0f;
     g_player.pitch = 0.0f;
+    snap_view();
     printf("Player initialized at (%.2f, %.2f, %.2f)\n", 
            g_player.pos_x, g_player.pos_y, g_player.pos_z);
 }
 
 // Update player state
 void player_update(double delta_time) {
+    snap_view();
+
     // Get mouse delta for look rotation
     float mouse_dx, mouse_dy;
     input_get_mouse_delta(&mouse_dx, &mouse_dy);
@@ -92,24 +108,15 @@ void player_update(double delta_time) {
     float move_z = (forward_z * move_forward_amount + right_z * move_right_amount) * 
                    g_player.speed * delta_time;
     
-    // Update position
-    float new_x = g_player.pos_x + move_x;
-    float new_z = g_player.pos_z + move_z;
-    
-    // Check collision before updating position (simple radius check)
-    // Player radius is about 0.3 units
+    // Sweep the player's circle through the map; a blocked axis keeps the
+    // other one's motion, so the player slides along walls
     float player_radius = 0.3f;
-    extern int world_check_collision(float x, float y, float z, float radius);
-    
-    // Only update position if no collision
-    if (!world_check_collision(new_x, 0.0f, new_z, player_radius)) {
-        g_player.pos_x = new_x;
-        g_player.pos_z = new_z;
-    }
+    CollisionGrid grid;
+    world_get_collision_grid(&grid);
+    collision_move(&grid, player_radius, &g_player.pos_x, &g_player.pos_z, move_x, move_z);
     
     // Clamp player to world bounds (prevent going outside map)
     float min_x, max_x, min_z, max_z;
-    extern void world_get_bounds(float* min_x, float* max_x, float* min_z, float* max_z);
     world_get_bounds(&min_x, &max_x, &min_z, &max_z);
     
     if (g_player.pos_x < min_x + player_radius) g_player.pos_x = min_x + player_radius;
@@ -147,6 +154,39 @@ float player_get_pitch(void) {
 void player_set_rotation(float yaw, float pitch) {
     g_player.yaw = yaw;
     g_player.pitch = pitch;
+    g_player.prev_yaw = yaw;
+    g_player.prev_pitch = pitch;
+}
+
+// Set player position directly (scripted cameras, benchmarks)
+void player_set_position(float x, float y, float z) {
+    g_player.pos_x = x;
+    g_player.pos_y = y;
+    g_player.pos_z = z;
+    g_player.prev_x = x;
+    g_player.prev_z = z;
+}
+
+void player_set_interpolation(float alpha) {
+    if (alpha < 0.0f) alpha = 0.0f;
+    if (alpha > 1.0f) alpha = 1.0f;
+    g_player.alpha = alpha;
+}
+
+// Blend the last two ticks; yaw turns the short way across 0/360
+void player_get_view(float* x, float* z, float* yaw, float* pitch) {
+    float a = g_player.alpha;
+    float turn = g_player.yaw - g_player.prev_yaw;
+    if (turn > 180.0f) turn -= 360.0f;
+    if (turn < -180.0f) turn += 360.0f;
+    float view_yaw = g_player.prev_yaw + turn * a;
+    if (view_yaw < 0.0f) view_yaw += 360.0f;
+    if (view_yaw >= 360.0f) view_yaw -= 360.0f;
+
+    if (x) *x = g_player.prev_x + (g_player.pos_x - g_player.prev_x) * a;
+    if (z) *z = g_player.prev_z + (g_player.pos_z - g_player.prev_z) * a;
+    if (yaw) *yaw = view_yaw;
+    if (pitch) *pitch = g_player.prev_pitch + (g_player.pitch - g_player.prev_pitch) * a;
 }
 
 // Move player (relative to current position)
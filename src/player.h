@@ -23,6 +23,17 @@ float player_get_pitch(void);
 // Set player rotation (for mouse look)
 void player_set_rotation(float yaw, float pitch);
 
+// Set player position directly (scripted cameras, benchmarks)
+void player_set_position(float x, float y, float z);
+
+// The setters above teleport: the camera does not interpolate from the
+// old pose. player_update moves between ticks, and the view blends the
+// last two ticks by alpha in [0, 1] (0: the previous tick, 1: the latest).
+void player_set_interpolation(float alpha);
+
+// Interpolated camera for rendering
+void player_get_view(float* x, float* z, float* yaw, float* pitch);
+
 // Move player (relative to current position)
 void player_move(float forward, float right, float up);
 
@@ -0,0 +1,247 @@
+// Profile implementation - Phase timers, frame ring, trace writer
+// QuakeCloneWASM - Profiling system
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "profile.h"
+#include "jobs.h"
+
+static const char* g_phase_names[PROFILE_PHASE_COUNT] = {
+    "frame", "input", "update", "world_render", "present", "jobs"
+};
+
+const char* profile_get_phase_name(ProfilePhase phase) {
+    return phase >= 0 && phase < PROFILE_PHASE_COUNT ? g_phase_names[phase] : "unknown";
+}
+
+#ifdef PROFILER
+
+// A timed span kept for the trace
+typedef struct {
+    double start_ms;
+    double end_ms;
+    int phase;
+} ProfileEvent;
+
+// Written only by its own thread; the main thread reads job_ms once the
+// frame's jobs have finished
+typedef struct {
+    double job_start_ms;
+    double job_ms;              // Job time this frame
+    ProfileEvent* events;
+    int event_count;
+    int dropped;                // Spans past the capture's capacity
+    char padding[64];           // Keep neighbouring threads off this cache line
+} ThreadProfile;
+
+static ThreadProfile g_threads[JOBS_MAX_THREADS];
+static ProfileFrame g_history[PROFILE_HISTORY];
+static ProfileFrame g_current;
+static double g_open_ms[PROFILE_PHASE_COUNT];
+static uint32_t g_frames = 0;
+static int g_capturing = 0;
+static int g_capacity = 0;
+static double g_capture_start_ms = 0.0;
+
+static void keep_event(ThreadProfile* thread, int phase, double start_ms, double end_ms) {
+    if (thread->event_count >= g_capacity) {
+        thread->dropped++;
+        return;
+    }
+    ProfileEvent* event = &thread->events[thread->event_count++];
+    event->start_ms = start_ms;
+    event->end_ms = end_ms;
+    event->phase = phase;
+}
+
+void profile_begin(ProfilePhase phase) {
+    g_open_ms[phase] = platform_now_ms();
+}
+
+void profile_end(ProfilePhase phase) {
+    double end = platform_now_ms();
+    g_current.phase_ms[phase] += end - g_open_ms[phase];
+    if (g_capturing) {
+        keep_event(&g_threads[0], phase, g_open_ms[phase], end);
+    }
+}
+
+void profile_job_begin(int thread_index) {
+    g_threads[thread_index].job_start_ms = platform_now_ms();
+}
+
+void profile_job_end(int thread_index) {
+    ThreadProfile* thread = &g_threads[thread_index];
+    double end = platform_now_ms();
+    thread->job_ms += end - thread->job_start_ms;
+    if (g_capturing) {
+        keep_event(thread, PROFILE_JOBS, thread->job_start_ms, end);
+    }
+}
+
+void profile_frame_begin(void) {
+    memset(&g_current, 0, sizeof(g_current));
+    g_current.frame = g_frames;
+    for (int i = 0; i < JOBS_MAX_THREADS; ++i) {
+        g_threads[i].job_ms = 0.0;
+    }
+    profile_begin(PROFILE_FRAME);
+}
+
+void profile_frame_end(void) {
+    profile_end(PROFILE_FRAME);
+    for (int i = 0; i < JOBS_MAX_THREADS; ++i) {
+        g_current.phase_ms[PROFILE_JOBS] += g_threads[i].job_ms;
+    }
+    g_history[g_frames % PROFILE_HISTORY] = g_current;
+    g_frames++;
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+int profile_get_stats(ProfilePhase phase, ProfileStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    int count = g_frames < PROFILE_HISTORY ? (int)g_frames : PROFILE_HISTORY;
+    if (count == 0 || phase < 0 || phase >= PROFILE_PHASE_COUNT) {
+        return 0;
+    }
+
+    double samples[PROFILE_HISTORY];
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) {
+        samples[i] = g_history[i].phase_ms[phase];
+        sum += samples[i];
+    }
+    qsort(samples, (size_t)count, sizeof(double), compare_double);
+
+    stats->frames = count;
+    stats->min_ms = samples[0];
+    stats->avg_ms = sum / count;
+    stats->p99_ms = samples[(int)(0.99 * (count - 1) + 0.5)];
+    stats->max_ms = samples[count - 1];
+    return 1;
+}
+
+const ProfileFrame* profile_get_last_frame(void) {
+    return g_frames ? &g_history[(g_frames - 1) % PROFILE_HISTORY] : NULL;
+}
+
+void profile_reset(void) {
+    g_frames = 0;
+}
+
+int profile_trace_begin(int max_events) {
+    for (int i = 0; i < JOBS_MAX_THREADS; ++i) {
+        ProfileEvent* events = (ProfileEvent*)realloc(g_threads[i].events, (size_t)max_events * sizeof(ProfileEvent));
+        if (!events) {
+            printf("ERROR: Failed to allocate %d trace events\n", max_events);
+            return 0;
+        }
+        g_threads[i].events = events;
+        g_threads[i].event_count = 0;
+        g_threads[i].dropped = 0;
+    }
+    g_capacity = max_events;
+    g_capture_start_ms = platform_now_ms();
+    g_capturing = 1;
+    return 1;
+}
+
+void profile_trace_end(void) {
+    g_capturing = 0;
+}
+
+#ifndef __EMSCRIPTEN__
+int profile_write_trace(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        printf("ERROR: Cannot write %s\n", path);
+        return 0;
+    }
+
+    // Complete events ("X") in microseconds, one track per thread
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    int first = 1;
+    int dropped = 0;
+    for (int t = 0; t < JOBS_MAX_THREADS; ++t) {
+        const ThreadProfile* thread = &g_threads[t];
+        dropped += thread->dropped;
+        if (thread->event_count == 0) {
+            continue;
+        }
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                "\"args\":{\"name\":\"%s %d\"}}", first ? "" : ",\n", t, t ? "worker" : "main", t);
+        first = 0;
+        for (int i = 0; i < thread->event_count; ++i) {
+            const ProfileEvent* event = &thread->events[i];
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                    "\"ts\":%.3f,\"dur\":%.3f}",
+                    g_phase_names[event->phase], event->phase == PROFILE_JOBS ? "jobs" : "frame", t,
+                    (event->start_ms - g_capture_start_ms) * 1000.0,
+                    (event->end_ms - event->start_ms) * 1000.0);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    if (dropped) {
+        printf("WARNING: %d spans did not fit the trace buffers\n", dropped);
+    }
+    return 1;
+}
+#endif
+
+void profile_shutdown(void) {
+    g_capturing = 0;
+    for (int i = 0; i < JOBS_MAX_THREADS; ++i) {
+        free(g_threads[i].events);
+        g_threads[i].events = NULL;
+    }
+    g_capacity = 0;
+}
+
+#else // Profiler compiled out
+
+void profile_begin(ProfilePhase phase) { (void)phase; }
+void profile_end(ProfilePhase phase) { (void)phase; }
+void profile_job_begin(int thread_index) { (void)thread_index; }
+void profile_job_end(int thread_index) { (void)thread_index; }
+void profile_frame_begin(void) {}
+void profile_frame_end(void) {}
+
+int profile_get_stats(ProfilePhase phase, ProfileStats* stats) {
+    (void)phase;
+    memset(stats, 0, sizeof(*stats));
+    return 0;
+}
+
+const ProfileFrame* profile_get_last_frame(void) {
+    return NULL;
+}
+
+void profile_reset(void) {}
+
+int profile_trace_begin(int max_events) {
+    (void)max_events;
+    printf("ERROR: Profiler not compiled in (build with PROFILE=1)\n");
+    return 0;
+}
+
+void profile_trace_end(void) {}
+
+#ifndef __EMSCRIPTEN__
+int profile_write_trace(const char* path) {
+    (void)path;
+    return 0;
+}
+#endif
+
+void profile_shutdown(void) {}
+
+#endif // PROFILER
@@ -0,0 +1,102 @@
+// Profile header - Scoped phase timers, per-frame history, trace export
+// QuakeCloneWASM - Profiling system
+//
+// PROFILE_BEGIN/PROFILE_END time a phase of the frame; the times of every
+// frame land in a ring of the last PROFILE_HISTORY frames, from which
+// profile_get_stats reports min/avg/p99/max per phase. Worker threads time
+// their job ranges with PROFILE_JOB_BEGIN/END. While a trace is captured
+// every timed span is also kept, to be written as Chrome trace-event JSON
+// (chrome://tracing, Perfetto) by native builds.
+//
+// The timers exist only in builds with -DPROFILER (native builds by
+// default, web builds with PROFILE=1); elsewhere the macros compile to
+// nothing and the query functions report zeros.
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+// Frames kept for the statistics
+#define PROFILE_HISTORY 256
+
+typedef enum {
+    PROFILE_FRAME = 0,          // profile_frame_begin to profile_frame_end
+    PROFILE_INPUT,              // Draining the input queue
+    PROFILE_UPDATE,             // Simulation ticks
+    PROFILE_WORLD_RENDER,       // world_render (sprites and strips included)
+    PROFILE_PRESENT,            // renderer_present (upload and draw)
+    PROFILE_JOBS,               // Job ranges on all threads (summed)
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+// One frame of the history
+typedef struct {
+    uint32_t frame;             // Frame number since profile_reset
+    double phase_ms[PROFILE_PHASE_COUNT];
+} ProfileFrame;
+
+typedef struct {
+    int frames;                 // Frames the statistics cover
+    double min_ms;
+    double avg_ms;
+    double p99_ms;
+    double max_ms;
+} ProfileStats;
+
+#ifdef PROFILER
+#define PROFILE_BEGIN(phase) profile_begin(phase)
+#define PROFILE_END(phase) profile_end(phase)
+#define PROFILE_JOB_BEGIN(thread_index) profile_job_begin(thread_index)
+#define PROFILE_JOB_END(thread_index) profile_job_end(thread_index)
+#define PROFILE_FRAME_BEGIN() profile_frame_begin()
+#define PROFILE_FRAME_END() profile_frame_end()
+#else
+#define PROFILE_BEGIN(phase) ((void)0)
+#define PROFILE_END(phase) ((void)0)
+#define PROFILE_JOB_BEGIN(thread_index) ((void)0)
+#define PROFILE_JOB_END(thread_index) ((void)0)
+#define PROFILE_FRAME_BEGIN() ((void)0)
+#define PROFILE_FRAME_END() ((void)0)
+#endif
+
+// Main thread phases; a phase may run several times in a frame (its times
+// add up) but must not nest inside itself
+void profile_begin(ProfilePhase phase);
+void profile_end(ProfilePhase phase);
+
+// Worker side, around the job ranges of thread_index (0 = main thread)
+void profile_job_begin(int thread_index);
+void profile_job_end(int thread_index);
+
+// Frame boundaries; profile_frame_end stores the frame in the history
+void profile_frame_begin(void);
+void profile_frame_end(void);
+
+// Statistics of phase over the frames in the history. Returns 0 (and
+// zeros) when there are none or the profiler is compiled out.
+int profile_get_stats(ProfilePhase phase, ProfileStats* stats);
+
+// The most recent frame (NULL if none)
+const ProfileFrame* profile_get_last_frame(void);
+
+const char* profile_get_phase_name(ProfilePhase phase);
+
+// Forget the history
+void profile_reset(void);
+
+// Keep every span from now on, up to max_events per thread. Returns 0 if
+// the buffers cannot be allocated or the profiler is compiled out.
+int profile_trace_begin(int max_events);
+
+// Stop keeping spans; the captured ones stay until the next capture
+void profile_trace_end(void);
+
+#ifndef __EMSCRIPTEN__
+// Write the captured spans as Chrome trace-event JSON. Returns 0 on failure.
+int profile_write_trace(const char* path);
+#endif
+
+void profile_shutdown(void);
+
+#endif // PROFILE_H
@@ -0,0 +1,244 @@
+// QMap implementation - Load and write binary map images
+// QuakeCloneWASM - World system
+//
+// Validation only looks at the header and level table, so loading costs the
+// same for a 16x16 and a 4096x4096 map. Native builds mmap the file; the
+// browser build fetches it into the heap from JavaScript and attaches it.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "qmap.h"
+
+#ifndef __EMSCRIPTEN__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+typedef char qmap_header_size_check[(sizeof(QMapHeader) == 96) ? 1 : -1];
+typedef char qmap_level_size_check[(sizeof(QMapLevel) == 16) ? 1 : -1];
+typedef char qmap_spawn_size_check[(sizeof(QMapSpawn) == 16) ? 1 : -1];
+
+static size_t align_up(size_t value) {
+    return (value + QMAP_ALIGNMENT - 1) & ~(size_t)(QMAP_ALIGNMENT - 1);
+}
+
+// [offset, offset + size) lies inside the image
+static int section_fits(uint32_t offset, uint64_t size, size_t image_size) {
+    return (offset % 4) == 0 && (uint64_t)offset + size <= (uint64_t)image_size;
+}
+
+// Validate an image and point file at it
+int qmap_attach(QMapFile* file, const void* data, size_t size) {
+    memset(file, 0, sizeof(*file));
+
+    const QMapHeader* header = (const QMapHeader*)data;
+    if (!data || size < sizeof(QMapHeader) || ((uintptr_t)data % 4) != 0) {
+        printf("ERROR: Map image is too small or misaligned\n");
+        return 0;
+    }
+    if (header->magic != QMAP_MAGIC || header->version != QMAP_VERSION ||
+        header->header_size != sizeof(QMapHeader) || header->file_size != size) {
+        printf("ERROR: Not a version %d map image\n", QMAP_VERSION);
+        return 0;
+    }
+
+    int width = header->width;
+    int height = header->height;
+    int tiles_x = (width + WORLDMAP_TILE_SIZE - 1) / WORLDMAP_TILE_SIZE;
+    int tiles_y = (height + WORLDMAP_TILE_SIZE - 1) / WORLDMAP_TILE_SIZE;
+    size_t cell_bytes = ((size_t)tiles_x * (size_t)tiles_y << (2 * WORLDMAP_TILE_LOG2)) + WORLDMAP_PADDING;
+    if (width <= 0 || height <= 0 || header->tiles_x != tiles_x || header->tiles_y != tiles_y ||
+        header->cells_size < cell_bytes || !section_fits(header->cells_offset, header->cells_size, size) ||
+        header->level_count <= 0 || header->level_count > WORLDMAP_MAX_LEVELS ||
+        !section_fits(header->levels_offset, (uint64_t)header->level_count * sizeof(QMapLevel), size) ||
+        !section_fits(header->spawns_offset, (uint64_t)header->spawn_count * sizeof(QMapSpawn), size) ||
+        memchr(header->name, 0, QMAP_NAME_LENGTH) == NULL) {
+        printf("ERROR: Map image header is inconsistent\n");
+        return 0;
+    }
+
+    const uint8_t* bytes = (const uint8_t*)data;
+    const QMapLevel* levels = (const QMapLevel*)(bytes + header->levels_offset);
+    WorldMap* map = &file->map;
+    map->width = width;
+    map->height = height;
+    map->tiles_x = tiles_x;
+    map->tiles_y = tiles_y;
+    map->cells = (uint8_t*)(bytes + header->cells_offset);
+    map->cell_bytes = header->cells_size;
+    map->level_count = header->level_count;
+
+    // Each level halves the previous one, ending in a single block
+    int level_width = tiles_x;
+    int level_height = tiles_y;
+    for (int k = 0; k < header->level_count; ++k) {
+        const QMapLevel* level = &levels[k];
+        if (level->width != level_width || level->height != level_height ||
+            level->size < (uint64_t)level_width * (uint64_t)level_height + WORLDMAP_PADDING ||
+            !section_fits(level->offset, level->size, size)) {
+            printf("ERROR: Map image level %d is inconsistent\n", k);
+            memset(file, 0, sizeof(*file));
+            return 0;
+        }
+        map->level_width[k] = level_width;
+        map->level_height[k] = level_height;
+        map->levels[k] = (uint8_t*)(bytes + level->offset);
+        map->pyramid_bytes += level->size;
+        level_width = (level_width + 1) / 2;
+        level_height = (level_height + 1) / 2;
+    }
+    if (map->level_width[map->level_count - 1] != 1 || map->level_height[map->level_count - 1] != 1) {
+        printf("ERROR: Map image pyramid is incomplete\n");
+        memset(file, 0, sizeof(*file));
+        return 0;
+    }
+
+    file->header = header;
+    file->spawns = (const QMapSpawn*)(bytes + header->spawns_offset);
+    file->data = bytes;
+    file->size = size;
+    return 1;
+}
+
+// Map a .qmap file into memory
+int qmap_open(QMapFile* file, const char* path) {
+    memset(file, 0, sizeof(*file));
+
+#ifndef __EMSCRIPTEN__
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("ERROR: Cannot open map %s\n", path);
+        return 0;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        printf("ERROR: Cannot read map %s\n", path);
+        close(fd);
+        return 0;
+    }
+    size_t size = (size_t)info.st_size;
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        printf("ERROR: Cannot map %s\n", path);
+        return 0;
+    }
+    if (!qmap_attach(file, data, size)) {
+        munmap(data, size);
+        return 0;
+    }
+    file->mapped = 1;
+#else
+    // The browser build has no real file system: read the whole image once
+    FILE* stream = fopen(path, "rb");
+    if (!stream) {
+        printf("ERROR: Cannot open map %s\n", path);
+        return 0;
+    }
+    fseek(stream, 0, SEEK_END);
+    long length = ftell(stream);
+    fseek(stream, 0, SEEK_SET);
+    void* data = length > 0 ? malloc((size_t)length) : NULL;
+    if (!data || fread(data, 1, (size_t)length, stream) != (size_t)length) {
+        printf("ERROR: Cannot read map %s\n", path);
+        free(data);
+        fclose(stream);
+        return 0;
+    }
+    fclose(stream);
+    if (!qmap_attach(file, data, (size_t)length)) {
+        free(data);
+        return 0;
+    }
+    file->mapped = 2;
+#endif
+    return 1;
+}
+
+// Release the image
+void qmap_close(QMapFile* file) {
+#ifndef __EMSCRIPTEN__
+    if (file->mapped == 1) {
+        munmap((void*)file->data, file->size);
+    }
+#endif
+    if (file->mapped == 2) {
+        free((void*)file->data);
+    }
+    memset(file, 0, sizeof(*file));
+}
+
+// Write map and its spawns as a .qmap file
+int qmap_write(const char* path, const WorldMap* map, const char* name,
+               const QMapSpawn* spawns, int spawn_count) {
+    QMapHeader header;
+    QMapLevel levels[WORLDMAP_MAX_LEVELS];
+    memset(&header, 0, sizeof(header));
+    memset(levels, 0, sizeof(levels));
+
+    // Layout: header, level table, spawns, cells, levels
+    size_t offset = align_up(sizeof(QMapHeader));
+    header.levels_offset = (uint32_t)offset;
+    offset = align_up(offset + (size_t)map->level_count * sizeof(QMapLevel));
+    header.spawns_offset = (uint32_t)offset;
+    offset = align_up(offset + (size_t)spawn_count * sizeof(QMapSpawn));
+    header.cells_offset = (uint32_t)offset;
+    header.cells_size = (uint32_t)map->cell_bytes;
+    offset = align_up(offset + map->cell_bytes);
+    for (int k = 0; k < map->level_count; ++k) {
+        levels[k].width = map->level_width[k];
+        levels[k].height = map->level_height[k];
+        levels[k].offset = (uint32_t)offset;
+        levels[k].size = (uint32_t)((size_t)map->level_width[k] * (size_t)map->level_height[k] + WORLDMAP_PADDING);
+        offset = align_up(offset + levels[k].size);
+    }
+    if (offset > 0xFFFFFFFFu) {
+        printf("ERROR: Map is too large for the file format\n");
+        return 0;
+    }
+
+    header.magic = QMAP_MAGIC;
+    header.version = QMAP_VERSION;
+    header.header_size = sizeof(QMapHeader);
+    header.file_size = (uint32_t)offset;
+    header.width = map->width;
+    header.height = map->height;
+    header.tiles_x = map->tiles_x;
+    header.tiles_y = map->tiles_y;
+    header.level_count = map->level_count;
+    header.spawn_count = (uint32_t)spawn_count;
+    strncpy(header.name, name ? name : "", QMAP_NAME_LENGTH - 1);
+
+    uint8_t* image = (uint8_t*)calloc(offset, 1);
+    if (!image) {
+        printf("ERROR: Out of memory writing %s\n", path);
+        return 0;
+    }
+    memcpy(image, &header, sizeof(header));
+    memcpy(image + header.levels_offset, levels, (size_t)map->level_count * sizeof(QMapLevel));
+    if (spawn_count > 0) {
+        memcpy(image + header.spawns_offset, spawns, (size_t)spawn_count * sizeof(QMapSpawn));
+    }
+    memcpy(image + header.cells_offset, map->cells, map->cell_bytes);
+    for (int k = 0; k < map->level_count; ++k) {
+        memcpy(image + levels[k].offset, map->levels[k], levels[k].size);
+    }
+
+    FILE* stream = fopen(path, "wb");
+    if (!stream) {
+        printf("ERROR: Cannot write %s\n", path);
+        free(image);
+        return 0;
+    }
+    size_t written = fwrite(image, 1, offset, stream);
+    fclose(stream);
+    free(image);
+    if (written != offset) {
+        printf("ERROR: Short write to %s\n", path);
+        return 0;
+    }
+    return 1;
+}
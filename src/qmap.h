@@ -0,0 +1,79 @@
+// QMap header - Versioned binary map format
+// QuakeCloneWASM - World system
+//
+// A .qmap file is the in-memory WorldMap laid out in one little-endian
+// image: header, level table, tiled cells, occupancy pyramid, spawn points.
+// Loading validates the header and points a WorldMap into the image; no
+// cell is parsed or copied. Produce files with tools/qmapconv.
+
+#ifndef QMAP_H
+#define QMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "worldmap.h"
+
+#define QMAP_MAGIC 0x50414D51u  // "QMAP"
+#define QMAP_VERSION 1
+#define QMAP_NAME_LENGTH 32
+#define QMAP_ALIGNMENT 16       // Every section starts on a 16-byte boundary
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;       // sizeof(QMapHeader) for this version
+    uint32_t file_size;
+    int32_t width;              // Cells along x
+    int32_t height;             // Cells along z
+    int32_t tiles_x;
+    int32_t tiles_y;
+    int32_t level_count;
+    uint32_t levels_offset;     // QMapLevel[level_count]
+    uint32_t cells_offset;      // Tiled cells as in WorldMap (padding included)
+    uint32_t cells_size;
+    uint32_t spawns_offset;     // QMapSpawn[spawn_count]
+    uint32_t spawn_count;
+    char name[QMAP_NAME_LENGTH]; // NUL-terminated display name
+    uint32_t reserved[3];
+} QMapHeader;
+
+typedef struct {
+    int32_t width;
+    int32_t height;
+    uint32_t offset;
+    uint32_t size;              // Padding included
+} QMapLevel;
+
+// Player start in world units (the first spawn is the default)
+typedef struct {
+    float x;
+    float z;
+    float yaw;                  // Degrees
+    uint32_t flags;             // Reserved, 0
+} QMapSpawn;
+
+// A map backed by a file image
+typedef struct {
+    WorldMap map;               // Views into data
+    const QMapHeader* header;
+    const QMapSpawn* spawns;
+    const uint8_t* data;        // Whole image
+    size_t size;
+    int mapped;                 // 1: mmap'd, 2: read into the heap, 0: caller-owned
+} QMapFile;
+
+// Validate an image and point file at it. data must stay valid (and
+// 4-byte aligned) while the map is in use; nothing is copied.
+int qmap_attach(QMapFile* file, const void* data, size_t size);
+
+// Map a .qmap file into memory (mmap natively, a single read elsewhere)
+int qmap_open(QMapFile* file, const char* path);
+
+// Unmap or free the image as appropriate and clear file
+void qmap_close(QMapFile* file);
+
+// Write map and its spawns as a .qmap file
+int qmap_write(const char* path, const WorldMap* map, const char* name,
+               const QMapSpawn* spawns, int spawn_count);
+
+#endif // QMAP_H
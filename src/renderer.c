@@ -1,32 +1,34 @@
 // Renderer implementation - Software raycasting composited through WebGL
 // QuakeCloneWASM - Rendering system
+//
+// The software framebuffer is shared by every build. How it reaches the
+// screen is up to the backend: WebGL2 compositing under Emscripten, or a
+// headless stub for native builds (benchmarks, profiling, golden images).
 
-#include <emscripten.h>
-#include <emscripten/html5.h>
 #include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "platform.h"
 #include "renderer.h"
+#include "camera.h"
 
 #ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#include <emscripten/html5.h>
 #include <GLES3/gl3.h>
-#else
-#ifdef _WIN32
-#include <GL/glew.h>
-#else
-#include <OpenGL/gl3.h>
-#endif
 #endif
 
+#ifdef __EMSCRIPTEN__
 // GPU resources
 static EMSCRIPTEN_WEBGL_CONTEXT_HANDLE g_webgl_context = 0;
 static GLuint g_shader_program = 0;
 static GLuint g_quad_vao = 0;
 static GLuint g_quad_vbo = 0;
 static GLuint g_scene_texture = 0;
+#endif
 
 // Software framebuffer
 static uint32_t* g_framebuffer = NULL;
@@ -34,14 +36,42 @@ static size_t g_framebuffer_capacity = 0;
 
 // Renderer state
 static int g_renderer_initialized = 0;
-static int g_viewport_width = 800;
+static int g_clear_needed = 1;
+static int g_cleared_this_frame = 0;
+static size_t g_frame_bytes_written = 0;
+
+static int g_viewport_width = 800;   // Internal render size (framebuffer)
 static int g_viewport_height = 600;
+static int g_output_width = 800;     // Canvas size the quad is drawn at
+static int g_output_height = 600;
 int g_gl_state_ready = 0; // Exposed for world rendering checks
 
+// Damage tracking
+static RendererRect g_dirty_rects[RENDERER_MAX_DIRTY_RECTS];
+static int g_dirty_count = 0;
+static RendererStats g_stats;
+
+// Dynamic resolution: every RENDERER_SCALE_WINDOW rendered frames the
+// controller compares the mean frame time with the budget and picks a new
+// render scale; the compositing quad upscales with linear filtering
+#define RENDERER_SCALE_WINDOW 8
+#define RENDERER_SCALE_STEP_UP 0.05f
+static float g_render_scale = 1.0f;
+static float g_fixed_scale = 0.0f; // > 0 pins the scale
+static double g_frame_budget_ms = RENDERER_DEFAULT_BUDGET_MS;
+static double g_frame_start_ms = 0.0;
+static double g_window_ms = 0.0;
+static int g_window_frames = 0;
+
+// Backend hooks (WebGL2 or headless)
+static int backend_init(void);
+static void backend_present(const RendererRect* rects, int count);
+static void backend_resize(void);
+static void backend_shutdown(void);
+
 // Internal helpers
-static GLuint compile_shader(GLenum type, const char* source);
-static GLuint create_shader_program(void);
-static void create_fullscreen_quad(void);
+static void apply_render_size(void);
+static void update_render_scale(double frame_ms);
 static void ensure_framebuffer_capacity(int width, int height);
 static uint32_t pack_color(uint8_t r, uint8_t g, uint8_t b);
 
@@ -51,9 +81,310 @@ int renderer_init(int width, int height) {
         return 1;
     }
 
+    g_output_width = width;
+    g_output_height = height;
+    g_viewport_width = width;
+    g_viewport_height = height;
+
+    ensure_framebuffer_capacity(g_viewport_width, g_viewport_height);
+    if (!g_framebuffer) {
+        return 0;
+    }
+
+    if (!camera_tables_build(g_viewport_width, g_viewport_height)) {
+        return 0;
+    }
+
+    if (!backend_init()) {
+        return 0;
+    }
+
+    memset(&g_stats, 0, sizeof(g_stats));
+    renderer_mark_all_dirty();
+
+    g_renderer_initialized = 1;
+    g_gl_state_ready = 1;
+
+#ifdef __EMSCRIPTEN__
+    printf("Renderer initialized: %dx%d (WebGL2 compositing pipeline)\n", g_viewport_width, g_viewport_height);
+#else
+    printf("Renderer initialized: %dx%d (headless)\n", g_viewport_width, g_viewport_height);
+#endif
+    return 1;
+}
+
+// Clear the software framebuffer with a base color
+void renderer_clear(void) {
+    g_frame_bytes_written = 0;
+    g_cleared_this_frame = 0;
+    g_frame_start_ms = platform_now_ms();
+
+    if (!g_renderer_initialized || !g_framebuffer || !g_clear_needed) {
+        return;
+    }
+
+    uint32_t clear_color = pack_color(20, 22, 28);
+    size_t pixel_count = (size_t)g_viewport_width * (size_t)g_viewport_height;
+    for (size_t i = 0; i < pixel_count; ++i) {
+        g_framebuffer[i] = clear_color;
+    }
+    g_frame_bytes_written += pixel_count * sizeof(uint32_t);
+    g_cleared_this_frame = 1;
+    renderer_mark_all_dirty();
+}
+
+int renderer_frame_was_cleared(void) {
+    return g_cleared_this_frame;
+}
+
+void renderer_set_clear_needed(int needed) {
+    g_clear_needed = needed;
+}
+
+// Per-frame store accounting for the software passes
+void renderer_count_bytes_written(size_t bytes) {
+    g_frame_bytes_written += bytes;
+}
+
+size_t renderer_get_bytes_written(void) {
+    return g_frame_bytes_written;
+}
+
+// Upload the dirty parts of the framebuffer and draw a fullscreen quad
+void renderer_present(void) {
+    if (!g_renderer_initialized || !g_framebuffer) {
+        return;
+    }
+
+    // Nothing changed: the canvas still shows the last presented frame
+    if (g_dirty_count == 0) {
+        g_stats.frames_skipped++;
+        g_stats.last_upload_bytes = 0;
+        return;
+    }
+
+    uint64_t upload_bytes = 0;
+    for (int i = 0; i < g_dirty_count; ++i) {
+        upload_bytes += (uint64_t)g_dirty_rects[i].width * (uint64_t)g_dirty_rects[i].height * sizeof(uint32_t);
+    }
+
+    backend_present(g_dirty_rects, g_dirty_count);
+
+    g_stats.frames_presented++;
+    g_stats.last_upload_bytes = upload_bytes;
+    g_stats.total_upload_bytes += upload_bytes;
+    g_dirty_count = 0;
+
+    // Only frames that did work feed the resolution controller
+    update_render_scale(platform_now_ms() - g_frame_start_ms);
+}
+
+// Add a dirty rectangle (clipped to the viewport); when the list is full
+// everything collapses into one bounding rectangle
+void renderer_mark_dirty(int x, int y, int width, int height) {
+    int x1 = x + width;
+    int y1 = y + height;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x1 > g_viewport_width) x1 = g_viewport_width;
+    if (y1 > g_viewport_height) y1 = g_viewport_height;
+    if (x >= x1 || y >= y1) {
+        return;
+    }
+
+    if (g_dirty_count == RENDERER_MAX_DIRTY_RECTS) {
+        for (int i = 0; i < g_dirty_count; ++i) {
+            const RendererRect* rect = &g_dirty_rects[i];
+            if (rect->x < x) x = rect->x;
+            if (rect->y < y) y = rect->y;
+            if (rect->x + rect->width > x1) x1 = rect->x + rect->width;
+            if (rect->y + rect->height > y1) y1 = rect->y + rect->height;
+        }
+        g_dirty_count = 0;
+    }
+
+    RendererRect* rect = &g_dirty_rects[g_dirty_count++];
+    rect->x = x;
+    rect->y = y;
+    rect->width = x1 - x;
+    rect->height = y1 - y;
+}
+
+void renderer_mark_all_dirty(void) {
+    g_dirty_count = 0;
+    renderer_mark_dirty(0, 0, g_viewport_width, g_viewport_height);
+}
+
+const RendererStats* renderer_get_stats(void) {
+    return &g_stats;
+}
+
+// Resize framebuffer and texture resources
+void renderer_resize(int width, int height) {
+    if (!g_renderer_initialized) {
+        return;
+    }
+
+    g_output_width = width;
+    g_output_height = height;
+    apply_render_size();
+}
+
+// Expose viewport dimensions (internal render size)
+void renderer_get_viewport(int* width, int* height) {
+    if (width) *width = g_viewport_width;
+    if (height) *height = g_viewport_height;
+}
+
+void renderer_get_output_size(int* width, int* height) {
+    if (width) *width = g_output_width;
+    if (height) *height = g_output_height;
+}
+
+// Pin the render scale (0 hands it back to the frame time controller)
+void renderer_set_fixed_scale(float scale) {
+    if (scale > 0.0f) {
+        if (scale < RENDERER_MIN_SCALE) scale = RENDERER_MIN_SCALE;
+        if (scale > 1.0f) scale = 1.0f;
+    } else {
+        scale = 0.0f;
+    }
+    g_fixed_scale = scale;
+    g_window_ms = 0.0;
+    g_window_frames = 0;
+
+    if (scale > 0.0f && scale != g_render_scale) {
+        g_render_scale = scale;
+        apply_render_size();
+    }
+}
+
+void renderer_set_frame_budget_ms(double budget_ms) {
+    if (budget_ms > 0.0) {
+        g_frame_budget_ms = budget_ms;
+    }
+}
+
+float renderer_get_scale(void) {
+    return g_render_scale;
+}
+
+// Return the software framebuffer pointer
+uint32_t* renderer_get_framebuffer(void) {
+    return g_framebuffer;
+}
+
+// Renderer readiness flag
+int renderer_gl_ready(void) {
+    return g_gl_state_ready;
+}
+
+// Release GPU and CPU resources
+void renderer_shutdown(void) {
+    if (!g_renderer_initialized) {
+        return;
+    }
+
+    backend_shutdown();
+
+    if (g_framebuffer) {
+        free(g_framebuffer);
+        g_framebuffer = NULL;
+        g_framebuffer_capacity = 0;
+    }
+
+    camera_tables_free();
+
+    g_renderer_initialized = 0;
+    g_gl_state_ready = 0;
+}
+
+// -------------------------------------------------------------------------
+// Internal helpers
+// -------------------------------------------------------------------------
+
+// Size the framebuffer and dependent resources for output size * scale
+static void apply_render_size(void) {
+    int width = (int)((float)g_output_width * g_render_scale + 0.5f);
+    int height = (int)((float)g_output_height * g_render_scale + 0.5f);
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+
     g_viewport_width = width;
     g_viewport_height = height;
 
+    ensure_framebuffer_capacity(width, height);
+    camera_tables_build(width, height);
+    g_clear_needed = 1; // New pixels have no content yet
+    renderer_mark_all_dirty();
+
+    if (g_renderer_initialized) {
+        backend_resize();
+    }
+}
+
+// Feed one frame time to the controller; rescale at the end of each window
+static void update_render_scale(double frame_ms) {
+    if (g_fixed_scale > 0.0f) {
+        return;
+    }
+
+    g_window_ms += frame_ms;
+    if (++g_window_frames < RENDERER_SCALE_WINDOW) {
+        return;
+    }
+
+    double mean_ms = g_window_ms / (double)g_window_frames;
+    g_window_ms = 0.0;
+    g_window_frames = 0;
+
+    // Cost scales with pixel count, so shrink both axes by sqrt(budget / time);
+    // grow back slowly once there is clear headroom
+    float scale = g_render_scale;
+    if (mean_ms > g_frame_budget_ms) {
+        scale *= (float)sqrt(g_frame_budget_ms / mean_ms);
+    } else if (mean_ms < g_frame_budget_ms * 0.6) {
+        scale += RENDERER_SCALE_STEP_UP;
+    }
+    if (scale < RENDERER_MIN_SCALE) scale = RENDERER_MIN_SCALE;
+    if (scale > 1.0f) scale = 1.0f;
+
+    if (fabsf(scale - g_render_scale) >= 0.01f) {
+        g_render_scale = scale;
+        apply_render_size();
+    }
+}
+
+static void ensure_framebuffer_capacity(int width, int height) {
+    size_t required = (size_t)width * (size_t)height;
+    if (required > g_framebuffer_capacity) {
+        uint32_t* new_buffer = (uint32_t*)realloc(g_framebuffer, required * sizeof(uint32_t));
+        if (!new_buffer) {
+            printf("ERROR: Failed to allocate framebuffer (%zu pixels)\n", required);
+            return;
+        }
+        g_framebuffer = new_buffer;
+        g_framebuffer_capacity = required;
+    }
+}
+
+static uint32_t pack_color(uint8_t r, uint8_t g, uint8_t b) {
+    return 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+}
+
+
+// -------------------------------------------------------------------------
+// Backends
+// -------------------------------------------------------------------------
+
+#ifdef __EMSCRIPTEN__
+
+static GLuint compile_shader(GLenum type, const char* source);
+static GLuint create_shader_program(void);
+static void create_fullscreen_quad(void);
+
+// Create the WebGL2 context and the compositing resources
+static int backend_init(void) {
     EmscriptenWebGLContextAttributes attrs;
     emscripten_webgl_init_context_attributes(&attrs);
     attrs.alpha = 0;
@@ -87,7 +418,6 @@ int renderer_init(int width, int height) {
     }
 
     create_fullscreen_quad();
-    ensure_framebuffer_capacity(g_viewport_width, g_viewport_height);
 
     glGenTextures(1, &g_scene_texture);
     glBindTexture(GL_TEXTURE_2D, g_scene_texture);
@@ -101,43 +431,32 @@ int renderer_init(int width, int height) {
     GLint texture_location = glGetUniformLocation(g_shader_program, "uTexture");
     glUniform1i(texture_location, 0); // Texture unit 0
 
-    glViewport(0, 0, g_viewport_width, g_viewport_height);
+    glViewport(0, 0, g_output_width, g_output_height);
     glDisable(GL_DEPTH_TEST);
     glClearColor(0.1f, 0.12f, 0.16f, 1.0f);
 
-    g_renderer_initialized = 1;
-    g_gl_state_ready = 1;
-
-    printf("Renderer initialized: %dx%d (WebGL2 compositing pipeline)\n", g_viewport_width, g_viewport_height);
     return 1;
 }
 
-// Clear the software framebuffer with a base color
-void renderer_clear(void) {
-    if (!g_renderer_initialized || !g_framebuffer) {
-        return;
-    }
-
-    uint32_t clear_color = pack_color(20, 22, 28);
-    size_t pixel_count = (size_t)g_viewport_width * (size_t)g_viewport_height;
-    for (size_t i = 0; i < pixel_count; ++i) {
-        g_framebuffer[i] = clear_color;
-    }
-}
-
-// Upload the software framebuffer to the GPU texture and draw a fullscreen quad
-void renderer_present(void) {
-    if (!g_renderer_initialized || !g_framebuffer) {
-        return;
-    }
-
+// Upload the dirty rectangles to the scene texture and draw the fullscreen quad
+static void backend_present(const RendererRect* rects, int count) {
     emscripten_webgl_make_context_current(g_webgl_context);
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, g_scene_texture);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, g_viewport_width, g_viewport_height, GL_RGBA, GL_UNSIGNED_BYTE, g_framebuffer);
 
-    glViewport(0, 0, g_viewport_width, g_viewport_height);
+    // Sub-rectangles are read straight out of the full-width framebuffer
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, g_viewport_width);
+    for (int i = 0; i < count; ++i) {
+        const RendererRect* rect = &rects[i];
+        const uint32_t* pixels = g_framebuffer + (size_t)rect->y * (size_t)g_viewport_width + rect->x;
+        glTexSubImage2D(GL_TEXTURE_2D, 0, rect->x, rect->y, rect->width, rect->height,
+                        GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    // The quad stretches the render-size texture over the whole canvas
+    glViewport(0, 0, g_output_width, g_output_height);
     glClear(GL_COLOR_BUFFER_BIT);
 
     glUseProgram(g_shader_program);
@@ -145,45 +464,16 @@ void renderer_present(void) {
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 }
 
-// Resize framebuffer and texture resources
-void renderer_resize(int width, int height) {
-    if (!g_renderer_initialized) {
-        return;
-    }
-
-    g_viewport_width = width;
-    g_viewport_height = height;
-
-    ensure_framebuffer_capacity(width, height);
-
+// Reallocate the scene texture for the new render size
+static void backend_resize(void) {
     emscripten_webgl_make_context_current(g_webgl_context);
     glBindTexture(GL_TEXTURE_2D, g_scene_texture);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, g_viewport_width, g_viewport_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glViewport(0, 0, g_viewport_width, g_viewport_height);
+    glViewport(0, 0, g_output_width, g_output_height);
 }
 
-// Expose viewport dimensions
-void renderer_get_viewport(int* width, int* height) {
-    if (width) *width = g_viewport_width;
-    if (height) *height = g_viewport_height;
-}
-
-// Return the software framebuffer pointer
-uint32_t* renderer_get_framebuffer(void) {
-    return g_framebuffer;
-}
-
-// Renderer readiness flag
-int renderer_gl_ready(void) {
-    return g_gl_state_ready;
-}
-
-// Release GPU and CPU resources
-void renderer_shutdown(void) {
-    if (!g_renderer_initialized) {
-        return;
-    }
-
+// Release GPU resources and the WebGL context
+static void backend_shutdown(void) {
     emscripten_webgl_make_context_current(g_webgl_context);
 
     if (g_scene_texture) {
@@ -203,25 +493,12 @@ void renderer_shutdown(void) {
         g_shader_program = 0;
     }
 
-    if (g_framebuffer) {
-        free(g_framebuffer);
-        g_framebuffer = NULL;
-        g_framebuffer_capacity = 0;
-    }
-
     if (g_webgl_context) {
         emscripten_webgl_destroy_context(g_webgl_context);
         g_webgl_context = 0;
     }
-
-    g_renderer_initialized = 0;
-    g_gl_state_ready = 0;
 }
 
-// -------------------------------------------------------------------------
-// Internal helpers
-// -------------------------------------------------------------------------
-
 static GLuint compile_shader(GLenum type, const char* source) {
     GLuint shader = glCreateShader(type);
     glShaderSource(shader, 1, &source, NULL);
@@ -330,20 +607,22 @@ static void create_fullscreen_quad(void) {
     glBindVertexArray(0);
 }
 
-static void ensure_framebuffer_capacity(int width, int height) {
-    size_t required = (size_t)width * (size_t)height;
-    if (required > g_framebuffer_capacity) {
-        uint32_t* new_buffer = (uint32_t*)realloc(g_framebuffer, required * sizeof(uint32_t));
-        if (!new_buffer) {
-            printf("ERROR: Failed to allocate framebuffer (%zu pixels)\n", required);
-            return;
-        }
-        g_framebuffer = new_buffer;
-        g_framebuffer_capacity = required;
-    }
+#else
+
+// Headless backend: the framebuffer is the final output, nothing to upload
+static int backend_init(void) {
+    return 1;
 }
 
-static uint32_t pack_color(uint8_t r, uint8_t g, uint8_t b) {
-    return 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+static void backend_present(const RendererRect* rects, int count) {
+    (void)rects;
+    (void)count;
+}
+
+static void backend_resize(void) {
+}
+
+static void backend_shutdown(void) {
 }
 
+#endif
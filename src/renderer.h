@@ -4,23 +4,74 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <stddef.h>
 #include <stdint.h>
 
+// Framebuffer region in pixels
+typedef struct {
+    int x, y;
+    int width, height;
+} RendererRect;
+
+// Dirty rectangles kept per frame before they are merged into one
+#define RENDERER_MAX_DIRTY_RECTS 16
+
+// Presentation counters (damage tracking)
+typedef struct {
+    uint32_t frames_presented;    // Frames with at least one uploaded rectangle
+    uint32_t frames_skipped;      // Frames with nothing dirty (no upload, no draw)
+    uint64_t last_upload_bytes;   // Texture bytes uploaded by the last present
+    uint64_t total_upload_bytes;  // Texture bytes uploaded since init
+} RendererStats;
+
+// Dynamic resolution defaults: software frame budget and the lowest render
+// scale the controller may pick (render size = output size * scale)
+#define RENDERER_DEFAULT_BUDGET_MS 10.0
+#define RENDERER_MIN_SCALE 0.4f
+
 // Initialize renderer with given dimensions
 int renderer_init(int width, int height);
 
-// Clear the screen
+// Clear the screen (skipped while the world pass covers every pixel)
 void renderer_clear(void);
 
-// Present the rendered frame
+// Whether renderer_clear has to fill the framebuffer; the world pass turns
+// this off once it composites full frames
+void renderer_set_clear_needed(int needed);
+
+// Framebuffer bytes stored this frame (reset by renderer_clear)
+void renderer_count_bytes_written(size_t bytes);
+size_t renderer_get_bytes_written(void);
+
+// Present the rendered frame: uploads only the dirty rectangles and skips
+// the upload and draw entirely when nothing was marked dirty
 void renderer_present(void);
 
-// Resize renderer
+// Mark a framebuffer region as changed this frame
+void renderer_mark_dirty(int x, int y, int width, int height);
+void renderer_mark_all_dirty(void);
+
+// Whether renderer_clear filled the framebuffer this frame
+int renderer_frame_was_cleared(void);
+
+// Presentation counters
+const RendererStats* renderer_get_stats(void);
+
+// Resize renderer (output size; the render size follows the scale)
 void renderer_resize(int width, int height);
 
-// Get viewport dimensions
+// Get viewport dimensions (internal render size the world draws at)
 void renderer_get_viewport(int* width, int* height);
 
+// Get the output (canvas) size
+void renderer_get_output_size(int* width, int* height);
+
+// Pin the render scale to [RENDERER_MIN_SCALE, 1]; 0 lets the frame time
+// controller choose it against the frame budget
+void renderer_set_fixed_scale(float scale);
+void renderer_set_frame_budget_ms(double budget_ms);
+float renderer_get_scale(void);
+
 // Access the software framebuffer
 uint32_t* renderer_get_framebuffer(void);
 
@@ -0,0 +1,527 @@
+// Replay implementation - Record writer, playback cursor, pose checksums
+// QuakeCloneWASM - Simulation system
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+#include "sim.h"
+#include "input.h"
+#include "player.h"
+#include "world.h"
+#include "space.h"
+#include "jobs.h"
+
+#define MAX_KEYS 256
+
+static ReplayStats g_stats = { REPLAY_IDLE, 0, 0, 0, 0, 0, -1, 0 };
+
+// Recording being written, or the copy being played
+static uint8_t* g_data = NULL;
+static size_t g_size = 0;
+static size_t g_capacity = 0;
+static uint64_t g_last_stamp = 0;       // Tick of the previous record (writing)
+static int g_arrivals = 0;              // Beams completed when last checked (writing)
+
+// Playback cursors: events and checks in tick order, frames on their own
+static ReplayHeader g_header;
+static size_t g_event_offset = 0;
+static uint64_t g_event_tick = 0;
+static size_t g_frame_offset = 0;
+
+// FNV-1a over the player's pose
+static uint32_t pose_checksum(void) {
+    float pose[5];
+    player_get_position(&pose[0], &pose[1], &pose[2]);
+    pose[3] = player_get_yaw();
+    pose[4] = player_get_pitch();
+    const uint8_t* bytes = (const uint8_t*)pose;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(pose); ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// ---- Writing ----
+
+static int reserve(size_t bytes) {
+    if (g_size + bytes <= g_capacity) {
+        return 1;
+    }
+    size_t capacity = g_capacity ? g_capacity * 2 : 64 * 1024;
+    while (capacity < g_size + bytes) {
+        capacity *= 2;
+    }
+    uint8_t* data = (uint8_t*)realloc(g_data, capacity);
+    if (!data) {
+        printf("ERROR: Failed to grow the input recording to %zu bytes\n", capacity);
+        return 0;
+    }
+    g_data = data;
+    g_capacity = capacity;
+    return 1;
+}
+
+// Kind byte and varint tick delta; payload_size bytes are reserved after
+static int write_record(ReplayRecord kind, size_t payload_size) {
+    if (!reserve(1 + 10 + payload_size)) {
+        return 0;
+    }
+    g_data[g_size++] = (uint8_t)kind;
+    uint64_t delta = g_stats.tick - g_last_stamp;
+    g_last_stamp = g_stats.tick;
+    do {
+        uint8_t byte = (uint8_t)(delta & 0x7F);
+        delta >>= 7;
+        g_data[g_size++] = byte | (delta ? 0x80 : 0);
+    } while (delta);
+    return 1;
+}
+
+static void write_bytes(const void* data, size_t size) {
+    memcpy(g_data + g_size, data, size);
+    g_size += size;
+}
+
+int replay_start_recording(void) {
+    if (g_stats.state != REPLAY_IDLE) {
+        printf("ERROR: Cannot record while a replay is %s\n",
+               g_stats.state == REPLAY_RECORDING ? "recording" : "playing");
+        return 0;
+    }
+
+    ReplayHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = REPLAY_MAGIC;
+    header.version = REPLAY_VERSION;
+    header.header_size = (uint16_t)sizeof(ReplayHeader);
+    header.tick_hz = SIM_TICK_HZ;
+    header.planet_index = (int8_t)(space_get_location_type() == LOCATION_PLANET ? space_get_current_planet() : -1);
+    header.endless_surfaces = (uint8_t)world_get_endless_surfaces();
+    player_get_position(&header.x, &header.y, &header.z);
+    header.yaw = player_get_yaw();
+    header.pitch = player_get_pitch();
+
+    g_size = 0;
+    if (!reserve(sizeof(header))) {
+        return 0;
+    }
+    write_bytes(&header, sizeof(header));
+
+    g_stats.state = REPLAY_RECORDING;
+    g_stats.tick = 0;
+    g_stats.frames = 0;
+    g_stats.events = 0;
+    g_stats.checks = 0;
+    g_stats.mismatches = 0;
+    g_stats.first_mismatch = -1;
+    g_last_stamp = 0;
+    g_arrivals = space_get_beam_stats()->completed;
+
+    // Playback starts with no input: drop pending presses and mouse
+    // movement, and record the keys already held
+    input_update();
+    input_get_mouse_delta(NULL, NULL);
+    for (int key = 0; key < MAX_KEYS; ++key) {
+        if (input_is_key_down(key) && write_record(REPLAY_KEY_DOWN, 1)) {
+            uint8_t code = (uint8_t)key;
+            write_bytes(&code, 1);
+            g_stats.events++;
+        }
+    }
+
+    sim_set_lockstep(1);
+    printf("Recording input from tick 0\n");
+    return 1;
+}
+
+size_t replay_stop_recording(const uint8_t** data) {
+    if (g_stats.state != REPLAY_RECORDING) {
+        return 0;
+    }
+    uint32_t checksum = pose_checksum();
+    if (write_record(REPLAY_END, 4)) {
+        write_bytes(&checksum, 4);
+    }
+
+    ReplayHeader* header = (ReplayHeader*)g_data;
+    header->ticks = (uint32_t)g_stats.tick;
+    header->frames = g_stats.frames;
+    header->events = g_stats.events;
+
+    g_stats.state = REPLAY_IDLE;
+    g_stats.bytes = g_size;
+    sim_set_lockstep(0);
+    printf("Recorded %u ticks, %u frames, %u events in %zu bytes\n",
+           header->ticks, header->frames, header->events, g_size);
+    if (data) {
+        *data = g_data;
+    }
+    return g_size;
+}
+
+const uint8_t* replay_get_recording(size_t* size) {
+    if (g_stats.state == REPLAY_RECORDING || g_size == 0) {
+        if (size) *size = 0;
+        return NULL;
+    }
+    if (size) *size = g_size;
+    return g_data;
+}
+
+int replay_record_key(int key_code, int is_down) {
+    if (g_stats.state == REPLAY_PLAYING) {
+        return 0;
+    }
+    if (g_stats.state == REPLAY_RECORDING && key_code >= 0 && key_code < MAX_KEYS &&
+        write_record(is_down ? REPLAY_KEY_DOWN : REPLAY_KEY_UP, 1)) {
+        uint8_t code = (uint8_t)key_code;
+        write_bytes(&code, 1);
+        g_stats.events++;
+    }
+    return 1;
+}
+
+int replay_record_mouse(float dx, float dy) {
+    if (g_stats.state == REPLAY_PLAYING) {
+        return 0;
+    }
+    if (g_stats.state == REPLAY_RECORDING && write_record(REPLAY_MOUSE, 8)) {
+        write_bytes(&dx, 4);
+        write_bytes(&dy, 4);
+        g_stats.events++;
+    }
+    return 1;
+}
+
+int replay_record_beam(int planet_index) {
+    if (g_stats.state == REPLAY_PLAYING) {
+        return 0;
+    }
+    if (g_stats.state == REPLAY_RECORDING && write_record(REPLAY_BEAM, 1)) {
+        int8_t index = (int8_t)planet_index;
+        write_bytes(&index, 1);
+        g_stats.events++;
+    }
+    return 1;
+}
+
+void replay_record_frame(double frame_seconds) {
+    if (g_stats.state == REPLAY_RECORDING && write_record(REPLAY_FRAME, 4)) {
+        float seconds = (float)frame_seconds;
+        write_bytes(&seconds, 4);
+        g_stats.frames++;
+    }
+}
+
+// ---- Reading ----
+
+// Reads the record at *offset; returns 0 at a malformed or truncated one
+static int read_record(const uint8_t* data, size_t size, size_t* offset, ReplayRecord* kind,
+                       uint64_t* delta, const uint8_t** payload) {
+    size_t at = *offset;
+    if (at >= size) {
+        return 0;
+    }
+    *kind = (ReplayRecord)data[at++];
+
+    *delta = 0;
+    for (int shift = 0; ; shift += 7) {
+        if (at >= size || shift > 63) {
+            return 0;
+        }
+        uint8_t byte = data[at++];
+        *delta |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+
+    size_t payload_size;
+    switch (*kind) {
+        case REPLAY_KEY_DOWN:
+        case REPLAY_KEY_UP:
+        case REPLAY_BEAM:   payload_size = 1; break;
+        case REPLAY_ARRIVE: payload_size = 0; break;
+        case REPLAY_MOUSE:  payload_size = 8; break;
+        case REPLAY_FRAME:
+        case REPLAY_CHECK:
+        case REPLAY_END:    payload_size = 4; break;
+        default:            return 0;
+    }
+    if (size - at < payload_size) {
+        return 0;
+    }
+    *payload = data + at;
+    *offset = at + payload_size;
+    return 1;
+}
+
+static void compare_checksum(const uint8_t* payload) {
+    uint32_t expected;
+    memcpy(&expected, payload, 4);
+    g_stats.checks++;
+    if (expected != pose_checksum()) {
+        if (g_stats.mismatches == 0) {
+            g_stats.first_mismatch = (int64_t)g_stats.tick;
+            printf("Replay diverged at tick %llu\n", (unsigned long long)g_stats.tick);
+        }
+        g_stats.mismatches++;
+    }
+}
+
+// Header and every record must be sound before playback touches the game
+static int validate(const uint8_t* data, size_t size, ReplayHeader* header) {
+    if (size < sizeof(ReplayHeader)) {
+        printf("ERROR: Input recording too small (%zu bytes)\n", size);
+        return 0;
+    }
+    memcpy(header, data, sizeof(ReplayHeader));
+    if (header->magic != REPLAY_MAGIC || header->version != REPLAY_VERSION ||
+        header->header_size != sizeof(ReplayHeader)) {
+        printf("ERROR: Not a version %d input recording\n", REPLAY_VERSION);
+        return 0;
+    }
+    if (header->tick_hz != SIM_TICK_HZ) {
+        printf("ERROR: Input recording runs at %d Hz, the simulation at %d Hz\n",
+               header->tick_hz, SIM_TICK_HZ);
+        return 0;
+    }
+    if (header->planet_index >= space_get_planet_count()) {
+        printf("ERROR: Input recording starts on unknown planet %d\n", header->planet_index);
+        return 0;
+    }
+
+    size_t offset = sizeof(ReplayHeader);
+    uint64_t tick = 0;
+    ReplayRecord kind;
+    uint64_t delta;
+    const uint8_t* payload;
+    while (read_record(data, size, &offset, &kind, &delta, &payload)) {
+        tick += delta;
+        if (kind == REPLAY_END) {
+            if (tick == header->ticks && offset == size) {
+                return 1;
+            }
+            break;
+        }
+    }
+    printf("ERROR: Input recording is corrupt near byte %zu\n", offset);
+    return 0;
+}
+
+int replay_start_playback(const void* data, size_t size) {
+    if (g_stats.state != REPLAY_IDLE) {
+        printf("ERROR: Cannot play a replay while one is %s\n",
+               g_stats.state == REPLAY_RECORDING ? "recording" : "playing");
+        return 0;
+    }
+    ReplayHeader header;
+    if (!data || !validate((const uint8_t*)data, size, &header)) {
+        return 0;
+    }
+
+    if (size > g_capacity) {
+        uint8_t* copy = (uint8_t*)realloc(g_data, size);
+        if (!copy) {
+            printf("ERROR: Failed to allocate %zu bytes for the replay\n", size);
+            return 0;
+        }
+        g_data = copy;
+        g_capacity = size;
+    }
+    if (g_data != data) {
+        memmove(g_data, data, size);
+    }
+    g_size = size;
+    g_header = header;
+
+    // Recorded start: location, pose, streamed surroundings, no input
+    world_set_endless_surfaces(header.endless_surfaces);
+    if (header.planet_index >= 0) {
+        space_beam_to_planet(header.planet_index);
+    } else {
+        space_beam_to_spaceship();
+    }
+    player_set_position(header.x, header.y, header.z);
+    player_set_rotation(header.yaw, header.pitch);
+    jobs_wait_background();
+    world_update(0.0);
+    jobs_wait_background();
+    input_clear();
+
+    g_stats.state = REPLAY_PLAYING;
+    g_stats.tick = 0;
+    g_stats.frames = header.frames;
+    g_stats.events = 0;
+    g_stats.checks = 0;
+    g_stats.mismatches = 0;
+    g_stats.first_mismatch = -1;
+    g_stats.bytes = size;
+    g_event_offset = sizeof(ReplayHeader);
+    g_event_tick = 0;
+    g_frame_offset = sizeof(ReplayHeader);
+
+    sim_init();
+    sim_set_lockstep(1);
+    space_hold_beams(1);
+    printf("Replaying %u ticks (%.1f s), %u frames, %u events\n",
+           header.ticks, header.ticks * SIM_TICK_SECONDS, header.frames, header.events);
+    return 1;
+}
+
+// Ends playback; at the recording's last tick the final pose is compared
+void replay_stop_playback(void) {
+    if (g_stats.state != REPLAY_PLAYING) {
+        return;
+    }
+    if (g_stats.tick == g_header.ticks) {
+        ReplayRecord kind;
+        uint64_t delta;
+        const uint8_t* payload;
+        while (read_record(g_data, g_size, &g_event_offset, &kind, &delta, &payload)) {
+            if (kind == REPLAY_END) {
+                compare_checksum(payload);
+            }
+        }
+    }
+
+    g_stats.state = REPLAY_IDLE;
+    sim_set_lockstep(0);
+    space_hold_beams(0);
+    input_clear();
+    printf("Replay %s after %llu ticks: %u of %u checksums matched\n",
+           g_stats.tick == g_header.ticks ? "finished" : "stopped",
+           (unsigned long long)g_stats.tick, g_stats.checks - g_stats.mismatches, g_stats.checks);
+}
+
+int replay_next_frame(double* frame_seconds) {
+    if (g_stats.state != REPLAY_PLAYING) {
+        return 0;
+    }
+    ReplayRecord kind;
+    uint64_t delta;
+    const uint8_t* payload;
+    while (read_record(g_data, g_size, &g_frame_offset, &kind, &delta, &payload)) {
+        if (kind == REPLAY_FRAME) {
+            float seconds;
+            memcpy(&seconds, payload, 4);
+            *frame_seconds = seconds;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint64_t replay_get_tick_count(void) {
+    return g_stats.state == REPLAY_PLAYING ? g_header.ticks : 0;
+}
+
+// Apply this tick's records, up to the first one stamped later
+static void play_tick(void) {
+    for (;;) {
+        size_t offset = g_event_offset;
+        ReplayRecord kind;
+        uint64_t delta;
+        const uint8_t* payload;
+        if (!read_record(g_data, g_size, &offset, &kind, &delta, &payload) ||
+            kind == REPLAY_END || g_event_tick + delta > g_stats.tick) {
+            return;
+        }
+        g_event_offset = offset;
+        g_event_tick += delta;
+
+        switch (kind) {
+            case REPLAY_KEY_DOWN:
+            case REPLAY_KEY_UP:
+                input_apply_key(payload[0], kind == REPLAY_KEY_DOWN);
+                g_stats.events++;
+                break;
+            case REPLAY_MOUSE: {
+                float dx, dy;
+                memcpy(&dx, payload, 4);
+                memcpy(&dy, payload + 4, 4);
+                input_apply_mouse(dx, dy);
+                g_stats.events++;
+                break;
+            }
+            case REPLAY_BEAM:
+                space_request_beam((int8_t)payload[0]);
+                g_stats.events++;
+                break;
+            case REPLAY_ARRIVE:
+                space_commit_beam();
+                break;
+            case REPLAY_CHECK:
+                compare_checksum(payload);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void replay_begin_tick(void) {
+    if (g_stats.state == REPLAY_RECORDING) {
+        if (g_stats.tick % REPLAY_CHECK_TICKS == 0) {
+            uint32_t checksum = pose_checksum();
+            if (write_record(REPLAY_CHECK, 4)) {
+                write_bytes(&checksum, 4);
+            }
+        }
+        g_stats.tick++;
+    } else if (g_stats.state == REPLAY_PLAYING) {
+        if (g_stats.tick == g_header.ticks) {
+            replay_stop_playback();
+            return;
+        }
+        play_tick();
+        g_stats.tick++;
+    }
+}
+
+void replay_end_tick(void) {
+    if (g_stats.state == REPLAY_RECORDING) {
+        int arrivals = space_get_beam_stats()->completed;
+        if (arrivals != g_arrivals) {
+            g_arrivals = arrivals;
+            write_record(REPLAY_ARRIVE, 0);
+        }
+    } else if (g_stats.state == REPLAY_PLAYING) {
+        // The arrival is the next record, stamped with the following tick
+        size_t offset = g_event_offset;
+        ReplayRecord kind;
+        uint64_t delta;
+        const uint8_t* payload;
+        if (read_record(g_data, g_size, &offset, &kind, &delta, &payload) &&
+            kind == REPLAY_ARRIVE && g_event_tick + delta == g_stats.tick) {
+            g_event_offset = offset;
+            g_event_tick += delta;
+            space_commit_beam();
+        }
+    }
+}
+
+int replay_is_recording(void) {
+    return g_stats.state == REPLAY_RECORDING;
+}
+
+int replay_is_playing(void) {
+    return g_stats.state == REPLAY_PLAYING;
+}
+
+const ReplayStats* replay_get_stats(void) {
+    return &g_stats;
+}
+
+void replay_shutdown(void) {
+    if (g_stats.state == REPLAY_PLAYING) {
+        replay_stop_playback();
+    }
+    free(g_data);
+    g_data = NULL;
+    g_size = 0;
+    g_capacity = 0;
+    g_stats.state = REPLAY_IDLE;
+}
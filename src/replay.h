@@ -0,0 +1,140 @@
+// Replay header - Binary input recording and deterministic playback
+// QuakeCloneWASM - Simulation system
+//
+// A recording is every input event the simulation saw (keys, mouse
+// movement, beam requests), stamped with the tick that consumed it, plus
+// the real length of every frame and a checksum of the player's pose every
+// REPLAY_CHECK_TICKS ticks. Playing it back feeds the events to input.c at
+// the same ticks, so the player retraces the recorded path at any frame
+// rate; the checksums report the first tick where it does not.
+//
+// Layout (little-endian): a ReplayHeader, then records of one kind byte,
+// the ticks since the previous record as a LEB128 varint, and a payload:
+//   KEY_DOWN, KEY_UP  u8 key code
+//   MOUSE             f32 dx, f32 dy
+//   BEAM              i8 planet index (-1: spaceship)
+//   ARRIVE            none; the pending beam arrived at the end of the
+//                     tick before this one
+//   FRAME             f32 frame seconds (the frame ran the ticks up to here)
+//   CHECK             u32 pose checksum before this tick
+//   END               u32 pose checksum after the last tick
+// Frame stamps count FRAME records; the recording ends with one END.
+//
+// Recording and playback both run the simulation in lockstep (see
+// sim_set_lockstep), so surface streaming lands on the same ticks. Beams
+// arrive when their destination is ready, which depends on what was
+// cached, so arrivals are recorded too and playback commits each beam at
+// its recorded tick.
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define REPLAY_MAGIC 0x50455251u    // "QREP"
+#define REPLAY_VERSION 1
+#define REPLAY_CHECK_TICKS 120      // Pose checksum once per game second
+
+typedef enum {
+    REPLAY_KEY_DOWN = 1,
+    REPLAY_KEY_UP,
+    REPLAY_MOUSE,
+    REPLAY_BEAM,
+    REPLAY_ARRIVE,
+    REPLAY_FRAME,
+    REPLAY_CHECK,
+    REPLAY_END
+} ReplayRecord;
+
+// Where the recording starts; playback beams there first
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;       // sizeof(ReplayHeader) for this version
+    uint16_t tick_hz;           // SIM_TICK_HZ of the recording
+    int8_t planet_index;        // -1: aboard the spaceship
+    uint8_t endless_surfaces;
+    uint32_t ticks;             // Ticks recorded
+    uint32_t frames;            // FRAME records
+    uint32_t events;            // Key, mouse and beam records
+    float x;                    // Player pose at tick 0
+    float y;
+    float z;
+    float yaw;
+    float pitch;
+    uint32_t reserved[2];
+} ReplayHeader;
+
+typedef enum {
+    REPLAY_IDLE = 0,
+    REPLAY_RECORDING,
+    REPLAY_PLAYING
+} ReplayState;
+
+typedef struct {
+    ReplayState state;
+    uint64_t tick;              // Ticks recorded or played so far
+    uint32_t frames;            // Frames recorded (or in the playing recording)
+    uint32_t events;            // Events recorded or applied
+    uint32_t checks;            // Checksums written or compared
+    uint32_t mismatches;        // Compared checksums that differed
+    int64_t first_mismatch;     // Tick of the first difference (-1: none)
+    size_t bytes;               // Size of the recording
+} ReplayStats;
+
+// Start recording from the current state: the player's pose, location and
+// held keys. Turns lockstep on. Returns 0 on failure or if busy.
+int replay_start_recording(void);
+
+// Finish the recording; data points to it until the next recording or
+// replay_shutdown. Returns its size (0 if nothing was recording).
+size_t replay_stop_recording(const uint8_t** data);
+
+// The last finished (or played) recording, NULL while recording or if
+// there is none
+const uint8_t* replay_get_recording(size_t* size);
+
+// Live events (input.c and the beam calls route every event through
+// these); recorded while recording. Return 0 while a replay plays: the
+// live event must then be dropped.
+int replay_record_key(int key_code, int is_down);
+int replay_record_mouse(float dx, float dy);
+int replay_record_beam(int planet_index);
+
+// Real length of the frame about to run its ticks (the game loop)
+void replay_record_frame(double frame_seconds);
+
+// Beam to the recording's start, reset input and the clock, and feed its
+// events to the following ticks. Copies data. Live events are ignored
+// until the replay ends. Returns 0 if the recording is invalid.
+int replay_start_playback(const void* data, size_t size);
+
+// Stop playing; live input resumes. Playback stops by itself when the tick
+// after the recording's last begins; a headless run that ran exactly
+// replay_get_tick_count() ticks calls this to compare the final pose.
+void replay_stop_playback(void);
+
+// Next recorded frame length during playback (to reproduce the recorded
+// pacing). Returns 0 once the frames are used up.
+int replay_next_frame(double* frame_seconds);
+
+// Ticks in the playing recording
+uint64_t replay_get_tick_count(void);
+
+// Start of every simulation tick (sim.c): applies the tick's events while
+// playing, writes or compares checksums
+void replay_begin_tick(void);
+
+// After the tick's space_update (sim.c): records a beam arrival, or
+// commits the recorded one while playing
+void replay_end_tick(void);
+
+int replay_is_recording(void);
+int replay_is_playing(void);
+
+const ReplayStats* replay_get_stats(void);
+
+void replay_shutdown(void);
+
+#endif // REPLAY_H
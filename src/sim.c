@@ -0,0 +1,103 @@
+// Simulation implementation - Accumulator, tick, interpolation
+// QuakeCloneWASM - Simulation system
+
+#include "sim.h"
+#include "input.h"
+#include "player.h"
+#include "world.h"
+#include "space.h"
+#include "jobs.h"
+#include "replay.h"
+
+static SimStats g_stats;
+static double g_accumulator = 0.0;
+static int g_lockstep = 0;
+static SimInputFunc g_input_func = NULL;
+static void* g_input_data = NULL;
+
+void sim_init(void) {
+    g_stats.ticks = 0;
+    g_stats.dropped_ticks = 0;
+    g_stats.last_frame_ticks = 0;
+    g_stats.alpha = 0.0;
+    g_accumulator = 0.0;
+}
+
+// One fixed step of the whole game
+static void run_tick(void) {
+    if (g_input_func) {
+        g_input_func(g_stats.ticks, g_input_data);
+    }
+    // After the hook, so scripted input is stamped with this tick
+    replay_begin_tick();
+
+    // Check for beam up key (B key)
+    if (input_is_key_pressed('B') || input_is_key_pressed('b')) {
+        if (space_get_location_type() == LOCATION_PLANET) {
+            space_request_beam(-1);
+        }
+    }
+
+    player_update(SIM_TICK_SECONDS);
+    world_update(SIM_TICK_SECONDS);
+    space_update(SIM_TICK_SECONDS);
+    replay_end_tick();
+
+    // Key presses are consumed by the tick that saw them, so a frame
+    // without ticks keeps them for the next one
+    input_update();
+
+    if (g_lockstep) {
+        jobs_wait_background();
+    }
+    g_stats.ticks++;
+}
+
+// Run the ticks a frame's real time covers
+int sim_advance(double frame_seconds) {
+    if (frame_seconds > 0.0) {
+        g_accumulator += frame_seconds;
+    }
+
+    int ticks = 0;
+    while (g_accumulator >= SIM_TICK_SECONDS && ticks < SIM_MAX_TICKS_PER_FRAME) {
+        run_tick();
+        g_accumulator -= SIM_TICK_SECONDS;
+        ticks++;
+    }
+    if (g_accumulator >= SIM_TICK_SECONDS) {
+        uint64_t dropped = (uint64_t)(g_accumulator / SIM_TICK_SECONDS);
+        g_stats.dropped_ticks += dropped;
+        g_accumulator -= (double)dropped * SIM_TICK_SECONDS;
+    }
+
+    g_stats.last_frame_ticks = ticks;
+    g_stats.alpha = g_accumulator / SIM_TICK_SECONDS;
+    player_set_interpolation((float)g_stats.alpha);
+    return ticks;
+}
+
+void sim_run_ticks(uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i) {
+        run_tick();
+    }
+    g_stats.alpha = 1.0;
+    player_set_interpolation(1.0f);
+}
+
+void sim_set_lockstep(int enabled) {
+    g_lockstep = enabled ? 1 : 0;
+}
+
+void sim_set_input(SimInputFunc func, void* user_data) {
+    g_input_func = func;
+    g_input_data = user_data;
+}
+
+double sim_get_time(void) {
+    return (double)g_stats.ticks * SIM_TICK_SECONDS;
+}
+
+const SimStats* sim_get_stats(void) {
+    return &g_stats;
+}
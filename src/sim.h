@@ -0,0 +1,58 @@
+// Simulation header - Fixed-timestep game clock
+// QuakeCloneWASM - Simulation system
+//
+// Player, world and space state advance in fixed ticks of SIM_TICK_SECONDS,
+// so the results of a run depend only on the input each tick sees, not on
+// the frame rate. Frames add their real elapsed time to an accumulator and
+// run the ticks it covers; the fraction of a tick left over interpolates
+// the camera between the last two ticks for rendering.
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+// Simulation rate
+#define SIM_TICK_HZ 120
+#define SIM_TICK_SECONDS (1.0 / SIM_TICK_HZ)
+
+// Spiral-of-death guard: a frame runs at most this many ticks (0.1 s of
+// game time); time beyond that is dropped, so a slow frame slows the game
+// down instead of making the next frame slower still
+#define SIM_MAX_TICKS_PER_FRAME 12
+
+// Called before every tick to feed scripted input (autopilots, replays)
+typedef void (*SimInputFunc)(uint64_t tick, void* user_data);
+
+typedef struct {
+    uint64_t ticks;             // Ticks run since sim_init
+    uint64_t dropped_ticks;     // Ticks of real time discarded by the guard
+    int last_frame_ticks;       // Ticks run by the last sim_advance
+    double alpha;               // Interpolation between the last two ticks
+} SimStats;
+
+// Reset the clock (tick 0, empty accumulator)
+void sim_init(void);
+
+// Add frame_seconds of real time and run the ticks it covers, at most
+// SIM_MAX_TICKS_PER_FRAME. Sets the player's render interpolation.
+// Returns the number of ticks run.
+int sim_advance(double frame_seconds);
+
+// Run count ticks back to back, as fast as possible (headless runs)
+void sim_run_ticks(uint64_t count);
+
+// Lockstep mode waits at the end of every tick for the background work it
+// started (surface chunks, beam preparation), so a run is reproducible
+// regardless of thread timing. Off by default; headless runs turn it on.
+void sim_set_lockstep(int enabled);
+
+// Input hook for every tick (NULL: live input only)
+void sim_set_input(SimInputFunc func, void* user_data);
+
+// Game time in seconds (ticks * SIM_TICK_SECONDS)
+double sim_get_time(void);
+
+const SimStats* sim_get_stats(void);
+
+#endif // SIM_H
@@ -0,0 +1,194 @@
+// SIMD header - Thin portable vector layer for the renderer
+// QuakeCloneWASM - Rendering system
+//
+// Picks the widest instruction set enabled at build time:
+//   AVX2         8 lanes (native, -mavx2 / -march=native)
+//   SSE2         4 lanes (any x86-64)
+//   WASM SIMD    4 lanes (emcc -msimd128)
+// Define NO_SIMD (or build without any of the above) for the scalar
+// fallback, where SIMD_WIDTH is 1 and callers use their scalar paths.
+//
+// Only IEEE-exact operations are exposed (no reciprocal estimates, no fused
+// multiply-add), so vector code can reproduce scalar results bit for bit.
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stdint.h>
+
+#if !defined(NO_SIMD) && defined(__AVX2__)
+#define SIMD_AVX2 1
+#define SIMD_WIDTH 8
+#include <immintrin.h>
+#elif !defined(NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define SIMD_SSE2 1
+#define SIMD_WIDTH 4
+#include <emmintrin.h>
+#elif !defined(NO_SIMD) && defined(__wasm_simd128__)
+#define SIMD_WASM 1
+#define SIMD_WIDTH 4
+#include <wasm_simd128.h>
+#else
+#define SIMD_SCALAR 1
+#define SIMD_WIDTH 1
+#endif
+
+#ifndef SIMD_SCALAR
+
+// Lane masks are all-ones / all-zeros per 32-bit lane in every backend
+#if defined(SIMD_AVX2)
+typedef __m256 vfloat;
+typedef __m256i vint;
+
+static inline vfloat vf_set1(float v) { return _mm256_set1_ps(v); }
+static inline vfloat vf_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline void vf_store(float* p, vfloat v) { _mm256_storeu_ps(p, v); }
+static inline vfloat vf_add(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+static inline vfloat vf_sub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+static inline vfloat vf_mul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+static inline vfloat vf_div(vfloat a, vfloat b) { return _mm256_div_ps(a, b); }
+static inline vint vf_lt(vfloat a, vfloat b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+static inline vint vf_eq(vfloat a, vfloat b) { return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+static inline vfloat vf_abs(vfloat a) { return _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff))); }
+static inline vfloat vf_select(vint mask, vfloat a, vfloat b) { return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(mask)); }
+static inline vfloat vf_from_int(vint a) { return _mm256_cvtepi32_ps(a); }
+static inline vint vf_to_int(vfloat a) { return _mm256_cvttps_epi32(a); } // Truncates, like (int)
+
+static inline vint vi_set1(int32_t v) { return _mm256_set1_epi32(v); }
+static inline vint vi_load(const int32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+static inline void vi_store(int32_t* p, vint v) { _mm256_storeu_si256((__m256i*)p, v); }
+static inline vint vi_add(vint a, vint b) { return _mm256_add_epi32(a, b); }
+static inline vint vi_sub(vint a, vint b) { return _mm256_sub_epi32(a, b); }
+static inline vint vi_mul(vint a, vint b) { return _mm256_mullo_epi32(a, b); }
+static inline vint vi_sra(vint a, int bits) { return _mm256_sra_epi32(a, _mm_cvtsi32_si128(bits)); }
+static inline vint vi_sll(vint a, int bits) { return _mm256_sll_epi32(a, _mm_cvtsi32_si128(bits)); }
+static inline vint vi_lt(vint a, vint b) { return _mm256_cmpgt_epi32(b, a); }
+static inline vint vi_eq(vint a, vint b) { return _mm256_cmpeq_epi32(a, b); }
+static inline vint vi_and(vint a, vint b) { return _mm256_and_si256(a, b); }
+static inline vint vi_or(vint a, vint b) { return _mm256_or_si256(a, b); }
+static inline vint vi_andnot(vint a, vint b) { return _mm256_andnot_si256(a, b); } // ~a & b
+static inline vint vi_select(vint mask, vint a, vint b) { return _mm256_blendv_epi8(b, a, mask); }
+static inline int vi_any(vint mask) { return !_mm256_testz_si256(mask, mask); }
+
+#elif defined(SIMD_SSE2)
+typedef __m128 vfloat;
+typedef __m128i vint;
+
+static inline vfloat vf_set1(float v) { return _mm_set1_ps(v); }
+static inline vfloat vf_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void vf_store(float* p, vfloat v) { _mm_storeu_ps(p, v); }
+static inline vfloat vf_add(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+static inline vfloat vf_sub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+static inline vfloat vf_mul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+static inline vfloat vf_div(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+static inline vint vf_lt(vfloat a, vfloat b) { return _mm_castps_si128(_mm_cmplt_ps(a, b)); }
+static inline vint vf_eq(vfloat a, vfloat b) { return _mm_castps_si128(_mm_cmpeq_ps(a, b)); }
+static inline vfloat vf_abs(vfloat a) { return _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))); }
+static inline vfloat vf_select(vint mask, vfloat a, vfloat b) {
+    __m128 m = _mm_castsi128_ps(mask);
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+}
+static inline vfloat vf_from_int(vint a) { return _mm_cvtepi32_ps(a); }
+static inline vint vf_to_int(vfloat a) { return _mm_cvttps_epi32(a); } // Truncates, like (int)
+
+static inline vint vi_set1(int32_t v) { return _mm_set1_epi32(v); }
+static inline vint vi_load(const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+static inline void vi_store(int32_t* p, vint v) { _mm_storeu_si128((__m128i*)p, v); }
+static inline vint vi_add(vint a, vint b) { return _mm_add_epi32(a, b); }
+static inline vint vi_sub(vint a, vint b) { return _mm_sub_epi32(a, b); }
+static inline vint vi_mul(vint a, vint b) {
+    // SSE2 has no 32-bit mullo: multiply even and odd lanes, keep the low halves
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+static inline vint vi_sra(vint a, int bits) { return _mm_sra_epi32(a, _mm_cvtsi32_si128(bits)); }
+static inline vint vi_sll(vint a, int bits) { return _mm_sll_epi32(a, _mm_cvtsi32_si128(bits)); }
+static inline vint vi_lt(vint a, vint b) { return _mm_cmplt_epi32(a, b); }
+static inline vint vi_eq(vint a, vint b) { return _mm_cmpeq_epi32(a, b); }
+static inline vint vi_and(vint a, vint b) { return _mm_and_si128(a, b); }
+static inline vint vi_or(vint a, vint b) { return _mm_or_si128(a, b); }
+static inline vint vi_andnot(vint a, vint b) { return _mm_andnot_si128(a, b); } // ~a & b
+static inline vint vi_select(vint mask, vint a, vint b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+static inline int vi_any(vint mask) { return _mm_movemask_epi8(mask) != 0; }
+
+#elif defined(SIMD_WASM)
+typedef v128_t vfloat;
+typedef v128_t vint;
+
+static inline vfloat vf_set1(float v) { return wasm_f32x4_splat(v); }
+static inline vfloat vf_load(const float* p) { return wasm_v128_load(p); }
+static inline void vf_store(float* p, vfloat v) { wasm_v128_store(p, v); }
+static inline vfloat vf_add(vfloat a, vfloat b) { return wasm_f32x4_add(a, b); }
+static inline vfloat vf_sub(vfloat a, vfloat b) { return wasm_f32x4_sub(a, b); }
+static inline vfloat vf_mul(vfloat a, vfloat b) { return wasm_f32x4_mul(a, b); }
+static inline vfloat vf_div(vfloat a, vfloat b) { return wasm_f32x4_div(a, b); }
+static inline vint vf_lt(vfloat a, vfloat b) { return wasm_f32x4_lt(a, b); }
+static inline vint vf_eq(vfloat a, vfloat b) { return wasm_f32x4_eq(a, b); }
+static inline vfloat vf_abs(vfloat a) { return wasm_f32x4_abs(a); }
+static inline vfloat vf_select(vint mask, vfloat a, vfloat b) { return wasm_v128_bitselect(a, b, mask); }
+static inline vfloat vf_from_int(vint a) { return wasm_f32x4_convert_i32x4(a); }
+static inline vint vf_to_int(vfloat a) { return wasm_i32x4_trunc_sat_f32x4(a); } // Truncates, like (int)
+
+static inline vint vi_set1(int32_t v) { return wasm_i32x4_splat(v); }
+static inline vint vi_load(const int32_t* p) { return wasm_v128_load(p); }
+static inline void vi_store(int32_t* p, vint v) { wasm_v128_store(p, v); }
+static inline vint vi_add(vint a, vint b) { return wasm_i32x4_add(a, b); }
+static inline vint vi_sub(vint a, vint b) { return wasm_i32x4_sub(a, b); }
+static inline vint vi_mul(vint a, vint b) { return wasm_i32x4_mul(a, b); }
+static inline vint vi_sra(vint a, int bits) { return wasm_i32x4_shr(a, bits); }
+static inline vint vi_sll(vint a, int bits) { return wasm_i32x4_shl(a, bits); }
+static inline vint vi_lt(vint a, vint b) { return wasm_i32x4_lt(a, b); }
+static inline vint vi_eq(vint a, vint b) { return wasm_i32x4_eq(a, b); }
+static inline vint vi_and(vint a, vint b) { return wasm_v128_and(a, b); }
+static inline vint vi_or(vint a, vint b) { return wasm_v128_or(a, b); }
+static inline vint vi_andnot(vint a, vint b) { return wasm_v128_andnot(b, a); } // ~a & b
+static inline vint vi_select(vint mask, vint a, vint b) { return wasm_v128_bitselect(a, b, mask); }
+static inline int vi_any(vint mask) { return wasm_v128_any_true(mask); }
+#endif
+
+static inline vint vi_min(vint a, vint b) { return vi_select(vi_lt(a, b), a, b); }
+static inline vint vi_max(vint a, vint b) { return vi_select(vi_lt(a, b), b, a); }
+
+// 0, 1, ... SIMD_WIDTH - 1
+static inline vint vi_lane_index(void) {
+    static const int32_t lanes[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    return vi_load(lanes);
+}
+
+// Gather base[index] for lanes in mask (other lanes read as 0)
+static inline vint vi_gather(const int32_t* base, vint index, vint mask) {
+#if defined(SIMD_AVX2)
+    return _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), base, index, mask, 4);
+#else
+    // Masked-off lanes read base[0] and are then cleared, keeping the loop branch-free
+    int32_t lanes[SIMD_WIDTH];
+    vi_store(lanes, vi_and(index, mask));
+    for (int i = 0; i < SIMD_WIDTH; ++i) {
+        lanes[i] = base[lanes[i]];
+    }
+    return vi_and(vi_load(lanes), mask);
+#endif
+}
+
+// Gather the bytes base[index] for lanes in mask (other lanes read as 0).
+// The AVX2 path loads a 32-bit word per lane, so base needs 3 readable
+// bytes past its last element.
+static inline vint vi_gather_u8(const uint8_t* base, vint index, vint mask) {
+#if defined(SIMD_AVX2)
+    vint words = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), (const int*)base, index, mask, 1);
+    return vi_and(words, vi_set1(0xFF));
+#else
+    int32_t lanes[SIMD_WIDTH];
+    vi_store(lanes, vi_and(index, mask));
+    for (int i = 0; i < SIMD_WIDTH; ++i) {
+        lanes[i] = base[lanes[i]];
+    }
+    return vi_and(vi_load(lanes), mask);
+#endif
+}
+
+#endif // !SIMD_SCALAR
+
+#endif // SIMD_H
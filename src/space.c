@@ -2,9 +2,11 @@
 // QuakeCloneWASM - Space exploration
 
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include "space.h"
+#include "platform.h"
 #include "player.h"
 #include "world.h"
 
@@ -12,6 +14,29 @@
 static LocationType g_current_location = LOCATION_PLANET;
 static int g_current_planet = 0; // Start on first planet
 
+// Beaming is split into a prepare phase, which generates the destination's
+// surface in the background while the current world keeps running, and a
+// commit that swaps the destination in between two frames
+#define BEAM_SPACESHIP -1
+
+// A prepared destination that is still incomplete after this long is
+// committed anyway (the missing chunks are generated synchronously)
+#define BEAM_TIMEOUT_MS 2000.0
+
+typedef struct {
+    int planet_index;          // BEAM_SPACESHIP for the spaceship
+    SurfaceDesc surface;
+    float spawn_x, spawn_z, spawn_yaw;
+} BeamTarget;
+
+static int g_beam_pending = 0;
+static BeamTarget g_beam_target;
+static double g_beam_request_ms = 0.0;
+static int g_beam_hold = 0;
+static int g_prefetch_pending = 0;
+static BeamTarget g_prefetch_target;
+static SpaceBeamStats g_beam_stats;
+
 // Realistic planet database - Based on real exoplanet characteristics
 static PlanetData g_planets[] = {
     // Planet 0: Earth-like (Terran)
@@ -27,7 +52,8 @@ static PlanetData g_planets[] = {
         .rotation_period_h = 24.0f,
         .resource_richness = 85,
         .map_offset_x = 16.0f,
-        .map_offset_z = 16.0f
+        .map_offset_z = 16.0f,
+        .map_file = "terra_nova.qmap"
     },
     // Planet 1: Mars-like (Desert)
     {
@@ -42,7 +68,8 @@ static PlanetData g_planets[] = {
         .rotation_period_h = 24.6f,
         .resource_richness = 60,
         .map_offset_x = 16.0f,
-        .map_offset_z = 16.0f
+        .map_offset_z = 16.0f,
+        .map_file = "aridus_prime.qmap"
     },
     // Planet 2: Venus-like (Toxic)
     {
@@ -57,7 +84,8 @@ static PlanetData g_planets[] = {
         .rotation_period_h = 5832.0f,
         .resource_richness = 40,
         .map_offset_x = 16.0f,
-        .map_offset_z = 16.0f
+        .map_offset_z = 16.0f,
+        .map_file = "vulcanis.qmap"
     },
     // Planet 3: Gas Giant Moon (Ice)
     {
@@ -72,7 +100,8 @@ static PlanetData g_planets[] = {
         .rotation_period_h = 84.0f,
         .resource_richness = 75,
         .map_offset_x = 16.0f,
-        .map_offset_z = 16.0f
+        .map_offset_z = 16.0f,
+        .map_file = "glacius.qmap"
     },
     // Planet 4: Ocean World
     {
@@ -87,7 +116,8 @@ static PlanetData g_planets[] = {
         .rotation_period_h = 18.0f,
         .resource_richness = 90,
         .map_offset_x = 16.0f,
-        .map_offset_z = 16.0f
+        .map_offset_z = 16.0f,
+        .map_file = "aquarius.qmap"
     },
     // Planet 5: Rocky Desert
     {
@@ -102,7 +132,8 @@ static PlanetData g_planets[] = {
         .rotation_period_h = 36.0f,
         .resource_richness = 70,
         .map_offset_x = 16.0f,
-        .map_offset_z = 16.0f
+        .map_offset_z = 16.0f,
+        .map_file = "cimmeria.qmap"
     },
     // Planet 6: Lava World
     {
@@ -117,7 +148,8 @@ static PlanetData g_planets[] = {
         .rotation_period_h = 12.0f,
         .resource_richness = 95,
         .map_offset_x = 16.0f,
-        .map_offset_z = 16.0f
+        .map_offset_z = 16.0f,
+        .map_file = "inferno.qmap"
     },
     // Planet 7: Gas Giant with Space Station
     {
@@ -132,11 +164,15 @@ static PlanetData g_planets[] = {
         .rotation_period_h = 16.0f,
         .resource_richness = 50,
         .map_offset_x = 16.0f,
-        .map_offset_z = 16.0f
+        .map_offset_z = 16.0f,
+        .map_file = "neptunus_station.qmap"
     }
 };
 
 static const int g_planet_count = sizeof(g_planets) / sizeof(g_planets[0]);
+
+// The home system sits two thirds of the way out in the galaxy's disc
+static const float g_galaxy_position[3] = { 3870.0f, 18.0f, -2155.0f };
 static int g_space_initialized = 0;
 
 // Spaceship interior state (simple room)
@@ -171,29 +207,98 @@ int space_get_current_planet(void) {
     return -1;
 }
 
+// Destination of a beam: where the player lands and which surface
+static void plan_beam(int planet_index, BeamTarget* target) {
+    memset(target, 0, sizeof(*target));
+    target->planet_index = planet_index;
+    if (planet_index == BEAM_SPACESHIP) {
+        target->spawn_x = 4.0f; // Spaceship interior position
+        target->spawn_z = 4.0f;
+        return;
+    }
+    // The map's own spawn point if it has one
+    const PlanetData* planet = &g_planets[planet_index];
+    target->spawn_x = planet->map_offset_x;
+    target->spawn_z = planet->map_offset_z;
+    world_get_planet_spawn(planet_index, &target->spawn_x, &target->spawn_z, &target->spawn_yaw);
+    space_get_surface_desc(planet_index, &target->surface);
+}
+
+// Prepare phase: keep generating the destination; returns what is missing
+static int prepare_beam(const BeamTarget* target) {
+    if (target->planet_index == BEAM_SPACESHIP) {
+        return 0;
+    }
+    return world_prefetch_surface(&target->surface, target->spawn_x, target->spawn_z);
+}
+
+// Commit phase: swap the destination in. Whatever the prepare phase did
+// not finish is generated here, inside the frame.
+static void commit_beam(const BeamTarget* target, double request_ms) {
+    double start = platform_now_ms();
+    if (target->planet_index == BEAM_SPACESHIP) {
+        g_current_location = LOCATION_SPACESHIP;
+        world_set_spaceship_map();
+    } else {
+        g_current_location = LOCATION_PLANET;
+        g_current_planet = target->planet_index;
+        world_set_planet_map(target->planet_index);
+        // Open the map onto the planet's endless surface
+        world_enter_surface(&target->surface, target->spawn_x, target->spawn_z);
+    }
+    player_init(target->spawn_x, target->spawn_z);
+    player_set_rotation(target->spawn_yaw, 0.0f);
+    double end = platform_now_ms();
+
+    g_beam_stats.completed++;
+    g_beam_stats.last_commit_ms = end - start;
+    g_beam_stats.last_latency_ms = end - request_ms;
+    if (g_beam_stats.last_commit_ms > g_beam_stats.max_commit_ms) {
+        g_beam_stats.max_commit_ms = g_beam_stats.last_commit_ms;
+    }
+    if (g_beam_stats.last_latency_ms > g_beam_stats.max_latency_ms) {
+        g_beam_stats.max_latency_ms = g_beam_stats.last_latency_ms;
+    }
+}
+
+static void print_departure(int planet_index) {
+    if (planet_index == BEAM_SPACESHIP) {
+        printf("Beaming up to spaceship...\n");
+        return;
+    }
+    const PlanetData* planet = &g_planets[planet_index];
+    printf("Beaming down to %s...\n", planet->name);
+    printf("  Distance: %.2f AU\n", planet->distance_au);
+    printf("  Temperature: %.1f K (%.1f C)\n", planet->surface_temp_k, planet->surface_temp_k - 273.15f);
+    printf("  Gravity: %.2fg\n", planet->gravity_g);
+    printf("  Atmosphere: %s\n", 
+           planet->atmosphere_type == 0 ? "None" :
+           planet->atmosphere_type == 1 ? "Thin" :
+           planet->atmosphere_type == 2 ? "Breathable" : "Toxic");
+}
+
+static void print_arrival(int planet_index) {
+    if (planet_index == BEAM_SPACESHIP) {
+        printf("Arrived on spaceship\n");
+    } else {
+        printf("Arrived on %s surface\n", g_planets[planet_index].name);
+    }
+}
+
 // Beam player to spaceship
 void space_beam_to_spaceship(void) {
     if (g_current_location == LOCATION_SPACESHIP) {
         return; // Already on spaceship
     }
     
-    printf("Beaming up to spaceship...\n");
-    
-    // Save current planet position
-    float player_x, player_y, player_z;
-    player_get_position(&player_x, &player_y, &player_z);
-    
-    // Teleport to spaceship interior
-    g_current_location = LOCATION_SPACESHIP;
-    
-    // Switch to spaceship map
-    extern void world_set_spaceship_map(void);
-    world_set_spaceship_map();
+    print_departure(BEAM_SPACESHIP);
+    g_beam_pending = 0;
     
-    player_init(4.0f, 4.0f); // Spaceship interior position
-    player_set_rotation(0.0f, 0.0f);
+    BeamTarget target;
+    plan_beam(BEAM_SPACESHIP, &target);
+    commit_beam(&target, platform_now_ms());
     
-    printf("Arrived on spaceship\n");
+    print_arrival(BEAM_SPACESHIP);
 }
 
 // Beam player to pilot seat (triggers C# transition)
@@ -205,35 +310,98 @@ void space_beam_to_pilot_seat(void) {
     // The actual C# initialization will be handled by JavaScript
 }
 
-// Beam player to planet
+// Surface generation parameters derived from the planet's data, so every
+// planet has its own terrain and the same terrain on every visit
+int space_get_surface_desc(int planet_index, SurfaceDesc* desc) {
+    if (planet_index < 0 || planet_index >= g_planet_count) {
+        return 0;
+    }
+    const PlanetData* planet = &g_planets[planet_index];
+    float floats[5] = { planet->distance_au, planet->radius_km, planet->surface_temp_k,
+                        planet->gravity_g, planet->rotation_period_h };
+    int ints[4] = { planet->atmosphere_type, planet->has_water, planet->has_life, planet->resource_richness };
+
+    // FNV-1a over the fields' bytes
+    uint32_t seed = 2166136261u;
+    const uint8_t* bytes = (const uint8_t*)floats;
+    for (size_t i = 0; i < sizeof(floats); ++i) {
+        seed = (seed ^ bytes[i]) * 16777619u;
+    }
+    bytes = (const uint8_t*)ints;
+    for (size_t i = 0; i < sizeof(ints); ++i) {
+        seed = (seed ^ bytes[i]) * 16777619u;
+    }
+
+    desc->seed = seed;
+    // Richer worlds are rockier; thick and toxic atmospheres erode the rock
+    // into broad, smooth formations, airless worlds keep small crags
+    desc->rock_density = 40 + planet->resource_richness / 2;
+    desc->feature_log2 = planet->atmosphere_type >= 2 ? 4 : 3;
+    if (planet->atmosphere_type == 0) {
+        desc->feature_log2 = 2;
+    }
+    desc->ruin_chance = planet->has_life ? 48 : 0;
+    desc->basin_level = planet->has_water ? 80 : 0;
+    return 1;
+}
+
+// Beam player to planet, all within this call
 void space_beam_to_planet(int planet_index) {
     if (planet_index < 0 || planet_index >= g_planet_count) {
         printf("ERROR: Invalid planet index %d\n", planet_index);
         return;
     }
     
-    PlanetData* planet = &g_planets[planet_index];
-    
-    printf("Beaming down to %s...\n", planet->name);
-    printf("  Distance: %.2f AU\n", planet->distance_au);
-    printf("  Temperature: %.1f K (%.1f C)\n", planet->surface_temp_k, planet->surface_temp_k - 273.15f);
-    printf("  Gravity: %.2fg\n", planet->gravity_g);
-    printf("  Atmosphere: %s\n", 
-           planet->atmosphere_type == 0 ? "None" :
-           planet->atmosphere_type == 1 ? "Thin" :
-           planet->atmosphere_type == 2 ? "Breathable" : "Toxic");
-    
-    g_current_location = LOCATION_PLANET;
-    g_current_planet = planet_index;
-    
-    // Set planet-specific map
-    world_set_planet_map(planet_index);
+    print_departure(planet_index);
+    g_beam_pending = 0;
     
-    // Teleport to planet surface
-    player_init(planet->map_offset_x, planet->map_offset_z);
-    player_set_rotation(0.0f, 0.0f);
+    BeamTarget target;
+    plan_beam(planet_index, &target);
+    commit_beam(&target, platform_now_ms());
     
-    printf("Arrived on %s surface\n", planet->name);
+    print_arrival(planet_index);
+}
+
+// Start a beam; space_update finishes it
+int space_request_beam(int planet_index) {
+    if (planet_index < BEAM_SPACESHIP || planet_index >= g_planet_count) {
+        printf("ERROR: Invalid planet index %d\n", planet_index);
+        return 0;
+    }
+    if (g_beam_pending && g_beam_target.planet_index == planet_index) {
+        return 1; // Already on the way
+    }
+    if (planet_index == BEAM_SPACESHIP && g_current_location == LOCATION_SPACESHIP) {
+        g_beam_pending = 0; // Stay aboard
+        return 1;
+    }
+
+    print_departure(planet_index);
+    plan_beam(planet_index, &g_beam_target);
+    g_beam_pending = 1;
+    g_beam_request_ms = platform_now_ms();
+    g_beam_stats.requested++;
+    prepare_beam(&g_beam_target);
+    return 1;
+}
+
+int space_is_beam_pending(void) {
+    return g_beam_pending;
+}
+
+// Prepare a likely destination before it is requested
+void space_prefetch_planet(int planet_index) {
+    if (planet_index < 0 || planet_index >= g_planet_count) {
+        g_prefetch_pending = 0;
+        return;
+    }
+    plan_beam(planet_index, &g_prefetch_target);
+    g_prefetch_pending = 1;
+    prepare_beam(&g_prefetch_target);
+}
+
+const SpaceBeamStats* space_get_beam_stats(void) {
+    return &g_beam_stats;
 }
 
 // Get planet data
@@ -249,9 +417,67 @@ int space_get_planet_count(void) {
     return g_planet_count;
 }
 
+void space_get_galaxy_position(float* x, float* y, float* z) {
+    *x = g_galaxy_position[0];
+    *y = g_galaxy_position[1];
+    *z = g_galaxy_position[2];
+}
+
+// Load every planet's map image from a directory
+int space_load_planet_maps(const char* directory) {
+    int loaded = 0;
+    for (int i = 0; i < g_planet_count; ++i) {
+        if (!g_planets[i].map_file) {
+            continue;
+        }
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", directory, g_planets[i].map_file);
+        if (world_open_planet_map(i, path)) {
+            loaded++;
+        }
+    }
+    return loaded;
+}
+
 // Update space system
 void space_update(double delta_time) {
     // Future: Add space environment updates (stars, nebulas, etc.)
+
+    // Prepare the pending beam (or the prefetched planet) and swap the
+    // destination in once all of it is ready
+    if (!g_beam_pending) {
+        if (g_prefetch_pending) {
+            prepare_beam(&g_prefetch_target);
+        }
+        return;
+    }
+    int missing = prepare_beam(&g_beam_target);
+    if (g_beam_hold) {
+        return;
+    }
+    if (missing > 0 && platform_now_ms() - g_beam_request_ms < BEAM_TIMEOUT_MS) {
+        return;
+    }
+    if (missing > 0) {
+        g_beam_stats.waited++;
+    }
+    space_commit_beam();
+}
+
+void space_hold_beams(int hold) {
+    g_beam_hold = hold ? 1 : 0;
+}
+
+void space_commit_beam(void) {
+    if (!g_beam_pending) {
+        return;
+    }
+    g_beam_pending = 0;
+    if (g_prefetch_pending && g_prefetch_target.planet_index == g_beam_target.planet_index) {
+        g_prefetch_pending = 0;
+    }
+    commit_beam(&g_beam_target, g_beam_request_ms);
+    print_arrival(g_beam_target.planet_index);
 }
 
 // Render space environment (if on spaceship)
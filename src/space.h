@@ -4,6 +4,8 @@
 #ifndef SPACE_H
 #define SPACE_H
 
+#include "surface.h"
+
 // Location types
 typedef enum {
     LOCATION_SPACESHIP = 0,
@@ -24,8 +26,21 @@ typedef struct {
     int resource_richness;    // 0-100
     float map_offset_x;       // Map spawn position X
     float map_offset_z;       // Map spawn position Z
+    const char* map_file;     // .qmap image (spawn overrides map_offset_*)
 } PlanetData;
 
+// Beam transitions: time from request to arrival, and the part of it
+// spent inside one frame swapping the destination in
+typedef struct {
+    int requested;            // Beams started with space_request_beam
+    int completed;            // Arrivals, including synchronous beams
+    int waited;               // Arrivals whose surface was not fully prepared
+    double last_latency_ms;   // Request to arrival
+    double max_latency_ms;
+    double last_commit_ms;    // Frame time taken by the swap
+    double max_commit_ms;
+} SpaceBeamStats;
+
 // Get current location type
 LocationType space_get_location_type(void);
 
@@ -38,15 +53,48 @@ void space_beam_to_spaceship(void);
 // Beam player to pilot seat (triggers C# transition)
 void space_beam_to_pilot_seat(void);
 
-// Beam player to planet
+// Beam player to planet (synchronously: the destination is built and
+// swapped in before this returns)
 void space_beam_to_planet(int planet_index);
 
+// Start beaming to a planet, or -1 for the spaceship. The destination is
+// prepared in the background while the current world keeps running, and
+// space_update swaps it in within one frame once it is ready. A new
+// request replaces a pending one. Returns 0 for an invalid index.
+int space_request_beam(int planet_index);
+int space_is_beam_pending(void);
+
+// When a beam arrives depends on how much of the destination was cached.
+// Replays hold pending beams (space_update keeps preparing them but never
+// swaps them in) and commit each at its recorded tick; the commit builds
+// whatever preparation left.
+void space_hold_beams(int hold);
+void space_commit_beam(void);
+
+// Start preparing a planet the player is likely to beam to (selected in
+// the planet menu), so the beam arrives without waiting; -1 stops
+void space_prefetch_planet(int planet_index);
+
+const SpaceBeamStats* space_get_beam_stats(void);
+
 // Get planet data
 PlanetData* space_get_planet(int index);
 
 // Get number of available planets
 int space_get_planet_count(void);
 
+// Where the home system (these planets) lies in the galaxy, in light
+// years (see galaxy.h)
+void space_get_galaxy_position(float* x, float* y, float* z);
+
+// Generation parameters of a planet's endless surface, derived from its
+// data (returns 0 for an invalid index)
+int space_get_surface_desc(int planet_index, SurfaceDesc* desc);
+
+// Load every planet's map_file from a directory (native builds; the browser
+// fetches them and attaches them instead). Returns the number loaded.
+int space_load_planet_maps(const char* directory);
+
 // Initialize space system
 int space_init(void);
 
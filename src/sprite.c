@@ -0,0 +1,479 @@
+// Sprite implementation - Culling, radix sort, per-strip batches
+// QuakeCloneWASM - Rendering system
+//
+// Billboards stand parallel to the camera plane, so a sprite has one
+// perpendicular depth for all its columns, compared directly with the
+// walls' corrected distance. Columns follow the camera tables (equal angle
+// steps), so a billboard's texel column comes from the column's ray slope
+// rather than from a linear step. Visible sprites are sorted once for the
+// frame with an LSD radix sort on their depth bits and bucketed by strip
+// (a stable counting sort), so each strip walks only its own batch.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "camera.h"
+#include "sprite.h"
+
+// Sprites nearer than this are behind the camera or inside it
+#define SPRITE_NEAR 0.05f
+
+// Height of the eye above the floor (walls span 2 units around it)
+#define EYE_HEIGHT 1.0f
+
+// Column-major images, SPRITE_SIZE texels per column; 0 is transparent
+static uint32_t g_images[SPRITE_IMAGE_COUNT][SPRITE_SIZE * SPRITE_SIZE];
+
+// First and last opaque texel of every image column (first > last: empty)
+static int8_t g_opaque_first[SPRITE_IMAGE_COUNT][SPRITE_SIZE];
+static int8_t g_opaque_last[SPRITE_IMAGE_COUNT][SPRITE_SIZE];
+
+// Projected visible sprites (indices are visible slots, not entities)
+typedef struct {
+    float* depth;           // Perpendicular distance
+    float* left;            // Lateral position of the left edge
+    float* u_scale;         // Texels per world unit
+    int32_t* column_first;
+    int32_t* column_last;
+    int32_t* row_top;       // First row (clamped to the viewport)
+    int32_t* row_end;       // One past the last row
+    int32_t* v_origin;      // 16.16 fixed point, as the wall spans
+    int32_t* v_step;
+    int32_t* light;         // Colormap level
+    uint32_t* key;          // Sort keys and order (two buffers each)
+    uint32_t* key_swap;
+    int32_t* order;
+    int32_t* order_swap;
+    int capacity;
+} SpriteList;
+
+static SpriteList g_list;
+static SpriteCamera g_camera;
+static SpriteStats g_stats;
+static int g_visible = 0;
+static float g_half_fov = 0.0f;     // Radians
+static float g_tan_half_fov = 0.0f;
+
+// Per-strip batches: entries[strip_start[s] .. strip_start[s + 1]) in
+// far-to-near order
+static int32_t* g_strip_start = NULL;
+static int g_strip_capacity = 0;
+static int32_t* g_entries = NULL;
+static int g_entry_capacity = 0;
+
+static inline uint32_t pack_texel(int r, int g, int b) {
+    if (r < 0) r = 0;
+    if (g < 0) g = 0;
+    if (b < 0) b = 0;
+    if (r > 255) r = 255;
+    if (g > 255) g = 255;
+    if (b > 255) b = 255;
+    return 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+}
+
+// Squared distance of texel (u, v) from (cu, cv) in units of the radii
+static float ellipse(int u, int v, float cu, float cv, float ru, float rv) {
+    float du = ((float)u + 0.5f - cu) / ru;
+    float dv = ((float)v + 0.5f - cv) / rv;
+    return du * du + dv * dv;
+}
+
+// Texel (u, v) of an image
+static uint32_t generate_texel(int image, int u, int v) {
+    if (image == SPRITE_IMAGE_CRITTER) {
+        // Eyes with pupils, a round body, two stubby legs
+        float eye_l = ellipse(u, v, 12.0f, 15.0f, 2.5f, 2.5f);
+        float eye_r = ellipse(u, v, 20.0f, 15.0f, 2.5f, 2.5f);
+        if (eye_l < 1.0f || eye_r < 1.0f) {
+            return (eye_l < 0.3f || eye_r < 0.3f) ? pack_texel(20, 20, 30) : pack_texel(235, 235, 220);
+        }
+        float body = ellipse(u, v, 16.0f, 19.0f, 11.0f, 9.0f);
+        if (body < 1.0f) {
+            int light = (int)((1.0f - body) * 60.0f) - v;
+            return pack_texel(90 + light, 150 + light, 70 + light / 2);
+        }
+        if (v >= 26 && ((u >= 10 && u < 13) || (u >= 19 && u < 22))) {
+            return pack_texel(60, 90, 40);
+        }
+        return 0;
+    }
+
+    // Drone: antenna, red beacon in a metal disc, thruster glow below
+    if (u >= 15 && u < 17 && v < 5) {
+        return pack_texel(150, 160, 175);
+    }
+    float beacon = ellipse(u, v, 16.0f, 14.0f, 3.0f, 3.0f);
+    if (beacon < 1.0f) {
+        return pack_texel(255, 60 + (int)(beacon * 80.0f), 50);
+    }
+    float disc = ellipse(u, v, 16.0f, 14.0f, 12.0f, 9.0f);
+    if (disc < 1.0f) {
+        int band = (v >= 16 && v < 18) ? -50 : 0;
+        int light = (int)((1.0f - disc) * 50.0f) - u + band;
+        return pack_texel(140 + light, 155 + light, 175 + light);
+    }
+    int half = (31 - v) / 2;
+    if (v >= 24 && v < 31 && u >= 16 - half && u < 16 + half) {
+        return pack_texel(120, 220, 255);
+    }
+    return 0;
+}
+
+// Generate the images and their opaque ranges
+int sprite_init(void) {
+    for (int image = 0; image < SPRITE_IMAGE_COUNT; ++image) {
+        for (int u = 0; u < SPRITE_SIZE; ++u) {
+            int first = SPRITE_SIZE, last = -1;
+            for (int v = 0; v < SPRITE_SIZE; ++v) {
+                uint32_t texel = generate_texel(image, u, v);
+                g_images[image][u * SPRITE_SIZE + v] = texel;
+                if (texel) {
+                    if (v < first) first = v;
+                    last = v;
+                }
+            }
+            g_opaque_first[image][u] = (int8_t)first;
+            g_opaque_last[image][u] = (int8_t)last;
+        }
+    }
+    return 1;
+}
+
+// realloc that leaves *array untouched on failure
+static int grow_array(void** array, size_t count, size_t element_size) {
+    void* grown = realloc(*array, count * element_size);
+    if (!grown) {
+        return 0;
+    }
+    *array = grown;
+    return 1;
+}
+
+static int ensure_list_capacity(int count) {
+    if (count <= g_list.capacity) {
+        return 1;
+    }
+    size_t n = (size_t)count;
+    if (!grow_array((void**)&g_list.depth, n, sizeof(float)) ||
+        !grow_array((void**)&g_list.left, n, sizeof(float)) ||
+        !grow_array((void**)&g_list.u_scale, n, sizeof(float)) ||
+        !grow_array((void**)&g_list.column_first, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_list.column_last, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_list.row_top, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_list.row_end, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_list.v_origin, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_list.v_step, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_list.light, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_list.key, n, sizeof(uint32_t)) ||
+        !grow_array((void**)&g_list.key_swap, n, sizeof(uint32_t)) ||
+        !grow_array((void**)&g_list.order, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_list.order_swap, n, sizeof(int32_t))) {
+        printf("ERROR: Failed to allocate %d sprites\n", count);
+        return 0;
+    }
+    g_list.capacity = count;
+    return 1;
+}
+
+// Project one sprite; returns 0 when it is culled
+static int project_sprite(int slot, float x, float z, float radius) {
+    const SpriteCamera* cam = &g_camera;
+    float dx = x - cam->pos_x;
+    float dz = z - cam->pos_z;
+    float forward = dx * cam->view_sin - dz * cam->view_cos;
+    if (forward < SPRITE_NEAR || forward >= cam->max_depth) {
+        return 0;
+    }
+
+    // Both edges against the view's half angle, before any trig
+    float size = radius * SPRITE_SCALE;
+    float lateral = dx * cam->view_cos + dz * cam->view_sin;
+    float left = lateral - size * 0.5f;
+    float right = lateral + size * 0.5f;
+    float reach = forward * g_tan_half_fov;
+    if (left >= reach || right <= -reach) {
+        return 0;
+    }
+
+    // Columns whose rays pass between the edges
+    float angle_step = 2.0f * g_half_fov / (float)cam->viewport_width;
+    int first = (int)ceilf((atanf(left / forward) + g_half_fov) / angle_step);
+    int last = (int)floorf((atanf(right / forward) + g_half_fov) / angle_step);
+    if (first < 0) first = 0;
+    if (last >= cam->viewport_width) last = cam->viewport_width - 1;
+    if (first > last) {
+        return 0;
+    }
+
+    // Rows: standing on the floor, height scaled like the walls
+    float pixels_per_unit = (float)cam->viewport_height / forward;
+    float bottom = (float)cam->horizon + EYE_HEIGHT * pixels_per_unit;
+    float height = size * pixels_per_unit;
+    float top = bottom - height;
+    int row_top = (int)ceilf(top - 0.5f);
+    int row_end = (int)ceilf(bottom - 0.5f);
+    if (row_top < 0) row_top = 0;
+    if (row_end > cam->viewport_height) row_end = cam->viewport_height;
+    if (row_top >= row_end) {
+        return 0;
+    }
+
+    float ratio = (float)SPRITE_SIZE / height;
+    g_list.depth[slot] = forward;
+    g_list.left[slot] = left;
+    g_list.u_scale[slot] = (float)SPRITE_SIZE / size;
+    g_list.column_first[slot] = first;
+    g_list.column_last[slot] = last;
+    g_list.row_top[slot] = row_top;
+    g_list.row_end[slot] = row_end;
+    g_list.v_step[slot] = (int32_t)(ratio * 65536.0f);
+    g_list.v_origin[slot] = (int32_t)((0.5f - top) * ratio * 65536.0f);
+    g_list.light[slot] = colormap_level(cam->colormap, forward); // Same shading as the walls
+    return 1;
+}
+
+// Sort g_list.order far to near: LSD radix sort, 8 bits per pass, on the
+// inverted bits of the (positive) depths. Passes whose digit is the same
+// for every key are skipped.
+static void sort_visible(int count) {
+    for (int i = 0; i < count; ++i) {
+        uint32_t bits;
+        memcpy(&bits, &g_list.depth[i], sizeof(bits));
+        g_list.key[i] = ~bits;
+        g_list.order[i] = i;
+    }
+
+    uint32_t* key = g_list.key;
+    uint32_t* key_out = g_list.key_swap;
+    int32_t* order = g_list.order;
+    int32_t* order_out = g_list.order_swap;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int histogram[257];
+        memset(histogram, 0, sizeof(histogram));
+        for (int i = 0; i < count; ++i) {
+            histogram[((key[i] >> shift) & 0xFF) + 1]++;
+        }
+        if (histogram[((key[0] >> shift) & 0xFF) + 1] == count) {
+            continue;
+        }
+        for (int d = 0; d < 256; ++d) {
+            histogram[d + 1] += histogram[d];
+        }
+        for (int i = 0; i < count; ++i) {
+            int at = histogram[(key[i] >> shift) & 0xFF]++;
+            key_out[at] = key[i];
+            order_out[at] = order[i];
+        }
+        uint32_t* key_tmp = key;
+        key = key_out;
+        key_out = key_tmp;
+        int32_t* order_tmp = order;
+        order = order_out;
+        order_out = order_tmp;
+    }
+
+    // Leave the result in the primary buffers
+    if (order != g_list.order) {
+        memcpy(g_list.order, order, (size_t)count * sizeof(int32_t));
+    }
+}
+
+// Bucket the sorted sprites by the strips they cover, keeping the order
+static int bucket_by_strip(int count) {
+    int strip_columns = g_camera.strip_columns;
+    int strips = (g_camera.viewport_width + strip_columns - 1) / strip_columns;
+    if (strips + 1 > g_strip_capacity) {
+        if (!grow_array((void**)&g_strip_start, (size_t)strips + 1, sizeof(int32_t))) {
+            printf("ERROR: Failed to allocate sprite strips\n");
+            return 0;
+        }
+        g_strip_capacity = strips + 1;
+    }
+
+    memset(g_strip_start, 0, (size_t)(strips + 1) * sizeof(int32_t));
+    int entries = 0;
+    for (int i = 0; i < count; ++i) {
+        int slot = g_list.order[i];
+        int first = g_list.column_first[slot] / strip_columns;
+        int last = g_list.column_last[slot] / strip_columns;
+        for (int s = first; s <= last; ++s) {
+            g_strip_start[s + 1]++;
+        }
+        entries += last - first + 1;
+    }
+    if (entries > g_entry_capacity) {
+        if (!grow_array((void**)&g_entries, (size_t)entries, sizeof(int32_t))) {
+            printf("ERROR: Failed to allocate sprite batches\n");
+            return 0;
+        }
+        g_entry_capacity = entries;
+    }
+    for (int s = 0; s < strips; ++s) {
+        g_strip_start[s + 1] += g_strip_start[s];
+    }
+    // Scatter with each strip's start as its cursor, then shift back
+    for (int i = 0; i < count; ++i) {
+        int slot = g_list.order[i];
+        int first = g_list.column_first[slot] / strip_columns;
+        int last = g_list.column_last[slot] / strip_columns;
+        for (int s = first; s <= last; ++s) {
+            g_entries[g_strip_start[s]++] = slot;
+        }
+    }
+    for (int s = strips; s > 0; --s) {
+        g_strip_start[s] = g_strip_start[s - 1];
+    }
+    g_strip_start[0] = 0;
+    g_stats.strip_batches = entries;
+    return 1;
+}
+
+// Cull, project, sort and bucket the frame's sprites
+int sprite_prepare(const SpriteCamera* camera, const float* x, const float* z, const float* radius, int count) {
+    double start = platform_now_ms();
+    g_camera = *camera;
+    g_half_fov = CAMERA_FOV_DEGREES * (M_PI / 360.0f);
+    g_tan_half_fov = tanf(g_half_fov);
+    g_visible = 0;
+    g_stats.total = count;
+    g_stats.visible = 0;
+    g_stats.strip_batches = 0;
+
+    const CameraTables* tables = camera_get_tables();
+    if (count <= 0 || !tables || tables->width != camera->viewport_width || !ensure_list_capacity(count)) {
+        g_stats.prepare_ms = platform_now_ms() - start;
+        return 0;
+    }
+
+    int visible = 0;
+    for (int i = 0; i < count; ++i) {
+        visible += project_sprite(visible, x[i], z[i], radius[i]);
+    }
+    if (visible > 0) {
+        sort_visible(visible);
+        if (!bucket_by_strip(visible)) {
+            visible = 0;
+        }
+    }
+
+    g_visible = visible;
+    g_stats.visible = visible;
+    g_stats.prepare_ms = platform_now_ms() - start;
+    return visible;
+}
+
+// Draw one sprite's columns [x_begin, x_end) where it is nearer than the
+// walls; grows *drawn (x0, y0, x1, y1) by what it wrote
+static void draw_sprite_columns(const CameraTables* tables, int slot, int x_begin, int x_end,
+                                uint32_t* framebuffer, const float* depth, int32_t* drawn) {
+    const uint32_t* image = g_images[g_camera.image];
+    const int8_t* opaque_first = g_opaque_first[g_camera.image];
+    const int8_t* opaque_last = g_opaque_last[g_camera.image];
+    float sprite_depth = g_list.depth[slot];
+    float left = g_list.left[slot];
+    float u_scale = g_list.u_scale[slot];
+    int32_t v_origin = g_list.v_origin[slot];
+    int32_t v_step = g_list.v_step[slot];
+    const ColormapLevel* light = &g_camera.colormap->levels[g_list.light[slot]];
+    int row_top = g_list.row_top[slot];
+    int row_end = g_list.row_end[slot];
+    size_t stride = (size_t)g_camera.viewport_width;
+
+    int first = g_list.column_first[slot] > x_begin ? g_list.column_first[slot] : x_begin;
+    int last = g_list.column_last[slot] < x_end - 1 ? g_list.column_last[slot] : x_end - 1;
+    for (int x = first; x <= last; ++x) {
+        if (depth[x] <= sprite_depth) {
+            continue; // Behind this column's wall
+        }
+        // Texel column from where the column's ray crosses the billboard
+        float lateral = sprite_depth * tables->ray_sin[x] / tables->ray_cos[x];
+        int u = (int)((lateral - left) * u_scale);
+        if (u < 0) u = 0;
+        if (u >= SPRITE_SIZE) u = SPRITE_SIZE - 1;
+        int v_first = opaque_first[u];
+        int v_last = opaque_last[u];
+        if (v_first > v_last) {
+            continue;
+        }
+
+        // Rows whose texel falls in the opaque range
+        int y0 = (int)(((int64_t)v_first * 65536 - v_origin) / v_step) - 1;
+        int y1 = (int)(((int64_t)(v_last + 1) * 65536 - v_origin) / v_step) + 1;
+        if (y0 < row_top) y0 = row_top;
+        if (y1 > row_end) y1 = row_end;
+
+        const uint32_t* column = image + u * SPRITE_SIZE;
+        int wrote = 0;
+        for (int y = y0; y < y1; ++y) {
+            int32_t v = (int32_t)((uint32_t)v_origin + (uint32_t)y * (uint32_t)v_step) >> 16;
+            if (v < 0 || v >= SPRITE_SIZE) {
+                continue;
+            }
+            uint32_t texel = column[v];
+            if (!texel) {
+                continue;
+            }
+            framebuffer[(size_t)y * stride + (size_t)x] = colormap_shade(light, texel);
+            wrote = 1;
+        }
+        if (wrote) {
+            if (x < drawn[0]) drawn[0] = x;
+            if (x + 1 > drawn[2]) drawn[2] = x + 1;
+            if (y0 < drawn[1]) drawn[1] = y0;
+            if (y1 > drawn[3]) drawn[3] = y1;
+        }
+    }
+}
+
+// Draw one strip's batch, far to near
+void sprite_draw_strip(int strip, int x_end, uint32_t* framebuffer, const float* depth, RendererRect* drawn) {
+    drawn->x = drawn->y = drawn->width = drawn->height = 0;
+    const CameraTables* tables = camera_get_tables();
+    if (g_visible == 0 || !tables) {
+        return;
+    }
+
+    int x_begin = strip * g_camera.strip_columns;
+    int32_t bounds[4] = { x_end, g_camera.viewport_height, x_begin, 0 };
+    for (int e = g_strip_start[strip]; e < g_strip_start[strip + 1]; ++e) {
+        draw_sprite_columns(tables, g_entries[e], x_begin, x_end, framebuffer, depth, bounds);
+    }
+    if (bounds[0] < bounds[2] && bounds[1] < bounds[3]) {
+        drawn->x = bounds[0];
+        drawn->y = bounds[1];
+        drawn->width = bounds[2] - bounds[0];
+        drawn->height = bounds[3] - bounds[1];
+    }
+}
+
+const SpriteStats* sprite_get_stats(void) {
+    return &g_stats;
+}
+
+void sprite_shutdown(void) {
+    free(g_list.depth);
+    free(g_list.left);
+    free(g_list.u_scale);
+    free(g_list.column_first);
+    free(g_list.column_last);
+    free(g_list.row_top);
+    free(g_list.row_end);
+    free(g_list.v_origin);
+    free(g_list.v_step);
+    free(g_list.light);
+    free(g_list.key);
+    free(g_list.key_swap);
+    free(g_list.order);
+    free(g_list.order_swap);
+    memset(&g_list, 0, sizeof(g_list));
+    free(g_strip_start);
+    free(g_entries);
+    g_strip_start = NULL;
+    g_entries = NULL;
+    g_strip_capacity = 0;
+    g_entry_capacity = 0;
+    g_visible = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+}
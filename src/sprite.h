@@ -0,0 +1,71 @@
+// Sprite header - Billboards clipped against the wall depth buffer
+// QuakeCloneWASM - Rendering system
+//
+// Sprites are camera-facing squares standing on the floor. Each frame
+// sprite_prepare projects them, culls those outside the view before any
+// sorting, radix-sorts the rest far to near and buckets them by column
+// strip; the world's column strips then call sprite_draw_strip after their
+// walls, so every strip draws its own batch against the depth of the walls
+// it just traced.
+
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include <stdint.h>
+#include "renderer.h"
+#include "colormap.h"
+
+// Sprite images are SPRITE_SIZE x SPRITE_SIZE texels, stored column-major
+#define SPRITE_SIZE 32
+
+// Billboard height and width per unit of collision radius
+#define SPRITE_SCALE 4.0f
+
+typedef enum {
+    SPRITE_IMAGE_CRITTER = 0,   // Planet wildlife
+    SPRITE_IMAGE_DRONE,         // Spaceship maintenance drone
+    SPRITE_IMAGE_COUNT
+} SpriteImage;
+
+// Camera for one frame
+typedef struct {
+    float pos_x;            // World position
+    float pos_z;
+    float view_sin;         // sin(yaw) and cos(yaw), as the wall pass
+    float view_cos;
+    int viewport_width;
+    int viewport_height;
+    int horizon;
+    int strip_columns;      // Columns per strip of the world pass
+    float max_depth;        // Farthest visible distance (sprites beyond are culled)
+    const Colormap* colormap; // Light and fog tables, shared with the walls
+    SpriteImage image;      // Image drawn for every sprite this frame
+} SpriteCamera;
+
+// Counters of the last sprite_prepare
+typedef struct {
+    int total;              // Sprites offered
+    int visible;            // Left after culling (sorted and drawn)
+    int strip_batches;      // Sprite-strip pairs handed to the strips
+    double prepare_ms;      // Projection, culling, sorting and bucketing
+} SpriteStats;
+
+// Generate the sprite images. Returns 0 on failure.
+int sprite_init(void);
+
+// Project count sprites (world positions and collision radii) for camera,
+// cull those outside the view and sort and bucket the rest. Returns the
+// number of visible sprites.
+int sprite_prepare(const SpriteCamera* camera, const float* x, const float* z, const float* radius, int count);
+
+// Draw the batch of strip (columns strip * strip_columns onwards, up to
+// x_end) far to near into framebuffer, skipping columns where depth (the
+// walls' perpendicular distance per column) is nearer than the sprite.
+// Sets drawn to the pixels written (width 0: none).
+void sprite_draw_strip(int strip, int x_end, uint32_t* framebuffer, const float* depth, RendererRect* drawn);
+
+const SpriteStats* sprite_get_stats(void);
+
+void sprite_shutdown(void);
+
+#endif // SPRITE_H
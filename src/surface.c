@@ -0,0 +1,641 @@
+// Surface implementation - Chunk generation, LRU cache and resident window
+// QuakeCloneWASM - World system
+//
+// The main thread owns the cache index (hash chains and LRU list) and the
+// window. A requested chunk is PENDING until its background task has filled
+// the cells and published READY with a release store; only then does the
+// main thread read them. Pending chunks are never evicted. Generation uses
+// integer arithmetic only, so every build produces the same terrain.
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "jobs.h"
+#include "surface.h"
+
+#define CHUNK_TILES (SURFACE_CHUNK_SIZE / WORLDMAP_TILE_SIZE)
+#define WINDOW_CELLS (SURFACE_WINDOW_CHUNKS * SURFACE_CHUNK_SIZE)
+#define PREFETCH_CHUNKS ((2 * SURFACE_PREFETCH_RADIUS + 1) * (2 * SURFACE_PREFETCH_RADIUS + 1))
+
+// Chunks generating at once, and the smallest cache: twice the prefetch area
+#define MAX_IN_FLIGHT 16
+#define MIN_CACHE_CHUNKS (2 * PREFETCH_CHUNKS)
+
+// Builds without threads generate on the main thread for this long per update
+#define UPDATE_BUDGET_MS 1.0
+
+// Open cells kept around the landing site so it joins the terrain
+#define SITE_MARGIN 2
+
+// Keeps lattice coordinates positive on both sides of the origin
+#define NOISE_BIAS 0x40000000u
+
+// Independent noise streams from one seed
+#define SALT_DETAIL 0x68E31DA4u
+#define SALT_BASIN 0xB5297A4Du
+#define SALT_BOULDER 0x1B56C4E9u
+#define SALT_RUIN 0x9E3779B9u
+
+enum {
+    CHUNK_FREE = 0,
+    CHUNK_PENDING,
+    CHUNK_READY
+};
+
+typedef struct {
+    SurfaceDesc desc;           // Key: surface and chunk position
+    int chunk_x, chunk_z;
+    atomic_int state;
+    double generate_ms;         // Written by the generating thread
+    int lru_prev, lru_next;     // Most recent at g_lru_head; the free list uses lru_next
+    int hash_next;
+    uint8_t cells[SURFACE_CHUNK_CELLS];
+} SurfaceChunk;
+
+// Chunk cache
+static SurfaceChunk* g_chunks = NULL;
+static int g_capacity = 0;
+static size_t g_budget_bytes = 0;
+static int* g_hash_heads = NULL;
+static uint32_t g_hash_mask = 0;
+static int g_lru_head = -1;
+static int g_lru_tail = -1;
+static int g_free_head = -1;
+static int g_in_flight[MAX_IN_FLIGHT];
+static int g_in_flight_count = 0;
+
+// Surface being streamed
+static SurfaceDesc g_desc;
+static const WorldMap* g_site = NULL;
+static int g_active = 0;
+
+// Resident window
+static WorldMap g_window;
+static int g_window_x = 0;      // Chunk at window slot (0, 0)
+static int g_window_z = 0;
+static int g_window_valid = 0;
+static uint8_t g_window_ready[SURFACE_WINDOW_CHUNKS * SURFACE_WINDOW_CHUNKS];
+
+static SurfaceStats g_stats;
+
+static uint32_t mix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+static uint32_t lattice_hash(uint32_t seed, uint32_t x, uint32_t z) {
+    return mix32(seed ^ mix32(x ^ mix32(z + 0x9E3779B9u)));
+}
+
+// Bilinear value noise in [0, 255] on a lattice of 2^period_log2 cells
+static int value_noise(uint32_t seed, int x, int z, int period_log2) {
+    uint32_t ux = (uint32_t)x + NOISE_BIAS;
+    uint32_t uz = (uint32_t)z + NOISE_BIAS;
+    uint32_t ix = ux >> period_log2;
+    uint32_t iz = uz >> period_log2;
+    int period = 1 << period_log2;
+    int fx = (int)(ux & (uint32_t)(period - 1));
+    int fz = (int)(uz & (uint32_t)(period - 1));
+
+    int v00 = (int)(lattice_hash(seed, ix, iz) >> 24);
+    int v10 = (int)(lattice_hash(seed, ix + 1, iz) >> 24);
+    int v01 = (int)(lattice_hash(seed, ix, iz + 1) >> 24);
+    int v11 = (int)(lattice_hash(seed, ix + 1, iz + 1) >> 24);
+    int top = v00 * (period - fx) + v10 * fx;
+    int bottom = v01 * (period - fx) + v11 * fx;
+    return (top * (period - fz) + bottom * fz) >> (2 * period_log2);
+}
+
+// Offset of cell (x, z) in a chunk's tile-ordered cells
+static inline int chunk_cell_index(int x, int z) {
+    return ((((z >> WORLDMAP_TILE_LOG2) * CHUNK_TILES) + (x >> WORLDMAP_TILE_LOG2)) << (2 * WORLDMAP_TILE_LOG2)) |
+           ((z & (WORLDMAP_TILE_SIZE - 1)) << WORLDMAP_TILE_LOG2) | (x & (WORLDMAP_TILE_SIZE - 1));
+}
+
+// A walled square with one doorway, fully inside the chunk
+static void add_ruin(uint32_t h, uint8_t* cells) {
+    int size = 5 + (int)((h >> 8) & 3);
+    int span = SURFACE_CHUNK_SIZE - 4 - size;
+    int ox = 2 + (int)((h >> 12) & 0xFF) % span;
+    int oz = 2 + (int)((h >> 20) & 0xFF) % span;
+    int door = (int)(h >> 28) & 3;
+    int last = size - 1;
+
+    // A free ring around the walls keeps the doorway reachable
+    for (int z = oz - 1; z <= oz + size; ++z) {
+        for (int x = ox - 1; x <= ox + size; ++x) {
+            int dx = x - ox;
+            int dz = z - oz;
+            int wall = (dx == 0 || dx == last || dz == 0 || dz == last) && dx >= 0 && dx <= last && dz >= 0 && dz <= last;
+            int doorway = (door == 0 && dz == 0 && dx == size / 2) || (door == 1 && dz == last && dx == size / 2) ||
+                          (door == 2 && dx == 0 && dz == size / 2) || (door == 3 && dx == last && dz == size / 2);
+            cells[chunk_cell_index(x, z)] = (uint8_t)(wall && !doorway ? 1 : 0);
+        }
+    }
+}
+
+// Rock formations where two octaves of noise peak, scattered boulders,
+// open basins on low ground and the occasional ruin
+void surface_generate_chunk(const SurfaceDesc* desc, int chunk_x, int chunk_z, uint8_t* cells) {
+    int feature_log2 = desc->feature_log2 < 1 ? 1 : (desc->feature_log2 > 8 ? 8 : desc->feature_log2);
+    int detail_log2 = feature_log2 > 1 ? feature_log2 - 1 : 1;
+    int threshold = 255 - desc->rock_density;
+    int base_x = chunk_x * SURFACE_CHUNK_SIZE;
+    int base_z = chunk_z * SURFACE_CHUNK_SIZE;
+
+    for (int z = 0; z < SURFACE_CHUNK_SIZE; ++z) {
+        for (int x = 0; x < SURFACE_CHUNK_SIZE; ++x) {
+            int gx = base_x + x;
+            int gz = base_z + z;
+            uint8_t cell = 0;
+            int basin = desc->basin_level > 0 &&
+                        value_noise(desc->seed ^ SALT_BASIN, gx, gz, feature_log2 + 3) < desc->basin_level;
+            if (!basin) {
+                int height = (2 * value_noise(desc->seed, gx, gz, feature_log2) +
+                              value_noise(desc->seed ^ SALT_DETAIL, gx, gz, detail_log2)) / 3;
+                if (height > threshold || (lattice_hash(desc->seed ^ SALT_BOULDER, (uint32_t)gx, (uint32_t)gz) & 0xFF) < 2) {
+                    cell = 2;
+                }
+            }
+            cells[chunk_cell_index(x, z)] = cell;
+        }
+    }
+
+    uint32_t h = lattice_hash(desc->seed ^ SALT_RUIN, (uint32_t)chunk_x, (uint32_t)chunk_z);
+    if ((int)(h & 0xFF) < desc->ruin_chance) {
+        add_ruin(h, cells);
+    }
+}
+
+// Chunk holding cell c (rounding toward negative infinity)
+static int chunk_of(float c) {
+    float limit = (float)SURFACE_MAX_CELLS;
+    int cell = (int)floorf(c < -limit ? -limit : (c > limit ? limit : c));
+    return cell >= 0 ? cell >> SURFACE_CHUNK_LOG2 : -((-cell - 1) >> SURFACE_CHUNK_LOG2) - 1;
+}
+
+static int desc_equal(const SurfaceDesc* a, const SurfaceDesc* b) {
+    return memcmp(a, b, sizeof(SurfaceDesc)) == 0;
+}
+
+static uint32_t chunk_hash(const SurfaceDesc* desc, int chunk_x, int chunk_z) {
+    return lattice_hash(desc->seed, (uint32_t)chunk_x, (uint32_t)chunk_z) & g_hash_mask;
+}
+
+static int find_chunk(const SurfaceDesc* desc, int chunk_x, int chunk_z) {
+    for (int i = g_hash_heads[chunk_hash(desc, chunk_x, chunk_z)]; i >= 0; i = g_chunks[i].hash_next) {
+        const SurfaceChunk* chunk = &g_chunks[i];
+        if (chunk->chunk_x == chunk_x && chunk->chunk_z == chunk_z && desc_equal(&chunk->desc, desc)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void hash_insert(int i) {
+    SurfaceChunk* chunk = &g_chunks[i];
+    int* head = &g_hash_heads[chunk_hash(&chunk->desc, chunk->chunk_x, chunk->chunk_z)];
+    chunk->hash_next = *head;
+    *head = i;
+}
+
+static void hash_remove(int i) {
+    SurfaceChunk* chunk = &g_chunks[i];
+    int* link = &g_hash_heads[chunk_hash(&chunk->desc, chunk->chunk_x, chunk->chunk_z)];
+    while (*link != i) {
+        link = &g_chunks[*link].hash_next;
+    }
+    *link = chunk->hash_next;
+}
+
+static void lru_unlink(int i) {
+    SurfaceChunk* chunk = &g_chunks[i];
+    if (chunk->lru_prev >= 0) g_chunks[chunk->lru_prev].lru_next = chunk->lru_next;
+    else g_lru_head = chunk->lru_next;
+    if (chunk->lru_next >= 0) g_chunks[chunk->lru_next].lru_prev = chunk->lru_prev;
+    else g_lru_tail = chunk->lru_prev;
+}
+
+static void lru_push_front(int i) {
+    SurfaceChunk* chunk = &g_chunks[i];
+    chunk->lru_prev = -1;
+    chunk->lru_next = g_lru_head;
+    if (g_lru_head >= 0) g_chunks[g_lru_head].lru_prev = i;
+    g_lru_head = i;
+    if (g_lru_tail < 0) g_lru_tail = i;
+}
+
+static void lru_touch(int i) {
+    if (g_lru_head != i) {
+        lru_unlink(i);
+        lru_push_front(i);
+    }
+}
+
+static int in_window(const SurfaceChunk* chunk) {
+    return g_window_valid && desc_equal(&chunk->desc, &g_desc) &&
+           chunk->chunk_x >= g_window_x && chunk->chunk_x < g_window_x + SURFACE_WINDOW_CHUNKS &&
+           chunk->chunk_z >= g_window_z && chunk->chunk_z < g_window_z + SURFACE_WINDOW_CHUNKS;
+}
+
+// A free entry, evicting the least recently used finished chunk outside the
+// window if the budget is used up (-1 if everything is pending or in use)
+static int alloc_chunk(void) {
+    if (g_free_head >= 0) {
+        int i = g_free_head;
+        g_free_head = g_chunks[i].lru_next;
+        return i;
+    }
+    for (int i = g_lru_tail; i >= 0; i = g_chunks[i].lru_prev) {
+        SurfaceChunk* chunk = &g_chunks[i];
+        if (atomic_load_explicit(&chunk->state, memory_order_acquire) == CHUNK_READY && !in_window(chunk)) {
+            hash_remove(i);
+            lru_unlink(i);
+            atomic_store_explicit(&chunk->state, CHUNK_FREE, memory_order_relaxed);
+            g_stats.evictions++;
+            g_stats.resident_chunks--;
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void release_chunk(int i) {
+    atomic_store_explicit(&g_chunks[i].state, CHUNK_FREE, memory_order_relaxed);
+    g_chunks[i].lru_next = g_free_head;
+    g_free_head = i;
+}
+
+// Background task: fill a pending chunk and publish it
+static void generate_task(void* user_data) {
+    SurfaceChunk* chunk = (SurfaceChunk*)user_data;
+    double start = platform_now_ms();
+    surface_generate_chunk(&chunk->desc, chunk->chunk_x, chunk->chunk_z, chunk->cells);
+    chunk->generate_ms = platform_now_ms() - start;
+    atomic_store_explicit(&chunk->state, CHUNK_READY, memory_order_release);
+}
+
+// Index a new entry for a chunk of desc's surface (-1 if none is free)
+static int add_chunk(const SurfaceDesc* desc, int chunk_x, int chunk_z) {
+    int i = alloc_chunk();
+    if (i < 0) {
+        return -1;
+    }
+    SurfaceChunk* chunk = &g_chunks[i];
+    chunk->desc = *desc;
+    chunk->chunk_x = chunk_x;
+    chunk->chunk_z = chunk_z;
+    atomic_store_explicit(&chunk->state, CHUNK_PENDING, memory_order_relaxed);
+    hash_insert(i);
+    lru_push_front(i);
+    return i;
+}
+
+static void remove_chunk(int i) {
+    hash_remove(i);
+    lru_unlink(i);
+    release_chunk(i);
+}
+
+static void count_generated(int i) {
+    g_stats.generated++;
+    g_stats.generate_ms += g_chunks[i].generate_ms;
+    g_stats.resident_chunks++;
+}
+
+// Queue generation of a chunk (0 when the cache or queue is full)
+static int request_chunk(const SurfaceDesc* desc, int chunk_x, int chunk_z) {
+    int i = add_chunk(desc, chunk_x, chunk_z);
+    if (i < 0) {
+        return 0;
+    }
+    if (!jobs_submit_background(generate_task, &g_chunks[i])) {
+        remove_chunk(i);
+        return 0;
+    }
+    g_in_flight[g_in_flight_count++] = i;
+    return 1;
+}
+
+// Copy a chunk into a window slot (NULL clears it)
+static void copy_to_slot(int slot_x, int slot_z, const uint8_t* cells) {
+    size_t row_bytes = (size_t)CHUNK_TILES << (2 * WORLDMAP_TILE_LOG2);
+    for (int row = 0; row < CHUNK_TILES; ++row) {
+        size_t tile = (size_t)(slot_z * CHUNK_TILES + row) * (size_t)g_window.tiles_x + (size_t)(slot_x * CHUNK_TILES);
+        uint8_t* dest = g_window.cells + (tile << (2 * WORLDMAP_TILE_LOG2));
+        if (cells) {
+            memcpy(dest, cells + (size_t)row * row_bytes, row_bytes);
+        } else {
+            memset(dest, 0, row_bytes);
+        }
+    }
+}
+
+// Overlay the landing site (and the open margin around it) on a slot
+static void stamp_site(int slot_x, int slot_z) {
+    if (!g_site) {
+        return;
+    }
+    int base_x = (g_window_x + slot_x) * SURFACE_CHUNK_SIZE;
+    int base_z = (g_window_z + slot_z) * SURFACE_CHUNK_SIZE;
+    int x0 = base_x > -SITE_MARGIN ? base_x : -SITE_MARGIN;
+    int z0 = base_z > -SITE_MARGIN ? base_z : -SITE_MARGIN;
+    int x1 = base_x + SURFACE_CHUNK_SIZE < g_site->width + SITE_MARGIN ? base_x + SURFACE_CHUNK_SIZE : g_site->width + SITE_MARGIN;
+    int z1 = base_z + SURFACE_CHUNK_SIZE < g_site->height + SITE_MARGIN ? base_z + SURFACE_CHUNK_SIZE : g_site->height + SITE_MARGIN;
+
+    for (int z = z0; z < z1; ++z) {
+        for (int x = x0; x < x1; ++x) {
+            uint8_t cell = 0;
+            if (worldmap_inside(g_site, x, z)) {
+                cell = g_site->cells[worldmap_cell_index(g_site, x, z)];
+                int edge = x == 0 || z == 0 || x == g_site->width - 1 || z == g_site->height - 1;
+                if (edge && cell == 1) {
+                    cell = 0;
+                }
+            }
+            int wx = x - g_window_x * SURFACE_CHUNK_SIZE;
+            int wz = z - g_window_z * SURFACE_CHUNK_SIZE;
+            g_window.cells[worldmap_cell_index(&g_window, wx, wz)] = cell;
+        }
+    }
+}
+
+// Fill a window slot from the cache; returns 1 if its chunk was ready
+static int fill_slot(int slot_x, int slot_z) {
+    int i = find_chunk(&g_desc, g_window_x + slot_x, g_window_z + slot_z);
+    int ready = i >= 0 && atomic_load_explicit(&g_chunks[i].state, memory_order_acquire) == CHUNK_READY;
+    if (ready) {
+        lru_touch(i);
+    }
+    copy_to_slot(slot_x, slot_z, ready ? g_chunks[i].cells : NULL);
+    stamp_site(slot_x, slot_z);
+    g_window_ready[slot_z * SURFACE_WINDOW_CHUNKS + slot_x] = (uint8_t)ready;
+    return ready;
+}
+
+// Centre the window on a chunk
+static void rebuild_window(int chunk_x, int chunk_z) {
+    g_window_x = chunk_x - SURFACE_WINDOW_RADIUS;
+    g_window_z = chunk_z - SURFACE_WINDOW_RADIUS;
+    g_window_valid = 1;
+    for (int slot_z = 0; slot_z < SURFACE_WINDOW_CHUNKS; ++slot_z) {
+        for (int slot_x = 0; slot_x < SURFACE_WINDOW_CHUNKS; ++slot_x) {
+            if (fill_slot(slot_x, slot_z)) {
+                g_stats.hits++;
+            } else {
+                g_stats.misses++;
+            }
+        }
+    }
+}
+
+// Touch what is cached within radius chunks of (chunk_x, chunk_z) and
+// request what is missing, nearest chunks first. Returns the chunks that
+// are not ready yet.
+static int request_around(const SurfaceDesc* desc, int chunk_x, int chunk_z, int radius) {
+    int missing = 0;
+    for (int ring = 0; ring <= radius; ++ring) {
+        for (int dz = -ring; dz <= ring; ++dz) {
+            for (int dx = -ring; dx <= ring; ++dx) {
+                if (abs(dx) != ring && abs(dz) != ring) {
+                    continue;
+                }
+                int i = find_chunk(desc, chunk_x + dx, chunk_z + dz);
+                if (i >= 0) {
+                    lru_touch(i);
+                    missing += atomic_load_explicit(&g_chunks[i].state, memory_order_acquire) != CHUNK_READY;
+                    continue;
+                }
+                missing++;
+                if (g_in_flight_count < MAX_IN_FLIGHT) {
+                    request_chunk(desc, chunk_x + dx, chunk_z + dz);
+                }
+            }
+        }
+    }
+    return missing;
+}
+
+// Account for finished chunks and copy those the window is waiting for;
+// returns 1 if the window changed
+static int collect_finished(void) {
+    int changed = 0;
+    for (int k = 0; k < g_in_flight_count;) {
+        int i = g_in_flight[k];
+        SurfaceChunk* chunk = &g_chunks[i];
+        if (atomic_load_explicit(&chunk->state, memory_order_acquire) != CHUNK_READY) {
+            ++k;
+            continue;
+        }
+        g_in_flight[k] = g_in_flight[--g_in_flight_count];
+        count_generated(i);
+        if (in_window(chunk)) {
+            int slot_x = chunk->chunk_x - g_window_x;
+            int slot_z = chunk->chunk_z - g_window_z;
+            if (!g_window_ready[slot_z * SURFACE_WINDOW_CHUNKS + slot_x]) {
+                fill_slot(slot_x, slot_z);
+                changed = 1;
+            }
+        }
+    }
+    return changed;
+}
+
+// Allocate the cache and window
+int surface_init(size_t budget_bytes) {
+    if (g_window.cells) {
+        return surface_set_budget(budget_bytes);
+    }
+    uint8_t* empty = (uint8_t*)calloc((size_t)WINDOW_CELLS * WINDOW_CELLS, 1);
+    memset(&g_window, 0, sizeof(g_window));
+    int ok = empty && worldmap_create(&g_window, empty, WINDOW_CELLS, WINDOW_CELLS);
+    free(empty);
+    if (!ok) {
+        printf("ERROR: Failed to allocate surface window\n");
+        return 0;
+    }
+    return surface_set_budget(budget_bytes);
+}
+
+// Reallocate the cache for a new budget
+int surface_set_budget(size_t budget_bytes) {
+    jobs_wait_background();
+
+    free(g_chunks);
+    free(g_hash_heads);
+    g_chunks = NULL;
+    g_hash_heads = NULL;
+
+    int capacity = (int)(budget_bytes / sizeof(SurfaceChunk));
+    if (capacity < MIN_CACHE_CHUNKS) {
+        capacity = MIN_CACHE_CHUNKS;
+    }
+    uint32_t buckets = 1;
+    while (buckets < (uint32_t)capacity * 2) {
+        buckets <<= 1;
+    }
+
+    g_chunks = (SurfaceChunk*)calloc((size_t)capacity, sizeof(SurfaceChunk));
+    g_hash_heads = (int*)malloc(buckets * sizeof(int));
+    if (!g_chunks || !g_hash_heads) {
+        printf("ERROR: Failed to allocate %d surface chunks\n", capacity);
+        free(g_chunks);
+        free(g_hash_heads);
+        g_chunks = NULL;
+        g_hash_heads = NULL;
+        g_capacity = 0;
+        return 0;
+    }
+
+    g_capacity = capacity;
+    g_budget_bytes = budget_bytes;
+    g_hash_mask = buckets - 1;
+    for (uint32_t b = 0; b < buckets; ++b) {
+        g_hash_heads[b] = -1;
+    }
+    g_lru_head = -1;
+    g_lru_tail = -1;
+    g_free_head = -1;
+    for (int i = capacity - 1; i >= 0; --i) {
+        release_chunk(i);
+    }
+    g_in_flight_count = 0;
+    g_window_valid = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+    return 1;
+}
+
+// Start streaming a surface around (x, z)
+void surface_begin(const SurfaceDesc* desc, const WorldMap* site, float x, float z) {
+    if (!g_chunks) {
+        return;
+    }
+    g_desc = *desc;
+    g_site = site;
+    g_active = 1;
+    g_window_valid = 0;
+
+    // The player's chunk and its neighbours are generated right away, so
+    // the first frame has ground to stand on
+    int chunk_x = chunk_of(x);
+    int chunk_z = chunk_of(z);
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            int i = find_chunk(&g_desc, chunk_x + dx, chunk_z + dz);
+            if (i >= 0) {
+                if (atomic_load_explicit(&g_chunks[i].state, memory_order_acquire) != CHUNK_READY) {
+                    jobs_wait_background();
+                }
+                continue;
+            }
+            i = add_chunk(&g_desc, chunk_x + dx, chunk_z + dz);
+            if (i >= 0) {
+                generate_task(&g_chunks[i]);
+                count_generated(i);
+            }
+        }
+    }
+
+    surface_update(x, z);
+}
+
+void surface_set_site(const WorldMap* site) {
+    g_site = site;
+    g_window_valid = 0;
+}
+
+// Stop streaming; the cached chunks stay for the next visit
+void surface_end(void) {
+    g_active = 0;
+    g_window_valid = 0;
+    g_site = NULL;
+}
+
+// Generate another surface's chunks ahead of a visit
+int surface_prefetch(const SurfaceDesc* desc, float x, float z) {
+    if (!g_chunks) {
+        return 0;
+    }
+    // While a surface streams, surface_update drains the queue and collects
+    // finished chunks (it runs first each frame, so its window comes first)
+    if (!g_active) {
+        jobs_run_background(UPDATE_BUDGET_MS);
+        collect_finished();
+    }
+    // The whole prefetch area, so surface_begin has nothing left to request
+    return request_around(desc, chunk_of(x), chunk_of(z), SURFACE_PREFETCH_RADIUS);
+}
+
+// Keep the window around (x, z) and stream chunks
+int surface_update(float x, float z) {
+    if (!g_active || !g_chunks) {
+        return 0;
+    }
+
+    int chunk_x = chunk_of(x);
+    int chunk_z = chunk_of(z);
+    int changed = 0;
+    if (!g_window_valid || chunk_x != g_window_x + SURFACE_WINDOW_RADIUS ||
+        chunk_z != g_window_z + SURFACE_WINDOW_RADIUS) {
+        rebuild_window(chunk_x, chunk_z);
+        changed = 1;
+    }
+
+    request_around(&g_desc, chunk_x, chunk_z, SURFACE_PREFETCH_RADIUS);
+    jobs_run_background(UPDATE_BUDGET_MS);
+    changed |= collect_finished();
+
+    if (changed) {
+        worldmap_update_pyramid(&g_window);
+    }
+
+    int pending = 0;
+    for (int s = 0; s < SURFACE_WINDOW_CHUNKS * SURFACE_WINDOW_CHUNKS; ++s) {
+        pending += !g_window_ready[s];
+    }
+    g_stats.window_pending = pending;
+    return changed;
+}
+
+const WorldMap* surface_get_window(int* origin_x, int* origin_z) {
+    if (origin_x) *origin_x = g_window_x * SURFACE_CHUNK_SIZE;
+    if (origin_z) *origin_z = g_window_z * SURFACE_CHUNK_SIZE;
+    return &g_window;
+}
+
+int surface_window_ready(int x, int z) {
+    if (!worldmap_inside(&g_window, x, z)) {
+        return 0;
+    }
+    return g_window_ready[(z >> SURFACE_CHUNK_LOG2) * SURFACE_WINDOW_CHUNKS + (x >> SURFACE_CHUNK_LOG2)];
+}
+
+void surface_get_stats(SurfaceStats* stats) {
+    *stats = g_stats;
+    stats->capacity_chunks = g_capacity;
+    stats->pending_chunks = g_in_flight_count;
+    stats->budget_bytes = g_budget_bytes;
+    stats->resident_bytes = (size_t)g_stats.resident_chunks * sizeof(SurfaceChunk);
+}
+
+// Wait for background generation and free everything
+void surface_shutdown(void) {
+    jobs_wait_background();
+    free(g_chunks);
+    free(g_hash_heads);
+    g_chunks = NULL;
+    g_hash_heads = NULL;
+    g_capacity = 0;
+    g_in_flight_count = 0;
+    g_active = 0;
+    g_window_valid = 0;
+    g_site = NULL;
+    worldmap_destroy(&g_window);
+}
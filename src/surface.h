@@ -0,0 +1,102 @@
+// Surface header - Endless procedural planet surfaces streamed in chunks
+// QuakeCloneWASM - World system
+//
+// A surface is generated from a SurfaceDesc in square chunks of cells. A
+// background task generates chunks around the player into an LRU cache
+// with a memory budget; the chunks nearest the player are copied into a
+// small resident window, an ordinary WorldMap the tracers and collision
+// read without knowing about chunks. Positions here are in cells.
+
+#ifndef SURFACE_H
+#define SURFACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "worldmap.h"
+
+// Chunks are 32x32 cells (4x4 map tiles)
+#define SURFACE_CHUNK_LOG2 5
+#define SURFACE_CHUNK_SIZE (1 << SURFACE_CHUNK_LOG2)
+#define SURFACE_CHUNK_CELLS (SURFACE_CHUNK_SIZE * SURFACE_CHUNK_SIZE)
+
+// The window holds the player's chunk and WINDOW_RADIUS chunks on each
+// side, so rays always end inside it; chunks up to PREFETCH_RADIUS away
+// are generated ahead of time
+#define SURFACE_WINDOW_RADIUS 2
+#define SURFACE_WINDOW_CHUNKS (2 * SURFACE_WINDOW_RADIUS + 1)
+#define SURFACE_PREFETCH_RADIUS 3
+
+// Surfaces extend this many cells from the origin in every direction
+// (float positions stay precise to a few millimetres out there)
+#define SURFACE_MAX_CELLS 16384
+
+// Default chunk cache budget
+#define SURFACE_DEFAULT_BUDGET (1024 * 1024)
+
+// Generation parameters; equal descs generate identical surfaces
+typedef struct {
+    uint32_t seed;
+    int rock_density;       // 0-255: share of the ground taken by rock formations
+    int feature_log2;       // Rock formations are about 2^feature_log2 cells across
+    int ruin_chance;        // 0-255: chance per chunk of a walled ruin
+    int basin_level;        // 0-255: low ground below this stays open (0 = none)
+} SurfaceDesc;
+
+// Cache and streaming counters
+typedef struct {
+    int capacity_chunks;    // Chunks the budget allows
+    int resident_chunks;    // Generated chunks in the cache
+    int pending_chunks;     // Requested and not yet generated
+    int window_pending;     // Window chunks still missing (collision treats them as solid)
+    size_t budget_bytes;
+    size_t resident_bytes;
+    unsigned long hits;     // Window chunks found in the cache
+    unsigned long misses;   // Window chunks that had to wait for generation
+    unsigned long evictions;
+    unsigned long generated;
+    double generate_ms;     // Time spent generating, on any thread
+} SurfaceStats;
+
+// Allocate the cache (budget in bytes; a minimum that covers the prefetch
+// area is enforced) and the window
+int surface_init(size_t budget_bytes);
+
+// Change the cache budget; cached chunks are dropped
+int surface_set_budget(size_t budget_bytes);
+
+// Start streaming desc's surface around cell position (x, z). site, if not
+// NULL, is stamped with its cell (0, 0) at the surface origin (its outer
+// ring of 1 cells left open); it must stay valid while the surface is in
+// use. The chunks around (x, z) are ready when this returns.
+void surface_begin(const SurfaceDesc* desc, const WorldMap* site, float x, float z);
+
+// The site map's contents changed: restamp it on the next update
+void surface_set_site(const WorldMap* site);
+
+// Stop streaming (leaving the surface); cached chunks are kept
+void surface_end(void);
+
+// Generate the chunks around cell position (x, z) of desc's surface ahead
+// of surface_begin, after those of the surface being streamed. Call every
+// frame until it returns 0: the number of those chunks not ready.
+int surface_prefetch(const SurfaceDesc* desc, float x, float z);
+
+// Once per frame: keep the window centred on (x, z), request missing
+// chunks and copy in finished ones. Returns 1 if the window changed.
+int surface_update(float x, float z);
+
+// Resident window and the surface cell of its cell (0, 0)
+const WorldMap* surface_get_window(int* origin_x, int* origin_z);
+
+// 0 while the chunk holding window cell (x, z) is still being generated
+int surface_window_ready(int x, int z);
+
+// Generate one chunk (SURFACE_CHUNK_CELLS bytes, in map tile order)
+void surface_generate_chunk(const SurfaceDesc* desc, int chunk_x, int chunk_z, uint8_t* cells);
+
+void surface_get_stats(SurfaceStats* stats);
+
+// Wait for background generation and free the cache
+void surface_shutdown(void);
+
+#endif // SURFACE_H
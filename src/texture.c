@@ -0,0 +1,174 @@
+// Texture implementation - Procedural wall texture atlas
+// QuakeCloneWASM - Rendering system
+//
+// Textures are generated at startup from integer hash noise, so the build
+// needs no image files and every platform gets identical texels.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "texture.h"
+
+static TextureAtlas g_atlas;
+static int g_atlas_initialized = 0;
+
+static inline uint32_t pack_texel(int r, int g, int b) {
+    if (r < 0) r = 0;
+    if (g < 0) g = 0;
+    if (b < 0) b = 0;
+    if (r > 255) r = 255;
+    if (g > 255) g = 255;
+    if (b > 255) b = 255;
+    return 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+}
+
+// Deterministic per-texel noise in [0, 255]
+static int hash_noise(int texture, int u, int v) {
+    uint32_t h = (uint32_t)u * 374761393u + (uint32_t)v * 668265263u + (uint32_t)texture * 2246822519u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    return (int)((h ^ (h >> 16)) & 0xFF);
+}
+
+// Texel (u, v) of a level-0 texture
+static uint32_t generate_texel(int texture, int u, int v) {
+    int noise = hash_noise(texture, u, v) - 128; // -128..127
+
+    switch (texture) {
+    case TEXTURE_BRICK: {
+        // 16-texel courses, alternate courses offset by half a block
+        int course = v / 16;
+        int bu = (u + (course & 1) * 16) % 32;
+        int mortar = (v % 16) == 0 || bu == 0;
+        if (mortar) {
+            return pack_texel(120 + noise / 16, 110 + noise / 16, 95 + noise / 16);
+        }
+        int tint = hash_noise(texture, (u + (course & 1) * 16) / 32, course) / 8 - 16;
+        return pack_texel(200 + tint + noise / 8, 170 + tint + noise / 8, 140 + tint / 2 + noise / 8);
+    }
+    case TEXTURE_ROCK: {
+        int coarse = hash_noise(texture, u / 8, v / 8) - 128;
+        int value = coarse / 4 + noise / 6;
+        return pack_texel(180 + value, 150 + value, 120 + value);
+    }
+    case TEXTURE_HULL_PANEL: {
+        // 32x32 panels with dark seams and rivets near the corners
+        int pu = u % 32;
+        int pv = v % 32;
+        if (pu == 0 || pv == 0) {
+            return pack_texel(70, 85, 105);
+        }
+        if ((pu == 3 || pu == 28) && (pv == 3 || pv == 28)) {
+            return pack_texel(200, 215, 235);
+        }
+        int sheen = (pu + pv) / 8;
+        return pack_texel(140 + sheen + noise / 24, 165 + sheen + noise / 24, 200 + sheen + noise / 24);
+    }
+    case TEXTURE_HULL_VENT: {
+        // Frame around horizontal slats
+        if (u < 4 || u >= TEXTURE_SIZE - 4 || v < 4 || v >= TEXTURE_SIZE - 4) {
+            return pack_texel(120 + noise / 24, 145 + noise / 24, 180 + noise / 24);
+        }
+        int slat = (v % 6) < 3;
+        return slat ? pack_texel(95, 115, 145) : pack_texel(35, 42, 58);
+    }
+    case TEXTURE_GROUND: {
+        // Soil with coarse patches and scattered pebbles
+        int patch = (hash_noise(texture, u / 16, v / 16) - 128) / 8;
+        int pebble = hash_noise(texture + 7, u / 4, v / 4) > 236;
+        if (pebble) {
+            return pack_texel(150 + noise / 10, 140 + noise / 10, 125 + noise / 10);
+        }
+        return pack_texel(120 + patch + noise / 6, 95 + patch + noise / 6, 70 + patch / 2 + noise / 8);
+    }
+    case TEXTURE_DECK_PLATE: {
+        // 32x32 plates with dark seams and a diagonal tread
+        int pu = u % 32;
+        int pv = v % 32;
+        if (pu == 0 || pv == 0) {
+            return pack_texel(25, 30, 40);
+        }
+        int tread = ((pu + pv) % 8 == 0) || ((pu - pv + 32) % 8 == 0);
+        int value = (tread ? 20 : 0) + noise / 24;
+        return pack_texel(70 + value, 78 + value, 92 + value);
+    }
+    case TEXTURE_CEILING_LIGHT:
+    default: {
+        // Dark panels around a light strip along the middle of the cell
+        if (u >= 28 && u < 36) {
+            return (v % 16 == 0) ? pack_texel(90, 100, 115) : pack_texel(225, 235, 245);
+        }
+        if (u % 32 == 0 || v % 32 == 0) {
+            return pack_texel(30, 36, 48);
+        }
+        return pack_texel(55 + noise / 24, 63 + noise / 24, 78 + noise / 24);
+    }
+    }
+}
+
+// Average a 2x2 block of the previous level
+static uint32_t average_texels(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    uint32_t r = (((a >> 16) & 0xFF) + ((b >> 16) & 0xFF) + ((c >> 16) & 0xFF) + ((d >> 16) & 0xFF) + 2) / 4;
+    uint32_t g = (((a >> 8) & 0xFF) + ((b >> 8) & 0xFF) + ((c >> 8) & 0xFF) + ((d >> 8) & 0xFF) + 2) / 4;
+    uint32_t bl = ((a & 0xFF) + (b & 0xFF) + (c & 0xFF) + (d & 0xFF) + 2) / 4;
+    return 0xFF000000u | (r << 16) | (g << 8) | bl;
+}
+
+// Build every texture and its mip chain
+int texture_atlas_init(void) {
+    if (g_atlas_initialized) {
+        return 1;
+    }
+
+    // Each full mip chain holds just under 4/3 of the base level
+    size_t total = 0;
+    for (int t = 0; t < TEXTURE_COUNT; ++t) {
+        for (int m = 0; m < TEXTURE_MIP_LEVELS; ++m) {
+            int size = TEXTURE_SIZE >> m;
+            g_atlas.offsets[t][m] = (int)total;
+            total += (size_t)size * (size_t)size;
+        }
+    }
+
+    g_atlas.texels = (uint32_t*)malloc(total * sizeof(uint32_t));
+    if (!g_atlas.texels) {
+        printf("ERROR: Failed to allocate texture atlas\n");
+        return 0;
+    }
+
+    for (int t = 0; t < TEXTURE_COUNT; ++t) {
+        uint32_t* base = g_atlas.texels + g_atlas.offsets[t][0];
+        for (int u = 0; u < TEXTURE_SIZE; ++u) {
+            for (int v = 0; v < TEXTURE_SIZE; ++v) {
+                base[u * TEXTURE_SIZE + v] = generate_texel(t, u, v);
+            }
+        }
+
+        for (int m = 1; m < TEXTURE_MIP_LEVELS; ++m) {
+            int size = TEXTURE_SIZE >> m;
+            int parent_size = size * 2;
+            const uint32_t* parent = g_atlas.texels + g_atlas.offsets[t][m - 1];
+            uint32_t* level = g_atlas.texels + g_atlas.offsets[t][m];
+            for (int u = 0; u < size; ++u) {
+                const uint32_t* col0 = parent + (size_t)(u * 2) * parent_size;
+                const uint32_t* col1 = col0 + parent_size;
+                for (int v = 0; v < size; ++v) {
+                    level[u * size + v] = average_texels(col0[v * 2], col0[v * 2 + 1], col1[v * 2], col1[v * 2 + 1]);
+                }
+            }
+        }
+    }
+
+    g_atlas_initialized = 1;
+    printf("Texture atlas initialized: %d textures, %dx%d, %d mip levels\n",
+           TEXTURE_COUNT, TEXTURE_SIZE, TEXTURE_SIZE, TEXTURE_MIP_LEVELS);
+    return 1;
+}
+
+const TextureAtlas* texture_get_atlas(void) {
+    return g_atlas_initialized ? &g_atlas : NULL;
+}
+
+void texture_atlas_shutdown(void) {
+    free(g_atlas.texels);
+    g_atlas.texels = NULL;
+    g_atlas_initialized = 0;
+}
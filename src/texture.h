@@ -0,0 +1,48 @@
+// Texture header - Procedural wall texture atlas
+// QuakeCloneWASM - Rendering system
+
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include <stdint.h>
+
+// Square power-of-two wall, floor and ceiling textures with a full mip
+// chain (64, 32, ... 1)
+#define TEXTURE_SIZE 64
+#define TEXTURE_SIZE_LOG2 6
+#define TEXTURE_MIP_LEVELS (TEXTURE_SIZE_LOG2 + 1)
+
+typedef enum {
+    TEXTURE_BRICK = 0,   // Planet: stone blocks
+    TEXTURE_ROCK,        // Planet: rough rock face
+    TEXTURE_HULL_PANEL,  // Spaceship: riveted metal panels
+    TEXTURE_HULL_VENT,   // Spaceship: slatted vents
+    TEXTURE_GROUND,      // Planet floor: packed soil and pebbles
+    TEXTURE_DECK_PLATE,  // Spaceship floor: tread plates
+    TEXTURE_CEILING_LIGHT, // Spaceship ceiling: panels with a light strip
+    TEXTURE_COUNT
+} TextureId;
+
+// Column-major atlas: column u of mip level m of a texture is
+// (TEXTURE_SIZE >> m) contiguous texels from top to bottom, so a screen
+// column reads one linear strip.
+typedef struct {
+    uint32_t* texels;
+    int offsets[TEXTURE_COUNT][TEXTURE_MIP_LEVELS]; // First texel of each level
+} TextureAtlas;
+
+// Generate the atlas (procedural, no image assets)
+int texture_atlas_init(void);
+
+// Atlas after texture_atlas_init (NULL before)
+const TextureAtlas* texture_get_atlas(void);
+
+// Texel strip of column u in mip level mip
+static inline const uint32_t* texture_atlas_column(const TextureAtlas* atlas, int texture, int mip, int u) {
+    return atlas->texels + atlas->offsets[texture][mip] + (size_t)u * (size_t)(TEXTURE_SIZE >> mip);
+}
+
+// Release the atlas
+void texture_atlas_shutdown(void);
+
+#endif // TEXTURE_H
@@ -5,67 +5,168 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "world.h"
 #include "player.h"
 #include "renderer.h"
 #include "space.h"  // For LocationType and space_get_location_type
+#include "simd.h"
+#include "jobs.h"
+#include "camera.h"
+#include "texture.h"
+#include "worldmap.h"
+#include "qmap.h"
+#include "surface.h"
+#include "entity.h"
+#include "sprite.h"
+#include "colormap.h"
 
-// Simple map definition (grid-based)
-#define MAP_WIDTH 16
-#define MAP_HEIGHT 16
+// Built-in maps are 16x16; loaded maps can be any size
+#define BUILTIN_MAP_SIZE 16
 #define MAP_SCALE 2.0f
 
+// Camera / wall projection
+#define RAY_MAX_DIST 50.0f
+#define WALL_HEIGHT_WORLD 2.0f
+
+// Columns per render job; a multiple of every SIMD_WIDTH so packets never
+// straddle two strips
+#define WORLD_STRIP_COLUMNS 64
+
+// Floor and ceiling textures span one map cell
+#define FLOOR_TEXELS_PER_UNIT ((float)TEXTURE_SIZE / MAP_SCALE)
+
+// Added to floor texture coordinates so the rows in reach of the camera
+// never go negative (conversion truncates towards zero)
+#define FLOOR_TEXEL_BIAS 131072.0f
+
+// Cell ids: 0 = open, 1 = outer wall, 2 = inner wall (selects the wall texture)
+
 // Planet map data (maze/outdoor environment)
-static int g_planet_map[MAP_HEIGHT][MAP_WIDTH] = {
+static const uint8_t g_planet_cells[BUILTIN_MAP_SIZE][BUILTIN_MAP_SIZE] = {
     {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1},
-    {1,0,0,1,0,0,0,0,0,0,0,0,1,0,0,1},
+    {1,0,0,2,2,0,0,0,0,0,0,2,2,0,0,1},
+    {1,0,0,2,0,0,0,0,0,0,0,0,2,0,0,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,0,0,0,0,1,1,1,1,0,0,0,0,0,1},
-    {1,0,0,0,0,0,1,0,0,1,0,0,0,0,0,1},
-    {1,0,0,0,0,0,1,0,0,1,0,0,0,0,0,1},
-    {1,0,0,0,0,0,1,1,0,1,0,0,0,0,0,1},
+    {1,0,0,0,0,0,2,2,2,2,0,0,0,0,0,1},
+    {1,0,0,0,0,0,2,0,0,2,0,0,0,0,0,1},
+    {1,0,0,0,0,0,2,0,0,2,0,0,0,0,0,1},
+    {1,0,0,0,0,0,2,2,0,2,0,0,0,0,0,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,0,1,0,0,0,0,0,0,0,0,1,0,0,1},
-    {1,0,0,1,1,0,0,0,0,0,0,1,1,0,0,1},
+    {1,0,0,2,0,0,0,0,0,0,0,0,2,0,0,1},
+    {1,0,0,2,2,0,0,0,0,0,0,2,2,0,0,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
     {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
 };
 
 // Spaceship interior map (futuristic ship corridors)
-static int g_spaceship_map[MAP_HEIGHT][MAP_WIDTH] = {
+static const uint8_t g_spaceship_cells[BUILTIN_MAP_SIZE][BUILTIN_MAP_SIZE] = {
     {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,1,1,0,0,0,0,0,0,0,0,1,1,0,1},
-    {1,0,1,0,0,0,0,0,0,0,0,0,0,1,0,1},
+    {1,0,2,2,0,0,0,0,0,0,0,0,2,2,0,1},
+    {1,0,2,0,0,0,0,0,0,0,0,0,0,2,0,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,0,0,0,1,1,0,0,1,1,0,0,0,0,1},
-    {1,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1},
+    {1,0,0,0,0,2,2,0,0,2,2,0,0,0,0,1},
+    {1,0,0,0,0,2,0,0,0,0,2,0,0,0,0,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,0,0,0,1,0,0,0,0,1,0,0,0,0,1},
-    {1,0,0,0,0,1,1,0,0,1,1,0,0,0,0,1},
+    {1,0,0,0,0,2,0,0,0,0,2,0,0,0,0,1},
+    {1,0,0,0,0,2,2,0,0,2,2,0,0,0,0,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
-    {1,0,1,0,0,0,0,0,0,0,0,0,0,1,0,1},
-    {1,0,1,1,0,0,0,0,0,0,0,0,1,1,0,1},
+    {1,0,2,0,0,0,0,0,0,0,0,0,0,2,0,1},
+    {1,0,2,2,0,0,0,0,0,0,0,0,2,2,0,1},
     {1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1},
     {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
 };
 
-// Current active map (points to planet or spaceship map)
-static int (*g_map)[MAP_WIDTH] = g_planet_map;
+typedef enum {
+    MAP_PLANET = 0,
+    MAP_SPACESHIP,
+    MAP_LOADED,     // Last world_load_map
+    MAP_COUNT
+} MapSlot;
+
+static WorldMap g_maps[MAP_COUNT];
+
+// Per-planet map images (.qmap); planets without one use the built-in map
+static QMapFile g_planet_files[WORLD_MAX_PLANET_MAPS];
+
+// Current active map (planet, spaceship, loaded or a planet image) and the
+// image it came from, if any
+static const WorldMap* g_map = &g_maps[MAP_PLANET];
+static const QMapFile* g_map_file = NULL;
+
+// On a planet the active map is the resident window of an endless surface
+// (src/surface.c) with the planet's map as its landing site. World
+// positions are relative to the window's corner: g_map_origin_x/z (world
+// units) is subtracted before reading g_map, and is 0 for bounded maps.
+static int g_endless_surfaces = 1;
+static int g_on_surface = 0;
+static float g_map_origin_x = 0.0f;
+static float g_map_origin_z = 0.0f;
+
+// Use the occupancy pyramid to cross empty regions (0: cell-by-cell DDA)
+static int g_skip_empty_space = 1;
+
+// Smaller maps cross too few tiles to pay for the pyramid lookups
+#define SKIP_MIN_MAP_SIZE 64
+
+static int use_empty_space_skipping(const WorldMap* map) {
+    return g_skip_empty_space && (map->width >= SKIP_MIN_MAP_SIZE || map->height >= SKIP_MIN_MAP_SIZE);
+}
 
 static int g_world_initialized = 0;
 
+// Sample the texture atlas for walls (0: flat-shaded walls)
+static int g_textured_walls = 1;
+
+// Cast textured floors (and the spaceship's ceiling) instead of the
+// per-row gradient
+static int g_textured_floors = 1;
+
+// Bumped whenever the active map changes, so cached frames are invalidated
+static unsigned g_map_generation = 0;
+
+// Light and fog tables of the current location, and the planet they were
+// built for (-1: the spaceship, no fog)
+static Colormap g_colormap;
+static int g_colormap_planet = -2;
+
 // Helper: Get map cell value
 static int get_map_cell(int x, int y) {
-    if (x < 0 || x >= MAP_WIDTH || y < 0 || y >= MAP_HEIGHT) {
+    if (!worldmap_inside(g_map, x, y)) {
         return 1; // Out of bounds = wall
     }
-    return g_map[y][x];
+    if (g_on_surface && !surface_window_ready(x, y)) {
+        return 1; // Terrain still being generated
+    }
+    return g_map->cells[worldmap_cell_index(g_map, x, y)];
+}
+
+// Switch to a bounded map (leaving the surface, if on it)
+static void set_bounded_map(const WorldMap* map, const QMapFile* file) {
+    if (g_on_surface) {
+        surface_end();
+    }
+    entity_clear(); // Entities belong to the map they were spawned on
+    g_map = map;
+    g_map_file = file;
+    g_on_surface = 0;
+    g_map_origin_x = 0.0f;
+    g_map_origin_z = 0.0f;
+    g_map_generation++;
+}
+
+// Follow the surface window after it moved or changed
+static void sync_surface_window(void) {
+    int origin_x, origin_z;
+    g_map = surface_get_window(&origin_x, &origin_z);
+    g_map_origin_x = (float)origin_x * MAP_SCALE;
+    g_map_origin_z = (float)origin_z * MAP_SCALE;
+    g_map_generation++;
 }
 
 // Get current location type for rendering (wraps space system)
@@ -80,91 +181,309 @@ static void world_to_map(float wx, float wz, int* mx, int* mz) {
     *mz = (int)(wz / MAP_SCALE);
 }
 
-// Raycasting for wall rendering
-static void cast_ray(float ray_angle, float max_dist, float* hit_dist, int* hit_wall) {
-    float player_x, player_y, player_z;
-    player_get_position(&player_x, &player_y, &player_z);
-    
-    float ray_dir_x = sinf(ray_angle);
-    float ray_dir_z = -cosf(ray_angle);
-    
-    float pos_x = player_x;
-    float pos_z = player_z;
-    
-    float delta_dist_x = (ray_dir_x == 0) ? 1e30 : fabsf(1.0f / ray_dir_x);
-    float delta_dist_z = (ray_dir_z == 0) ? 1e30 : fabsf(1.0f / ray_dir_z);
-    
-    int map_x = (int)(pos_x / MAP_SCALE);
-    int map_z = (int)(pos_z / MAP_SCALE);
-    
-    int step_x, step_z;
-    float side_dist_x, side_dist_z;
-    
-    if (ray_dir_x < 0) {
-        step_x = -1;
-        side_dist_x = (pos_x / MAP_SCALE - map_x) * delta_dist_x;
-    } else {
-        step_x = 1;
-        side_dist_x = (map_x + 1.0f - pos_x / MAP_SCALE) * delta_dist_x;
-    }
-    
-    if (ray_dir_z < 0) {
-        step_z = -1;
-        side_dist_z = (pos_z / MAP_SCALE - map_z) * delta_dist_z;
+// Ray parameter (in cells) where a ray crosses grid line b of one axis
+static inline float boundary_t(int b, float origin, float inv, int flat) {
+    return flat ? 1e30f : ((float)b - origin) * inv;
+}
+
+// Row (or column) a ray occupies at parameter t, starting from an estimate
+// within [lo, hi]. The estimate can be one off next to a grid line; decide
+// with the crossing times the cell-by-cell DDA compares, where a line
+// crossed exactly at t counts as crossed
+static inline int settle_cell(int c, int lo, int hi, float t, float origin, float inv, int flat, int step) {
+    if (step > 0) {
+        if (c > lo && boundary_t(c, origin, inv, flat) > t) return c - 1;
+        if (c < hi && boundary_t(c + 1, origin, inv, flat) <= t) return c + 1;
     } else {
-        step_z = 1;
-        side_dist_z = (map_z + 1.0f - pos_z / MAP_SCALE) * delta_dist_z;
+        if (c < hi && boundary_t(c + 1, origin, inv, flat) > t) return c + 1;
+        if (c > lo && boundary_t(c, origin, inv, flat) <= t) return c - 1;
     }
-    
-    int hit = 0;
+    return c;
+}
+
+// Raycasting for wall rendering (scalar DDA from an explicit origin).
+// Besides distance and side it reports where along the wall face the ray
+// landed (hit_u in [0, 1)) and the id of the cell it hit.
+//
+// Each step moves to the exit of the largest empty pyramid block around the
+// current cell, which is the next cell boundary when that cell's tile holds
+// a wall. Boundary distances are computed from the origin rather than
+// accumulated, so long skips do not drift. Rays stop at max_dist.
+static void cast_ray(float pos_x, float pos_z, float ray_dir_x, float ray_dir_z,
+                     float max_dist, float* hit_dist, int* hit_wall, float* hit_u, int* hit_cell) {
+    const WorldMap* map = g_map;
+    const float cell_x = pos_x / MAP_SCALE;
+    const float cell_z = pos_z / MAP_SCALE;
+    const float max_t = max_dist / MAP_SCALE;
+    const float inv_x = (ray_dir_x == 0) ? 0.0f : 1.0f / ray_dir_x;
+    const float inv_z = (ray_dir_z == 0) ? 0.0f : 1.0f / ray_dir_z;
+    const int step_x = (ray_dir_x < 0) ? -1 : 1;
+    const int step_z = (ray_dir_z < 0) ? -1 : 1;
+
+    int map_x = (int)cell_x;
+    int map_z = (int)cell_z;
     int side = 0;
-    
-    while (!hit) {
-        if (side_dist_x < side_dist_z) {
-            side_dist_x += delta_dist_x;
-            map_x += step_x;
+    int cell = 0;
+    const int skip = use_empty_space_skipping(map);
+
+    for (;;) {
+        int block = 1;
+        if (skip && worldmap_inside(map, map_x, map_z)) {
+            block = worldmap_empty_block(map, map_x, map_z);
+        }
+        int block_x = map_x & -block;
+        int block_z = map_z & -block;
+        int bound_x = (step_x > 0) ? block_x + block : block_x;
+        int bound_z = (step_z > 0) ? block_z + block : block_z;
+
+        // Ray parameter (in cells) where the block's x and z faces are crossed
+        float t_x = boundary_t(bound_x, cell_x, inv_x, ray_dir_x == 0);
+        float t_z = boundary_t(bound_z, cell_z, inv_z, ray_dir_z == 0);
+        float t;
+
+        if (t_x < t_z) {
+            t = t_x;
+            map_x = (step_x > 0) ? bound_x : bound_x - 1;
+            if (block > 1) {
+                // Row where the ray leaves the block, kept inside the block
+                // and never behind the current cell
+                int z = (int)(cell_z + t * ray_dir_z);
+                int lo = (step_z > 0) ? map_z : block_z;
+                int hi = (step_z > 0) ? block_z + block - 1 : map_z;
+                z = (z < lo) ? lo : (z > hi) ? hi : z;
+                map_z = settle_cell(z, lo, hi, t, cell_z, inv_z, ray_dir_z == 0, step_z);
+            }
             side = 0;
         } else {
-            side_dist_z += delta_dist_z;
-            map_z += step_z;
+            t = t_z;
+            map_z = (step_z > 0) ? bound_z : bound_z - 1;
+            if (block > 1) {
+                int x = (int)(cell_x + t * ray_dir_x);
+                int lo = (step_x > 0) ? map_x : block_x;
+                int hi = (step_x > 0) ? block_x + block - 1 : map_x;
+                x = (x < lo) ? lo : (x > hi) ? hi : x;
+                map_x = settle_cell(x, lo, hi, t, cell_x, inv_x, ray_dir_x == 0, step_x);
+            }
             side = 1;
         }
-        
-        if (map_x < 0 || map_x >= MAP_WIDTH || map_z < 0 || map_z >= MAP_HEIGHT) {
+
+        if (t >= max_t || !worldmap_inside(map, map_x, map_z)) {
             *hit_dist = max_dist;
             *hit_wall = 0;
+            *hit_u = 0.0f;
+            *hit_cell = 0;
             return;
         }
-        
-        if (get_map_cell(map_x, map_z) == 1) {
-            hit = 1;
+
+        cell = map->cells[worldmap_cell_index(map, map_x, map_z)];
+        if (cell != 0) {
+            break;
         }
     }
-    
+
     if (side == 0) {
         *hit_dist = (map_x - pos_x / MAP_SCALE + (1 - step_x) / 2.0f) / ray_dir_x * MAP_SCALE;
     } else {
         *hit_dist = (map_z - pos_z / MAP_SCALE + (1 - step_z) / 2.0f) / ray_dir_z * MAP_SCALE;
     }
     
+    // Position along the wall face, in cells (world coordinates are >= 0)
+    float wall = (side == 0) ? pos_z + *hit_dist * ray_dir_z : pos_x + *hit_dist * ray_dir_x;
+    float wall_cell = wall / MAP_SCALE;
+
     *hit_wall = side;
+    *hit_u = wall_cell - (float)(int)wall_cell;
+    *hit_cell = cell;
+}
+
+#ifndef SIMD_SCALAR
+static inline vfloat boundary_t_packet(vint b, vfloat origin, vfloat inv, vint flat) {
+    return vf_select(flat, vf_set1(1e30f), vf_mul(vf_sub(vf_from_int(b), origin), inv));
+}
+
+// settle_cell per lane, after clamping the estimate to [lo, hi]
+static inline vint settle_cell_packet(vint c, vint lo, vint hi, vfloat t, vfloat origin, vfloat inv, vint flat, vint negative) {
+    const vint one = vi_set1(1);
+    c = vi_min(vi_max(c, lo), hi);
+    vint above_lo = vi_lt(lo, c);
+    vint below_hi = vi_lt(c, hi);
+    vint line_after = vf_lt(t, boundary_t_packet(c, origin, inv, flat));                     // Line c crossed after t
+    vint next_after = vf_lt(t, boundary_t_packet(vi_add(c, one), origin, inv, flat));       // Line c + 1 crossed after t
+
+    vint forward_dec = vi_and(above_lo, line_after);
+    vint forward_inc = vi_andnot(forward_dec, vi_andnot(next_after, below_hi));
+    vint backward_inc = vi_and(below_hi, next_after);
+    vint backward_dec = vi_andnot(backward_inc, vi_andnot(line_after, above_lo));
+
+    vint inc = vi_select(negative, backward_inc, forward_inc);
+    vint dec = vi_select(negative, backward_dec, forward_dec);
+    return vi_add(vi_sub(c, inc), dec); // Masks are -1
 }
 
+// Packet raycasting: SIMD_WIDTH rays from one origin stepped through the grid
+// together. Every lane performs exactly the float operations of cast_ray, in
+// the same order, so hit distances and sides are bit-identical to it. Lanes
+// that hit a wall, leave the map or pass max_dist are masked off; the packet
+// runs until all lanes have terminated.
+static void cast_ray_packet(float pos_x, float pos_z, const float* ray_dir_x, const float* ray_dir_z,
+                            float max_dist, float* hit_dist, int* hit_wall, float* hit_u, int* hit_cell) {
+    const WorldMap* map = g_map;
+    const float cell_x = pos_x / MAP_SCALE;
+    const float cell_z = pos_z / MAP_SCALE;
+    const int start_x = (int)cell_x;
+    const int start_z = (int)cell_z;
+
+    const vfloat zero = vf_set1(0.0f);
+    const vfloat one = vf_set1(1.0f);
+    const vfloat origin_x = vf_set1(cell_x);
+    const vfloat origin_z = vf_set1(cell_z);
+    const vfloat max_t = vf_set1(max_dist / MAP_SCALE);
+
+    vfloat dir_x = vf_load(ray_dir_x);
+    vfloat dir_z = vf_load(ray_dir_z);
+    vint flat_x = vf_eq(dir_x, zero);
+    vint flat_z = vf_eq(dir_z, zero);
+    vfloat inv_x = vf_select(flat_x, zero, vf_div(one, dir_x));
+    vfloat inv_z = vf_select(flat_z, zero, vf_div(one, dir_z));
+
+    vint neg_x = vf_lt(dir_x, zero);
+    vint neg_z = vf_lt(dir_z, zero);
+
+    vint map_x = vi_set1(start_x);
+    vint map_z = vi_set1(start_z);
+
+    const vint no_lanes = vi_set1(0);
+    const vint one_cell = vi_set1(1);
+    const vint wall = vi_set1(1); // Side value of z-facing walls
+    const vint last_x = vi_set1(map->width - 1);
+    const vint last_z = vi_set1(map->height - 1);
+    const vint tiles_x = vi_set1(map->tiles_x);
+    const vint in_tile = vi_set1(WORLDMAP_TILE_SIZE - 1);
+    const int skip = use_empty_space_skipping(map);
+
+    vint active = vi_eq(no_lanes, no_lanes);
+    vint missed = no_lanes;
+    vint side = no_lanes;
+    vint hit_cells = no_lanes;
+
+    while (vi_any(active)) {
+        vint inside = vi_andnot(vi_or(vi_or(vi_lt(map_x, no_lanes), vi_lt(last_x, map_x)),
+                                      vi_or(vi_lt(map_z, no_lanes), vi_lt(last_z, map_z))), active);
+
+        // Largest empty block per lane: climb the pyramid while it stays empty
+        vint block = one_cell;
+        vint probe = skip ? inside : no_lanes;
+        for (int k = 0; k < map->level_count && vi_any(probe); ++k) {
+            int shift = WORLDMAP_TILE_LOG2 + k;
+            vint index = vi_add(vi_mul(vi_sra(map_z, shift), vi_set1(map->level_width[k])), vi_sra(map_x, shift));
+            vint occupied = vi_gather_u8(map->levels[k], index, probe);
+            vint empty = vi_and(probe, vi_eq(occupied, no_lanes));
+            block = vi_select(empty, vi_set1(1 << shift), block);
+            probe = empty;
+        }
+
+        vint block_mask = vi_sub(no_lanes, block);
+        vint block_x = vi_and(map_x, block_mask);
+        vint block_z = vi_and(map_z, block_mask);
+        vint block_last_x = vi_sub(vi_add(block_x, block), one_cell);
+        vint block_last_z = vi_sub(vi_add(block_z, block), one_cell);
+        vint bound_x = vi_select(neg_x, block_x, vi_add(block_x, block));
+        vint bound_z = vi_select(neg_z, block_z, vi_add(block_z, block));
+
+        vfloat t_x = boundary_t_packet(bound_x, origin_x, inv_x, flat_x);
+        vfloat t_z = boundary_t_packet(bound_z, origin_z, inv_z, flat_z);
+
+        vint take_x = vi_and(active, vf_lt(t_x, t_z));
+        vint take_z = vi_andnot(take_x, active);
+        vfloat t = vf_select(take_x, t_x, t_z);
+
+        // Cross a face along the stepping axis; along the other axis, land
+        // in the row/column where the ray leaves the block (the current one
+        // for single cells, where the clamp range is empty)
+        vint exit_z = vf_to_int(vf_add(origin_z, vf_mul(t, dir_z)));
+        vint exit_x = vf_to_int(vf_add(origin_x, vf_mul(t, dir_x)));
+        vint next_z = settle_cell_packet(exit_z, vi_select(neg_z, block_z, map_z), vi_select(neg_z, map_z, block_last_z),
+                                         t, origin_z, inv_z, flat_z, neg_z);
+        vint next_x = settle_cell_packet(exit_x, vi_select(neg_x, block_x, map_x), vi_select(neg_x, map_x, block_last_x),
+                                         t, origin_x, inv_x, flat_x, neg_x);
+
+        map_x = vi_select(take_x, vi_select(neg_x, vi_sub(bound_x, one_cell), bound_x),
+                          vi_select(take_z, next_x, map_x));
+        map_z = vi_select(take_z, vi_select(neg_z, vi_sub(bound_z, one_cell), bound_z),
+                          vi_select(take_x, next_z, map_z));
+        side = vi_select(take_x, no_lanes, vi_select(take_z, wall, side));
+
+        vint outside = vi_or(vi_or(vi_lt(map_x, no_lanes), vi_lt(last_x, map_x)),
+                             vi_or(vi_lt(map_z, no_lanes), vi_lt(last_z, map_z)));
+        vint too_far = vi_andnot(vf_lt(t, max_t), active);
+        vint ended = vi_and(active, vi_or(outside, too_far));
+        missed = vi_or(missed, ended);
+        active = vi_andnot(ended, active);
+
+        // Lanes still marching look up their new cell; any non-empty cell ends them
+        vint tile = vi_add(vi_mul(vi_sra(map_z, WORLDMAP_TILE_LOG2), tiles_x), vi_sra(map_x, WORLDMAP_TILE_LOG2));
+        vint index = vi_or(vi_sll(tile, 2 * WORLDMAP_TILE_LOG2),
+                           vi_or(vi_sll(vi_and(map_z, in_tile), WORLDMAP_TILE_LOG2), vi_and(map_x, in_tile)));
+        vint cell = vi_gather_u8(map->cells, index, active);
+        vint hit = vi_andnot(vi_eq(cell, no_lanes), active);
+        hit_cells = vi_select(hit, cell, hit_cells);
+        active = vi_andnot(hit, active);
+    }
+
+    vfloat dist_x = vf_mul(vf_div(vf_add(vf_sub(vf_from_int(map_x), origin_x), vf_select(neg_x, one, zero)), dir_x), vf_set1(MAP_SCALE));
+    vfloat dist_z = vf_mul(vf_div(vf_add(vf_sub(vf_from_int(map_z), origin_z), vf_select(neg_z, one, zero)), dir_z), vf_set1(MAP_SCALE));
+    vint x_side = vi_eq(side, no_lanes);
+    vfloat dist = vf_select(x_side, dist_x, dist_z);
+
+    // Position along the wall face, as in cast_ray
+    vfloat wall_pos = vf_select(x_side, vf_add(vf_set1(pos_z), vf_mul(dist, dir_z)),
+                                vf_add(vf_set1(pos_x), vf_mul(dist, dir_x)));
+    vfloat wall_cell = vf_div(wall_pos, vf_set1(MAP_SCALE));
+    vfloat u = vf_sub(wall_cell, vf_from_int(vf_to_int(wall_cell)));
+
+    vf_store(hit_dist, vf_select(missed, vf_set1(max_dist), dist));
+    vi_store((int32_t*)hit_wall, vi_select(missed, no_lanes, side));
+    vf_store(hit_u, vf_select(missed, zero, u));
+    vi_store((int32_t*)hit_cell, vi_select(missed, no_lanes, hit_cells));
+}
+#endif
+
 // Initialize world
 int world_init(void) {
     if (g_world_initialized) {
         return 1;
     }
     
+    if (!texture_atlas_init() ||
+        !worldmap_create(&g_maps[MAP_PLANET], &g_planet_cells[0][0], BUILTIN_MAP_SIZE, BUILTIN_MAP_SIZE) ||
+        !worldmap_create(&g_maps[MAP_SPACESHIP], &g_spaceship_cells[0][0], BUILTIN_MAP_SIZE, BUILTIN_MAP_SIZE) ||
+        !surface_init(SURFACE_DEFAULT_BUDGET) ||
+        !entity_init(ENTITY_DEFAULT_CAPACITY) ||
+        !sprite_init()) {
+        return 0;
+    }
+
+    colormap_build(&g_colormap, NULL, RAY_MAX_DIST);
+    g_colormap_planet = -1;
     g_world_initialized = 1;
-    printf("World initialized: %dx%d map\n", MAP_WIDTH, MAP_HEIGHT);
+    printf("World initialized: %dx%d map\n", g_map->width, g_map->height);
     
     return 1;
 }
 
 // Update world state
 void world_update(double delta_time) {
-    // World updates (enemies, triggers, etc.)
+    // Stream surface chunks around the player
+    if (g_on_surface) {
+        float player_x, player_y, player_z;
+        player_get_position(&player_x, &player_y, &player_z);
+        if (surface_update(player_x / MAP_SCALE, player_z / MAP_SCALE)) {
+            sync_surface_window();
+        }
+    }
+
+    // Move entities through the (possibly just updated) map
+    entity_tick((float)delta_time);
 }
 
 // Helper to safely pack RGB values into framebuffer format
@@ -172,36 +491,530 @@ static inline uint32_t pack_rgba(uint8_t r, uint8_t g, uint8_t b) {
     return 0xFF000000u | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
 }
 
-// Render world using raycasting into the software framebuffer
-void world_render(void) {
-    if (!g_world_initialized) {
-        return;
+// Wall span of every column, stored as arrays for the SIMD compositor.
+// Flat walls use color; textured walls sample a per-column strip of
+// pre-shaded texels at row (v_origin + y * v_step) >> 16, clamped to v_max.
+typedef struct {
+    int32_t* top;           // First wall row
+    int32_t* end;           // One past the last wall row (top == end: no wall)
+    uint32_t* color;        // Flat wall color (0 for textured walls)
+    int32_t* texture_key;   // Texture, mip and texel column (-1 for flat walls)
+    int32_t* light;         // Colormap level applied to the texel strip
+    int32_t* v_origin;      // 16.16 fixed point
+    int32_t* v_step;
+    int32_t* v_max;
+    uint32_t* texels;       // TEXTURE_SIZE shaded texels per column
+    float* depth;           // Perpendicular wall distance (depth buffer for sprites)
+    int capacity;
+} ColumnSpans;
+
+// One column's span before it is stored
+typedef struct {
+    int32_t top;
+    int32_t end;
+    uint32_t color;
+    int32_t texture_key;
+    int32_t light;
+    int32_t v_origin;
+    int32_t v_step;
+    int32_t v_max;
+    const uint32_t* source; // Unshaded texel strip in the atlas
+    float depth;            // Perpendicular distance (RAY_MAX_DIST: no wall)
+} WallSpan;
+
+// Ray result for one column
+typedef struct {
+    float dist;
+    int side;
+    float u;
+    int cell;
+    float dir_x;
+    float dir_z;
+} ColumnHit;
+
+// Floor or ceiling row: the texel under column x is
+// (u0 + ray_slope[x] * du, v0 + ray_slope[x] * dv) in level-0 texels, so
+// a row costs one divide (its distance) and each pixel a multiply-add
+typedef struct {
+    float u0, v0;           // World position straight ahead, biased
+    float du, dv;           // World offset per unit of ray slope
+    int32_t offset;         // Atlas texel of the row's mip level (-1: gradient colour)
+    int32_t mip;
+    int32_t light;          // Colormap level of the row's distance
+} CastRow;
+
+// Per-frame camera state shared by the column strips
+typedef struct {
+    uint32_t* framebuffer;
+    const uint32_t* row_colors; // Ceiling/floor color of every row
+    const CastRow* cast_rows;   // Textured floor/ceiling rows (NULL: gradient only)
+    const uint32_t* floor_texels; // Atlas the cast rows sample
+    int cast_y0, cast_y1;       // Cast rows every strip redraws (the camera moved)
+    ColumnSpans* spans;
+    const TextureAtlas* atlas;  // NULL: flat-shaded walls
+    const Colormap* colormap;
+    RendererRect* strip_damage; // Changed region of every strip (width 0: unchanged)
+    RendererRect* sprite_damage;// Sprite pixels of every strip: last frame's on entry, this frame's after
+    int draw_sprites;           // sprite_prepare found visible sprites
+    int full_redraw;            // Previous frame's pixels are unusable
+    int viewport_width;
+    int viewport_height;
+    int horizon;
+    int is_spaceship;
+    float pos_x;
+    float pos_z;
+    float view_sin;             // sin(yaw): rotates camera-space rays into the world
+    float view_cos;             // cos(yaw)
+    const float* ray_sin;       // CameraTables columns
+    const float* ray_cos;
+    const float* ray_slope;
+} ColumnContext;
+
+// Texture for a wall cell in the current environment
+static int wall_texture(int is_spaceship, int cell) {
+    int base = is_spaceship ? TEXTURE_HULL_PANEL : TEXTURE_BRICK;
+    return base + ((cell - 1) & 1);
+}
+
+// Point the span at its texture strip: pick the mip level whose texel
+// density is closest to one texel per row (never above two)
+static void texture_wall_span(const ColumnContext* ctx, WallSpan* span, const ColumnHit* hit, float line_height) {
+    int mip = 0;
+    float texels_per_row = (float)TEXTURE_SIZE / line_height;
+    while (mip < TEXTURE_MIP_LEVELS - 1 && texels_per_row >= 2.0f) {
+        texels_per_row *= 0.5f;
+        mip++;
     }
+    int size = TEXTURE_SIZE >> mip;
 
-    uint32_t* framebuffer = renderer_get_framebuffer();
-    if (!framebuffer) {
-        return;
+    // Flip u on two of the four faces so textures are never mirrored
+    float u = hit->u;
+    if ((hit->side == 0 && hit->dir_x > 0.0f) || (hit->side == 1 && hit->dir_z < 0.0f)) {
+        u = 1.0f - u;
     }
+    int column = (int)(u * (float)size);
+    if (column >= size) column = size - 1;
+    if (column < 0) column = 0;
 
-    int viewport_width, viewport_height;
-    renderer_get_viewport(&viewport_width, &viewport_height);
+    int texture = wall_texture(ctx->is_spaceship, hit->cell);
 
-    float player_x, player_y, player_z;
-    player_get_position(&player_x, &player_y, &player_z);
+    // Row y samples texel ((y + 0.5) - wall_top) * size / line_height
+    float wall_top = (float)ctx->horizon - line_height * 0.5f;
+    float ratio = (float)size / line_height;
+    span->texture_key = (texture << 16) | (mip << 8) | column;
+    span->v_step = (int32_t)(ratio * 65536.0f);
+    span->v_origin = (int32_t)((0.5f - wall_top) * ratio * 65536.0f);
+    span->v_max = size - 1;
+    span->source = texture_atlas_column(ctx->atlas, texture, mip, column);
+}
 
-    float player_yaw = player_get_yaw();
-    float player_pitch = player_get_pitch();
+// Shade one wall column from its ray hit
+static WallSpan compute_wall_span(const ColumnContext* ctx, int x, const ColumnHit* hit) {
+    WallSpan span = { 0, 0, 0, -1, 0, 0, 0, 0, NULL, RAY_MAX_DIST };
+    float hit_dist = hit->dist;
+    int hit_wall = hit->side;
 
-    // Establish horizon based on pitch for simple look up/down effect
-    int horizon = viewport_height / 2 - (int)(player_pitch * (viewport_height / 180.0f));
-    if (horizon < 0) horizon = 0;
-    if (horizon > viewport_height) horizon = viewport_height;
+    // Skip if ray didn't hit anything (hit distance is max_dist)
+    if (hit_dist >= RAY_MAX_DIST) {
+        return span;
+    }
 
-    // Determine if we're on spaceship or planet for different rendering
-    LocationType location_type = space_get_location_type();
-    int is_spaceship = (location_type == LOCATION_SPACESHIP);
+    // Calculate perspective-corrected distance for wall height
+    float corrected_dist = hit_dist * ctx->ray_cos[x];
+    if (corrected_dist < 0.001f) {
+        corrected_dist = 0.001f;
+    }
+    span.depth = corrected_dist;
+
+    // Calculate wall height on screen
+    float line_height = ((float)ctx->viewport_height / corrected_dist) * WALL_HEIGHT_WORLD;
+    int draw_start = ctx->horizon - (int)(line_height * 0.5f);
+    int draw_end = ctx->horizon + (int)(line_height * 0.5f);
+
+    // Clamp to screen bounds
+    if (draw_start < 0) draw_start = 0;
+    if (draw_end >= ctx->viewport_height) draw_end = ctx->viewport_height - 1;
+    if (draw_start > draw_end) return span; // Skip if wall is off-screen
+
+    span.top = draw_start;
+    span.end = draw_end + 1;
+
+    // Light level from the distance, darker on one pair of faces
+    // (north/south vs east/west)
+    int light = colormap_level(ctx->colormap, hit_dist);
+    if (hit_wall) {
+        light += COLORMAP_SIDE_LEVELS;
+        if (light > COLORMAP_LEVELS - 1) light = COLORMAP_LEVELS - 1;
+    }
+    span.light = light;
+
+    if (ctx->atlas) {
+        // Textured walls: the texel strip goes through the level's tables
+        texture_wall_span(ctx, &span, hit, line_height);
+        return span;
+    }
+
+    // Environment-specific wall colors
+    uint8_t base_r, base_g, base_b;
+    if (ctx->is_spaceship) {
+        // Spaceship walls - metallic blue-gray with highlights
+        base_r = hit_wall ? 120 : 140;
+        base_g = hit_wall ? 145 : 165;
+        base_b = hit_wall ? 180 : 200;
+        
+        // Add subtle blue glow
+        if (!hit_wall) {
+            base_b = (uint8_t)(base_b * 1.1f);
+            if (base_b > 220) base_b = 220;
+        }
+    } else {
+        // Planet walls - warmer stone/rock colors
+        base_r = hit_wall ? 180 : 200;
+        base_g = hit_wall ? 150 : 170;
+        base_b = hit_wall ? 120 : 140;
+    }
+
+    span.color = colormap_shade(&ctx->colormap->levels[light], pack_rgba(base_r, base_g, base_b));
+    return span;
+}
+
+// Changed rows and columns of one strip
+typedef struct {
+    int x0, x1;
+    int y0, y1;
+} StripDamage;
+
+// Store a column's new span; if it differs from last frame's, grow the
+// strip's damage by the rows the old and new walls cover
+static void store_wall_span(const ColumnContext* ctx, StripDamage* damage, int x, const WallSpan* span) {
+    ColumnSpans* spans = ctx->spans;
+    int32_t old_top = spans->top[x];
+    int32_t old_end = spans->end[x];
+    int old_empty = old_top >= old_end;
+    int new_empty = span->top >= span->end;
+
+    // The depth buffer is refreshed for every column, changed or not
+    spans->depth[x] = span->depth;
+
+    if (!ctx->full_redraw) {
+        if (old_empty && new_empty) {
+            return;
+        }
+        if (old_top == span->top && old_end == span->end && spans->color[x] == span->color &&
+            spans->texture_key[x] == span->texture_key && spans->light[x] == span->light &&
+            spans->v_origin[x] == span->v_origin && spans->v_step[x] == span->v_step) {
+            return;
+        }
+    }
+
+    spans->top[x] = span->top;
+    spans->end[x] = span->end;
+    spans->color[x] = span->color;
+    spans->texture_key[x] = span->texture_key;
+    spans->light[x] = span->light;
+    spans->v_origin[x] = span->v_origin;
+    spans->v_step[x] = span->v_step;
+    spans->v_max[x] = span->v_max;
+    if (span->source) {
+        colormap_shade_strip(&ctx->colormap->levels[span->light], spans->texels + (size_t)x * TEXTURE_SIZE,
+                             span->source, span->v_max + 1);
+    }
+
+    if (x < damage->x0) damage->x0 = x;
+    if (x + 1 > damage->x1) damage->x1 = x + 1;
+    if (!old_empty) {
+        if (old_top < damage->y0) damage->y0 = old_top;
+        if (old_end > damage->y1) damage->y1 = old_end;
+    }
+    if (!new_empty) {
+        if (span->top < damage->y0) damage->y0 = span->top;
+        if (span->end > damage->y1) damage->y1 = span->end;
+    }
+}
+
+// Floor/ceiling texel of column x in a cast row, shaded for the row's distance
+static inline uint32_t cast_texel(const ColumnContext* ctx, const CastRow* cast, int x) {
+    float slope = ctx->ray_slope[x];
+    int32_t mask = (TEXTURE_SIZE >> cast->mip) - 1;
+    int32_t u = ((int32_t)(cast->u0 + slope * cast->du) >> cast->mip) & mask;
+    int32_t v = ((int32_t)(cast->v0 + slope * cast->dv) >> cast->mip) & mask;
+    uint32_t texel = ctx->floor_texels[cast->offset + (u << (TEXTURE_SIZE_LOG2 - cast->mip)) + v];
+    return colormap_shade(&ctx->colormap->levels[cast->light], texel);
+}
+
+#ifndef SIMD_SCALAR
+// cast_texel for SIMD_WIDTH columns from x; lanes outside mask read as
+// garbage (the compositor replaces them with wall pixels)
+static inline vint cast_packet(const ColumnContext* ctx, const CastRow* cast, int x, vint mask) {
+    const ColormapLevel* light = &ctx->colormap->levels[cast->light];
+    const vint size_mask = vi_set1((TEXTURE_SIZE >> cast->mip) - 1);
+    const vint channel = vi_set1(0xFF);
+    const vint scale = vi_set1((int32_t)light->scale);
+
+    vfloat slope = vf_load(ctx->ray_slope + x);
+    vint u = vf_to_int(vf_add(vf_set1(cast->u0), vf_mul(slope, vf_set1(cast->du))));
+    vint v = vf_to_int(vf_add(vf_set1(cast->v0), vf_mul(slope, vf_set1(cast->dv))));
+    u = vi_and(vi_sra(u, cast->mip), size_mask);
+    v = vi_and(vi_sra(v, cast->mip), size_mask);
+    vint index = vi_add(vi_set1(cast->offset), vi_add(vi_sll(u, TEXTURE_SIZE_LOG2 - cast->mip), v));
+    vint texel = vi_gather((const int32_t*)ctx->floor_texels, index, mask);
+
+    // colormap_shade on every lane
+    vint r = vi_sra(vi_add(vi_mul(vi_and(vi_sra(texel, 16), channel), scale), vi_set1((int32_t)light->offset[0])), 8);
+    vint g = vi_sra(vi_add(vi_mul(vi_and(vi_sra(texel, 8), channel), scale), vi_set1((int32_t)light->offset[1])), 8);
+    vint b = vi_sra(vi_add(vi_mul(vi_and(texel, channel), scale), vi_set1((int32_t)light->offset[2])), 8);
+    return vi_or(vi_set1((int32_t)0xFF000000u), vi_or(vi_sll(r, 16), vi_or(vi_sll(g, 8), b)));
+}
+#endif
+
+// Row y's cast floor/ceiling (NULL: the row is its gradient colour)
+static inline const CastRow* cast_row(const ColumnContext* ctx, int y) {
+    if (!ctx->cast_rows || ctx->cast_rows[y].offset < 0) {
+        return NULL;
+    }
+    return &ctx->cast_rows[y];
+}
+
+// Write rows [y_begin, y_end) of columns [x_begin, x_end): every pixel is
+// stored exactly once, either the column's wall color or the row's
+// ceiling/floor (its color, or the cast texel where the wall leaves a gap)
+static void composite_strip_flat(const ColumnContext* ctx, int x_begin, int x_end, int y_begin, int y_end) {
+    const int32_t* span_top = ctx->spans->top;
+    const int32_t* span_end = ctx->spans->end;
+    const uint32_t* span_color = ctx->spans->color;
+
+    for (int y = y_begin; y < y_end; ++y) {
+        uint32_t* row = ctx->framebuffer + (size_t)y * (size_t)ctx->viewport_width;
+        uint32_t background = ctx->row_colors[y];
+        const CastRow* cast = cast_row(ctx, y);
+        int x = x_begin;
+
+#ifndef SIMD_SCALAR
+        const vint row_y = vi_set1(y);
+        const vint row_color = vi_set1((int32_t)background);
+        const vint all_lanes = vi_set1(-1);
+        for (; x + SIMD_WIDTH <= x_end; x += SIMD_WIDTH) {
+            vint in_wall = vi_andnot(vi_lt(row_y, vi_load(span_top + x)), vi_lt(row_y, vi_load(span_end + x)));
+            vint floor = row_color;
+            if (cast) {
+                vint open = vi_andnot(in_wall, all_lanes);
+                if (vi_any(open)) {
+                    floor = cast_packet(ctx, cast, x, open);
+                }
+            }
+            vint color = vi_load((const int32_t*)(span_color + x));
+            vi_store((int32_t*)(row + x), vi_select(in_wall, color, floor));
+        }
+#endif
+        for (; x < x_end; ++x) {
+            if (y >= span_top[x] && y < span_end[x]) {
+                row[x] = span_color[x];
+            } else {
+                row[x] = cast ? cast_texel(ctx, cast, x) : background;
+            }
+        }
+    }
+}
+
+// Textured variant: wall pixels fetch from their column's shaded texel strip
+static void composite_strip_textured(const ColumnContext* ctx, int x_begin, int x_end, int y_begin, int y_end) {
+    const ColumnSpans* spans = ctx->spans;
+    const uint32_t* texels = spans->texels;
+
+    for (int y = y_begin; y < y_end; ++y) {
+        uint32_t* row = ctx->framebuffer + (size_t)y * (size_t)ctx->viewport_width;
+        uint32_t background = ctx->row_colors[y];
+        const CastRow* cast = cast_row(ctx, y);
+        int x = x_begin;
+
+#ifndef SIMD_SCALAR
+        const vint row_y = vi_set1(y);
+        const vint row_color = vi_set1((int32_t)background);
+        const vint all_lanes = vi_set1(-1);
+        const vint strip_stride = vi_set1(TEXTURE_SIZE);
+        const vint lanes = vi_lane_index();
+        const vint zero = vi_set1(0);
+        for (; x + SIMD_WIDTH <= x_end; x += SIMD_WIDTH) {
+            vint in_wall = vi_andnot(vi_lt(row_y, vi_load(spans->top + x)), vi_lt(row_y, vi_load(spans->end + x)));
+            vint floor = row_color;
+            if (cast) {
+                vint open = vi_andnot(in_wall, all_lanes);
+                if (vi_any(open)) {
+                    floor = cast_packet(ctx, cast, x, open);
+                }
+            }
+            if (!vi_any(in_wall)) {
+                vi_store((int32_t*)(row + x), floor);
+                continue;
+            }
+            vint v = vi_sra(vi_add(vi_load(spans->v_origin + x), vi_mul(row_y, vi_load(spans->v_step + x))), 16);
+            v = vi_min(vi_max(v, zero), vi_load(spans->v_max + x));
+            vint index = vi_add(vi_mul(vi_add(vi_set1(x), lanes), strip_stride), v);
+            vint texel = vi_gather((const int32_t*)texels, index, in_wall);
+            vi_store((int32_t*)(row + x), vi_select(in_wall, texel, floor));
+        }
+#endif
+        for (; x < x_end; ++x) {
+            if (y >= spans->top[x] && y < spans->end[x]) {
+                int32_t v = (int32_t)((uint32_t)spans->v_origin[x] + (uint32_t)y * (uint32_t)spans->v_step[x]) >> 16;
+                if (v < 0) v = 0;
+                if (v > spans->v_max[x]) v = spans->v_max[x];
+                row[x] = texels[(size_t)x * TEXTURE_SIZE + v];
+            } else {
+                row[x] = cast ? cast_texel(ctx, cast, x) : background;
+            }
+        }
+    }
+}
+
+// Ceiling/floor gradient, one color per framebuffer row. Depends only on
+// the viewport height, horizon and environment, so it is rebuilt when one
+// of those changes rather than every frame.
+static uint32_t* g_row_colors = NULL;
+static int g_row_capacity = 0;
+static int g_row_height = -1;
+static int g_row_horizon = -1;
+static int g_row_is_spaceship = -1;
+
+// Textured floor/ceiling rows, rebuilt every drawn frame from the camera
+static CastRow* g_cast_rows = NULL;
+static int g_cast_row_count = 0; // Rows cast by the last drawn frame
+
+// Wall span of every column, filled by the strips each frame
+static ColumnSpans g_spans;
+static RendererRect* g_strip_damage = NULL;
+
+// Sprite pixels drawn into each strip by the last frame; they are
+// composited over (erased) by the next one
+static RendererRect* g_sprite_damage = NULL;
+static int g_sprites_on_screen = 0;
+
+// realloc that leaves *array untouched on failure
+static int grow_array(void** array, size_t count, size_t element_size) {
+    void* grown = realloc(*array, count * element_size);
+    if (!grown) {
+        return 0;
+    }
+    *array = grown;
+    return 1;
+}
+
+static int ensure_span_capacity(int columns) {
+    if (columns <= g_spans.capacity) {
+        return 1;
+    }
+    size_t n = (size_t)columns;
+    size_t strips = (n + WORLD_STRIP_COLUMNS - 1) / WORLD_STRIP_COLUMNS;
+    if (!grow_array((void**)&g_spans.top, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_spans.end, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_spans.color, n, sizeof(uint32_t)) ||
+        !grow_array((void**)&g_spans.texture_key, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_spans.light, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_spans.v_origin, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_spans.v_step, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_spans.v_max, n, sizeof(int32_t)) ||
+        !grow_array((void**)&g_spans.texels, n * TEXTURE_SIZE, sizeof(uint32_t)) ||
+        !grow_array((void**)&g_spans.depth, n, sizeof(float)) ||
+        !grow_array((void**)&g_strip_damage, strips, sizeof(RendererRect)) ||
+        !grow_array((void**)&g_sprite_damage, strips, sizeof(RendererRect))) {
+        printf("ERROR: Failed to allocate column spans\n");
+        return 0;
+    }
+    g_spans.capacity = columns;
+    return 1;
+}
+
+static void free_spans(void) {
+    free(g_spans.top);
+    free(g_spans.end);
+    free(g_spans.color);
+    free(g_spans.texture_key);
+    free(g_spans.light);
+    free(g_spans.v_origin);
+    free(g_spans.v_step);
+    free(g_spans.v_max);
+    free(g_spans.texels);
+    free(g_spans.depth);
+    free(g_strip_damage);
+    free(g_sprite_damage);
+    memset(&g_spans, 0, sizeof(g_spans));
+    g_strip_damage = NULL;
+    g_sprite_damage = NULL;
+}
+
+static int ensure_row_capacity(int rows) {
+    if (rows <= g_row_capacity) {
+        return 1;
+    }
+    if (!grow_array((void**)&g_row_colors, (size_t)rows, sizeof(uint32_t)) ||
+        !grow_array((void**)&g_cast_rows, (size_t)rows, sizeof(CastRow))) {
+        printf("ERROR: Failed to allocate row color table\n");
+        return 0;
+    }
+    g_row_capacity = rows;
+    return 1;
+}
+
+// Set up the textured rows: the floor everywhere, the ceiling only inside
+// the spaceship (planets keep their sky gradient). A row at p pixels from
+// the horizon sees the floor (or ceiling) at depth half a wall's height
+// times viewport_height / p; its mip level follows the texel footprint of
+// one pixel, the geometric mean of its width along the row and its depth
+// down to the next row. Returns the number of rows cast.
+static int build_cast_rows(CastRow* rows, int viewport_width, int viewport_height, int horizon, int is_spaceship,
+                           float world_x, float world_z, float view_sin, float view_cos) {
+    const TextureAtlas* atlas = texture_get_atlas();
+    const float angle_step = CAMERA_FOV_DEGREES * (M_PI / 180.0f) / (float)viewport_width;
+    const float eye_depth = (float)viewport_height * (WALL_HEIGHT_WORLD * 0.5f);
+
+    // Camera position in texels, wrapped to one texture so rows stay exact
+    // however far the player is from the origin
+    float origin_u = (float)fmod((double)world_x * FLOOR_TEXELS_PER_UNIT, TEXTURE_SIZE);
+    float origin_v = (float)fmod((double)world_z * FLOOR_TEXELS_PER_UNIT, TEXTURE_SIZE);
+    if (origin_u < 0.0f) origin_u += TEXTURE_SIZE;
+    if (origin_v < 0.0f) origin_v += TEXTURE_SIZE;
+    origin_u += FLOOR_TEXEL_BIAS;
+    origin_v += FLOOR_TEXEL_BIAS;
+
+    int cast = 0;
+    for (int y = 0; y < viewport_height; ++y) {
+        CastRow* row = &rows[y];
+        int is_floor = y >= horizon;
+        if (!is_floor && !is_spaceship) {
+            row->offset = -1;
+            continue;
+        }
+
+        float rows_from_horizon = fabsf((float)y + 0.5f - (float)horizon);
+        float depth = eye_depth / rows_from_horizon;
+        float texels = depth * FLOOR_TEXELS_PER_UNIT;
+
+        int mip = 0;
+        float texels_per_pixel = texels * sqrtf(angle_step / rows_from_horizon);
+        while (mip < TEXTURE_MIP_LEVELS - 1 && texels_per_pixel >= 2.0f) {
+            texels_per_pixel *= 0.5f;
+            mip++;
+        }
+
+        // Forward is (sin, -cos) of the yaw, right is (cos, sin)
+        int texture = is_floor ? (is_spaceship ? TEXTURE_DECK_PLATE : TEXTURE_GROUND) : TEXTURE_CEILING_LIGHT;
+        row->u0 = origin_u + texels * view_sin;
+        row->v0 = origin_v - texels * view_cos;
+        row->du = texels * view_cos;
+        row->dv = texels * view_sin;
+        row->offset = atlas->offsets[texture][mip];
+        row->mip = mip;
+        row->light = colormap_level(&g_colormap, depth);
+        cast++;
+    }
+    return cast;
+}
 
-    // Fill ceiling and floor with environment-specific colors
+// Compute the ceiling and floor color of every row. Rows near the horizon
+// are far away: in an atmosphere they fade into the fog like the walls,
+// taking the distance of a floor (or mirrored ceiling) at eye height.
+static void build_row_colors(uint32_t* row_colors, int viewport_height, int horizon, int is_spaceship,
+                             const Colormap* colormap) {
     for (int y = 0; y < viewport_height; ++y) {
         uint8_t r, g, b;
         if (y < horizon) {
@@ -234,137 +1047,407 @@ void world_render(void) {
                 b = (uint8_t)(35.0f + 40.0f * t);
             }
         }
-
         uint32_t color = pack_rgba(r, g, b);
-        uint32_t* row = framebuffer + (size_t)y * (size_t)viewport_width;
-        for (int x = 0; x < viewport_width; ++x) {
-            row[x] = color;
+        if (colormap->fog_density > 0.0f) {
+            float rows_from_horizon = fabsf((float)y + 0.5f - (float)horizon);
+            float distance = (float)viewport_height * (WALL_HEIGHT_WORLD * 0.5f) / rows_from_horizon;
+            color = colormap_fog(colormap, colormap_level(colormap, distance), color);
         }
+        row_colors[y] = color;
     }
+}
 
-    // Raycasting - render walls column by column
-    const float max_dist = 50.0f;
-    const float wall_height_world = 2.0f;
-    const float fov = 66.0f;
-    const float fov_radians = fov * (M_PI / 180.0f);
+// Render columns [x_begin, x_end): trace wall spans, then composite the
+// ones that changed over the ceiling/floor. Strips touch disjoint
+// framebuffer columns, so they can run on any thread.
+static void render_column_strip(void* user_data, int x_begin, int x_end, int thread_index) {
+    const ColumnContext* ctx = (const ColumnContext*)user_data;
+    (void)thread_index;
 
-    float yaw_rad = player_yaw * (M_PI / 180.0f);
-    float start_angle = yaw_rad - (fov_radians * 0.5f);
-    float ray_angle_step = fov_radians / (float)viewport_width;
+    StripDamage damage = { x_end, x_begin, ctx->viewport_height, 0 };
 
+    // World ray = camera-space ray rotated by yaw:
+    //   dir_x = sin(yaw + a),  dir_z = -cos(yaw + a)
+#ifdef SIMD_SCALAR
     // Render every column for better visual quality
-    for (int x = 0; x < viewport_width; ++x) {
-        float ray_angle = start_angle + x * ray_angle_step;
-        float hit_dist;
-        int hit_wall;
-        cast_ray(ray_angle, max_dist, &hit_dist, &hit_wall);
-
-        // Skip if ray didn't hit anything (hit distance is max_dist)
-        if (hit_dist >= max_dist) {
-            continue;
-        }
-
-        // Calculate perspective-corrected distance for wall height
-        float corrected_dist = hit_dist * cosf(ray_angle - yaw_rad);
-        if (corrected_dist < 0.001f) {
-            corrected_dist = 0.001f;
-        }
+    for (int x = x_begin; x < x_end; ++x) {
+        float dir_x = ctx->view_sin * ctx->ray_cos[x] + ctx->view_cos * ctx->ray_sin[x];
+        float dir_z = ctx->view_sin * ctx->ray_sin[x] - ctx->view_cos * ctx->ray_cos[x];
+        ColumnHit hit;
+        hit.dir_x = dir_x;
+        hit.dir_z = dir_z;
+        cast_ray(ctx->pos_x, ctx->pos_z, dir_x, dir_z, RAY_MAX_DIST, &hit.dist, &hit.side, &hit.u, &hit.cell);
+        WallSpan span = compute_wall_span(ctx, x, &hit);
+        store_wall_span(ctx, &damage, x, &span);
+    }
+#else
+    // Trace SIMD_WIDTH adjacent columns per packet; the tables are padded,
+    // so a short last packet repeats the final column in its spare lanes
+    const vfloat view_sin = vf_set1(ctx->view_sin);
+    const vfloat view_cos = vf_set1(ctx->view_cos);
+    for (int x0 = x_begin; x0 < x_end; x0 += SIMD_WIDTH) {
+        float dir_x[SIMD_WIDTH], dir_z[SIMD_WIDTH], hit_dist[SIMD_WIDTH], hit_u[SIMD_WIDTH];
+        int hit_wall[SIMD_WIDTH], hit_cell[SIMD_WIDTH];
 
-        // Calculate wall height on screen
-        float line_height = ((float)viewport_height / corrected_dist) * wall_height_world;
-        int draw_start = horizon - (int)(line_height * 0.5f);
-        int draw_end = horizon + (int)(line_height * 0.5f);
+        vfloat ray_sin = vf_load(ctx->ray_sin + x0);
+        vfloat ray_cos = vf_load(ctx->ray_cos + x0);
+        vf_store(dir_x, vf_add(vf_mul(view_sin, ray_cos), vf_mul(view_cos, ray_sin)));
+        vf_store(dir_z, vf_sub(vf_mul(view_sin, ray_sin), vf_mul(view_cos, ray_cos)));
 
-        // Clamp to screen bounds
-        if (draw_start < 0) draw_start = 0;
-        if (draw_end >= viewport_height) draw_end = viewport_height - 1;
-        if (draw_start > draw_end) continue; // Skip if wall is off-screen
+        cast_ray_packet(ctx->pos_x, ctx->pos_z, dir_x, dir_z, RAY_MAX_DIST, hit_dist, hit_wall, hit_u, hit_cell);
 
-        // Calculate distance-based shading (farther = darker)
-        float shade = 1.0f - (hit_dist / max_dist) * 0.65f;
-        if (shade < 0.25f) shade = 0.25f; // Minimum brightness
-        if (shade > 1.0f) shade = 1.0f;
-        
-        // Different shade for different wall sides (north/south vs east/west)
-        if (hit_wall) {
-            shade *= 0.82f; // Slightly darker for one side
+        for (int lane = 0; lane < SIMD_WIDTH && x0 + lane < x_end; ++lane) {
+            int x = x0 + lane;
+            ColumnHit hit = { hit_dist[lane], hit_wall[lane], hit_u[lane], hit_cell[lane], dir_x[lane], dir_z[lane] };
+            WallSpan span = compute_wall_span(ctx, x, &hit);
+            store_wall_span(ctx, &damage, x, &span);
         }
+    }
+#endif
 
-        // Environment-specific wall colors
-        uint8_t base_r, base_g, base_b;
-        if (is_spaceship) {
-            // Spaceship walls - metallic blue-gray with highlights
-            base_r = hit_wall ? 120 : 140;
-            base_g = hit_wall ? 145 : 165;
-            base_b = hit_wall ? 180 : 200;
-            
-            // Add subtle blue glow
-            if (!hit_wall) {
-                base_b = (uint8_t)(base_b * 1.1f);
-                if (base_b > 220) base_b = 220;
-            }
+    int strip = x_begin / WORLD_STRIP_COLUMNS;
+    RendererRect* sprites = &ctx->sprite_damage[strip];
+    if (ctx->full_redraw) {
+        damage.x0 = x_begin;
+        damage.x1 = x_end;
+        damage.y0 = 0;
+        damage.y1 = ctx->viewport_height;
+    } else if (sprites->width) {
+        // Composite over last frame's sprites
+        if (sprites->x < damage.x0) damage.x0 = sprites->x;
+        if (sprites->x + sprites->width > damage.x1) damage.x1 = sprites->x + sprites->width;
+        if (sprites->y < damage.y0) damage.y0 = sprites->y;
+        if (sprites->y + sprites->height > damage.y1) damage.y1 = sprites->y + sprites->height;
+    }
+    if (!ctx->full_redraw && ctx->cast_y0 < ctx->cast_y1) {
+        // A moving camera changes every pixel of the textured rows
+        damage.x0 = x_begin;
+        damage.x1 = x_end;
+        if (ctx->cast_y0 < damage.y0) damage.y0 = ctx->cast_y0;
+        if (ctx->cast_y1 > damage.y1) damage.y1 = ctx->cast_y1;
+    }
+
+    if (damage.x0 < damage.x1 && damage.y0 < damage.y1) {
+        if (ctx->atlas) {
+            composite_strip_textured(ctx, damage.x0, damage.x1, damage.y0, damage.y1);
         } else {
-            // Planet walls - warmer stone/rock colors
-            base_r = hit_wall ? 180 : 200;
-            base_g = hit_wall ? 150 : 170;
-            base_b = hit_wall ? 120 : 140;
+            composite_strip_flat(ctx, damage.x0, damage.x1, damage.y0, damage.y1);
         }
+    }
 
-        uint8_t r = (uint8_t)(base_r * shade);
-        uint8_t g = (uint8_t)(base_g * shade);
-        uint8_t b = (uint8_t)(base_b * shade);
-        
-        // Add depth-based color variation for more visual interest
-        float depth_factor = hit_dist / max_dist;
-        if (depth_factor > 0.7f) {
-            // Fade to darker at distance
-            float fade = (depth_factor - 0.7f) / 0.3f;
-            r = (uint8_t)(r * (1.0f - fade * 0.3f));
-            g = (uint8_t)(g * (1.0f - fade * 0.3f));
-            b = (uint8_t)(b * (1.0f - fade * 0.3f));
+    // This strip's sprite batch, against the depth of the walls just traced
+    sprites->width = 0;
+    if (ctx->draw_sprites) {
+        sprite_draw_strip(strip, x_end, ctx->framebuffer, ctx->spans->depth, sprites);
+        if (sprites->width) {
+            if (sprites->x < damage.x0) damage.x0 = sprites->x;
+            if (sprites->x + sprites->width > damage.x1) damage.x1 = sprites->x + sprites->width;
+            if (sprites->y < damage.y0) damage.y0 = sprites->y;
+            if (sprites->y + sprites->height > damage.y1) damage.y1 = sprites->y + sprites->height;
         }
-        
-        uint32_t wall_color = pack_rgba(r, g, b);
+    }
 
-        // Draw the wall column
-        for (int y = draw_start; y <= draw_end; ++y) {
-            framebuffer[(size_t)y * (size_t)viewport_width + x] = wall_color;
+    RendererRect* rect = &ctx->strip_damage[strip];
+    rect->width = 0;
+    if (damage.x0 < damage.x1 && damage.y0 < damage.y1) {
+        rect->x = damage.x0;
+        rect->y = damage.y0;
+        rect->width = damage.x1 - damage.x0;
+        rect->height = damage.y1 - damage.y0;
+    }
+}
+
+// Everything a frame's pixels depend on; an identical key means the
+// framebuffer already holds this frame
+typedef struct {
+    float pos_x, pos_z;
+    float yaw, pitch;
+    unsigned map_generation;
+    int viewport_width, viewport_height;
+    int is_spaceship;
+} FrameKey;
+
+static FrameKey g_last_frame_key;
+static int g_history_valid = 0; // Framebuffer and spans hold g_last_frame_key's frame
+
+static int frame_key_equal(const FrameKey* a, const FrameKey* b) {
+    return a->pos_x == b->pos_x && a->pos_z == b->pos_z &&
+           a->yaw == b->yaw && a->pitch == b->pitch &&
+           a->map_generation == b->map_generation &&
+           a->viewport_width == b->viewport_width && a->viewport_height == b->viewport_height &&
+           a->is_spaceship == b->is_spaceship;
+}
+
+// Hand changed strips to the renderer, joining neighbours into one rectangle;
+// returns the number of bytes composited
+static size_t submit_strip_damage(const RendererRect* strips, int strip_count) {
+    size_t bytes = 0;
+    RendererRect merged = { 0, 0, 0, 0 };
+
+    for (int i = 0; i < strip_count; ++i) {
+        const RendererRect* rect = &strips[i];
+        if (rect->width == 0) {
+            continue;
         }
+        bytes += (size_t)rect->width * (size_t)rect->height * sizeof(uint32_t);
+
+        if (merged.width && merged.x + merged.width == rect->x) {
+            int y0 = merged.y < rect->y ? merged.y : rect->y;
+            int y1 = merged.y + merged.height > rect->y + rect->height ? merged.y + merged.height : rect->y + rect->height;
+            merged.width = rect->x + rect->width - merged.x;
+            merged.y = y0;
+            merged.height = y1 - y0;
+            continue;
+        }
+        if (merged.width) {
+            renderer_mark_dirty(merged.x, merged.y, merged.width, merged.height);
+        }
+        merged = *rect;
+    }
+    if (merged.width) {
+        renderer_mark_dirty(merged.x, merged.y, merged.width, merged.height);
     }
+    return bytes;
+}
+
+// Render world using raycasting into the software framebuffer
+void world_render(void) {
+    if (!g_world_initialized) {
+        return;
+    }
+
+    uint32_t* framebuffer = renderer_get_framebuffer();
+    if (!framebuffer) {
+        return;
+    }
+
+    int viewport_width, viewport_height;
+    renderer_get_viewport(&viewport_width, &viewport_height);
+
+    const CameraTables* tables = camera_get_tables();
+    if (!tables || tables->width != viewport_width ||
+        !ensure_row_capacity(viewport_height) || !ensure_span_capacity(viewport_width)) {
+        // Nothing composited: let renderer_clear provide the background
+        g_history_valid = 0;
+        renderer_set_clear_needed(1);
+        return;
+    }
+
+    // Camera between the last two simulation ticks
+    float player_x, player_z, player_yaw, player_pitch;
+    player_get_view(&player_x, &player_z, &player_yaw, &player_pitch);
+
+    // Determine if we're on spaceship or planet for different rendering
+    LocationType location_type = space_get_location_type();
+    int is_spaceship = (location_type == LOCATION_SPACESHIP);
+
+    // Skip the frame entirely when nothing it depends on has changed
+    FrameKey key;
+    key.pos_x = player_x;
+    key.pos_z = player_z;
+    key.yaw = player_yaw;
+    key.pitch = player_pitch;
+    key.map_generation = g_map_generation;
+    key.viewport_width = viewport_width;
+    key.viewport_height = viewport_height;
+    key.is_spaceship = is_spaceship;
+
+    int full_redraw = !g_history_valid || renderer_frame_was_cleared() ||
+                      viewport_width != g_last_frame_key.viewport_width ||
+                      viewport_height != g_last_frame_key.viewport_height;
+
+    // Establish horizon based on pitch for simple look up/down effect
+    int horizon = viewport_height / 2 - (int)(player_pitch * (viewport_height / 180.0f));
+    if (horizon < 0) horizon = 0;
+    if (horizon > viewport_height) horizon = viewport_height;
+
+    const float yaw_rad = player_yaw * (M_PI / 180.0f);
+    const float view_sin = sinf(yaw_rad);
+    const float view_cos = cosf(yaw_rad);
+
+    // Cull and sort the entities' sprites; entities move on their own, so
+    // a frame with sprites on screen (now or last frame) is never skipped
+    SpriteCamera sprite_camera;
+    sprite_camera.pos_x = player_x;
+    sprite_camera.pos_z = player_z;
+    sprite_camera.view_sin = view_sin;
+    sprite_camera.view_cos = view_cos;
+    sprite_camera.viewport_width = viewport_width;
+    sprite_camera.viewport_height = viewport_height;
+    sprite_camera.horizon = horizon;
+    sprite_camera.strip_columns = WORLD_STRIP_COLUMNS;
+    sprite_camera.max_depth = RAY_MAX_DIST;
+    sprite_camera.colormap = &g_colormap;
+    sprite_camera.image = is_spaceship ? SPRITE_IMAGE_DRONE : SPRITE_IMAGE_CRITTER;
+    const EntityData* entities = entity_get_data();
+    int visible_sprites = sprite_prepare(&sprite_camera, entities->x, entities->z, entities->radius, entities->count);
+
+    if (!full_redraw && !visible_sprites && !g_sprites_on_screen && frame_key_equal(&key, &g_last_frame_key)) {
+        return;
+    }
+
+    // A new sky/floor gradient changes every background pixel
+    if (viewport_height != g_row_height || horizon != g_row_horizon || is_spaceship != g_row_is_spaceship) {
+        build_row_colors(g_row_colors, viewport_height, horizon, is_spaceship, &g_colormap);
+        g_row_height = viewport_height;
+        g_row_horizon = horizon;
+        g_row_is_spaceship = is_spaceship;
+        full_redraw = 1;
+    }
+
+    // Textured floor/ceiling rows; when the camera moved, every strip
+    // redraws them whether or not its walls changed
+    g_cast_row_count = 0;
+    if (g_textured_floors) {
+        g_cast_row_count = build_cast_rows(g_cast_rows, viewport_width, viewport_height, horizon, is_spaceship,
+                                           player_x, player_z, view_sin, view_cos);
+    }
+    int camera_moved = key.pos_x != g_last_frame_key.pos_x || key.pos_z != g_last_frame_key.pos_z ||
+                       key.yaw != g_last_frame_key.yaw;
+
+    // Raycasting - render walls column by column, then each strip's sprites
+    ColumnContext ctx;
+    ctx.framebuffer = framebuffer;
+    ctx.row_colors = g_row_colors;
+    ctx.cast_rows = g_cast_row_count ? g_cast_rows : NULL;
+    ctx.floor_texels = texture_get_atlas()->texels;
+    ctx.cast_y0 = 0;
+    ctx.cast_y1 = 0;
+    if (g_cast_row_count && camera_moved) {
+        ctx.cast_y0 = is_spaceship ? 0 : horizon;
+        ctx.cast_y1 = viewport_height;
+    }
+    ctx.spans = &g_spans;
+    ctx.atlas = g_textured_walls ? texture_get_atlas() : NULL;
+    ctx.colormap = &g_colormap;
+    ctx.strip_damage = g_strip_damage;
+    ctx.sprite_damage = g_sprite_damage;
+    ctx.draw_sprites = visible_sprites > 0;
+    ctx.full_redraw = full_redraw;
+    ctx.viewport_width = viewport_width;
+    ctx.viewport_height = viewport_height;
+    ctx.horizon = horizon;
+    ctx.is_spaceship = is_spaceship;
+    ctx.pos_x = player_x - g_map_origin_x;
+    ctx.pos_z = player_z - g_map_origin_z;
+    ctx.view_sin = view_sin;
+    ctx.view_cos = view_cos;
+    ctx.ray_sin = tables->ray_sin;
+    ctx.ray_cos = tables->ray_cos;
+    ctx.ray_slope = tables->ray_slope;
+
+    // Column strips on the worker pool; returns once every strip is drawn
+    jobs_parallel_for(viewport_width, WORLD_STRIP_COLUMNS, render_column_strip, &ctx);
+
+    int strip_count = (viewport_width + WORLD_STRIP_COLUMNS - 1) / WORLD_STRIP_COLUMNS;
+    renderer_count_bytes_written(submit_strip_damage(g_strip_damage, strip_count));
+    g_sprites_on_screen = 0;
+    for (int i = 0; i < strip_count; ++i) {
+        g_sprites_on_screen |= g_sprite_damage[i].width > 0;
+    }
+
+    // The framebuffer now holds this frame, so the next one needs no clear
+    renderer_set_clear_needed(0);
+    g_last_frame_key = key;
+    g_history_valid = 1;
+}
+
+// Switch between textured and flat-shaded walls
+void world_set_textured_walls(int enabled) {
+    enabled = enabled ? 1 : 0;
+    if (enabled != g_textured_walls) {
+        g_textured_walls = enabled;
+        g_history_valid = 0; // Every span changes
+    }
+}
+
+int world_get_textured_walls(void) {
+    return g_textured_walls;
+}
+
+// Switch between cast floor/ceiling textures and the row gradient
+void world_set_textured_floors(int enabled) {
+    enabled = enabled ? 1 : 0;
+    if (enabled != g_textured_floors) {
+        g_textured_floors = enabled;
+        g_history_valid = 0; // Every background pixel changes
+    }
+}
+
+int world_get_textured_floors(void) {
+    return g_textured_floors;
+}
+
+int world_get_cast_rows(void) {
+    return g_cast_row_count;
+}
+
+// Cast a single ray from an origin (scalar DDA)
+void world_cast_ray(float origin_x, float origin_z, float dir_x, float dir_z,
+                    float max_dist, float* hit_dist, int* hit_side, float* hit_u, int* hit_cell) {
+    cast_ray(origin_x - g_map_origin_x, origin_z - g_map_origin_z, dir_x, dir_z, max_dist,
+             hit_dist, hit_side, hit_u, hit_cell);
+}
+
+// Number of rays traced together by world_cast_ray_packet
+int world_ray_packet_width(void) {
+    return SIMD_WIDTH;
+}
+
+// Cast world_ray_packet_width() rays from one origin together
+void world_cast_ray_packet(float origin_x, float origin_z, const float* dir_x, const float* dir_z,
+                           float max_dist, float* hit_dist, int* hit_side, float* hit_u, int* hit_cell) {
+    origin_x -= g_map_origin_x;
+    origin_z -= g_map_origin_z;
+#ifdef SIMD_SCALAR
+    cast_ray(origin_x, origin_z, dir_x[0], dir_z[0], max_dist, &hit_dist[0], &hit_side[0], &hit_u[0], &hit_cell[0]);
+#else
+    cast_ray_packet(origin_x, origin_z, dir_x, dir_z, max_dist, hit_dist, hit_side, hit_u, hit_cell);
+#endif
 }
 
 // Check collision with world
 int world_check_collision(float x, float y, float z, float radius) {
-    int map_x = (int)(x / MAP_SCALE);
-    int map_z = (int)(z / MAP_SCALE);
-    
-    // Check current cell and neighboring cells
-    for (int dz = -1; dz <= 1; dz++) {
-        for (int dx = -1; dx <= 1; dx++) {
-            if (get_map_cell(map_x + dx, map_z + dz) == 1) {
-                float cell_x = (map_x + dx) * MAP_SCALE;
-                float cell_z = (map_z + dz) * MAP_SCALE;
-                
-                float dist_x = fabsf(x - cell_x);
-                float dist_z = fabsf(z - cell_z);
-                
-                if (dist_x < radius + MAP_SCALE / 2.0f && 
-                    dist_z < radius + MAP_SCALE / 2.0f) {
-                    return 1; // Collision
-                }
-            }
-        }
-    }
-    
-    return 0; // No collision
+    CollisionGrid grid;
+    world_get_collision_grid(&grid);
+    return collision_overlaps(&grid, x, z, radius);
+}
+
+// Collision view of the active map: non-zero cells (and surface chunks
+// still being generated) are solid, as is everything outside the map
+void world_get_collision_grid(CollisionGrid* grid) {
+    grid->solid = get_map_cell;
+    grid->origin_x = g_map_origin_x;
+    grid->origin_z = g_map_origin_z;
+    grid->cell_size = MAP_SCALE;
 }
 
 // Get world bounds
 void world_get_bounds(float* min_x, float* max_x, float* min_z, float* max_z) {
+    if (g_on_surface) {
+        float extent = (float)SURFACE_MAX_CELLS * MAP_SCALE;
+        if (min_x) *min_x = -extent;
+        if (max_x) *max_x = extent;
+        if (min_z) *min_z = -extent;
+        if (max_z) *max_z = extent;
+        return;
+    }
     if (min_x) *min_x = 0.0f;
-    if (max_x) *max_x = MAP_WIDTH * MAP_SCALE;
+    if (max_x) *max_x = g_map->width * MAP_SCALE;
     if (min_z) *min_z = 0.0f;
-    if (max_z) *max_z = MAP_HEIGHT * MAP_SCALE;
+    if (max_z) *max_z = g_map->height * MAP_SCALE;
+}
+
+// Light and fog for a planet (-1: the spaceship). Every cached span and
+// the sky/floor gradient were shaded with the old tables.
+static void select_colormap(int planet_index) {
+    if (planet_index == g_colormap_planet) {
+        return;
+    }
+    colormap_build(&g_colormap, planet_index >= 0 ? space_get_planet(planet_index) : NULL, RAY_MAX_DIST);
+    g_colormap_planet = planet_index;
+    g_history_valid = 0;
+    g_row_height = -1;
 }
 
 // Set planet-specific map (for different planets)
@@ -373,19 +1456,176 @@ void world_set_planet_map(int planet_type) {
         return; // Invalid planet type
     }
     
-    // Switch to planet map
-    g_map = g_planet_map;
+    // Switch to the planet's own map image if it has one (a pointer swap)
+    if (planet_type < WORLD_MAX_PLANET_MAPS && g_planet_files[planet_type].header) {
+        set_bounded_map(&g_planet_files[planet_type].map, &g_planet_files[planet_type]);
+    } else {
+        set_bounded_map(&g_maps[MAP_PLANET], NULL);
+    }
+    select_colormap(planet_type);
     printf("Map set for planet type %d\n", planet_type);
 }
 
 // Set spaceship map
 void world_set_spaceship_map(void) {
-    g_map = g_spaceship_map;
+    set_bounded_map(&g_maps[MAP_SPACESHIP], NULL);
+    select_colormap(-1);
     printf("Map set for spaceship interior\n");
 }
 
+// Load a runtime-sized map and make it the active one
+int world_load_map(const uint8_t* cells, int width, int height) {
+    if (!worldmap_create(&g_maps[MAP_LOADED], cells, width, height)) {
+        return 0;
+    }
+    set_bounded_map(&g_maps[MAP_LOADED], NULL);
+    printf("Map loaded: %dx%d\n", width, height);
+    return 1;
+}
+
+// Make a loaded image the planet's map, replacing (and closing) its old one
+static void install_planet_map(int planet_index, const QMapFile* loaded) {
+    QMapFile* file = &g_planet_files[planet_index];
+    int was_active = (g_map_file == file);
+    qmap_close(file);
+    *file = *loaded;
+    if (was_active && g_on_surface) {
+        surface_set_site(&file->map); // Restamped on the next world_update
+    } else if (was_active) {
+        g_map = &file->map;
+        g_map_generation++;
+    }
+    printf("Planet %d map: %s (%dx%d)\n", planet_index, file->header->name, file->map.width, file->map.height);
+}
+
+// Give a planet its own map from a caller-owned .qmap image (no copy)
+int world_attach_planet_map(int planet_index, const void* data, size_t size) {
+    if (planet_index < 0 || planet_index >= WORLD_MAX_PLANET_MAPS) {
+        printf("ERROR: Invalid planet index %d for map\n", planet_index);
+        return 0;
+    }
+    QMapFile loaded;
+    if (!qmap_attach(&loaded, data, size)) {
+        return 0;
+    }
+    install_planet_map(planet_index, &loaded);
+    return 1;
+}
+
+// Give a planet its own map from a .qmap file (memory-mapped natively)
+int world_open_planet_map(int planet_index, const char* path) {
+    if (planet_index < 0 || planet_index >= WORLD_MAX_PLANET_MAPS) {
+        printf("ERROR: Invalid planet index %d for map\n", planet_index);
+        return 0;
+    }
+    QMapFile loaded;
+    if (!qmap_open(&loaded, path)) {
+        return 0;
+    }
+    install_planet_map(planet_index, &loaded);
+    return 1;
+}
+
+// Player start defined by the active map image
+int world_get_spawn(float* x, float* z, float* yaw) {
+    if (!g_map_file || g_map_file->header->spawn_count == 0) {
+        return 0;
+    }
+    const QMapSpawn* spawn = &g_map_file->spawns[0];
+    if (x) *x = spawn->x;
+    if (z) *z = spawn->z;
+    if (yaw) *yaw = spawn->yaw;
+    return 1;
+}
+
+// Player start defined by a planet's map image, before switching to it
+int world_get_planet_spawn(int planet_index, float* x, float* z, float* yaw) {
+    if (planet_index < 0 || planet_index >= WORLD_MAX_PLANET_MAPS) {
+        return 0;
+    }
+    const QMapFile* file = &g_planet_files[planet_index];
+    if (!file->header || file->header->spawn_count == 0) {
+        return 0;
+    }
+    if (x) *x = file->spawns[0].x;
+    if (z) *z = file->spawns[0].z;
+    if (yaw) *yaw = file->spawns[0].yaw;
+    return 1;
+}
+
+// Turn the active planet map into the landing site of an endless surface
+int world_enter_surface(const SurfaceDesc* desc, float x, float z) {
+    if (!g_endless_surfaces || g_on_surface) {
+        return 0;
+    }
+    surface_begin(desc, g_map, x / MAP_SCALE, z / MAP_SCALE);
+    entity_clear();
+    g_on_surface = 1;
+    sync_surface_window();
+    return 1;
+}
+
+// Generate a surface around world position (x, z) ahead of entering it
+int world_prefetch_surface(const SurfaceDesc* desc, float x, float z) {
+    if (!g_endless_surfaces) {
+        return 0;
+    }
+    return surface_prefetch(desc, x / MAP_SCALE, z / MAP_SCALE);
+}
+
+// Enter endless surfaces on planets (default) or stay on bounded maps
+void world_set_endless_surfaces(int enabled) {
+    g_endless_surfaces = enabled ? 1 : 0;
+}
+
+int world_get_endless_surfaces(void) {
+    return g_endless_surfaces;
+}
+
+int world_is_on_surface(void) {
+    return g_on_surface;
+}
+
+// Size and memory footprint of the active map
+void world_get_map_info(WorldMapInfo* info) {
+    info->width = g_map->width;
+    info->height = g_map->height;
+    info->levels = g_map->level_count;
+    info->cell_bytes = g_map->cell_bytes;
+    info->pyramid_bytes = g_map->pyramid_bytes;
+}
+
+// Toggle empty-space skipping in the ray tracers (for benchmarks)
+void world_set_empty_space_skipping(int enabled) {
+    g_skip_empty_space = enabled ? 1 : 0;
+}
+
 // Shutdown world
 void world_shutdown(void) {
+    free(g_row_colors);
+    free(g_cast_rows);
+    g_row_colors = NULL;
+    g_cast_rows = NULL;
+    g_row_capacity = 0;
+    g_row_height = -1;
+    free_spans();
+    texture_atlas_shutdown();
+    for (int i = 0; i < MAP_COUNT; ++i) {
+        worldmap_destroy(&g_maps[i]);
+    }
+    surface_shutdown();
+    entity_shutdown();
+    sprite_shutdown();
+    for (int i = 0; i < WORLD_MAX_PLANET_MAPS; ++i) {
+        qmap_close(&g_planet_files[i]);
+    }
+    g_map = &g_maps[MAP_PLANET];
+    g_map_file = NULL;
+    g_on_surface = 0;
+    g_map_origin_x = 0.0f;
+    g_map_origin_z = 0.0f;
+    g_history_valid = 0;
+    g_sprites_on_screen = 0;
     g_world_initialized = 0;
 }
 
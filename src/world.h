@@ -4,6 +4,23 @@
 #ifndef WORLD_H
 #define WORLD_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include "collision.h"
+#include "surface.h"
+
+// Planets that can have their own map image
+#define WORLD_MAX_PLANET_MAPS 16
+
+// Active map size and memory use
+typedef struct {
+    int width;              // Cells along x (each cell is 2 world units)
+    int height;             // Cells along z
+    int levels;             // Occupancy pyramid levels
+    size_t cell_bytes;      // One byte per cell, in 8x8 tiles
+    size_t pyramid_bytes;
+} WorldMapInfo;
+
 // Initialize world
 int world_init(void);
 
@@ -16,15 +33,92 @@ void world_render(void);
 // Get current location type (for rendering different environments)
 int world_get_location_type(void);
 
-// Check collision with world
+// Check collision with world: 1 if a circle of the given radius at (x, z)
+// overlaps a wall
 int world_check_collision(float x, float y, float z, float radius);
 
+// The active map as a collision grid for collision_move (valid until the
+// map changes; world_update can move the surface window)
+void world_get_collision_grid(CollisionGrid* grid);
+
+// Cast a single ray from an origin through the active map (scalar DDA).
+// hit_dist is in world units (max_dist on a miss); hit_side is 0 for an
+// x-facing wall and 1 for a z-facing wall. hit_u is the texture coordinate
+// along the wall face in [0, 1) and hit_cell the id of the map cell hit
+// (both 0 on a miss).
+void world_cast_ray(float origin_x, float origin_z, float dir_x, float dir_z,
+                    float max_dist, float* hit_dist, int* hit_side, float* hit_u, int* hit_cell);
+
+// Number of rays traced together by world_cast_ray_packet (1 without SIMD)
+int world_ray_packet_width(void);
+
+// Cast world_ray_packet_width() rays from one origin together. Results are
+// bit-identical to calling world_cast_ray on each direction.
+void world_cast_ray_packet(float origin_x, float origin_z, const float* dir_x, const float* dir_z,
+                           float max_dist, float* hit_dist, int* hit_side, float* hit_u, int* hit_cell);
+
+// Sample the wall texture atlas (default) or use flat-shaded walls
+void world_set_textured_walls(int enabled);
+int world_get_textured_walls(void);
+
+// Cast textured floors, and the spaceship's ceiling (default), or draw the
+// per-row gradient
+void world_set_textured_floors(int enabled);
+int world_get_textured_floors(void);
+
+// Rows the last drawn frame cast with floor or ceiling textures
+int world_get_cast_rows(void);
+
 // Get world bounds
 void world_get_bounds(float* min_x, float* max_x, float* min_z, float* max_z);
 
 // Set planet-specific map (for different planets)
 void world_set_planet_map(int planet_type);
 
+// Set spaceship interior map
+void world_set_spaceship_map(void);
+
+// Load a width x height map of row-major cell ids (0 = empty, any other
+// value is a wall; 1 and 2 pick the environment's two wall textures) and
+// make it active. The cells are copied. Returns 0 on failure.
+int world_load_map(const uint8_t* cells, int width, int height);
+
+// Give a planet its own map from a .qmap image. attach uses a caller-owned
+// buffer (it must stay valid and is not copied); open memory-maps a file.
+// world_set_planet_map then switches to it by pointer. Return 0 on failure.
+int world_attach_planet_map(int planet_index, const void* data, size_t size);
+int world_open_planet_map(int planet_index, const char* path);
+
+// First spawn point of the active map image in world units (returns 0 if
+// the active map has none, e.g. the built-in maps)
+int world_get_spawn(float* x, float* z, float* yaw);
+
+// First spawn point of a planet's map image, whether or not it is active
+int world_get_planet_spawn(int planet_index, float* x, float* z, float* yaw);
+
+// Make the active planet map the landing site of the endless surface desc
+// describes, streamed around world position (x, z); the site's cell (0, 0)
+// stays at world (0, 0). The bounded map setters above leave the surface.
+// Returns 0 (and keeps the bounded map) when endless surfaces are off.
+int world_enter_surface(const SurfaceDesc* desc, float x, float z);
+
+// Start generating the surface around world position (x, z) before
+// entering it, while the current map keeps rendering. Call every frame;
+// returns the chunks still missing (0 when ready or surfaces are off).
+int world_prefetch_surface(const SurfaceDesc* desc, float x, float z);
+
+// Enter endless surfaces on planets (default) or keep the bounded maps
+void world_set_endless_surfaces(int enabled);
+int world_get_endless_surfaces(void);
+int world_is_on_surface(void);
+
+// Size and memory footprint of the active map
+void world_get_map_info(WorldMapInfo* info);
+
+// Let the ray tracers skip empty regions through the occupancy pyramid
+// (default). Disabling it walks every cell; results are identical.
+void world_set_empty_space_skipping(int enabled);
+
 // Shutdown world
 void world_shutdown(void);
 
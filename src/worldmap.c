@@ -0,0 +1,118 @@
+// World map implementation - Tiled cells and occupancy pyramid
+// QuakeCloneWASM - World system
+//
+// A 1024x1024 map takes 1 MB of cells (4 MB as int) plus about 22 KB of
+// pyramid. Tiles keep the cells a ray crosses within a few cache lines,
+// and the pyramid lets the tracers cross an empty 8x8 ... NxN block in a
+// single step.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "worldmap.h"
+
+// Build level 0 from the cells and every coarser level from the one below
+void worldmap_update_pyramid(WorldMap* map) {
+    for (int ty = 0; ty < map->tiles_y; ++ty) {
+        for (int tx = 0; tx < map->tiles_x; ++tx) {
+            const uint8_t* tile = map->cells + (((size_t)ty * (size_t)map->tiles_x + (size_t)tx) << (2 * WORLDMAP_TILE_LOG2));
+            uint8_t occupied = 0;
+            for (int i = 0; i < WORLDMAP_TILE_SIZE * WORLDMAP_TILE_SIZE; ++i) {
+                occupied |= tile[i];
+            }
+            map->levels[0][(size_t)ty * (size_t)map->tiles_x + (size_t)tx] = occupied ? 1 : 0;
+        }
+    }
+
+    for (int k = 1; k < map->level_count; ++k) {
+        const uint8_t* below = map->levels[k - 1];
+        int below_width = map->level_width[k - 1];
+        int below_height = map->level_height[k - 1];
+        for (int y = 0; y < map->level_height[k]; ++y) {
+            for (int x = 0; x < map->level_width[k]; ++x) {
+                uint8_t occupied = 0;
+                for (int dy = 0; dy < 2; ++dy) {
+                    for (int dx = 0; dx < 2; ++dx) {
+                        int bx = x * 2 + dx;
+                        int by = y * 2 + dy;
+                        if (bx < below_width && by < below_height) {
+                            occupied |= below[(size_t)by * (size_t)below_width + (size_t)bx];
+                        }
+                    }
+                }
+                map->levels[k][(size_t)y * (size_t)map->level_width[k] + (size_t)x] = occupied;
+            }
+        }
+    }
+}
+
+// Build a map from row-major cells
+int worldmap_create(WorldMap* map, const uint8_t* cells, int width, int height) {
+    worldmap_destroy(map);
+
+    if (width <= 0 || height <= 0 || !cells) {
+        printf("ERROR: Invalid map size %dx%d\n", width, height);
+        return 0;
+    }
+
+    map->width = width;
+    map->height = height;
+    map->tiles_x = (width + WORLDMAP_TILE_SIZE - 1) / WORLDMAP_TILE_SIZE;
+    map->tiles_y = (height + WORLDMAP_TILE_SIZE - 1) / WORLDMAP_TILE_SIZE;
+
+    // Cells beyond the map edge in partial tiles stay empty
+    map->cell_bytes = ((size_t)map->tiles_x * (size_t)map->tiles_y << (2 * WORLDMAP_TILE_LOG2)) + WORLDMAP_PADDING;
+    map->cells = (uint8_t*)calloc(map->cell_bytes, 1);
+    if (!map->cells) {
+        printf("ERROR: Failed to allocate %dx%d map\n", width, height);
+        worldmap_destroy(map);
+        return 0;
+    }
+
+    for (int z = 0; z < height; ++z) {
+        for (int x = 0; x < width; ++x) {
+            map->cells[worldmap_cell_index(map, x, z)] = cells[(size_t)z * (size_t)width + (size_t)x];
+        }
+    }
+
+    // Halve the level size until one block covers the whole map
+    int level_width = map->tiles_x;
+    int level_height = map->tiles_y;
+    for (;;) {
+        if (map->level_count == WORLDMAP_MAX_LEVELS) {
+            printf("ERROR: Map %dx%d is too large\n", width, height);
+            worldmap_destroy(map);
+            return 0;
+        }
+        int k = map->level_count;
+        size_t bytes = (size_t)level_width * (size_t)level_height + WORLDMAP_PADDING;
+        map->levels[k] = (uint8_t*)calloc(bytes, 1);
+        if (!map->levels[k]) {
+            printf("ERROR: Failed to allocate map pyramid\n");
+            worldmap_destroy(map);
+            return 0;
+        }
+        map->level_width[k] = level_width;
+        map->level_height[k] = level_height;
+        map->pyramid_bytes += bytes;
+        map->level_count++;
+
+        if (level_width == 1 && level_height == 1) {
+            break;
+        }
+        level_width = (level_width + 1) / 2;
+        level_height = (level_height + 1) / 2;
+    }
+
+    worldmap_update_pyramid(map);
+    return 1;
+}
+
+// Release a map's arrays
+void worldmap_destroy(WorldMap* map) {
+    free(map->cells);
+    for (int k = 0; k < map->level_count; ++k) {
+        free(map->levels[k]);
+    }
+    memset(map, 0, sizeof(*map));
+}
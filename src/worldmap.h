@@ -0,0 +1,73 @@
+// World map header - Runtime-sized tiled grid with an occupancy pyramid
+// QuakeCloneWASM - World system
+
+#ifndef WORLDMAP_H
+#define WORLDMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Cells are stored in 8x8 tiles (64 bytes, one cache line)
+#define WORLDMAP_TILE_LOG2 3
+#define WORLDMAP_TILE_SIZE (1 << WORLDMAP_TILE_LOG2)
+
+// Coarse levels: level k has one byte per (8 << k) x (8 << k) block of cells
+#define WORLDMAP_MAX_LEVELS 16
+
+// Bytes readable past the end of every array, so SIMD gathers may load a
+// whole 32-bit word for a byte cell
+#define WORLDMAP_PADDING 4
+
+// One map. Cell ids are bytes (0 = empty); anything outside the map counts
+// as empty for rays and as solid for collision.
+typedef struct {
+    int width;                                  // Cells along x
+    int height;                                 // Cells along z
+    int tiles_x;                                // Tiles per tile row
+    int tiles_y;                                // Tile rows
+    uint8_t* cells;                             // Tile-major; row-major within a tile
+    int level_count;                            // Last level is a single block
+    int level_width[WORLDMAP_MAX_LEVELS];
+    int level_height[WORLDMAP_MAX_LEVELS];
+    uint8_t* levels[WORLDMAP_MAX_LEVELS];       // 1 if any cell in the block is non-empty
+    size_t cell_bytes;                          // Allocation sizes, for reporting
+    size_t pyramid_bytes;
+} WorldMap;
+
+// Build a map from row-major cells (width * height bytes). map must be
+// zeroed or hold a previous map, which is replaced; returns 0 on failure
+// and leaves map empty.
+int worldmap_create(WorldMap* map, const uint8_t* cells, int width, int height);
+
+// Release a map's arrays
+void worldmap_destroy(WorldMap* map);
+
+// Recompute the occupancy pyramid after writing to map->cells directly
+void worldmap_update_pyramid(WorldMap* map);
+
+// Offset of cell (x, z) in map->cells; (x, z) must lie inside the map
+static inline size_t worldmap_cell_index(const WorldMap* map, int x, int z) {
+    size_t tile = (size_t)(z >> WORLDMAP_TILE_LOG2) * (size_t)map->tiles_x + (size_t)(x >> WORLDMAP_TILE_LOG2);
+    return (tile << (2 * WORLDMAP_TILE_LOG2)) |
+           (size_t)(((z & (WORLDMAP_TILE_SIZE - 1)) << WORLDMAP_TILE_LOG2) | (x & (WORLDMAP_TILE_SIZE - 1)));
+}
+
+static inline int worldmap_inside(const WorldMap* map, int x, int z) {
+    return x >= 0 && x < map->width && z >= 0 && z < map->height;
+}
+
+// Side length in cells of the largest empty pyramid block containing cell
+// (x, z): 1 when its tile holds a wall, up to the whole map
+static inline int worldmap_empty_block(const WorldMap* map, int x, int z) {
+    int block = 1;
+    for (int k = 0; k < map->level_count; ++k) {
+        int shift = WORLDMAP_TILE_LOG2 + k;
+        if (map->levels[k][(size_t)(z >> shift) * (size_t)map->level_width[k] + (size_t)(x >> shift)]) {
+            break;
+        }
+        block = 1 << shift;
+    }
+    return block;
+}
+
+#endif // WORLDMAP_H
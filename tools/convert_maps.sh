@@ -0,0 +1,17 @@
+#!/bin/bash
+# Map conversion script - Build site/maps/*.qmap from assets/maps/*.txt
+# QuakeCloneWASM - Run ./build_native.sh first to build the converter
+
+CONVERTER=build/native/qmapconv
+
+if [ ! -x "$CONVERTER" ]; then
+    echo "ERROR: $CONVERTER not found (run ./build_native.sh)"
+    exit 1
+fi
+
+mkdir -p site/maps
+
+for source in assets/maps/*.txt; do
+    name=$(basename "$source" .txt)
+    "$CONVERTER" "$source" "site/maps/$name.qmap" || exit 1
+done
@@ -0,0 +1,168 @@
+// Map converter - Turn ASCII map sources into .qmap images
+// QuakeCloneWASM - Tools
+//
+// Usage: qmapconv input.txt output.qmap
+//
+// Source format, one grid row per line after optional header lines:
+//   name: Terra Nova          Display name (defaults to the file name)
+//   spawn: x z yaw            Extra spawn point in world units
+//   #  wall (1)   +  rock (2)   1-9  cell id   . or space  empty
+//   S  empty cell holding a spawn point (facing yaw 0)
+// Rows may differ in length; missing cells are empty.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "qmap.h"
+
+#define MAX_LINE 4096
+#define MAX_SPAWNS 64
+#define CELL_SIZE 2.0f
+
+static void trim_line_end(char* line) {
+    size_t length = strlen(line);
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+        line[--length] = '\0';
+    }
+}
+
+static int cell_value(char c, int* value) {
+    if (c == '.' || c == ' ' || c == 'S') {
+        *value = 0;
+    } else if (c == '#') {
+        *value = 1;
+    } else if (c == '+') {
+        *value = 2;
+    } else if (c >= '1' && c <= '9') {
+        *value = c - '0';
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        printf("Usage: qmapconv input.txt output.qmap\n");
+        return 1;
+    }
+
+    FILE* stream = fopen(argv[1], "r");
+    if (!stream) {
+        printf("ERROR: Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    char name[QMAP_NAME_LENGTH];
+    const char* base = strrchr(argv[1], '/');
+    strncpy(name, base ? base + 1 : argv[1], QMAP_NAME_LENGTH - 1);
+    name[QMAP_NAME_LENGTH - 1] = '\0';
+    char* extension = strrchr(name, '.');
+    if (extension) {
+        *extension = '\0';
+    }
+
+    QMapSpawn spawns[MAX_SPAWNS];
+    int spawn_count = 0;
+    memset(spawns, 0, sizeof(spawns));
+
+    // First pass collects the rows; the grid size is only known at the end
+    char** rows = NULL;
+    int row_count = 0;
+    int width = 0;
+    char line[MAX_LINE];
+    while (fgets(line, sizeof(line), stream)) {
+        trim_line_end(line);
+        if (row_count == 0 && strncmp(line, "name:", 5) == 0) {
+            const char* value = line + 5;
+            while (*value == ' ') {
+                value++;
+            }
+            strncpy(name, value, QMAP_NAME_LENGTH - 1);
+            name[QMAP_NAME_LENGTH - 1] = '\0';
+            continue;
+        }
+        if (row_count == 0 && strncmp(line, "spawn:", 6) == 0) {
+            QMapSpawn* spawn = &spawns[spawn_count];
+            if (spawn_count == MAX_SPAWNS || sscanf(line + 6, "%f %f %f", &spawn->x, &spawn->z, &spawn->yaw) != 3) {
+                printf("ERROR: Bad spawn line: %s\n", line);
+                fclose(stream);
+                return 1;
+            }
+            spawn_count++;
+            continue;
+        }
+        if (row_count == 0 && line[0] == '\0') {
+            continue;
+        }
+
+        char** grown = (char**)realloc(rows, (size_t)(row_count + 1) * sizeof(char*));
+        if (!grown) {
+            printf("ERROR: Out of memory\n");
+            fclose(stream);
+            return 1;
+        }
+        rows = grown;
+        rows[row_count++] = strdup(line);
+        int length = (int)strlen(line);
+        if (length > width) {
+            width = length;
+        }
+    }
+    fclose(stream);
+
+    // Drop trailing blank rows
+    while (row_count > 0 && rows[row_count - 1][0] == '\0') {
+        free(rows[--row_count]);
+    }
+    if (row_count == 0 || width == 0) {
+        printf("ERROR: %s has no grid\n", argv[1]);
+        return 1;
+    }
+
+    int height = row_count;
+    uint8_t* cells = (uint8_t*)calloc((size_t)width * (size_t)height, 1);
+    if (!cells) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+    for (int z = 0; z < height; ++z) {
+        const char* row = rows[z];
+        for (int x = 0; row[x] != '\0'; ++x) {
+            int value;
+            if (!cell_value(row[x], &value)) {
+                printf("ERROR: %s:%d: unknown cell '%c'\n", argv[1], z + 1, row[x]);
+                return 1;
+            }
+            cells[(size_t)z * (size_t)width + (size_t)x] = (uint8_t)value;
+            if (row[x] == 'S') {
+                if (spawn_count == MAX_SPAWNS) {
+                    printf("ERROR: Too many spawn points\n");
+                    return 1;
+                }
+                spawns[spawn_count].x = ((float)x + 0.5f) * CELL_SIZE;
+                spawns[spawn_count].z = ((float)z + 0.5f) * CELL_SIZE;
+                spawns[spawn_count].yaw = 0.0f;
+                spawn_count++;
+            }
+        }
+        free(rows[z]);
+    }
+    free(rows);
+
+    WorldMap map;
+    memset(&map, 0, sizeof(map));
+    if (!worldmap_create(&map, cells, width, height)) {
+        free(cells);
+        return 1;
+    }
+    free(cells);
+
+    int ok = qmap_write(argv[2], &map, name, spawns, spawn_count);
+    if (ok) {
+        printf("%s: %s, %dx%d cells, %d spawn(s), %zu bytes\n", argv[2], name, width, height,
+               spawn_count, map.cell_bytes + map.pyramid_bytes);
+    }
+    worldmap_destroy(&map);
+    return ok ? 0 : 1;
+}